@@ -1,6 +1,9 @@
 include(UsePETSc)
 include(UseEigen)
 
+# std::thread based shared memory parallel assembly
+find_package(Threads)
+
 function(add_dune_petsc_flags)
   if(PETSC_FOUND)
     cmake_parse_arguments(ADD_PETSC "SOURCE_ONLY;OBJECT" "" "" ${ARGN})
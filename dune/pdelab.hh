@@ -32,6 +32,8 @@
 #include <dune/pdelab/solver/utility.hh>
 #include <dune/pdelab/newton/newton.hh>
 #include <dune/pdelab/localoperator/numericaljacobian.hh>
+#include <dune/pdelab/localoperator/adjacobian.hh>
+#include <dune/pdelab/localoperator/batchednumericaljacobian.hh>
 #include <dune/pdelab/localoperator/darcyccfv.hh>
 #include <dune/pdelab/localoperator/maxwellparameter.hh>
 #include <dune/pdelab/localoperator/variablefactories.hh>
@@ -43,6 +45,7 @@
 #include <dune/pdelab/localoperator/convectiondiffusionparameter.hh>
 #include <dune/pdelab/localoperator/interface.hh>
 #include <dune/pdelab/localoperator/diffusionmixed.hh>
+#include <dune/pdelab/localoperator/hybridizeddiffusionmixed.hh>
 #include <dune/pdelab/localoperator/zero.hh>
 #include <dune/pdelab/localoperator/scaled.hh>
 #include <dune/pdelab/localoperator/numericalresidual.hh>
@@ -55,6 +58,7 @@
 #include <dune/pdelab/localoperator/idefault.hh>
 #include <dune/pdelab/localoperator/darcyfem.hh>
 #include <dune/pdelab/localoperator/l2.hh>
+#include <dune/pdelab/localoperator/masslumping.hh>
 #include <dune/pdelab/localoperator/dgnavierstokes.hh>
 #include <dune/pdelab/localoperator/l2volumefunctional.hh>
 #include <dune/pdelab/localoperator/electrodynamic.hh>
@@ -98,6 +102,8 @@
 #include <dune/pdelab/common/elementmapper.hh>
 #include <dune/pdelab/common/quadraturerules.hh>
 #include <dune/pdelab/common/dofindex.hh>
+#include <dune/pdelab/common/dualnumber.hh>
+#include <dune/pdelab/common/perturbationbatch.hh>
 #include <dune/pdelab/common/benchmarkhelper.hh>
 #include <dune/pdelab/common/topologyutility.hh>
 #include <dune/pdelab/common/intersectiontype.hh>
@@ -109,6 +115,7 @@
 #include <dune/pdelab/common/hostname.hh>
 #include <dune/pdelab/common/functionutilities.hh>
 #include <dune/pdelab/common/borderindexidcache.hh>
+#include <dune/pdelab/common/geometrycache.hh>
 #include <dune/pdelab/common/geometrywrapper.hh>
 #include <dune/pdelab/common/clock.hh>
 #include <dune/pdelab/common/crossproduct.hh>
@@ -118,6 +125,7 @@
 #include <dune/pdelab/common/globaldofindex.hh>
 #include <dune/pdelab/common/multiindex.hh>
 #include <dune/pdelab/common/jacobiantocurl.hh>
+#include <dune/pdelab/common/atomicadd.hh>
 #include <dune/pdelab/stationary/linearproblem.hh>
 #include <dune/pdelab/constraints/noconstraints.hh>
 #include <dune/pdelab/constraints/hangingnodemanager.hh>
@@ -137,6 +145,8 @@
 #include <dune/pdelab/backend/common/uncachedvectorview.hh>
 #include <dune/pdelab/backend/common/uncachedmatrixview.hh>
 #include <dune/pdelab/backend/common/aliasedvectorview.hh>
+#include <dune/pdelab/backend/common/atomicaddmatrixview.hh>
+#include <dune/pdelab/backend/common/uppertriangularmatrixview.hh>
 #include <dune/pdelab/backend/solver.hh>
 #include <dune/pdelab/backend/eigen.hh>
 #include <dune/pdelab/backend/eigen/solvers.hh>
@@ -156,6 +166,8 @@
 #include <dune/pdelab/backend/istl/forwarddeclarations.hh>
 #include <dune/pdelab/backend/istl/novlpistlsolverbackend.hh>
 #include <dune/pdelab/backend/istl/seqistlsolverbackend.hh>
+#include <dune/pdelab/backend/istl/sumfactorizeddg.hh>
+#include <dune/pdelab/backend/istl/uppertriangularmatrix.hh>
 #include <dune/pdelab/backend/istl/parallelhelper.hh>
 #include <dune/pdelab/backend/istl/vector.hh>
 #include <dune/pdelab/backend/istl/bcrsmatrixbackend.hh>
@@ -198,10 +210,14 @@
 #include <dune/pdelab/ordering/singlecodimleafordering.hh>
 #include <dune/pdelab/ordering/interleavedordering.hh>
 #include <dune/pdelab/ordering/gridviewordering.hh>
+#include <dune/pdelab/instationary/blockdiagonalmassinverse.hh>
+#include <dune/pdelab/instationary/imexonestep.hh>
 #include <dune/pdelab/instationary/implicitonestep.hh>
 #include <dune/pdelab/instationary/onestep.hh>
 #include <dune/pdelab/instationary/explicitonestep.hh>
 #include <dune/pdelab/instationary/onestepparameter.hh>
+#include <dune/pdelab/instationary/rosenbrock.hh>
+#include <dune/pdelab/instationary/vectorpool.hh>
 #include <dune/pdelab/finiteelementmap/qkfem.hh>
 #include <dune/pdelab/finiteelementmap/utility.hh>
 #include <dune/pdelab/finiteelementmap/rt0cube3dfem.hh>
@@ -241,6 +257,13 @@
 #include <dune/pdelab/gridoperator/onestep/enginebase.hh>
 #include <dune/pdelab/gridoperator/fastdg.hh>
 #include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
+#include <dune/pdelab/gridoperator/common/assemblerworker.hh>
+#include <dune/pdelab/gridoperator/common/globalassemblerbase.hh>
+#include <dune/pdelab/gridoperator/common/jacobianscattermap.hh>
+#include <dune/pdelab/gridoperator/common/meshtopologycache.hh>
+#include <dune/pdelab/gridoperator/common/localcontributioncache.hh>
+#include <dune/pdelab/gridoperator/common/elementmatrixcache.hh>
+#include <dune/pdelab/gridoperator/common/staticcondensation.hh>
 #include <dune/pdelab/gridoperator/common/diagonallocalmatrix.hh>
 #include <dune/pdelab/gridoperator/common/localmatrix.hh>
 #include <dune/pdelab/gridoperator/common/borderdofexchanger.hh>
@@ -254,10 +277,13 @@
 #include <dune/pdelab/gridoperator/fastdg/jacobianapplyengine.hh>
 #include <dune/pdelab/gridoperator/onestep.hh>
 #include <dune/pdelab/gridoperator/default/residualengine.hh>
+#include <dune/pdelab/gridoperator/default/residualjacobianengine.hh>
 #include <dune/pdelab/gridoperator/default/localassembler.hh>
 #include <dune/pdelab/gridoperator/default/jacobianengine.hh>
 #include <dune/pdelab/gridoperator/default/assembler.hh>
 #include <dune/pdelab/gridoperator/default/patternengine.hh>
 #include <dune/pdelab/gridoperator/default/jacobianapplyengine.hh>
+#include <dune/pdelab/gridoperator/default/elementmatrixengine.hh>
+#include <dune/pdelab/gridoperator/default/staticcondensationengine.hh>
 
 #endif // DUNE_PDELAB_HH
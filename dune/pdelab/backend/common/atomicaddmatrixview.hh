@@ -0,0 +1,73 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifndef DUNE_PDELAB_BACKEND_COMMON_ATOMICADDMATRIXVIEW_HH
+#define DUNE_PDELAB_BACKEND_COMMON_ATOMICADDMATRIXVIEW_HH
+
+#include <dune/pdelab/common/atomicadd.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! Adaptor for a bound matrix view that performs all additions atomically.
+    /**
+     * The adaptor exposes the subset of the matrix view interface used by the
+     * scatter routines of the local assemblers, i.e. the index caches and add().
+     * It can be used to scatter local matrices into a matrix with preallocated
+     * pattern from several threads concurrently, even if they write to the same
+     * entries.
+     *
+     * \tparam View  The matrix view, e.g. UncachedMatrixView.
+     */
+    template<typename View>
+    class AtomicAddMatrixView
+    {
+
+    public:
+
+      typedef typename View::Container Container;
+      typedef typename View::ElementType ElementType;
+      typedef typename View::size_type size_type;
+
+      typedef typename View::RowIndexCache RowIndexCache;
+      typedef typename View::ColIndexCache ColIndexCache;
+
+      explicit AtomicAddMatrixView(View& view)
+        : _view(view)
+      {}
+
+      const RowIndexCache& rowIndexCache() const
+      {
+        return _view.rowIndexCache();
+      }
+
+      const ColIndexCache& colIndexCache() const
+      {
+        return _view.colIndexCache();
+      }
+
+      size_type N() const
+      {
+        return _view.N();
+      }
+
+      size_type M() const
+      {
+        return _view.M();
+      }
+
+      //! Atomically adds v to the entry (i,j), accepts the same index types as View::add().
+      template<typename RI, typename CI>
+      void add(const RI& i, const CI& j, const ElementType& v)
+      {
+        atomicAdd(_view(i,j),v);
+      }
+
+    private:
+
+      View& _view;
+
+    };
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_BACKEND_COMMON_ATOMICADDMATRIXVIEW_HH
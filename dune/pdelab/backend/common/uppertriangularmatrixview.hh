@@ -0,0 +1,128 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifndef DUNE_PDELAB_BACKEND_COMMON_UPPERTRIANGULARMATRIXVIEW_HH
+#define DUNE_PDELAB_BACKEND_COMMON_UPPERTRIANGULARMATRIXVIEW_HH
+
+namespace Dune {
+  namespace PDELab {
+
+#ifndef DOXYGEN
+
+    namespace impl {
+
+      template<typename M>
+      auto upper_triangular_storage(const M& matrix, int)
+        -> decltype(matrix.upperTriangularStorage())
+      {
+        return matrix.upperTriangularStorage();
+      }
+
+      template<typename M>
+      bool upper_triangular_storage(const M& matrix, long)
+      {
+        return false;
+      }
+
+    } // namespace impl
+
+#endif // DOXYGEN
+
+    //! Returns whether the matrix container only stores the upper triangle of a symmetric matrix.
+    /**
+     * Containers signal this by a method upperTriangularStorage(), all other containers
+     * store the full matrix.
+     */
+    template<typename M>
+    bool upperTriangularStorage(const M& matrix)
+    {
+      return impl::upper_triangular_storage(matrix,0);
+    }
+
+    //! Adaptor for a bound matrix view that drops all additions to the strict lower triangle.
+    /**
+     * The adaptor exposes the subset of the matrix view interface used by the
+     * scatter routines of the local assemblers, i.e. the index caches and add().
+     * Entries are compared by their outermost container index, so the diagonal
+     * blocks of a blocked matrix are written completely.
+     *
+     * \tparam View  The matrix view, e.g. UncachedMatrixView or AtomicAddMatrixView.
+     */
+    template<typename View>
+    class UpperTriangularMatrixView
+    {
+
+    public:
+
+      typedef typename View::Container Container;
+      typedef typename View::ElementType ElementType;
+      typedef typename View::size_type size_type;
+
+      typedef typename View::RowIndexCache RowIndexCache;
+      typedef typename View::ColIndexCache ColIndexCache;
+
+      typedef typename RowIndexCache::ContainerIndex RowContainerIndex;
+      typedef typename ColIndexCache::ContainerIndex ColContainerIndex;
+
+      explicit UpperTriangularMatrixView(View& view)
+        : _view(view)
+      {}
+
+      const RowIndexCache& rowIndexCache() const
+      {
+        return _view.rowIndexCache();
+      }
+
+      const ColIndexCache& colIndexCache() const
+      {
+        return _view.colIndexCache();
+      }
+
+      size_type N() const
+      {
+        return _view.N();
+      }
+
+      size_type M() const
+      {
+        return _view.M();
+      }
+
+      //! Adds v to the entry (i,j) if it is part of the upper triangle, accepts the same index types as View::add().
+      template<typename RI, typename CI>
+      void add(const RI& i, const CI& j, const ElementType& v)
+      {
+        const RowContainerIndex& ri = rowContainerIndex(i);
+        const ColContainerIndex& ci = colContainerIndex(j);
+        if (ri.back() <= ci.back())
+          _view.add(ri,ci,v);
+      }
+
+    private:
+
+      const RowContainerIndex& rowContainerIndex(size_type i) const
+      {
+        return rowIndexCache().containerIndex(i);
+      }
+
+      const RowContainerIndex& rowContainerIndex(const RowContainerIndex& ri) const
+      {
+        return ri;
+      }
+
+      const ColContainerIndex& colContainerIndex(size_type j) const
+      {
+        return colIndexCache().containerIndex(j);
+      }
+
+      const ColContainerIndex& colContainerIndex(const ColContainerIndex& ci) const
+      {
+        return ci;
+      }
+
+      View& _view;
+
+    };
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_BACKEND_COMMON_UPPERTRIANGULARMATRIXVIEW_HH
@@ -2,6 +2,9 @@
 #ifndef DUNE_PDELAB_BACKEND_ISTL_BCRSMATRIX_HH
 #define DUNE_PDELAB_BACKEND_ISTL_BCRSMATRIX_HH
 
+#include <atomic>
+#include <cstddef>
+
 #include <dune/common/typetraits.hh>
 #include <dune/common/shared_ptr.hh>
 #if DUNE_VERSION_GTE(ISTL,2,8)
@@ -18,6 +21,19 @@ namespace Dune {
 
     namespace ISTL {
 
+#ifndef DOXYGEN
+      namespace Impl {
+
+        //! Returns a new, globally unique generation of a matrix pattern.
+        inline std::size_t nextPatternGeneration()
+        {
+          static std::atomic<std::size_t> generation(0);
+          return ++generation;
+        }
+
+      }
+#endif // DOXYGEN
+
       template<typename GFSV, typename GFSU, typename C, typename Stats>
       class BCRSMatrix
         : public Backend::impl::Wrapper<C>
@@ -77,6 +93,8 @@ namespace Dune {
         template<typename GO>
         explicit BCRSMatrix (const GO& go)
           : _container(std::make_shared<Container>())
+          , _upper_triangular(false)
+          , _pattern_generation(Impl::nextPatternGeneration())
         {
           _stats = go.matrixBackend().buildPattern(go,*this);
         }
@@ -93,6 +111,8 @@ namespace Dune {
         template<typename GO>
         BCRSMatrix (const GO& go, Container& container)
           : _container(Dune::stackobject_to_shared_ptr(container))
+          , _upper_triangular(false)
+          , _pattern_generation(Impl::nextPatternGeneration())
         {
           _stats = go.matrixBackend().buildPattern(go,*this);
         }
@@ -100,6 +120,8 @@ namespace Dune {
         template<typename GO>
         BCRSMatrix (const GO& go, const E& e)
           : _container(std::make_shared<Container>())
+          , _upper_triangular(false)
+          , _pattern_generation(Impl::nextPatternGeneration())
         {
           _stats = go.matrixBackend().buildPattern(go,*this);
           (*_container) = e;
@@ -107,15 +129,21 @@ namespace Dune {
 
         //! Creates an BCRSMatrix without allocating an underlying ISTL matrix.
         explicit BCRSMatrix (Backend::unattached_container = Backend::unattached_container())
+          : _upper_triangular(false)
+          , _pattern_generation(0)
         {}
 
         //! Creates an BCRSMatrix with an empty underlying ISTL matrix.
         explicit BCRSMatrix (Backend::attached_container)
           : _container(std::make_shared<Container>())
+          , _upper_triangular(false)
+          , _pattern_generation(Impl::nextPatternGeneration())
         {}
 
         BCRSMatrix(const BCRSMatrix& rhs)
           : _container(std::make_shared<Container>(*(rhs._container)))
+          , _upper_triangular(rhs._upper_triangular)
+          , _pattern_generation(Impl::nextPatternGeneration())
         {}
 
         BCRSMatrix& operator=(const BCRSMatrix& rhs)
@@ -123,6 +151,8 @@ namespace Dune {
           if (this == &rhs)
             return *this;
           _stats.clear();
+          _upper_triangular = rhs._upper_triangular;
+          _pattern_generation = Impl::nextPatternGeneration();
           if (attached())
             {
               (*_container) = (*(rhs._container));
@@ -170,11 +200,13 @@ namespace Dune {
         {
           _container.reset();
           _stats.clear();
+          _pattern_generation = 0;
         }
 
         void attach(std::shared_ptr<Container> container)
         {
           _container = container;
+          _pattern_generation = Impl::nextPatternGeneration();
         }
 
         bool attached() const
@@ -187,6 +219,35 @@ namespace Dune {
           return _container;
         }
 
+        //! Returns an identifier of the current storage and pattern of the matrix.
+        /**
+         * The generation is globally unique and changes whenever the wrapper builds, copies or
+         * attaches its storage, so data referring to the addresses of the matrix entries (see
+         * JacobianScatterMap) can be keyed on it. It has to be updated with patternChanged()
+         * after modifying the pattern of the native matrix directly.
+         */
+        std::size_t patternGeneration() const
+        {
+          return _pattern_generation;
+        }
+
+        //! Notifies the wrapper that the pattern or storage of the native matrix has been changed directly.
+        void patternChanged()
+        {
+          _pattern_generation = Impl::nextPatternGeneration();
+        }
+
+        //! Returns whether the matrix only stores its diagonal and upper triangle, see MatrixStorage.
+        bool upperTriangularStorage() const
+        {
+          return _upper_triangular;
+        }
+
+        void setUpperTriangularStorage(bool upper_triangular)
+        {
+          _upper_triangular = upper_triangular;
+        }
+
         size_type N() const
         {
           return _container->N();
@@ -219,6 +280,12 @@ namespace Dune {
           return ISTL::access_matrix_element(ISTL::container_tag(*_container),*_container,ri,ci,ri.size()-1,ci.size()-1);
         }
 
+        //! Returns a pointer to the entry (ri,ci), or nullptr if the entry is not part of the matrix pattern.
+        E* find(const RowIndex& ri, const ColIndex& ci)
+        {
+          return ISTL::find_matrix_element(ISTL::container_tag(*_container),*_container,ri,ci,ri.size()-1,ci.size()-1);
+        }
+
       private:
 
         const Container& native() const
@@ -267,6 +334,8 @@ namespace Dune {
 
         std::shared_ptr<Container> _container;
         std::vector<PatternStatistics> _stats;
+        bool _upper_triangular;
+        std::size_t _pattern_generation;
 
       };
 
@@ -2,6 +2,8 @@
 #ifndef DUNE_PDELAB_BACKEND_ISTL_BCRSMATRIXBACKEND_HH
 #define DUNE_PDELAB_BACKEND_ISTL_BCRSMATRIXBACKEND_HH
 
+#include <dune/common/exceptions.hh>
+
 #include <dune/pdelab/backend/istl/bcrsmatrix.hh>
 #include <dune/pdelab/backend/istl/bcrspattern.hh>
 #include <dune/pdelab/backend/istl/patternstatistics.hh>
@@ -166,9 +168,49 @@ namespace Dune {
               }
         }
 
+        // leaf pattern
+        template<typename Pattern>
+        typename std::enable_if<
+          std::is_same<typename Pattern::SubPattern,void>::value
+          >::type
+        restrict_pattern_to_upper_triangle(Pattern& p)
+        {
+          p.restrictToUpperTriangle();
+        }
+
+        // nested pattern
+        template<typename Pattern>
+        typename std::enable_if<
+          !std::is_same<typename Pattern::SubPattern,void>::value
+          >::type
+        restrict_pattern_to_upper_triangle(Pattern& p)
+        {
+          DUNE_THROW(NotImplemented,"Upper triangular storage is not supported for nested BCRS matrices");
+        }
+
       } // anonymous namespace
 
 
+      //! The part of the matrix stored by BCRSMatrixBackend.
+      enum class MatrixStorage
+      {
+        //! Store all entries of the matrix.
+        full,
+        //! Only store the diagonal and the upper triangle of a symmetric matrix.
+        /**
+         * The lower triangle is neither part of the pattern nor assembled, which halves the
+         * memory of the matrix and the number of entries scattered into it. Dirichlet
+         * constraints are applied symmetrically. The resulting matrix must only be used with
+         * operators and preconditioners aware of the storage, see UpperTriangularMatrixAdapter
+         * and ISTLBackend_SEQ_CG_UpperTriangular_SSOR.
+         *
+         * \note This mode is only available for symmetric Galerkin methods, non-nested
+         *       matrices and the default assembler.
+         */
+        upperTriangular
+      };
+
+
 
       //! Backend using (possibly nested) ISTL BCRSMatrices.
       /**
@@ -229,6 +271,16 @@ namespace Dune {
             typename GridOperator::Traits::TestGridFunctionSpace,
             typename GridOperator::Traits::TrialGridFunctionSpace
             > pattern(grid_operator.testGridFunctionSpace().ordering(),grid_operator.trialGridFunctionSpace().ordering(),_entries_per_row);
+          if (_storage == MatrixStorage::upperTriangular)
+            {
+              if (!std::is_same<
+                    typename GridOperator::Traits::TrialGridFunctionSpace,
+                    typename GridOperator::Traits::TestGridFunctionSpace
+                    >::value)
+                DUNE_THROW(InvalidStateException,"Upper triangular storage requires a Galerkin method");
+              restrict_pattern_to_upper_triangle(pattern);
+            }
+          matrix.setUpperTriangularStorage(_storage == MatrixStorage::upperTriangular);
           grid_operator.fill_pattern(pattern);
           std::vector<Statistics> stats;
           allocate_bcrs_matrix(grid_operator.testGridFunctionSpace().ordering(),
@@ -245,14 +297,23 @@ namespace Dune {
          * TODO: Document and flesh out the way this should work for nested matrices (use a nested array as entries_per_row).
          *
          * \param entries_per_row  The average number of nonzero entries per row in matrices created with this backend.
+         * \param storage          Whether to store the full matrix or only its upper triangle.
          */
-        BCRSMatrixBackend(const EntriesPerRow& entries_per_row)
+        BCRSMatrixBackend(const EntriesPerRow& entries_per_row, MatrixStorage storage = MatrixStorage::full)
           : _entries_per_row(entries_per_row)
+          , _storage(storage)
         {}
 
+        //! Returns the part of the matrix stored by matrices created with this backend.
+        MatrixStorage storage() const
+        {
+          return _storage;
+        }
+
       private:
 
         EntriesPerRow _entries_per_row;
+        MatrixStorage _storage;
 
       };
 
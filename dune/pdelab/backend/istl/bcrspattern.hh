@@ -99,6 +99,9 @@ namespace Dune {
           size_type i = ri.back();
           size_type j = ci.back();
 
+          if (_upper_triangular && j < i)
+            return;
+
           IndicesIterator start = _indices.begin();
           IndicesIterator begin = start + _entries_per_row*i;
           IndicesIterator end = start + _entries_per_row*(i+1);
@@ -266,6 +269,7 @@ namespace Dune {
           , _col_ordering(col_ordering)
           , _entries_per_row(entries_per_row)
           , _indices(row_ordering.blockCount()*entries_per_row,size_type(empty))
+          , _upper_triangular(false)
         {}
 
         const RowOrdering& rowOrdering() const
@@ -301,6 +305,17 @@ namespace Dune {
           return _overflow.size();
         }
 
+        //! Only keep the links (i,j) with i <= j, which suffices to store a symmetric matrix.
+        void restrictToUpperTriangle()
+        {
+          _upper_triangular = true;
+        }
+
+        bool upperTriangular() const
+        {
+          return _upper_triangular;
+        }
+
       private:
 
         const RowOrdering& _row_ordering;
@@ -309,6 +324,7 @@ namespace Dune {
 
         std::vector<size_type> _indices;
         std::set<std::pair<size_type,size_type> > _overflow;
+        bool _upper_triangular;
 
       };
 
@@ -281,6 +281,26 @@ namespace Dune {
 
 
 
+      // entries of dense blocks always exist
+      template<typename Tag, typename RI, typename CI, typename Block>
+      typename Block::field_type*
+      find_matrix_element(Tag tag, Block& b, const RI& ri, const CI& ci, int i, int j)
+      {
+        return &access_matrix_element(tag,b,ri,ci,i,j);
+      }
+
+      template<typename RI, typename CI, typename Block>
+      typename Block::field_type*
+      find_matrix_element(tags::bcrs_matrix, Block& b, const RI& ri, const CI& ci, int i, int j)
+      {
+        auto& row = b[ri[i]];
+        auto it = row.find(ci[j]);
+        if (it == row.end())
+          return nullptr;
+        return find_matrix_element(container_tag(*it),*it,ri,ci,i-1,j-1);
+      }
+
+
       template<typename RI, typename Block>
       void clear_matrix_row(tags::field_matrix_1_any, Block& b, const RI& ri, int i)
       {
@@ -0,0 +1,739 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+#ifndef DUNE_PDELAB_BACKEND_ISTL_SUMFACTORIZEDDG_HH
+#define DUNE_PDELAB_BACKEND_ISTL_SUMFACTORIZEDDG_HH
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/istl/solvers.hh>
+
+#include <dune/pdelab/backend/interface.hh>
+#include <dune/pdelab/backend/solver.hh>
+#include <dune/pdelab/finiteelement/sumfactorization.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include <dune/pdelab/localoperator/convectiondiffusiondg.hh>
+#include <dune/pdelab/localoperator/convectiondiffusionparameter.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup Backend
+    //! \ingroup PDELab
+    //! \{
+
+    /** \brief Matrix-free interior penalty DG operator for convection-diffusion-reaction on affine hexahedral grids
+     *
+     * Applies the linear part of ConvectionDiffusionDG, i.e. what GridOperator::jacobian_apply()
+     * computes for it, without assembling a matrix and without the generic assembler. Values and
+     * gradients in cells and on faces are evaluated and integrated with a SumFactorizationKernel.
+     * The metric terms are computed once in the constructor: per cell the reference space
+     * diffusion tensor, convection vector and reaction coefficient, and per face the penalty
+     * factor, the weights and the normal fluxes.
+     *
+     * The operator makes the following assumptions, which are checked in the constructor:
+     *  - all cells are affine cubes and all faces are conforming, with quadrature points on the
+     *    two sides of a face that coincide (true for YaspGrid),
+     *  - the finite element map is a QkDG map with a tensor product basis,
+     *  - the degrees of freedom of each cell are contiguous in the vector, as required by the
+     *    fast DG assembler,
+     *  - A, b and c are constant per cell and the boundary condition type is constant per face.
+     *    The coefficients are stored at the cell centers and the boundary condition types at the
+     *    face centers, and the constructor throws if they differ from the values at any of the
+     *    quadrature points of the cell or face.
+     *
+     * Quadrature is exact for such data, so the result agrees with ConvectionDiffusionDG up to
+     * rounding errors.
+     *
+     * \tparam GFS The DG grid function space
+     * \tparam T   Model of ConvectionDiffusionParameterInterface
+     * \tparam X   The vector type
+     */
+    template<typename GFS, typename T,
+             typename X = Backend::Vector<GFS,typename T::Traits::RangeFieldType> >
+    class SumFactorizedConvectionDiffusionDGOperator
+      : public Dune::LinearOperator<X,X>
+    {
+      using GV = typename GFS::Traits::GridViewType;
+      using FEM = typename GFS::Traits::FiniteElementMapType;
+      using LocalBasis = typename FEM::Traits::FiniteElementType::Traits::LocalBasisType;
+      using Polynomials = TensorProductPolynomials<LocalBasis>;
+      using DF = typename GV::Grid::ctype;
+      using LFS = LocalFunctionSpace<GFS>;
+      using LFSCache = LFSIndexCache<LFS>;
+      using ContainerIndex = typename LFSCache::ContainerIndex;
+
+      static_assert(Polynomials::isTensorProduct,
+                    "SumFactorizedConvectionDiffusionDGOperator requires a tensor product DG basis");
+
+      static constexpr int dim = GV::dimension;
+
+    public:
+      typedef X domain_type;
+      typedef X range_type;
+      typedef typename X::ElementType field_type;
+      using RF = field_type;
+      using Kernel = decltype(makeSumFactorizationKernel<LocalBasis>(0));
+
+      /** \brief set up the cell and face data
+       *
+       * \param gfs     The DG grid function space.
+       * \param param   The parameter object.
+       * \param method  Interior penalty Galerkin method.
+       * \param weights Weighted averages for diffusion tensor.
+       * \param alpha   Penalization constant.
+       * \param intorderadd Increase of the quadrature order 2k.
+       *
+       * The parameters have the same meaning and defaults as for ConvectionDiffusionDG.
+       */
+      SumFactorizedConvectionDiffusionDGOperator (const GFS& gfs, T& param,
+                                                  ConvectionDiffusionDGMethod::Type method=ConvectionDiffusionDGMethod::SIPG,
+                                                  ConvectionDiffusionDGWeights::Type weights=ConvectionDiffusionDGWeights::weightsOn,
+                                                  RF alpha=1.0, int intorderadd=0)
+        : _kernel(makeSumFactorizationKernel<LocalBasis>(2*Polynomials::degree+intorderadd))
+        , _theta(method==ConvectionDiffusionDGMethod::SIPG ? -1.0 : (method==ConvectionDiffusionDGMethod::IIPG ? 0.0 : 1.0))
+      {
+        setup(gfs,param,weights,alpha);
+      }
+
+      //! y = A x
+      void apply (const X& x, X& y) const override
+      {
+        y = 0.0;
+        accumulate(1.0,x,y);
+      }
+
+      //! y += alpha A x
+      void applyscaleadd (field_type alpha, const X& x, X& y) const override
+      {
+        accumulate(alpha,x,y);
+      }
+
+      SolverCategory::Category category() const override
+      {
+        return SolverCategory::sequential;
+      }
+
+      //! number of cells
+      std::size_t cells () const
+      {
+        return _cells.size();
+      }
+
+      //! number of degrees of freedom per cell
+      std::size_t blockSize () const
+      {
+        return _kernel.size();
+      }
+
+      //! the coefficients of a cell
+      const RF* cellData (const X& x, std::size_t cell) const
+      {
+        return &x[_first] + _cells[cell].offset;
+      }
+
+      //! the coefficients of a cell
+      RF* cellData (X& x, std::size_t cell) const
+      {
+        return &x[_first] + _cells[cell].offset;
+      }
+
+      /** \brief compute the diagonal blocks of the operator
+       *
+       * Applies the coupling of each cell with itself to all unit vectors, which costs
+       * O((k+1)^(2d+1)) operations per cell. The blocks are stored row-wise.
+       */
+      void blockDiagonal (std::vector<Dune::DynamicMatrix<RF> >& blocks) const
+      {
+        const std::size_t n = blockSize();
+        blocks.assign(cells(),Dune::DynamicMatrix<RF>(n,n,0.0));
+        std::vector<RF> unit(n,0.0), zero(n,0.0), column(n), dummy(n);
+        auto store = [&](std::size_t cell, std::size_t j)
+          {
+            for (std::size_t i=0; i<n; i++)
+              blocks[cell][i][j] += column[i];
+          };
+        for (std::size_t j=0; j<n; j++)
+          {
+            unit[j] = 1.0;
+            for (std::size_t c=0; c<cells(); c++)
+              {
+                std::fill(column.begin(),column.end(),0.0);
+                applyCell(_cells[c],unit.data(),column.data(),1.0);
+                store(c,j);
+              }
+            for (const auto& face : _faces)
+              {
+                std::fill(column.begin(),column.end(),0.0);
+                applyFace(face,unit.data(),zero.data(),column.data(),dummy.data(),1.0);
+                store(face.inside,j);
+                std::fill(column.begin(),column.end(),0.0);
+                applyFace(face,zero.data(),unit.data(),dummy.data(),column.data(),1.0);
+                store(face.outside,j);
+              }
+            for (const auto& face : _boundary_faces)
+              {
+                std::fill(column.begin(),column.end(),0.0);
+                applyBoundaryFace(face,unit.data(),column.data(),1.0);
+                store(face.inside,j);
+              }
+            unit[j] = 0.0;
+          }
+      }
+
+    private:
+
+      struct CellData
+      {
+        std::ptrdiff_t offset;
+        Dune::FieldMatrix<RF,dim,dim> diffusion;
+        Dune::FieldVector<RF,dim> convection;
+        RF reaction;
+      };
+
+      struct FaceData
+      {
+        std::size_t inside, outside;
+        int face_s, face_n;
+        RF factor;
+        RF penalty;
+        RF omega_s, omega_n;
+        // A n transformed to the reference cells, for normal derivatives of reference gradients
+        Dune::FieldVector<RF,dim> a_s, a_n;
+        // upwind normal flux from either side
+        RF flux_s, flux_n;
+      };
+
+      struct BoundaryFaceData
+      {
+        std::size_t inside;
+        int face;
+        RF factor;
+        RF penalty;
+        Dune::FieldVector<RF,dim> a_s;
+        RF flux;
+        bool dirichlet;
+      };
+
+      template<typename Geometry>
+      static Dune::FieldMatrix<RF,dim,dim> jacobianInverseTransposed (const Geometry& geo)
+      {
+        const auto center = referenceElement(geo).position(0,0);
+        const auto jac = geo.jacobianInverseTransposed(center);
+        Dune::FieldMatrix<RF,dim,dim> J;
+        for (int j=0; j<dim; j++)
+          {
+            Dune::FieldVector<RF,dim> unit(0.0), column;
+            unit[j] = 1.0;
+            jac.mv(unit,column);
+            for (int i=0; i<dim; i++)
+              J[i][j] = column[i];
+          }
+        return J;
+      }
+
+      // throws unless A, b and c take their values at the cell center at all quadrature points
+      template<typename Cell, typename PermTensor, typename Vector>
+      void checkConstantCoefficients (T& param, const Cell& cell, const PermTensor& A, const Vector& b, RF c) const
+      {
+        const RF tolerance = 1e-10;
+        for (std::size_t q=0; q<_kernel.points(); q++)
+          {
+            auto position = _kernel.position(q);
+            auto A_q = param.A(cell,position);
+            A_q -= A;
+            auto b_q = param.b(cell,position);
+            b_q -= b;
+            if (A_q.infinity_norm() > tolerance*std::max(A.infinity_norm(),RF(1.0)) ||
+                b_q.infinity_norm() > tolerance*std::max(b.infinity_norm(),RF(1.0)) ||
+                std::abs(param.c(cell,position)-c) > tolerance*std::max(std::abs(c),RF(1.0)))
+              DUNE_THROW(Dune::NotImplemented,"SumFactorizedConvectionDiffusionDGOperator requires coefficients A, b and c that are constant per cell");
+          }
+      }
+
+      void setup (const GFS& gfs, T& param, ConvectionDiffusionDGWeights::Type weights, RF alpha)
+      {
+        const auto& gv = gfs.gridView();
+        const auto& indexset = gv.indexSet();
+        const int degree = Polynomials::degree;
+
+        // offsets of the cell coefficients in the vector
+        LFS lfs(gfs);
+        LFSCache lfs_cache(lfs);
+        X probe(gfs,0.0);
+        _cells.resize(gv.size(0));
+        bool first = true;
+        for (const auto& cell : elements(gv))
+          {
+            if (!cell.geometry().affine() || !cell.type().isCube())
+              DUNE_THROW(Dune::NotImplemented,"SumFactorizedConvectionDiffusionDGOperator requires affine cubes");
+            lfs.bind(cell);
+            lfs_cache.update();
+            if (lfs.size()!=_kernel.size())
+              DUNE_THROW(Dune::InvalidStateException,"local function space does not match the tensor product basis");
+            if (first)
+              {
+                _first = lfs_cache.containerIndex(0);
+                first = false;
+              }
+            const RF* data = &probe[lfs_cache.containerIndex(0)];
+            for (std::size_t i=1; i<lfs.size(); i++)
+              if (&probe[lfs_cache.containerIndex(i)]!=data+i)
+                DUNE_THROW(Dune::NotImplemented,"SumFactorizedConvectionDiffusionDGOperator requires contiguous cell blocks");
+
+            auto geo = cell.geometry();
+            auto center = referenceElement(geo).position(0,0);
+            auto J = jacobianInverseTransposed(geo);
+            auto detJ = geo.integrationElement(center);
+            auto A = param.A(cell,center);
+            auto b = param.b(cell,center);
+            auto c = param.c(cell,center);
+            checkConstantCoefficients(param,cell,A,b,c);
+
+            auto& data_c = _cells[indexset.index(cell)];
+            data_c.offset = data - &probe[_first];
+            // detJ J^T A J and detJ J^T b act on reference gradients
+            Dune::FieldMatrix<RF,dim,dim> AJ;
+            for (int i=0; i<dim; i++)
+              for (int j=0; j<dim; j++)
+                {
+                  AJ[i][j] = 0.0;
+                  for (int l=0; l<dim; l++)
+                    AJ[i][j] += A[i][l]*J[l][j];
+                }
+            for (int i=0; i<dim; i++)
+              for (int j=0; j<dim; j++)
+                {
+                  data_c.diffusion[i][j] = 0.0;
+                  for (int l=0; l<dim; l++)
+                    data_c.diffusion[i][j] += J[l][i]*AJ[l][j];
+                  data_c.diffusion[i][j] *= detJ;
+                }
+            J.mtv(b,data_c.convection);
+            data_c.convection *= detJ;
+            data_c.reaction = c*detJ;
+          }
+
+        // face data
+        for (const auto& cell : elements(gv))
+          {
+            auto geo_inside = cell.geometry();
+            auto J_s = jacobianInverseTransposed(geo_inside);
+            auto A_s = param.A(cell,referenceElement(geo_inside).position(0,0));
+            for (const auto& is : intersections(gv,cell))
+              {
+                auto geo = is.geometry();
+                auto n_F = is.centerUnitOuterNormal();
+                Dune::FieldVector<RF,dim> An_F_s;
+                A_s.mv(n_F,An_F_s);
+                auto b = param.b(cell,is.geometryInInside().center());
+                RF normalflux = b*n_F;
+
+                if (is.neighbor())
+                  {
+                    if (!is.conforming())
+                      DUNE_THROW(Dune::NotImplemented,"SumFactorizedConvectionDiffusionDGOperator requires conforming grids");
+                    const auto& outside = is.outside();
+                    if (indexset.index(cell) > indexset.index(outside))
+                      continue;
+                    auto geo_outside = outside.geometry();
+
+                    FaceData face;
+                    face.inside = indexset.index(cell);
+                    face.outside = indexset.index(outside);
+                    face.face_s = is.indexInInside();
+                    face.face_n = is.indexInOutside();
+                    for (std::size_t q=0; q<_kernel.facePoints(); q++)
+                      {
+                        auto distance = geo_inside.global(_kernel.facePosition(face.face_s,q));
+                        distance -= geo_outside.global(_kernel.facePosition(face.face_n,q));
+                        if (distance.two_norm() > 1e-8*std::pow(geo.volume(),1.0/std::max(dim-1,1)))
+                          DUNE_THROW(Dune::NotImplemented,"SumFactorizedConvectionDiffusionDGOperator requires matching face orientations");
+                      }
+
+                    auto A_n = param.A(outside,referenceElement(geo_outside).position(0,0));
+                    Dune::FieldVector<RF,dim> An_F_n;
+                    A_n.mv(n_F,An_F_n);
+                    RF harmonic_average;
+                    if (weights==ConvectionDiffusionDGWeights::weightsOn)
+                      {
+                        RF delta_s = (An_F_s*n_F);
+                        RF delta_n = (An_F_n*n_F);
+                        face.omega_s = delta_n/(delta_s+delta_n+1e-20);
+                        face.omega_n = delta_s/(delta_s+delta_n+1e-20);
+                        harmonic_average = 2.0*delta_s*delta_n/(delta_s+delta_n+1e-20);
+                      }
+                    else
+                      {
+                        face.omega_s = face.omega_n = 0.5;
+                        harmonic_average = 1.0;
+                      }
+                    auto h_F = std::min(geo_inside.volume(),geo_outside.volume())/geo.volume();
+                    face.penalty = (alpha/h_F) * harmonic_average * degree*(degree+dim-1);
+                    face.factor = geo.volume();
+                    J_s.mtv(An_F_s,face.a_s);
+                    jacobianInverseTransposed(geo_outside).mtv(An_F_n,face.a_n);
+                    face.flux_s = normalflux>=0.0 ? normalflux : 0.0;
+                    face.flux_n = normalflux>=0.0 ? 0.0 : normalflux;
+                    _faces.push_back(face);
+                  }
+                else if (is.boundary())
+                  {
+                    auto bctype = param.bctype(is,referenceElement(geo).position(0,0));
+                    for (std::size_t q=0; q<_kernel.facePoints(); q++)
+                      if (param.bctype(is,is.geometryInInside().local(_kernel.facePosition(is.indexInInside(),q)))!=bctype)
+                        DUNE_THROW(Dune::NotImplemented,"SumFactorizedConvectionDiffusionDGOperator requires boundary condition types that are constant per face");
+                    if (bctype==ConvectionDiffusionBoundaryConditions::None ||
+                        bctype==ConvectionDiffusionBoundaryConditions::Neumann)
+                      continue;
+
+                    BoundaryFaceData face;
+                    face.inside = indexset.index(cell);
+                    face.face = is.indexInInside();
+                    face.factor = geo.volume();
+                    face.dirichlet = bctype==ConvectionDiffusionBoundaryConditions::Dirichlet;
+                    RF harmonic_average = weights==ConvectionDiffusionDGWeights::weightsOn ? An_F_s*n_F : 1.0;
+                    auto h_F = geo_inside.volume()/geo.volume();
+                    face.penalty = (alpha/h_F) * harmonic_average * degree*(degree+dim-1);
+                    J_s.mtv(An_F_s,face.a_s);
+                    // Dirichlet faces take the upwind value from the inside, outflow faces always
+                    face.flux = face.dirichlet ? std::max(normalflux,RF(0.0)) : normalflux;
+                    _boundary_faces.push_back(face);
+                  }
+              }
+          }
+      }
+
+      // y += alpha A x
+      void accumulate (RF alpha, const X& x, X& y) const
+      {
+        const RF* x_data = &x[_first];
+        RF* y_data = &y[_first];
+        for (const auto& cell : _cells)
+          applyCell(cell,x_data+cell.offset,y_data+cell.offset,alpha);
+        for (const auto& face : _faces)
+          applyFace(face,
+                    x_data+_cells[face.inside].offset,x_data+_cells[face.outside].offset,
+                    y_data+_cells[face.inside].offset,y_data+_cells[face.outside].offset,alpha);
+        for (const auto& face : _boundary_faces)
+          applyBoundaryFace(face,x_data+_cells[face.inside].offset,y_data+_cells[face.inside].offset,alpha);
+      }
+
+      // (A grad u - b u) * grad v + c u v
+      void applyCell (const CellData& cell, const RF* x, RF* y, RF alpha) const
+      {
+        const std::size_t points = _kernel.points();
+        _u.resize(points);
+        _gradu.resize(dim*points);
+        _kernel.evaluate(x,_u.data());
+        _kernel.evaluateGradient(x,_gradu.data());
+        for (std::size_t q=0; q<points; q++)
+          {
+            const RF factor = alpha*_kernel.weight(q);
+            Dune::FieldVector<RF,dim> gradu, flux;
+            for (int j=0; j<dim; j++)
+              gradu[j] = _gradu[j*points+q];
+            cell.diffusion.mv(gradu,flux);
+            flux.axpy(-_u[q],cell.convection);
+            for (int j=0; j<dim; j++)
+              _gradu[j*points+q] = flux[j]*factor;
+            _u[q] *= cell.reaction*factor;
+          }
+        _kernel.integrate(_u.data(),y);
+        _kernel.integrateGradient(_gradu.data(),y);
+      }
+
+      // upwind convection, weighted average of the diffusive flux, (non-)symmetric term and penalty
+      void applyFace (const FaceData& face, const RF* x_s, const RF* x_n, RF* y_s, RF* y_n, RF alpha) const
+      {
+        const std::size_t points = _kernel.facePoints();
+        _u.resize(points);
+        _gradu.resize(dim*points);
+        _u_n.resize(points);
+        _gradu_n.resize(dim*points);
+        _kernel.evaluateFace(face.face_s,x_s,_u.data());
+        _kernel.evaluateFaceGradient(face.face_s,x_s,_gradu.data());
+        _kernel.evaluateFace(face.face_n,x_n,_u_n.data());
+        _kernel.evaluateFaceGradient(face.face_n,x_n,_gradu_n.data());
+        for (std::size_t q=0; q<points; q++)
+          {
+            const RF factor = alpha*_kernel.faceWeight(q)*face.factor;
+            const RF u_s = _u[q];
+            const RF u_n = _u_n[q];
+            RF flux_s = 0.0, flux_n = 0.0;
+            for (int j=0; j<dim; j++)
+              {
+                flux_s += face.a_s[j]*_gradu[j*points+q];
+                flux_n += face.a_n[j]*_gradu_n[j*points+q];
+              }
+            const RF jump = u_s-u_n;
+            const RF value = (face.flux_s*u_s + face.flux_n*u_n
+                              - (face.omega_s*flux_s + face.omega_n*flux_n)
+                              + face.penalty*jump) * factor;
+            _u[q] = value;
+            _u_n[q] = -value;
+            for (int j=0; j<dim; j++)
+              {
+                _gradu[j*points+q] = _theta*face.omega_s*jump*factor*face.a_s[j];
+                _gradu_n[j*points+q] = _theta*face.omega_n*jump*factor*face.a_n[j];
+              }
+          }
+        _kernel.integrateFace(face.face_s,_u.data(),y_s);
+        _kernel.integrateFaceGradient(face.face_s,_gradu.data(),y_s);
+        _kernel.integrateFace(face.face_n,_u_n.data(),y_n);
+        _kernel.integrateFaceGradient(face.face_n,_gradu_n.data(),y_n);
+      }
+
+      // outflow and Dirichlet faces with homogeneous boundary values
+      void applyBoundaryFace (const BoundaryFaceData& face, const RF* x, RF* y, RF alpha) const
+      {
+        const std::size_t points = _kernel.facePoints();
+        _u.resize(points);
+        _gradu.resize(dim*points);
+        _kernel.evaluateFace(face.face,x,_u.data());
+        if (face.dirichlet)
+          _kernel.evaluateFaceGradient(face.face,x,_gradu.data());
+        for (std::size_t q=0; q<points; q++)
+          {
+            const RF factor = alpha*_kernel.faceWeight(q)*face.factor;
+            const RF u = _u[q];
+            RF value = face.flux*u;
+            if (face.dirichlet)
+              {
+                RF flux = 0.0;
+                for (int j=0; j<dim; j++)
+                  flux += face.a_s[j]*_gradu[j*points+q];
+                value += face.penalty*u - flux;
+                for (int j=0; j<dim; j++)
+                  _gradu[j*points+q] = _theta*u*factor*face.a_s[j];
+              }
+            _u[q] = value*factor;
+          }
+        _kernel.integrateFace(face.face,_u.data(),y);
+        if (face.dirichlet)
+          _kernel.integrateFaceGradient(face.face,_gradu.data(),y);
+      }
+
+      Kernel _kernel;
+      RF _theta;
+      ContainerIndex _first;
+      std::vector<CellData> _cells;
+      std::vector<FaceData> _faces;
+      std::vector<BoundaryFaceData> _boundary_faces;
+      // scratch arrays for the values at the quadrature points
+      mutable std::vector<RF> _u, _gradu, _u_n, _gradu_n;
+    };
+
+    /** \brief Point Jacobi preconditioner for SumFactorizedConvectionDiffusionDGOperator
+     *
+     * The diagonal is extracted from the diagonal blocks of the operator once in the
+     * constructor.
+     */
+    template<typename Operator>
+    class SumFactorizedDGJacobi
+      : public Dune::Preconditioner<typename Operator::domain_type,typename Operator::range_type>
+    {
+      using X = typename Operator::domain_type;
+      using RF = typename Operator::field_type;
+
+    public:
+      typedef X domain_type;
+      typedef X range_type;
+      typedef RF field_type;
+
+      SumFactorizedDGJacobi (const Operator& op, RF relaxation=1.0)
+        : _op(op)
+        , _relaxation(relaxation)
+      {
+        std::vector<Dune::DynamicMatrix<RF> > blocks;
+        op.blockDiagonal(blocks);
+        const std::size_t n = op.blockSize();
+        _inverse_diagonal.resize(op.cells()*n);
+        for (std::size_t c=0; c<op.cells(); c++)
+          for (std::size_t i=0; i<n; i++)
+            _inverse_diagonal[c*n+i] = 1.0/blocks[c][i][i];
+      }
+
+      void pre (X& x, X& b) override {}
+
+      void apply (X& v, const X& d) override
+      {
+        const std::size_t n = _op.blockSize();
+        for (std::size_t c=0; c<_op.cells(); c++)
+          {
+            RF* v_c = _op.cellData(v,c);
+            const RF* d_c = _op.cellData(d,c);
+            for (std::size_t i=0; i<n; i++)
+              v_c[i] = _relaxation*_inverse_diagonal[c*n+i]*d_c[i];
+          }
+      }
+
+      void post (X& x) override {}
+
+      SolverCategory::Category category() const override
+      {
+        return SolverCategory::sequential;
+      }
+
+    private:
+      const Operator& _op;
+      RF _relaxation;
+      std::vector<RF> _inverse_diagonal;
+    };
+
+    /** \brief Block Jacobi preconditioner for SumFactorizedConvectionDiffusionDGOperator
+     *
+     * The diagonal blocks of the operator are computed and inverted once in the constructor,
+     * which stores (k+1)^(2d) entries per cell.
+     */
+    template<typename Operator>
+    class SumFactorizedDGBlockJacobi
+      : public Dune::Preconditioner<typename Operator::domain_type,typename Operator::range_type>
+    {
+      using X = typename Operator::domain_type;
+      using RF = typename Operator::field_type;
+
+    public:
+      typedef X domain_type;
+      typedef X range_type;
+      typedef RF field_type;
+
+      SumFactorizedDGBlockJacobi (const Operator& op, RF relaxation=1.0)
+        : _op(op)
+        , _relaxation(relaxation)
+      {
+        op.blockDiagonal(_inverse_blocks);
+        for (auto& block : _inverse_blocks)
+          block.invert();
+      }
+
+      void pre (X& x, X& b) override {}
+
+      void apply (X& v, const X& d) override
+      {
+        const std::size_t n = _op.blockSize();
+        for (std::size_t c=0; c<_op.cells(); c++)
+          {
+            RF* v_c = _op.cellData(v,c);
+            const RF* d_c = _op.cellData(d,c);
+            const auto& block = _inverse_blocks[c];
+            for (std::size_t i=0; i<n; i++)
+              {
+                RF sum = 0.0;
+                for (std::size_t j=0; j<n; j++)
+                  sum += block[i][j]*d_c[j];
+                v_c[i] = _relaxation*sum;
+              }
+          }
+      }
+
+      void post (X& x) override {}
+
+      SolverCategory::Category category() const override
+      {
+        return SolverCategory::sequential;
+      }
+
+    private:
+      const Operator& _op;
+      RF _relaxation;
+      std::vector<Dune::DynamicMatrix<RF> > _inverse_blocks;
+    };
+
+    /** \brief Sequential Krylov solver with SumFactorizedConvectionDiffusionDGOperator and block Jacobi preconditioning
+     *
+     * Solves A z = r without assembling a matrix, like ISTLBackend_SEQ_MatrixFree_BCGS_Richardson
+     * does for general grid operators. The block Jacobi preconditioner is set up once in the
+     * constructor.
+     *
+     * \tparam Operator A SumFactorizedConvectionDiffusionDGOperator
+     * \tparam Solver   The ISTL solver, e.g. Dune::CGSolver for the symmetric SIPG method
+     *                  without convection, or Dune::BiCGSTABSolver.
+     */
+    template<class Operator, template<class> class Solver>
+    class ISTLBackend_SEQ_MatrixFree_SumFactorizedDG
+      : public SequentialNorm, public LinearResultStorage
+    {
+      using V = typename Operator::domain_type;
+
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] op the operator, which has to outlive the solver
+        \param[in] maxiter maximum number of iterations to do
+        \param[in] verbose print messages if true
+      */
+      explicit ISTLBackend_SEQ_MatrixFree_SumFactorizedDG (Operator& op, unsigned maxiter=5000, int verbose=1)
+        : _op(op)
+        , _prec(op)
+        , _maxiter(maxiter)
+        , _verbose(verbose)
+      {}
+
+      /*! \brief solve the given linear system
+
+        \param[out] z the solution vector to be computed
+        \param[in] r right hand side
+        \param[in] reduction to be achieved
+      */
+      void apply (V& z, V& r, typename Dune::template FieldTraits<typename V::ElementType>::real_type reduction)
+      {
+        Solver<V> solver(_op, _prec, reduction, _maxiter, _verbose);
+        Dune::InverseOperatorResult stat;
+        solver.apply(z, r, stat);
+        res.converged  = stat.converged;
+        res.iterations = stat.iterations;
+        res.elapsed    = stat.elapsed;
+        res.reduction  = stat.reduction;
+        res.conv_rate  = stat.conv_rate;
+      }
+
+    private:
+      Operator& _op;
+      SumFactorizedDGBlockJacobi<Operator> _prec;
+      unsigned _maxiter;
+      int _verbose;
+    };
+
+    //! Matrix-free sum-factorized DG solver with CG and block Jacobi preconditioning
+    template<class Operator>
+    class ISTLBackend_SEQ_MatrixFree_SumFactorizedDG_CG
+      : public ISTLBackend_SEQ_MatrixFree_SumFactorizedDG<Operator, Dune::CGSolver>
+    {
+    public:
+      explicit ISTLBackend_SEQ_MatrixFree_SumFactorizedDG_CG (Operator& op, unsigned maxiter=5000, int verbose=1)
+        : ISTLBackend_SEQ_MatrixFree_SumFactorizedDG<Operator, Dune::CGSolver>(op, maxiter, verbose)
+      {}
+    };
+
+    //! Matrix-free sum-factorized DG solver with BiCGSTAB and block Jacobi preconditioning
+    template<class Operator>
+    class ISTLBackend_SEQ_MatrixFree_SumFactorizedDG_BCGS
+      : public ISTLBackend_SEQ_MatrixFree_SumFactorizedDG<Operator, Dune::BiCGSTABSolver>
+    {
+    public:
+      explicit ISTLBackend_SEQ_MatrixFree_SumFactorizedDG_BCGS (Operator& op, unsigned maxiter=5000, int verbose=1)
+        : ISTLBackend_SEQ_MatrixFree_SumFactorizedDG<Operator, Dune::BiCGSTABSolver>(op, maxiter, verbose)
+      {}
+    };
+
+    //! \} group Backend
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_BACKEND_ISTL_SUMFACTORIZEDDG_HH
@@ -0,0 +1,385 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_BACKEND_ISTL_UPPERTRIANGULARMATRIX_HH
+#define DUNE_PDELAB_BACKEND_ISTL_UPPERTRIANGULARMATRIX_HH
+
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/istl/solvers.hh>
+
+#include <dune/pdelab/backend/solver.hh>
+#include <dune/pdelab/backend/istl/bcrsmatrix.hh>
+#include <dune/pdelab/backend/istl/vector.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup Backend
+    //! \ingroup PDELab
+    //! \{
+
+    /** \brief Operators, preconditioners and solvers for symmetric matrices storing only their upper triangle
+     *
+     * Matrices assembled with ISTL::MatrixStorage::upperTriangular only contain the
+     * diagonal and the upper triangle of a symmetric matrix, the entry \f$a_{ji}\f$ for
+     * \f$j>i\f$ is given implicitly by the transpose of the stored block \f$a_{ij}\f$. The
+     * classes in this file operate on such matrices with a single pass over the stored
+     * entries, which reads half the memory of the corresponding full matrix.
+     */
+
+#ifndef DOXYGEN
+
+    namespace impl {
+
+      // y += alpha A x for the symmetric matrix A given by its upper triangle
+      template<class M, class X, class Y, class F>
+      void upper_triangular_usmv(const M& A, F alpha, const X& x, Y& y)
+      {
+        for (auto row = A.begin(); row != A.end(); ++row)
+          {
+            const auto i = row.index();
+            for (auto col = row->begin(); col != row->end(); ++col)
+              {
+                const auto j = col.index();
+                col->usmv(alpha,x[j],y[i]);
+                if (j != i)
+                  col->usmtv(alpha,x[i],y[j]);
+              }
+          }
+      }
+
+      // inverts the diagonal blocks of a matrix
+      template<class M>
+      std::vector<typename M::block_type> inverse_diagonal_blocks(const M& A)
+      {
+        std::vector<typename M::block_type> inverse_diagonal(A.N());
+        for (auto row = A.begin(); row != A.end(); ++row)
+          {
+            const auto diagonal = row->find(row.index());
+            if (diagonal == row->end())
+              DUNE_THROW(ISTLError,"diagonal block " << row.index() << " is not part of the matrix pattern");
+            inverse_diagonal[row.index()] = *diagonal;
+            inverse_diagonal[row.index()].invert();
+          }
+        return inverse_diagonal;
+      }
+
+    } // namespace impl
+
+#endif // DOXYGEN
+
+    /** \brief Linear operator of a symmetric BCRS matrix that stores only its upper triangle
+     *
+     * Each stored off-diagonal block contributes to two rows of the product, so the
+     * product is computed with a single pass over the matrix.
+     *
+     * \tparam M The ISTL matrix type
+     * \tparam X The domain vector type
+     * \tparam Y The range vector type
+     */
+    template<class M, class X, class Y>
+    class UpperTriangularMatrixAdapter
+      : public Dune::LinearOperator<X,Y>
+    {
+    public:
+      typedef M matrix_type;
+      typedef X domain_type;
+      typedef Y range_type;
+      typedef typename X::field_type field_type;
+
+      explicit UpperTriangularMatrixAdapter (const M& A)
+        : _A(A)
+      {}
+
+      //! y = A x
+      void apply (const X& x, Y& y) const override
+      {
+        y = 0.0;
+        impl::upper_triangular_usmv(_A,field_type(1.0),x,y);
+      }
+
+      //! y += alpha A x
+      void applyscaleadd (field_type alpha, const X& x, Y& y) const override
+      {
+        impl::upper_triangular_usmv(_A,alpha,x,y);
+      }
+
+      //! Returns the stored upper triangle of the matrix
+      const M& getmat () const
+      {
+        return _A;
+      }
+
+      SolverCategory::Category category() const override
+      {
+        return SolverCategory::sequential;
+      }
+
+    private:
+      const M& _A;
+    };
+
+    /** \brief Symmetric block SOR preconditioner for a BCRS matrix that stores only its upper triangle
+     *
+     * Computes the same iterates as Dune::SeqSSOR applied to the full matrix. The lower
+     * triangle required by the forward sweep and the old iterate required by the backward
+     * sweep are accessed through the transposed blocks of the upper triangle, which are
+     * accumulated into a defect vector. The diagonal blocks are inverted once in the
+     * constructor.
+     *
+     * \tparam M The ISTL matrix type
+     * \tparam X The domain vector type
+     * \tparam Y The range vector type
+     */
+    template<class M, class X, class Y>
+    class SeqUpperTriangularSSOR
+      : public Dune::Preconditioner<X,Y>
+    {
+    public:
+      typedef M matrix_type;
+      typedef X domain_type;
+      typedef Y range_type;
+      typedef typename X::field_type field_type;
+
+      /*! \brief Constructor
+
+        \param A the upper triangle of the matrix, which has to outlive the preconditioner
+        \param n the number of iterations to perform
+        \param w the relaxation factor
+      */
+      SeqUpperTriangularSSOR (const M& A, int n, field_type w)
+        : _A(A)
+        , _n(n)
+        , _w(w)
+        , _inverse_diagonal(impl::inverse_diagonal_blocks(A))
+      {}
+
+      void pre (X& x, Y& b) override {}
+
+      void apply (X& v, const Y& d) override
+      {
+        Y s(d);
+        for (int k = 0; k < _n; ++k)
+          {
+            forwardSweep(v,d,s);
+            backwardSweep(v,d,s);
+          }
+      }
+
+      void post (X& x) override {}
+
+      SolverCategory::Category category() const override
+      {
+        return SolverCategory::sequential;
+      }
+
+    private:
+
+      void forwardSweep (X& v, const Y& d, Y& s) const
+      {
+        // s_i = d_i - sum_{j>=i} a_ij v_j with the current iterate
+        s = d;
+        for (auto row = _A.begin(); row != _A.end(); ++row)
+          for (auto col = row->begin(); col != row->end(); ++col)
+            col->mmv(v[col.index()],s[row.index()]);
+
+        typename X::block_type correction;
+        for (auto row = _A.begin(); row != _A.end(); ++row)
+          {
+            const auto i = row.index();
+            _inverse_diagonal[i].mv(s[i],correction);
+            v[i].axpy(_w,correction);
+            // the updated v_i enters the rows j > i through a_ji = a_ij^T
+            for (auto col = row->begin(); col != row->end(); ++col)
+              if (col.index() > i)
+                col->mmtv(v[i],s[col.index()]);
+          }
+      }
+
+      void backwardSweep (X& v, const Y& d, Y& s) const
+      {
+        // s_i = d_i - sum_{j<i} a_ij v_j with the iterate of the forward sweep
+        s = d;
+        for (auto row = _A.begin(); row != _A.end(); ++row)
+          for (auto col = row->begin(); col != row->end(); ++col)
+            if (col.index() > row.index())
+              col->mmtv(v[row.index()],s[col.index()]);
+
+        typename X::block_type correction;
+        for (auto i = _A.N(); i-- > 0;)
+          {
+            const auto& row = _A[i];
+            for (auto col = row.begin(); col != row.end(); ++col)
+              col->mmv(v[col.index()],s[i]);
+            _inverse_diagonal[i].mv(s[i],correction);
+            v[i].axpy(_w,correction);
+          }
+      }
+
+      const M& _A;
+      int _n;
+      field_type _w;
+      std::vector<typename M::block_type> _inverse_diagonal;
+    };
+
+    /** \brief Block Jacobi preconditioner for a BCRS matrix that stores only its upper triangle
+     *
+     * \tparam M The ISTL matrix type
+     * \tparam X The domain vector type
+     * \tparam Y The range vector type
+     */
+    template<class M, class X, class Y>
+    class SeqUpperTriangularJac
+      : public Dune::Preconditioner<X,Y>
+    {
+    public:
+      typedef M matrix_type;
+      typedef X domain_type;
+      typedef Y range_type;
+      typedef typename X::field_type field_type;
+
+      /*! \brief Constructor
+
+        \param A the upper triangle of the matrix, which has to outlive the preconditioner
+        \param n the number of iterations to perform
+        \param w the relaxation factor
+      */
+      SeqUpperTriangularJac (const M& A, int n, field_type w)
+        : _A(A)
+        , _n(n)
+        , _w(w)
+        , _inverse_diagonal(impl::inverse_diagonal_blocks(A))
+      {}
+
+      void pre (X& x, Y& b) override {}
+
+      void apply (X& v, const Y& d) override
+      {
+        Y s(d);
+        typename X::block_type correction;
+        for (int k = 0; k < _n; ++k)
+          {
+            s = d;
+            impl::upper_triangular_usmv(_A,field_type(-1.0),v,s);
+            for (std::size_t i = 0; i < _inverse_diagonal.size(); ++i)
+              {
+                _inverse_diagonal[i].mv(s[i],correction);
+                v[i].axpy(_w,correction);
+              }
+          }
+      }
+
+      void post (X& x) override {}
+
+      SolverCategory::Category category() const override
+      {
+        return SolverCategory::sequential;
+      }
+
+    private:
+      const M& _A;
+      int _n;
+      field_type _w;
+      std::vector<typename M::block_type> _inverse_diagonal;
+    };
+
+    //! Sequential solver backend for matrices assembled with ISTL::MatrixStorage::upperTriangular
+    template<template<class,class,class> class Preconditioner,
+             template<class> class Solver>
+    class ISTLBackend_SEQ_UpperTriangular_Base
+      : public SequentialNorm, public LinearResultStorage
+    {
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] maxiter_ maximum number of iterations to do
+        \param[in] verbose_ print messages if true
+        \param[in] preconditioner_steps_ number of preconditioner iterations per application
+      */
+      explicit ISTLBackend_SEQ_UpperTriangular_Base(unsigned maxiter_=5000, int verbose_=1, unsigned preconditioner_steps_=1)
+        : maxiter(maxiter_), verbose(verbose_), preconditioner_steps(preconditioner_steps_)
+      {}
+
+      /*! \brief solve the given linear system
+
+        \param[in] A the given matrix, which must only store its upper triangle
+        \param[out] z the solution vector to be computed
+        \param[in] r right hand side
+        \param[in] reduction to be achieved
+      */
+      template<class M, class V, class W>
+      void apply(M& A, V& z, W& r, typename Dune::template FieldTraits<typename W::ElementType >::real_type reduction)
+      {
+        using Backend::Native;
+        using Backend::native;
+
+        if (!A.upperTriangularStorage())
+          DUNE_THROW(InvalidStateException,"the matrix does not use upper triangular storage");
+
+        UpperTriangularMatrixAdapter<Native<M>,
+                                     Native<V>,
+                                     Native<W>> opa(native(A));
+        Preconditioner<Native<M>,
+                       Native<V>,
+                       Native<W>> prec(native(A), preconditioner_steps, 1.0);
+        Solver<Native<V>> solver(opa, prec, reduction, maxiter, verbose);
+        Dune::InverseOperatorResult stat;
+        solver.apply(native(z), native(r), stat);
+        res.converged  = stat.converged;
+        res.iterations = stat.iterations;
+        res.elapsed    = stat.elapsed;
+        res.reduction  = stat.reduction;
+        res.conv_rate  = stat.conv_rate;
+      }
+
+    private:
+      unsigned maxiter;
+      int verbose;
+      unsigned preconditioner_steps;
+    };
+
+    /**
+     * @brief Backend for sequential conjugate gradient solver with SSOR preconditioner on upper triangular storage.
+     */
+    class ISTLBackend_SEQ_CG_UpperTriangular_SSOR
+      : public ISTLBackend_SEQ_UpperTriangular_Base<SeqUpperTriangularSSOR, Dune::CGSolver>
+    {
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] maxiter_ maximum number of iterations to do
+        \param[in] verbose_ print messages if true
+      */
+      explicit ISTLBackend_SEQ_CG_UpperTriangular_SSOR (unsigned maxiter_=5000, int verbose_=1, unsigned preconditioner_steps_=1)
+        : ISTLBackend_SEQ_UpperTriangular_Base<SeqUpperTriangularSSOR, Dune::CGSolver>(maxiter_, verbose_, preconditioner_steps_)
+      {}
+    };
+
+    /**
+     * @brief Backend for sequential conjugate gradient solver with Jacobi preconditioner on upper triangular storage.
+     */
+    class ISTLBackend_SEQ_CG_UpperTriangular_Jac
+      : public ISTLBackend_SEQ_UpperTriangular_Base<SeqUpperTriangularJac, Dune::CGSolver>
+    {
+    public:
+      /*! \brief make a linear solver object
+
+        \param[in] maxiter_ maximum number of iterations to do
+        \param[in] verbose_ print messages if true
+      */
+      explicit ISTLBackend_SEQ_CG_UpperTriangular_Jac (unsigned maxiter_=5000, int verbose_=1, unsigned preconditioner_steps_=1)
+        : ISTLBackend_SEQ_UpperTriangular_Base<SeqUpperTriangularJac, Dune::CGSolver>(maxiter_, verbose_, preconditioner_steps_)
+      {}
+    };
+
+    //! \} group Backend
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_BACKEND_ISTL_UPPERTRIANGULARMATRIX_HH
@@ -0,0 +1,66 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_COMMON_ATOMICADD_HH
+#define DUNE_PDELAB_COMMON_ATOMICADD_HH
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup common Common Utilities
+    //! \{
+
+#ifndef DOXYGEN
+    namespace Impl {
+
+      //! Mutexes protecting atomicAdd() for types without native atomic support.
+      inline std::mutex& atomicAddMutex(const void* address)
+      {
+        static std::array<std::mutex,64> mutexes;
+        return mutexes[(reinterpret_cast<std::uintptr_t>(address) / 16) % mutexes.size()];
+      }
+
+    } // namespace Impl
+#endif // DOXYGEN
+
+    //! Atomically adds value to target, which may be concurrently updated by other threads.
+    /**
+     * Arithmetic types are updated with a lock-free compare-and-swap loop, all
+     * other types (e.g. std::complex) fall back to a pool of mutexes.
+     */
+    template<typename T>
+    std::enable_if_t<!std::is_arithmetic<T>::value>
+    atomicAdd(T& target, const T& value)
+    {
+      std::lock_guard<std::mutex> lock(Impl::atomicAddMutex(&target));
+      target += value;
+    }
+
+#ifndef DOXYGEN
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value>
+    atomicAdd(T& target, const T& value)
+    {
+#if defined(__GNUC__)
+      T expected;
+      __atomic_load(&target,&expected,__ATOMIC_RELAXED);
+      T desired = expected + value;
+      while (!__atomic_compare_exchange(&target,&expected,&desired,true,__ATOMIC_RELAXED,__ATOMIC_RELAXED))
+        desired = expected + value;
+#else
+      std::lock_guard<std::mutex> lock(Impl::atomicAddMutex(&target));
+      target += value;
+#endif
+    }
+#endif // DOXYGEN
+
+    //! \} group common
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_COMMON_ATOMICADD_HH
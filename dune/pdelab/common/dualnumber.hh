@@ -0,0 +1,291 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifndef DUNE_PDELAB_COMMON_DUALNUMBER_HH
+#define DUNE_PDELAB_COMMON_DUALNUMBER_HH
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! A number carrying its value and its derivatives with respect to N independent variables.
+    /**
+     * DualNumber implements forward-mode automatic differentiation: every arithmetic operation
+     * and elementary function propagates the derivatives by the chain rule, so that evaluating
+     * a function with dual numbers seeded by seed() yields its exact gradient alongside its
+     * value. The derivatives are stored in a fixed-size array, the cost of each operation is
+     * proportional to N.
+     *
+     * The elementary functions are found by argument dependent lookup. Code evaluated with dual
+     * numbers therefore has to call them unqualified, e.g. `using std::exp; exp(u)`, instead of
+     * `std::exp(u)`.
+     *
+     * \tparam T The field type of the value and the derivatives
+     * \tparam N The number of independent variables
+     */
+    template<typename T, std::size_t N>
+    class DualNumber
+    {
+    public:
+
+      typedef T value_type;
+
+      //! The number of derivatives carried by the number.
+      static constexpr std::size_t size = N;
+
+      //! Creates a constant, i.e. a number with vanishing derivatives.
+      DualNumber (const T& value = T(0))
+        : _value(value)
+      {
+        _derivatives.fill(T(0));
+      }
+
+      //! Creates the independent variable with the given index.
+      static DualNumber seed (const T& value, std::size_t index)
+      {
+        DualNumber result(value);
+        result._derivatives[index] = T(1);
+        return result;
+      }
+
+      //! The value of the number.
+      const T& value () const
+      {
+        return _value;
+      }
+
+      //! The derivative with respect to the independent variable with the given index.
+      const T& derivative (std::size_t index) const
+      {
+        return _derivatives[index];
+      }
+
+      //! All derivatives of the number.
+      const std::array<T,N>& derivatives () const
+      {
+        return _derivatives;
+      }
+
+      //! Arithmetic assignment operators
+      //! @{
+      DualNumber& operator+= (const DualNumber& other)
+      {
+        _value += other._value;
+        for (std::size_t i = 0; i < N; ++i)
+          _derivatives[i] += other._derivatives[i];
+        return *this;
+      }
+
+      DualNumber& operator+= (const T& other)
+      {
+        _value += other;
+        return *this;
+      }
+
+      DualNumber& operator-= (const DualNumber& other)
+      {
+        _value -= other._value;
+        for (std::size_t i = 0; i < N; ++i)
+          _derivatives[i] -= other._derivatives[i];
+        return *this;
+      }
+
+      DualNumber& operator-= (const T& other)
+      {
+        _value -= other;
+        return *this;
+      }
+
+      DualNumber& operator*= (const DualNumber& other)
+      {
+        for (std::size_t i = 0; i < N; ++i)
+          _derivatives[i] = _derivatives[i] * other._value + _value * other._derivatives[i];
+        _value *= other._value;
+        return *this;
+      }
+
+      DualNumber& operator*= (const T& other)
+      {
+        _value *= other;
+        for (std::size_t i = 0; i < N; ++i)
+          _derivatives[i] *= other;
+        return *this;
+      }
+
+      DualNumber& operator/= (const DualNumber& other)
+      {
+        const T inverse = T(1) / other._value;
+        _value *= inverse;
+        for (std::size_t i = 0; i < N; ++i)
+          _derivatives[i] = (_derivatives[i] - _value * other._derivatives[i]) * inverse;
+        return *this;
+      }
+
+      DualNumber& operator/= (const T& other)
+      {
+        const T inverse = T(1) / other;
+        _value *= inverse;
+        for (std::size_t i = 0; i < N; ++i)
+          _derivatives[i] *= inverse;
+        return *this;
+      }
+      //! @}
+
+      //! Arithmetic operators
+      //! @{
+      friend DualNumber operator+ (const DualNumber& a)
+      {
+        return a;
+      }
+
+      friend DualNumber operator- (DualNumber a)
+      {
+        a._value = -a._value;
+        for (std::size_t i = 0; i < N; ++i)
+          a._derivatives[i] = -a._derivatives[i];
+        return a;
+      }
+
+      friend DualNumber operator+ (DualNumber a, const DualNumber& b) { return a += b; }
+      friend DualNumber operator+ (DualNumber a, const T& b) { return a += b; }
+      friend DualNumber operator+ (const T& a, DualNumber b) { return b += a; }
+
+      friend DualNumber operator- (DualNumber a, const DualNumber& b) { return a -= b; }
+      friend DualNumber operator- (DualNumber a, const T& b) { return a -= b; }
+      friend DualNumber operator- (const T& a, const DualNumber& b) { return -b + a; }
+
+      friend DualNumber operator* (DualNumber a, const DualNumber& b) { return a *= b; }
+      friend DualNumber operator* (DualNumber a, const T& b) { return a *= b; }
+      friend DualNumber operator* (const T& a, DualNumber b) { return b *= a; }
+
+      friend DualNumber operator/ (DualNumber a, const DualNumber& b) { return a /= b; }
+      friend DualNumber operator/ (DualNumber a, const T& b) { return a /= b; }
+      friend DualNumber operator/ (const T& a, const DualNumber& b) { return DualNumber(a) /= b; }
+      //! @}
+
+      //! Comparison operators, which only compare the values
+      //! @{
+      friend bool operator== (const DualNumber& a, const DualNumber& b) { return a._value == b._value; }
+      friend bool operator== (const DualNumber& a, const T& b) { return a._value == b; }
+      friend bool operator== (const T& a, const DualNumber& b) { return a == b._value; }
+      friend bool operator!= (const DualNumber& a, const DualNumber& b) { return a._value != b._value; }
+      friend bool operator!= (const DualNumber& a, const T& b) { return a._value != b; }
+      friend bool operator!= (const T& a, const DualNumber& b) { return a != b._value; }
+      friend bool operator< (const DualNumber& a, const DualNumber& b) { return a._value < b._value; }
+      friend bool operator< (const DualNumber& a, const T& b) { return a._value < b; }
+      friend bool operator< (const T& a, const DualNumber& b) { return a < b._value; }
+      friend bool operator<= (const DualNumber& a, const DualNumber& b) { return a._value <= b._value; }
+      friend bool operator<= (const DualNumber& a, const T& b) { return a._value <= b; }
+      friend bool operator<= (const T& a, const DualNumber& b) { return a <= b._value; }
+      friend bool operator> (const DualNumber& a, const DualNumber& b) { return a._value > b._value; }
+      friend bool operator> (const DualNumber& a, const T& b) { return a._value > b; }
+      friend bool operator> (const T& a, const DualNumber& b) { return a > b._value; }
+      friend bool operator>= (const DualNumber& a, const DualNumber& b) { return a._value >= b._value; }
+      friend bool operator>= (const DualNumber& a, const T& b) { return a._value >= b; }
+      friend bool operator>= (const T& a, const DualNumber& b) { return a >= b._value; }
+      //! @}
+
+      //! Elementary functions
+      //! @{
+      friend DualNumber abs (const DualNumber& a)
+      {
+        return a._value < T(0) ? -a : a;
+      }
+
+      friend DualNumber sqrt (const DualNumber& a)
+      {
+        using std::sqrt;
+        const T root = sqrt(a._value);
+        return chain(a,root,T(0.5)/root);
+      }
+
+      friend DualNumber exp (const DualNumber& a)
+      {
+        using std::exp;
+        const T e = exp(a._value);
+        return chain(a,e,e);
+      }
+
+      friend DualNumber log (const DualNumber& a)
+      {
+        using std::log;
+        return chain(a,log(a._value),T(1)/a._value);
+      }
+
+      friend DualNumber pow (const DualNumber& a, const T& b)
+      {
+        using std::pow;
+        const T p = pow(a._value,b-T(1));
+        return chain(a,p*a._value,b*p);
+      }
+
+      friend DualNumber pow (const DualNumber& a, const DualNumber& b)
+      {
+        return exp(b*log(a));
+      }
+
+      friend DualNumber sin (const DualNumber& a)
+      {
+        using std::sin; using std::cos;
+        return chain(a,sin(a._value),cos(a._value));
+      }
+
+      friend DualNumber cos (const DualNumber& a)
+      {
+        using std::sin; using std::cos;
+        return chain(a,cos(a._value),-sin(a._value));
+      }
+
+      friend DualNumber tanh (const DualNumber& a)
+      {
+        using std::tanh;
+        const T t = tanh(a._value);
+        return chain(a,t,T(1)-t*t);
+      }
+
+      friend DualNumber atan (const DualNumber& a)
+      {
+        using std::atan;
+        return chain(a,atan(a._value),T(1)/(T(1)+a._value*a._value));
+      }
+
+      friend const DualNumber& max (const DualNumber& a, const DualNumber& b)
+      {
+        return a._value < b._value ? b : a;
+      }
+
+      friend const DualNumber& min (const DualNumber& a, const DualNumber& b)
+      {
+        return b._value < a._value ? b : a;
+      }
+      //! @}
+
+      friend std::ostream& operator<< (std::ostream& s, const DualNumber& a)
+      {
+        s << a._value << " [";
+        for (std::size_t i = 0; i < N; ++i)
+          s << (i > 0 ? " " : "") << a._derivatives[i];
+        return s << "]";
+      }
+
+    private:
+
+      //! Returns f(a) given the value f and the derivative df of f at the value of a.
+      static DualNumber chain (const DualNumber& a, const T& f, const T& df)
+      {
+        DualNumber result(f);
+        for (std::size_t i = 0; i < N; ++i)
+          result._derivatives[i] = df * a._derivatives[i];
+        return result;
+      }
+
+      T _value;
+      std::array<T,N> _derivatives;
+    };
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_COMMON_DUALNUMBER_HH
@@ -259,8 +259,8 @@ namespace Dune {
           \param[in]  x The position in entity-local coordinates
           \param[out] y The result of the evaluation
       */
-      template<typename I>
-      inline void evaluate (const IntersectionGeometry<I>& ig,
+      template<typename I, bool cached>
+      inline void evaluate (const IntersectionGeometry<I,cached>& ig,
                             const typename Traits::DomainType& x,
                             typename Traits::RangeType& y) const
       {
@@ -1119,8 +1119,8 @@ namespace Dune {
           Evaluates all shape functions at the given position and returns
           these values in a vector.
       */
-      template<typename I>
-      inline void evaluate (const IntersectionGeometry<I>& ig,
+      template<typename I, bool cached>
+      inline void evaluate (const IntersectionGeometry<I,cached>& ig,
                             const typename Traits::DomainType& x,
                             typename Traits::RangeType& y) const
       {
@@ -0,0 +1,354 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifndef DUNE_PDELAB_COMMON_GEOMETRYCACHE_HH
+#define DUNE_PDELAB_COMMON_GEOMETRYCACHE_HH
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <dune/geometry/type.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! Cached geometry data of a single element or intersection.
+    /**
+     * For affine geometries, the entry stores the jacobians and the integration element
+     * once. For all other geometries, it stores the inverse transposed jacobian and the
+     * integration element for every local coordinate they are evaluated at, up to
+     * max_points coordinates. As quadrature loops evaluate the geometry at the same points
+     * in the same order in every assembly, the entry first checks the point following the
+     * last one looked up.
+     *
+     * An entry must only be used by a single thread at a time.
+     *
+     * \tparam G The geometry type
+     */
+    template<typename G>
+    class GeometryCacheEntry
+    {
+    public:
+      typedef typename G::ctype ctype;
+      typedef typename G::LocalCoordinate LocalCoordinate;
+      typedef typename G::JacobianTransposed JacobianTransposed;
+      typedef typename G::JacobianInverseTransposed JacobianInverseTransposed;
+
+      //! The maximum number of points cached for a non-affine geometry.
+      static const std::size_t max_points = 64;
+
+      GeometryCacheEntry ()
+        : _initialized(false)
+        , _affine(false)
+        , _next(0)
+      {}
+
+      //! The integration element of geo at local coordinate x.
+      ctype integrationElement (const G& geo, const LocalCoordinate& x)
+      {
+        const Data* data = lookup(geo,x);
+        return data ? data->integration_element : geo.integrationElement(x);
+      }
+
+      //! The transposed jacobian of geo at local coordinate x.
+      JacobianTransposed jacobianTransposed (const G& geo, const LocalCoordinate& x)
+      {
+        initialize(geo,x);
+        return _affine ? JacobianTransposed(_jacobian_transposed) : JacobianTransposed(geo.jacobianTransposed(x));
+      }
+
+      //! The inverse transposed jacobian of geo at local coordinate x.
+      JacobianInverseTransposed jacobianInverseTransposed (const G& geo, const LocalCoordinate& x)
+      {
+        const Data* data = lookup(geo,x);
+        return data ? JacobianInverseTransposed(data->jacobian_inverse_transposed) : JacobianInverseTransposed(geo.jacobianInverseTransposed(x));
+      }
+
+      //! Discards the cached data.
+      void clear ()
+      {
+        _initialized = false;
+        _points.clear();
+        _next = 0;
+      }
+
+    private:
+
+      struct Data
+      {
+        LocalCoordinate x;
+        ctype integration_element;
+        JacobianInverseTransposed jacobian_inverse_transposed;
+      };
+
+      static Data evaluate (const G& geo, const LocalCoordinate& x)
+      {
+        Data data;
+        data.x = x;
+        data.integration_element = geo.integrationElement(x);
+        data.jacobian_inverse_transposed = geo.jacobianInverseTransposed(x);
+        return data;
+      }
+
+      void initialize (const G& geo, const LocalCoordinate& x)
+      {
+        if (_initialized)
+          return;
+        _affine = geo.affine();
+        if (_affine)
+          {
+            _affine_data = evaluate(geo,x);
+            _jacobian_transposed = geo.jacobianTransposed(x);
+          }
+        _initialized = true;
+      }
+
+      //! Returns the cached data for x, or nullptr if it cannot be cached.
+      const Data* lookup (const G& geo, const LocalCoordinate& x)
+      {
+        initialize(geo,x);
+        if (_affine)
+          return &_affine_data;
+
+        if (_next < _points.size() && _points[_next].x == x)
+          return &_points[_next++];
+        for (std::size_t i = 0; i < _points.size(); ++i)
+          if (_points[i].x == x)
+            {
+              _next = i + 1;
+              return &_points[i];
+            }
+
+        if (_points.size() >= max_points)
+          return nullptr;
+        _points.push_back(evaluate(geo,x));
+        _next = _points.size();
+        return &_points.back();
+      }
+
+      bool _initialized;
+      bool _affine;
+      Data _affine_data;
+      JacobianTransposed _jacobian_transposed;
+      std::vector<Data> _points;
+      std::size_t _next;
+    };
+
+
+    //! A geometry that takes the jacobians and integration elements from a GeometryCacheEntry.
+    /**
+     * CachedGeometry provides the interface of a grid geometry and forwards all calls to the
+     * wrapped geometry, except for the jacobians and integration elements, which are taken from
+     * the cache entry if there is one. It converts implicitly to the wrapped geometry.
+     *
+     * \tparam G The geometry type
+     */
+    template<typename G>
+    class CachedGeometry
+    {
+    public:
+      //! The wrapped geometry type.
+      typedef G HostGeometry;
+      typedef GeometryCacheEntry<G> CacheEntry;
+
+      typedef typename G::ctype ctype;
+      typedef typename G::LocalCoordinate LocalCoordinate;
+      typedef typename G::GlobalCoordinate GlobalCoordinate;
+      typedef typename G::JacobianTransposed JacobianTransposed;
+      typedef typename G::JacobianInverseTransposed JacobianInverseTransposed;
+
+      /** \brief Dimension of the domain space of the geometry */
+      enum { mydimension=G::mydimension };
+
+      /** \brief Dimension of the image space of the geometry */
+      enum { coorddimension=G::coorddimension };
+
+      //! Wraps geo, the entry may be nullptr to disable caching.
+      CachedGeometry (const G& geo, CacheEntry* entry)
+        : _geo(geo)
+        , _entry(entry)
+      {}
+
+      GeometryType type () const
+      {
+        return _geo.type();
+      }
+
+      bool affine () const
+      {
+        return _geo.affine();
+      }
+
+      int corners () const
+      {
+        return _geo.corners();
+      }
+
+      GlobalCoordinate corner (int i) const
+      {
+        return _geo.corner(i);
+      }
+
+      GlobalCoordinate center () const
+      {
+        return _geo.center();
+      }
+
+      ctype volume () const
+      {
+        return _geo.volume();
+      }
+
+      GlobalCoordinate global (const LocalCoordinate& x) const
+      {
+        return _geo.global(x);
+      }
+
+      LocalCoordinate local (const GlobalCoordinate& y) const
+      {
+        return _geo.local(y);
+      }
+
+      ctype integrationElement (const LocalCoordinate& x) const
+      {
+        return _entry ? _entry->integrationElement(_geo,x) : _geo.integrationElement(x);
+      }
+
+      JacobianTransposed jacobianTransposed (const LocalCoordinate& x) const
+      {
+        return _entry ? _entry->jacobianTransposed(_geo,x) : JacobianTransposed(_geo.jacobianTransposed(x));
+      }
+
+      JacobianInverseTransposed jacobianInverseTransposed (const LocalCoordinate& x) const
+      {
+        return _entry ? _entry->jacobianInverseTransposed(_geo,x) : JacobianInverseTransposed(_geo.jacobianInverseTransposed(x));
+      }
+
+      //! The wrapped geometry.
+      const G& hostGeometry () const
+      {
+        return _geo;
+      }
+
+      operator const G& () const
+      {
+        return _geo;
+      }
+
+    private:
+      G _geo;
+      CacheEntry* _entry;
+    };
+
+    //! Returns the reference element of the wrapped geometry.
+    template<typename G>
+    auto referenceElement (const CachedGeometry<G>& geo)
+    {
+      return referenceElement(geo.hostGeometry());
+    }
+
+
+    //! Cached geometry data of all cells of an entity set and their intersections.
+    /**
+     * The cache holds a GeometryCacheEntry for every cell and every intersection of a cell,
+     * indexed by the cell index and the index of the intersection within the cell. The
+     * entries are filled lazily, so the entries of a cell and its intersections must only
+     * be used by the thread assembling the cell.
+     *
+     * The cache is never rebuilt implicitly, it has to be invalidated by calling invalidate()
+     * (or GridOperator::update()) whenever the grid changes.
+     *
+     * \tparam EntitySet The entity set of the trial grid function space
+     */
+    template<typename EntitySet>
+    class GeometryCache
+    {
+    public:
+      typedef typename EntitySet::Element Element;
+      typedef typename EntitySet::Intersection Intersection;
+      typedef GeometryCacheEntry<typename Element::Geometry> ElementEntry;
+      typedef GeometryCacheEntry<typename Intersection::Geometry> IntersectionEntry;
+
+      GeometryCache ()
+        : _valid(false)
+        , _size(0)
+      {}
+
+      //! Returns whether the cache has been built and not invalidated since.
+      bool valid () const
+      {
+        return _valid;
+      }
+
+      //! The number of cells of the entity set the cache has been built for.
+      std::size_t size () const
+      {
+        return _size;
+      }
+
+      //! Discards all cached data.
+      void invalidate ()
+      {
+        _valid = false;
+        _size = 0;
+        _elements.clear();
+        _offsets.clear();
+        _intersections.clear();
+      }
+
+      //! Allocates empty entries for all cells of the entity set and their intersections.
+      void update (const EntitySet& entity_set)
+      {
+        invalidate();
+        _entity_set = std::make_unique<EntitySet>(entity_set);
+        _size = entity_set.size(0);
+        _elements.resize(_size);
+        _offsets.assign(_size+1,0);
+
+        for (const auto& element : elements(entity_set))
+          {
+            std::size_t count = 0;
+            for (const auto& intersection : intersections(entity_set,element))
+              {
+                (void) intersection;
+                ++count;
+              }
+            _offsets[index(element)+1] = count;
+          }
+        for (std::size_t i = 0; i < _size; ++i)
+          _offsets[i+1] += _offsets[i];
+        _intersections.resize(_offsets[_size]);
+
+        _valid = true;
+      }
+
+      //! The entry of a cell.
+      ElementEntry& element (const Element& element)
+      {
+        return _elements[index(element)];
+      }
+
+      //! The entry of the intersection with the given index of a cell.
+      IntersectionEntry& intersection (const Element& inside, unsigned int intersection_index)
+      {
+        return _intersections[_offsets[index(inside)] + intersection_index];
+      }
+
+    private:
+
+      std::size_t index (const Element& element) const
+      {
+        return _entity_set->indexSet().index(element);
+      }
+
+      bool _valid;
+      std::size_t _size;
+      std::unique_ptr<EntitySet> _entity_set;
+      std::vector<ElementEntry> _elements;
+      std::vector<std::size_t> _offsets;
+      std::vector<IntersectionEntry> _intersections;
+    };
+
+  }
+}
+
+#endif // DUNE_PDELAB_COMMON_GEOMETRYCACHE_HH
@@ -4,31 +4,69 @@
 
 #include <dune/common/fvector.hh>
 
+#include <dune/pdelab/common/geometrycache.hh>
+
 namespace Dune {
   namespace PDELab {
 
+    namespace Impl {
+
+      // The geometry handed out by the wrappers below, either the host geometry or
+      // a CachedGeometry taking its jacobians from a GeometryCacheEntry.
+      template<typename G, bool cached>
+      struct WrappedGeometry
+      {
+        typedef G Geometry;
+
+        static Geometry wrap (const G& geo, GeometryCacheEntry<G>*)
+        {
+          return geo;
+        }
+      };
+
+      template<typename G>
+      struct WrappedGeometry<G,true>
+      {
+        typedef CachedGeometry<G> Geometry;
+
+        static Geometry wrap (const G& geo, GeometryCacheEntry<G>* entry)
+        {
+          return Geometry(geo,entry);
+        }
+      };
+
+    } // namespace Impl
+
     //! Wrap element
     /**
-     * \todo Please doc me!
+     * If cached is true, the geometry of the element is wrapped in a CachedGeometry, which
+     * takes the jacobians and integration elements from the GeometryCache entry the element
+     * geometry is constructed with. Otherwise, the geometry is the one of the element and
+     * the entry is ignored.
      */
-    template<typename E>
+    template<typename E, bool cached = false>
     class ElementGeometry
     {
+      typedef Impl::WrappedGeometry<typename E::Geometry,cached> Wrapper;
+
     public:
       //! \todo Please doc me!
-      typedef typename E::Geometry Geometry;
+      typedef typename Wrapper::Geometry Geometry;
+      //! The GeometryCache entry of the element.
+      typedef GeometryCacheEntry<typename E::Geometry> CacheEntry;
       //! \todo Please doc me!
       typedef E Entity;
 
       //! \todo Please doc me!
-      ElementGeometry (const E& e_)
+      ElementGeometry (const E& e_, CacheEntry* cache_entry_ = nullptr)
         : e(e_)
+        , cache_entry(cache_entry_)
       {}
 
       //! \todo Please doc me!
       Geometry geometry () const
       {
-        return e.geometry();
+        return Wrapper::wrap(e.geometry(),cache_entry);
       }
 
       //! \todo Please doc me!
@@ -45,22 +83,32 @@ namespace Dune {
 
     private:
       const E& e;
+      CacheEntry* cache_entry;
     };
 
 
     //! Wrap intersection
     /**
-     * \todo Please doc me!
+     * If cached is true, the geometry of the intersection is wrapped in a CachedGeometry,
+     * which takes the jacobians and integration elements from the GeometryCache entry the
+     * intersection geometry is constructed with. Otherwise, the geometry is the one of the
+     * intersection and the entry is ignored.
      */
-    template<typename I>
+    template<typename I, bool cached = false>
     class IntersectionGeometry
     {
+      typedef Impl::WrappedGeometry<typename I::Geometry,cached> Wrapper;
+
+    public:
+      //! \todo Please doc me!
+      typedef typename Wrapper::Geometry Geometry;
+      //! The GeometryCache entry of the intersection.
+      typedef GeometryCacheEntry<typename I::Geometry> CacheEntry;
     private:
       const I& i;
       const unsigned int index;
+      CacheEntry* cache_entry;
     public:
-      //! \todo Please doc me!
-      typedef typename I::Geometry Geometry;
       //! \todo Please doc me!
       typedef typename I::LocalGeometry LocalGeometry;
       //! \todo Please doc me!
@@ -75,8 +123,8 @@ namespace Dune {
       enum { coorddimension=Geometry::coorddimension };
 
       //! \todo Please doc me!
-      IntersectionGeometry (const I& i_, unsigned int index_)
-        : i(i_), index(index_)
+      IntersectionGeometry (const I& i_, unsigned int index_, CacheEntry* cache_entry_ = nullptr)
+        : i(i_), index(index_), cache_entry(cache_entry_)
       {}
 
       //! \todo Please doc me!
@@ -135,7 +183,7 @@ namespace Dune {
       */
       Geometry geometry () const
       {
-        return i.geometry();
+        return Wrapper::wrap(i.geometry(),cache_entry);
       }
 
       //! Local number of codim 1 entity in the inside() Entity where intersection is contained in
@@ -0,0 +1,281 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifndef DUNE_PDELAB_COMMON_PERTURBATIONBATCH_HH
+#define DUNE_PDELAB_COMMON_PERTURBATIONBATCH_HH
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! A quantity evaluated simultaneously for a batch of differently perturbed coefficients.
+    /**
+     * Each of the L lanes holds the value of the quantity for one set of coefficients. Lane 0
+     * belongs to the unperturbed coefficients, the other lanes to coefficients with a single
+     * perturbed entry each, so that a single evaluation of a function with batched coefficients
+     * yields its value and up to L-1 difference quotients. All arithmetic operations and
+     * elementary functions act lane-wise; the loops over the lanes are simple enough to be
+     * vectorized by the compiler.
+     *
+     * Comparisons only compare lane 0. Branches in the evaluated code are thus taken as for
+     * the unperturbed coefficients in all lanes, which yields the difference quotients of the
+     * active branch.
+     *
+     * The elementary functions are found by argument dependent lookup. Code evaluated with
+     * batches therefore has to call them unqualified, e.g. `using std::exp; exp(u)`, instead of
+     * `std::exp(u)`.
+     *
+     * \tparam T The field type of the lanes
+     * \tparam L The number of lanes
+     */
+    template<typename T, std::size_t L>
+    class PerturbationBatch
+    {
+    public:
+
+      typedef T value_type;
+
+      //! The number of lanes.
+      static constexpr std::size_t lanes = L;
+
+      //! Creates a batch with the same value in all lanes.
+      PerturbationBatch (const T& value = T(0))
+      {
+        _lanes.fill(value);
+      }
+
+      //! The value in the given lane.
+      T& lane (std::size_t index)
+      {
+        return _lanes[index];
+      }
+
+      //! The value in the given lane.
+      const T& lane (std::size_t index) const
+      {
+        return _lanes[index];
+      }
+
+      //! Arithmetic assignment operators
+      //! @{
+      PerturbationBatch& operator+= (const PerturbationBatch& other)
+      {
+        for (std::size_t l = 0; l < L; ++l)
+          _lanes[l] += other._lanes[l];
+        return *this;
+      }
+
+      PerturbationBatch& operator+= (const T& other)
+      {
+        for (std::size_t l = 0; l < L; ++l)
+          _lanes[l] += other;
+        return *this;
+      }
+
+      PerturbationBatch& operator-= (const PerturbationBatch& other)
+      {
+        for (std::size_t l = 0; l < L; ++l)
+          _lanes[l] -= other._lanes[l];
+        return *this;
+      }
+
+      PerturbationBatch& operator-= (const T& other)
+      {
+        for (std::size_t l = 0; l < L; ++l)
+          _lanes[l] -= other;
+        return *this;
+      }
+
+      PerturbationBatch& operator*= (const PerturbationBatch& other)
+      {
+        for (std::size_t l = 0; l < L; ++l)
+          _lanes[l] *= other._lanes[l];
+        return *this;
+      }
+
+      PerturbationBatch& operator*= (const T& other)
+      {
+        for (std::size_t l = 0; l < L; ++l)
+          _lanes[l] *= other;
+        return *this;
+      }
+
+      PerturbationBatch& operator/= (const PerturbationBatch& other)
+      {
+        for (std::size_t l = 0; l < L; ++l)
+          _lanes[l] /= other._lanes[l];
+        return *this;
+      }
+
+      PerturbationBatch& operator/= (const T& other)
+      {
+        for (std::size_t l = 0; l < L; ++l)
+          _lanes[l] /= other;
+        return *this;
+      }
+      //! @}
+
+      //! Arithmetic operators
+      //! @{
+      friend PerturbationBatch operator+ (const PerturbationBatch& a)
+      {
+        return a;
+      }
+
+      friend PerturbationBatch operator- (PerturbationBatch a)
+      {
+        for (std::size_t l = 0; l < L; ++l)
+          a._lanes[l] = -a._lanes[l];
+        return a;
+      }
+
+      friend PerturbationBatch operator+ (PerturbationBatch a, const PerturbationBatch& b) { return a += b; }
+      friend PerturbationBatch operator+ (PerturbationBatch a, const T& b) { return a += b; }
+      friend PerturbationBatch operator+ (const T& a, PerturbationBatch b) { return b += a; }
+
+      friend PerturbationBatch operator- (PerturbationBatch a, const PerturbationBatch& b) { return a -= b; }
+      friend PerturbationBatch operator- (PerturbationBatch a, const T& b) { return a -= b; }
+      friend PerturbationBatch operator- (const T& a, const PerturbationBatch& b) { return -b + a; }
+
+      friend PerturbationBatch operator* (PerturbationBatch a, const PerturbationBatch& b) { return a *= b; }
+      friend PerturbationBatch operator* (PerturbationBatch a, const T& b) { return a *= b; }
+      friend PerturbationBatch operator* (const T& a, PerturbationBatch b) { return b *= a; }
+
+      friend PerturbationBatch operator/ (PerturbationBatch a, const PerturbationBatch& b) { return a /= b; }
+      friend PerturbationBatch operator/ (PerturbationBatch a, const T& b) { return a /= b; }
+      friend PerturbationBatch operator/ (const T& a, const PerturbationBatch& b) { return PerturbationBatch(a) /= b; }
+      //! @}
+
+      //! Comparison operators, which only compare the unperturbed lane
+      //! @{
+      friend bool operator== (const PerturbationBatch& a, const PerturbationBatch& b) { return a._lanes[0] == b._lanes[0]; }
+      friend bool operator== (const PerturbationBatch& a, const T& b) { return a._lanes[0] == b; }
+      friend bool operator== (const T& a, const PerturbationBatch& b) { return a == b._lanes[0]; }
+      friend bool operator!= (const PerturbationBatch& a, const PerturbationBatch& b) { return a._lanes[0] != b._lanes[0]; }
+      friend bool operator!= (const PerturbationBatch& a, const T& b) { return a._lanes[0] != b; }
+      friend bool operator!= (const T& a, const PerturbationBatch& b) { return a != b._lanes[0]; }
+      friend bool operator< (const PerturbationBatch& a, const PerturbationBatch& b) { return a._lanes[0] < b._lanes[0]; }
+      friend bool operator< (const PerturbationBatch& a, const T& b) { return a._lanes[0] < b; }
+      friend bool operator< (const T& a, const PerturbationBatch& b) { return a < b._lanes[0]; }
+      friend bool operator<= (const PerturbationBatch& a, const PerturbationBatch& b) { return a._lanes[0] <= b._lanes[0]; }
+      friend bool operator<= (const PerturbationBatch& a, const T& b) { return a._lanes[0] <= b; }
+      friend bool operator<= (const T& a, const PerturbationBatch& b) { return a <= b._lanes[0]; }
+      friend bool operator> (const PerturbationBatch& a, const PerturbationBatch& b) { return a._lanes[0] > b._lanes[0]; }
+      friend bool operator> (const PerturbationBatch& a, const T& b) { return a._lanes[0] > b; }
+      friend bool operator> (const T& a, const PerturbationBatch& b) { return a > b._lanes[0]; }
+      friend bool operator>= (const PerturbationBatch& a, const PerturbationBatch& b) { return a._lanes[0] >= b._lanes[0]; }
+      friend bool operator>= (const PerturbationBatch& a, const T& b) { return a._lanes[0] >= b; }
+      friend bool operator>= (const T& a, const PerturbationBatch& b) { return a >= b._lanes[0]; }
+      //! @}
+
+      //! Elementary functions
+      //! @{
+      friend PerturbationBatch abs (PerturbationBatch a)
+      {
+        using std::abs;
+        for (std::size_t l = 0; l < L; ++l)
+          a._lanes[l] = abs(a._lanes[l]);
+        return a;
+      }
+
+      friend PerturbationBatch sqrt (PerturbationBatch a)
+      {
+        using std::sqrt;
+        for (std::size_t l = 0; l < L; ++l)
+          a._lanes[l] = sqrt(a._lanes[l]);
+        return a;
+      }
+
+      friend PerturbationBatch exp (PerturbationBatch a)
+      {
+        using std::exp;
+        for (std::size_t l = 0; l < L; ++l)
+          a._lanes[l] = exp(a._lanes[l]);
+        return a;
+      }
+
+      friend PerturbationBatch log (PerturbationBatch a)
+      {
+        using std::log;
+        for (std::size_t l = 0; l < L; ++l)
+          a._lanes[l] = log(a._lanes[l]);
+        return a;
+      }
+
+      friend PerturbationBatch pow (PerturbationBatch a, const T& b)
+      {
+        using std::pow;
+        for (std::size_t l = 0; l < L; ++l)
+          a._lanes[l] = pow(a._lanes[l],b);
+        return a;
+      }
+
+      friend PerturbationBatch pow (PerturbationBatch a, const PerturbationBatch& b)
+      {
+        using std::pow;
+        for (std::size_t l = 0; l < L; ++l)
+          a._lanes[l] = pow(a._lanes[l],b._lanes[l]);
+        return a;
+      }
+
+      friend PerturbationBatch sin (PerturbationBatch a)
+      {
+        using std::sin;
+        for (std::size_t l = 0; l < L; ++l)
+          a._lanes[l] = sin(a._lanes[l]);
+        return a;
+      }
+
+      friend PerturbationBatch cos (PerturbationBatch a)
+      {
+        using std::cos;
+        for (std::size_t l = 0; l < L; ++l)
+          a._lanes[l] = cos(a._lanes[l]);
+        return a;
+      }
+
+      friend PerturbationBatch tanh (PerturbationBatch a)
+      {
+        using std::tanh;
+        for (std::size_t l = 0; l < L; ++l)
+          a._lanes[l] = tanh(a._lanes[l]);
+        return a;
+      }
+
+      friend PerturbationBatch atan (PerturbationBatch a)
+      {
+        using std::atan;
+        for (std::size_t l = 0; l < L; ++l)
+          a._lanes[l] = atan(a._lanes[l]);
+        return a;
+      }
+
+      friend const PerturbationBatch& max (const PerturbationBatch& a, const PerturbationBatch& b)
+      {
+        return a._lanes[0] < b._lanes[0] ? b : a;
+      }
+
+      friend const PerturbationBatch& min (const PerturbationBatch& a, const PerturbationBatch& b)
+      {
+        return b._lanes[0] < a._lanes[0] ? b : a;
+      }
+      //! @}
+
+      friend std::ostream& operator<< (std::ostream& s, const PerturbationBatch& a)
+      {
+        s << "[";
+        for (std::size_t l = 0; l < L; ++l)
+          s << (l > 0 ? " " : "") << a._lanes[l];
+        return s << "]";
+      }
+
+    private:
+      std::array<T,L> _lanes;
+    };
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_COMMON_PERTURBATIONBATCH_HH
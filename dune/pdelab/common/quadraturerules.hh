@@ -58,6 +58,12 @@ namespace Dune {
         return _quadrature_rule->size();
       }
 
+      //! Returns the i-th quadrature point.
+      const typename QR::value_type& operator[](size_type i) const
+      {
+        return (*_quadrature_rule)[i];
+      }
+
       //! Returns an iterator pointing to the first quadrature point.
       const_iterator begin() const
       {
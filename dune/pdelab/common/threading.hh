@@ -0,0 +1,324 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_COMMON_THREADING_HH
+#define DUNE_PDELAB_COMMON_THREADING_HH
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <dune/pdelab/common/atomicadd.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup common Common Utilities
+    //! \{
+
+    //! Returns the number of threads used by default for shared memory parallel assembly.
+    inline std::size_t defaultThreadCount()
+    {
+      const std::size_t n = std::thread::hardware_concurrency();
+      return n > 0 ? n : 1;
+    }
+
+    //! A reusable barrier for a fixed number of threads.
+    class ThreadBarrier
+    {
+
+    public:
+
+      explicit ThreadBarrier(std::size_t count)
+        : _count(count)
+        , _waiting(0)
+        , _generation(0)
+      {}
+
+      //! Blocks until all threads of the team have called wait().
+      void wait()
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        const std::size_t generation = _generation;
+        if (++_waiting == _count)
+          {
+            _waiting = 0;
+            ++_generation;
+            _condition.notify_all();
+          }
+        else
+          _condition.wait(lock,[&]{ return generation != _generation; });
+      }
+
+    private:
+
+      const std::size_t _count;
+      std::size_t _waiting;
+      std::size_t _generation;
+      std::mutex _mutex;
+      std::condition_variable _condition;
+
+    };
+
+    //! Records the first exception thrown by any member of a thread team.
+    class ThreadExceptionCollector
+    {
+
+    public:
+
+      ThreadExceptionCollector()
+        : _failed(false)
+      {}
+
+      //! Stores the currently handled exception unless another one has been stored before.
+      void capture()
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_exception)
+          _exception = std::current_exception();
+        _failed.store(true);
+      }
+
+      //! Returns whether any thread has failed so far.
+      bool failed() const
+      {
+        return _failed.load();
+      }
+
+      //! Rethrows the stored exception, if there is one.
+      void rethrow() const
+      {
+        if (_exception)
+          std::rethrow_exception(_exception);
+      }
+
+    private:
+
+      std::mutex _mutex;
+      std::atomic<bool> _failed;
+      std::exception_ptr _exception;
+
+    };
+
+    //! A team of threads that is kept alive across parallel regions.
+    /**
+     * run() executes a function on all members of the team. The threads are only started
+     * once in the constructor and wait for the next parallel region in between. This avoids
+     * paying for the creation of the threads in every region, e.g. in every assembly of a
+     * residual during a Newton iteration. Concurrent calls of run() are serialized.
+     */
+    class ThreadTeam
+    {
+
+    public:
+
+      explicit ThreadTeam(std::size_t threads)
+        : _size(std::max(threads,std::size_t(1)))
+        , _task(nullptr)
+        , _invoke(nullptr)
+        , _generation(0)
+        , _pending(0)
+        , _shutdown(false)
+      {
+        _workers.reserve(_size - 1);
+        for (std::size_t t = 1; t < _size; ++t)
+          _workers.emplace_back([this,t]{ work(t); });
+      }
+
+      ThreadTeam(const ThreadTeam&) = delete;
+      ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+      ~ThreadTeam()
+      {
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _shutdown = true;
+        }
+        _start.notify_all();
+        for (auto& worker : _workers)
+          worker.join();
+      }
+
+      //! The number of threads in the team, including the calling thread.
+      std::size_t size() const
+      {
+        return _size;
+      }
+
+      //! Runs f(thread_index) on all members of the team and waits for all of them to finish.
+      /**
+       * The calling thread participates as the team member with index 0, so the team only
+       * holds size() - 1 additional threads. Exceptions escaping f are collected and the
+       * first one is rethrown on the calling thread after the whole team has finished.
+       * Note that f is responsible for not leaving other team members waiting on a
+       * ThreadBarrier when it throws.
+       */
+      template<typename F>
+      void run(F&& f)
+      {
+        std::lock_guard<std::mutex> region(_region_mutex);
+
+        ThreadExceptionCollector exceptions;
+        auto task = [&](std::size_t thread)
+          {
+            try
+              {
+                f(thread);
+              }
+            catch (...)
+              {
+                exceptions.capture();
+              }
+          };
+
+        if (_size > 1)
+          {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task = &task;
+            _invoke = [](void* t, std::size_t thread)
+              {
+                (*static_cast<decltype(task)*>(t))(thread);
+              };
+            _pending = _size - 1;
+            ++_generation;
+          }
+        _start.notify_all();
+
+        task(0);
+
+        {
+          std::unique_lock<std::mutex> lock(_mutex);
+          _done.wait(lock,[this]{ return _pending == 0; });
+        }
+
+        exceptions.rethrow();
+      }
+
+    private:
+
+      void work(std::size_t thread)
+      {
+        std::size_t generation = 0;
+        while (true)
+          {
+            void* task;
+            void (*invoke)(void*,std::size_t);
+            {
+              std::unique_lock<std::mutex> lock(_mutex);
+              _start.wait(lock,[&]{ return _shutdown || _generation != generation; });
+              if (_shutdown)
+                return;
+              generation = _generation;
+              task = _task;
+              invoke = _invoke;
+            }
+            invoke(task,thread);
+            {
+              std::lock_guard<std::mutex> lock(_mutex);
+              if (--_pending == 0)
+                _done.notify_one();
+            }
+          }
+      }
+
+      const std::size_t _size;
+      std::vector<std::thread> _workers;
+
+      std::mutex _region_mutex;
+      std::mutex _mutex;
+      std::condition_variable _start;
+      std::condition_variable _done;
+      void* _task;
+      void (*_invoke)(void*,std::size_t);
+      std::size_t _generation;
+      std::size_t _pending;
+      bool _shutdown;
+
+    };
+
+    //! Distributes a range of task indices among a team of threads with work stealing.
+    /**
+     * Every thread starts with a contiguous block of tasks that it processes from the
+     * front. A thread that runs out of work steals the back half of the remaining
+     * tasks of another thread, so the load is balanced even if the cost of the
+     * individual tasks varies strongly, while each thread still mostly works on
+     * neighboring tasks.
+     */
+    class WorkStealingScheduler
+    {
+
+      struct alignas(64) Range
+      {
+        std::mutex mutex;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+      };
+
+    public:
+
+      WorkStealingScheduler(std::size_t threads, std::size_t tasks)
+        : _threads(std::max(threads,std::size_t(1)))
+        , _ranges(new Range[_threads])
+      {
+        for (std::size_t t = 0; t < _threads; ++t)
+          {
+            _ranges[t].begin = (tasks * t) / _threads;
+            _ranges[t].end = (tasks * (t+1)) / _threads;
+          }
+      }
+
+      //! Fetches the next task for the given thread, returns false once all tasks have been handed out.
+      bool next(std::size_t thread, std::size_t& task)
+      {
+        if (pop(_ranges[thread],task))
+          return true;
+
+        for (std::size_t i = 1; i < _threads; ++i)
+          {
+            Range& victim = _ranges[(thread + i) % _threads];
+            std::size_t begin, end;
+            {
+              std::lock_guard<std::mutex> lock(victim.mutex);
+              if (victim.begin >= victim.end)
+                continue;
+              end = victim.end;
+              begin = end - (end - victim.begin + 1) / 2;
+              victim.end = begin;
+            }
+            task = begin;
+            Range& own = _ranges[thread];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = begin + 1;
+            own.end = end;
+            return true;
+          }
+        return false;
+      }
+
+    private:
+
+      static bool pop(Range& range, std::size_t& task)
+      {
+        std::lock_guard<std::mutex> lock(range.mutex);
+        if (range.begin >= range.end)
+          return false;
+        task = range.begin++;
+        return true;
+      }
+
+      const std::size_t _threads;
+      std::unique_ptr<Range[]> _ranges;
+
+    };
+
+    //! \} group common
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_COMMON_THREADING_HH
@@ -4,7 +4,11 @@
 #ifndef DUNE_PDELAB_FINITEELEMENT_QKDGLAGRANGE_HH
 #define DUNE_PDELAB_FINITEELEMENT_QKDGLAGRANGE_HH
 
+#include <array>
 #include <numeric>
+#include <utility>
+
+#include <dune/common/hybridutilities.hh>
 
 #include <dune/localfunctions/common/localbasis.hh>
 #include <dune/localfunctions/common/localkey.hh>
@@ -129,6 +133,87 @@ namespace Dune
       return alpha;
     }
 
+    //! values and derivatives of all Lagrange polynomials of degree k at x
+    /**
+     * The loops are unrolled at compile time, so the denominators are constants. The
+     * derivatives are accumulated with the product rule along with the values.
+     */
+    template<class D, class R, int k>
+    void lagrangePolynomials (D x, std::array<R,k+1>& values, std::array<R,k+1>& derivatives)
+    {
+      std::array<R,k+1> factors;
+      Hybrid::forEach(std::make_index_sequence<k+1>{},[&](auto j){
+          factors[j] = k*x-R(j);
+        });
+      Hybrid::forEach(std::make_index_sequence<k+1>{},[&](auto i){
+          R value(1.0), derivative(0.0);
+          Hybrid::forEach(std::make_index_sequence<k+1>{},[&](auto j){
+              if (int(j)!=int(i))
+                {
+                  const R denominator = int(i)-int(j);
+                  derivative = (derivative*factors[j] + value*k)/denominator;
+                  value *= factors[j]/denominator;
+                }
+            });
+          values[i] = value;
+          derivatives[i] = derivative;
+        });
+    }
+
+    //! products of one-dimensional factors for all (k+1)^d basis functions
+    /**
+     * The products are built direction by direction, with the first direction running
+     * fastest, which takes one multiplication per basis function and direction.
+     *
+     * \param factors The values of the k+1 one-dimensional polynomials in each direction
+     */
+    template<class R, int k, int d>
+    void tensorProduct (const std::array<const std::array<R,k+1>*,d>& factors,
+                        std::array<R,QkSize<k,d>::value>& products)
+    {
+      for (int i=0; i<=k; i++)
+        products[i] = (*factors[0])[i];
+      std::size_t size = k+1;
+      for (int j=1; j<d; j++)
+        {
+          // go backwards, so the products with the first factor overwrite their own sources last
+          for (int b=k; b>=0; b--)
+            for (std::size_t a=0; a<size; a++)
+              products[a+size*b] = products[a]*(*factors[j])[b];
+          size *= k+1;
+        }
+    }
+
+    //! values of all tensor product basis functions from the values of the one-dimensional polynomials
+    template<class R, int k, int d, class Out>
+    void tensorProductFunctions (const std::array<std::array<R,k+1>,d>& values, Out& out)
+    {
+      std::array<const std::array<R,k+1>*,d> factors;
+      for (int j=0; j<d; j++)
+        factors[j] = &values[j];
+      std::array<R,QkSize<k,d>::value> products;
+      tensorProduct<R,k,d>(factors,products);
+      for (std::size_t i=0; i<products.size(); i++)
+        out[i] = products[i];
+    }
+
+    //! jacobians of all tensor product basis functions from the values and derivatives of the one-dimensional polynomials
+    template<class R, int k, int d, class Out>
+    void tensorProductJacobians (const std::array<std::array<R,k+1>,d>& values,
+                                 const std::array<std::array<R,k+1>,d>& derivatives, Out& out)
+    {
+      std::array<const std::array<R,k+1>*,d> factors;
+      std::array<R,QkSize<k,d>::value> products;
+      for (int j=0; j<d; j++)
+        {
+          for (int l=0; l<d; l++)
+            factors[l] = l==j ? &derivatives[l] : &values[l];
+          tensorProduct<R,k,d>(factors,products);
+          for (std::size_t i=0; i<products.size(); i++)
+            out[i][0][j] = products[i];
+        }
+    }
+
     /**@ingroup LocalBasisImplementation
        \brief Lagrange shape functions of order k on the reference cube.
 
@@ -159,18 +244,14 @@ namespace Dune
                                     std::vector<typename Traits::RangeType>& out) const
       {
         out.resize(size());
-        for (size_t i=0; i<size(); i++)
-          {
-            // convert index i to multiindex
-            Dune::FieldVector<int,d> alpha(multiindex<k,d>(i));
-
-            // initialize product
-            out[i] = 1.0;
+        functions(in,out);
+      }
 
-            // dimension by dimension
-            for (int j=0; j<d; j++)
-              out[i] *= p<D,R,k>(alpha[j],in[j]);
-          }
+      //! \brief Evaluate all shape functions into an array of fixed size
+      inline void evaluateFunction (const typename Traits::DomainType& in,
+                                    std::array<typename Traits::RangeType,n>& out) const
+      {
+        functions(in,out);
       }
 
       //! \brief Evaluate Jacobian of all shape functions
@@ -179,26 +260,15 @@ namespace Dune
                         std::vector<typename Traits::JacobianType>& out) const      // return value
       {
         out.resize(size());
+        jacobians(in,out);
+      }
 
-        // Loop over all shape functions
-        for (size_t i=0; i<size(); i++)
-          {
-            // convert index i to multiindex
-            Dune::FieldVector<int,d> alpha(multiindex<k,d>(i));
-
-            // Loop over all coordinate directions
-            for (int j=0; j<d; j++)
-              {
-                // Initialize: the overall expression is a product
-                // if j-th bit of i is set to -1, else 1
-                out[i][0][j] = dp<D,R,k>(alpha[j],in[j]);
-
-                // rest of the product
-                for (int l=0; l<d; l++)
-                  if (l!=j)
-                    out[i][0][j] *= p<D,R,k>(alpha[l],in[l]);
-              }
-          }
+      //! \brief Evaluate Jacobian of all shape functions into an array of fixed size
+      inline void
+      evaluateJacobian (const typename Traits::DomainType& in,
+                        std::array<typename Traits::JacobianType,n>& out) const
+      {
+        jacobians(in,out);
       }
 
       //! \brief Evaluate partial derivative of all shape functions
@@ -219,6 +289,27 @@ namespace Dune
       {
         return k;
       }
+
+    private:
+
+      // the one-dimensional polynomials are evaluated once per direction
+      template<class Out>
+      void functions (const typename Traits::DomainType& in, Out& out) const
+      {
+        std::array<std::array<R,k+1>,d> v, a;
+        for (int j=0; j<d; j++)
+          lagrangePolynomials<D,R,k>(in[j],v[j],a[j]);
+        tensorProductFunctions<R,k,d>(v,out);
+      }
+
+      template<class Out>
+      void jacobians (const typename Traits::DomainType& in, Out& out) const
+      {
+        std::array<std::array<R,k+1>,d> v, a;
+        for (int j=0; j<d; j++)
+          lagrangePolynomials<D,R,k>(in[j],v[j],a[j]);
+        tensorProductJacobians<R,k,d>(v,a,out);
+      }
     };
 
     /**@ingroup LocalLayoutImplementation
@@ -6,10 +6,13 @@
 #ifndef DUNE_PDELAB_FINITEELEMENT_QKDGLEGENDRE_HH
 #define DUNE_PDELAB_FINITEELEMENT_QKDGLEGENDRE_HH
 
+#include <array>
 #include <numeric>
+#include <utility>
 #include <vector>
 
 #include <dune/common/fvector.hh>
+#include <dune/common/hybridutilities.hh>
 #include <dune/common/deprecated.hh>
 
 #include <dune/geometry/type.hh>
@@ -22,6 +25,8 @@
 #include <dune/localfunctions/common/localtoglobaladaptors.hh>
 #include <dune/localfunctions/common/localinterpolation.hh>
 
+#include <dune/pdelab/finiteelement/qkdglagrange.hh>
+
 namespace Dune
 {
 
@@ -129,6 +134,22 @@ namespace Dune
           }
       }
 
+      // value and derivative of all polynomials, with the recurrence unrolled at compile time
+      void pdp (D x, std::array<R,k+1>& value, std::array<R,k+1>& derivative) const
+      {
+        value[0] = 1;
+        derivative[0] = 0.0;
+        value[1] = 2*x-1;
+        derivative[1] = 2.0;
+        Hybrid::forEach(std::make_index_sequence<k+1>{},[&](auto n){
+            if (n>=2)
+              {
+                value[n] = ((2*n-1)*(2*x-1)*value[n-1]-(n-1)*value[n-2])/R(n);
+                derivative[n] = (2*x-1)*derivative[n-1] + 2*n*value[n-1];
+              }
+          });
+      }
+
       // derivative of ith Lagrange polynomial of degree k in one dimension
       R dp (int i, D x) const
       {
@@ -176,6 +197,13 @@ namespace Dune
         value[0] = 1.0;
         derivative[0] = 0.0;
       }
+
+      // value and derivative of all polynomials
+      void pdp (D x, std::array<R,1>& value, std::array<R,1>& derivative) const
+      {
+        value[0] = 1.0;
+        derivative[0] = 0.0;
+      }
     };
 
     template<class D, class R>
@@ -220,6 +248,15 @@ namespace Dune
         derivative[0] = 0.0;
         derivative[1] = 2.0;
       }
+
+      // value and derivative of all polynomials
+      void pdp (D x, std::array<R,2>& value, std::array<R,2>& derivative) const
+      {
+        value[0] = 1.0;
+        value[1] = 2*x-1;
+        derivative[0] = 0.0;
+        derivative[1] = 2.0;
+      }
     };
 
     /**@ingroup LocalBasisImplementation
@@ -239,15 +276,10 @@ namespace Dune
     {
       enum { n = LegendreSize<k,d>::value };
       LegendrePolynomials1d<D,R,k> poly;
-      mutable std::vector<std::vector<R> > v;
-      mutable std::vector<std::vector<R> > a;
 
     public:
       typedef LocalBasisTraits<D,d,Dune::FieldVector<D,d>,R,1,Dune::FieldVector<R,1>,Dune::FieldMatrix<R,1,d> > Traits;
 
-      DGLegendreLocalBasis () : v(d,std::vector<R>(k+1,0.0)), a(d,std::vector<R>(k+1,0.0))
-      {}
-
       //! \brief number of shape functions
       unsigned int size () const
       {
@@ -260,22 +292,14 @@ namespace Dune
       {
         // resize output vector
         value.resize(n);
+        functions(x,value);
+      }
 
-        // compute values of 1d basis functions in each direction
-        for (size_t j=0; j<d; j++) poly.p(x[j],v[j]);
-
-        // now compute the product
-        for (size_t i=0; i<n; i++)
-          {
-            // convert index i to multiindex
-            Dune::FieldVector<int,d> alpha(multiindex<k,d>(i));
-
-            // initialize product
-            value[i] = 1.0;
-
-            // dimension by dimension
-            for (int j=0; j<d; j++) value[i] *= v[j][alpha[j]];
-          }
+      //! \brief Evaluate all shape functions into an array of fixed size
+      inline void evaluateFunction (const typename Traits::DomainType& x,
+                                    std::array<typename Traits::RangeType,n>& value) const
+      {
+        functions(x,value);
       }
 
       //! \brief Evaluate Jacobian of all shape functions
@@ -285,28 +309,15 @@ namespace Dune
       {
         // resize output vector
         value.resize(size());
+        jacobians(x,value);
+      }
 
-        // compute values of 1d basis functions in each direction
-        for (size_t j=0; j<d; j++) poly.pdp(x[j],v[j],a[j]);
-
-        // Loop over all shape functions
-        for (size_t i=0; i<n; i++)
-          {
-            // convert index i to multiindex
-            Dune::FieldVector<int,d> alpha(multiindex<k,d>(i));
-
-            // Loop over all coordinate directions
-            for (int j=0; j<d; j++)
-              {
-                // Initialize: the overall expression is a product
-                value[i][0][j] = a[j][alpha[j]];
-
-                // rest of the product
-                for (int l=0; l<d; l++)
-                  if (l!=j)
-                    value[i][0][j] *= v[l][alpha[l]];
-              }
-          }
+      //! \brief Evaluate Jacobian of all shape functions into an array of fixed size
+      inline void
+      evaluateJacobian (const typename Traits::DomainType& x,
+                        std::array<typename Traits::JacobianType,n>& value) const
+      {
+        jacobians(x,value);
       }
 
       //! \brief Evaluate partial derivative of all shape functions
@@ -326,6 +337,25 @@ namespace Dune
       {
         return k;
       }
+
+    private:
+
+      // compute values of 1d basis functions in each direction, then their products
+      template<class Out>
+      void functions (const typename Traits::DomainType& x, Out& value) const
+      {
+        std::array<std::array<R,k+1>,d> v, a;
+        for (int j=0; j<d; j++) poly.pdp(x[j],v[j],a[j]);
+        QkStuff::tensorProductFunctions<R,k,d>(v,value);
+      }
+
+      template<class Out>
+      void jacobians (const typename Traits::DomainType& x, Out& value) const
+      {
+        std::array<std::array<R,k+1>,d> v, a;
+        for (int j=0; j<d; j++) poly.pdp(x[j],v[j],a[j]);
+        QkStuff::tensorProductJacobians<R,k,d>(v,a,value);
+      }
     };
 
 
@@ -4,7 +4,11 @@
 #ifndef DUNE_PDELAB_FINITEELEMENT_QKDGLOBATTO_HH
 #define DUNE_PDELAB_FINITEELEMENT_QKDGLOBATTO_HH
 
+#include <array>
 #include <numeric>
+#include <utility>
+
+#include <dune/common/hybridutilities.hh>
 
 #include <dune/localfunctions/common/localbasis.hh>
 #include <dune/localfunctions/common/localkey.hh>
@@ -96,6 +100,24 @@ namespace Dune
         return result;
       }
 
+      //! values and derivatives of all polynomials at x, with the loops unrolled at compile time
+      void pdp (D x, std::array<R,k+1>& values, std::array<R,k+1>& derivatives) const
+      {
+        Hybrid::forEach(std::make_index_sequence<k+1>{},[&](auto i){
+            R value(1.0), derivative(0.0);
+            Hybrid::forEach(std::make_index_sequence<k+1>{},[&](auto j){
+                if (int(j)!=int(i))
+                  {
+                    const R denominator = xi_gl[i]-xi_gl[j];
+                    derivative = (derivative*(x-xi_gl[j]) + value)/denominator;
+                    value *= (x-xi_gl[j])/denominator;
+                  }
+              });
+            values[i] = value;
+            derivatives[i] = derivative;
+          });
+      }
+
       // get ith Lagrange point
       R x (int i) const
       {
@@ -141,18 +163,14 @@ namespace Dune
                                     std::vector<typename Traits::RangeType>& out) const
       {
         out.resize(size());
-        for (size_t i=0; i<size(); i++)
-          {
-            // convert index i to multiindex
-            Dune::FieldVector<int,d> alpha(multiindex<k,d>(i));
-
-            // initialize product
-            out[i] = 1.0;
+        functions(in,out);
+      }
 
-            // dimension by dimension
-            for (int j=0; j<d; j++)
-              out[i] *= poly.p(alpha[j],in[j]);
-          }
+      //! \brief Evaluate all shape functions into an array of fixed size
+      inline void evaluateFunction (const typename Traits::DomainType& in,
+                                    std::array<typename Traits::RangeType,n>& out) const
+      {
+        functions(in,out);
       }
 
       //! \brief Evaluate Jacobian of all shape functions
@@ -161,26 +179,15 @@ namespace Dune
                         std::vector<typename Traits::JacobianType>& out) const      // return value
       {
         out.resize(size());
+        jacobians(in,out);
+      }
 
-        // Loop over all shape functions
-        for (size_t i=0; i<size(); i++)
-          {
-            // convert index i to multiindex
-            Dune::FieldVector<int,d> alpha(multiindex<k,d>(i));
-
-            // Loop over all coordinate directions
-            for (int j=0; j<d; j++)
-              {
-                // Initialize: the overall expression is a product
-                // if j-th bit of i is set to -1, else 1
-                out[i][0][j] = poly.dp(alpha[j],in[j]);
-
-                // rest of the product
-                for (int l=0; l<d; l++)
-                  if (l!=j)
-                    out[i][0][j] *= poly.p(alpha[l],in[l]);
-              }
-          }
+      //! \brief Evaluate Jacobian of all shape functions into an array of fixed size
+      inline void
+      evaluateJacobian (const typename Traits::DomainType& in,
+                        std::array<typename Traits::JacobianType,n>& out) const
+      {
+        jacobians(in,out);
       }
 
       //! \brief Evaluate partial derivative of all shape functions
@@ -200,6 +207,27 @@ namespace Dune
       {
         return k;
       }
+
+    private:
+
+      // the one-dimensional polynomials are evaluated once per direction
+      template<class Out>
+      void functions (const typename Traits::DomainType& in, Out& out) const
+      {
+        std::array<std::array<R,k+1>,d> v, a;
+        for (int j=0; j<d; j++)
+          poly.pdp(in[j],v[j],a[j]);
+        tensorProductFunctions<R,k,d>(v,out);
+      }
+
+      template<class Out>
+      void jacobians (const typename Traits::DomainType& in, Out& out) const
+      {
+        std::array<std::array<R,k+1>,d> v, a;
+        for (int j=0; j<d; j++)
+          poly.pdp(in[j],v[j],a[j]);
+        tensorProductJacobians<R,k,d>(v,a,out);
+      }
     };
 
     /** \todo Please doc me! */
@@ -0,0 +1,278 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_FINITEELEMENT_QUADRATUREBASISCACHE_HH
+#define DUNE_PDELAB_FINITEELEMENT_QUADRATUREBASISCACHE_HH
+
+#include<array>
+#include<atomic>
+#include<cmath>
+#include<cstddef>
+#include<functional>
+#include<memory>
+#include<mutex>
+#include<unordered_map>
+#include<vector>
+
+#include<dune/common/exceptions.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \brief values and jacobians of a local basis tabulated at the points of a quadrature rule
+    /**
+     * The values and the jacobians of all basis functions are stored in one contiguous array
+     * each, point by point, and are looked up by the index of the quadrature point. A table
+     * is immutable after construction and can be read by any number of threads.
+     */
+    template<class LocalBasisType>
+    class TabulatedLocalBasis
+    {
+    public:
+      typedef typename LocalBasisType::Traits::DomainType DomainType;
+      typedef typename LocalBasisType::Traits::RangeType RangeType;
+      typedef typename LocalBasisType::Traits::JacobianType JacobianType;
+
+      //! \brief the values of all basis functions at a single point
+      template<typename T>
+      class Values
+      {
+      public:
+        Values (const T* data, std::size_t size)
+          : _data(data), _size(size)
+        {}
+
+        const T& operator[] (std::size_t i) const { return _data[i]; }
+        std::size_t size () const { return _size; }
+        const T* begin () const { return _data; }
+        const T* end () const { return _data + _size; }
+
+      private:
+        const T* _data;
+        std::size_t _size;
+      };
+
+      //! \brief tabulate the basis at the given local positions
+      TabulatedLocalBasis (const LocalBasisType& localbasis, const std::vector<DomainType>& positions)
+        : _size(localbasis.size()), _points(positions.size())
+      {
+        _functions.reserve(_size*_points);
+        _jacobians.reserve(_size*_points);
+        std::vector<RangeType> values;
+        std::vector<JacobianType> jacobians;
+        for (const auto& position : positions)
+          {
+            localbasis.evaluateFunction(position,values);
+            _functions.insert(_functions.end(),values.begin(),values.end());
+            localbasis.evaluateJacobian(position,jacobians);
+            _jacobians.insert(_jacobians.end(),jacobians.begin(),jacobians.end());
+          }
+      }
+
+      //! number of basis functions
+      std::size_t size () const { return _size; }
+
+      //! number of quadrature points
+      std::size_t points () const { return _points; }
+
+      //! values of the basis functions at quadrature point q
+      Values<RangeType> function (std::size_t q) const
+      {
+        return Values<RangeType>(_functions.data() + q*_size,_size);
+      }
+
+      //! jacobians of the basis functions at quadrature point q
+      Values<JacobianType> jacobian (std::size_t q) const
+      {
+        return Values<JacobianType>(_jacobians.data() + q*_size,_size);
+      }
+
+    private:
+      std::size_t _size;
+      std::size_t _points;
+      std::vector<RangeType> _functions;
+      std::vector<JacobianType> _jacobians;
+    };
+
+    //! \brief tabulates local bases at quadrature rules, replacing the point-wise lookup of LocalBasisCache
+    /**
+     * A table is created for each combination of local basis and quadrature rule on first use,
+     * and for face quadrature rules additionally for each embedding of the face into the cell.
+     * Inside the quadrature loop, the values are then looked up in constant time by the index
+     * of the quadrature point:
+     *
+     * \code
+     * auto rule = quadratureRule(geo,intorder);
+     * const auto& basis = cache.table(lfsu.finiteElement().localBasis(),rule);
+     * for (std::size_t q=0; q<rule.size(); ++q)
+     *   {
+     *     auto phi = basis.function(q);
+     *     auto js = basis.jacobian(q);
+     *     ...
+     *   }
+     * \endcode
+     *
+     * Local bases and quadrature rules are identified by their address, so they must outlive
+     * the cache. This holds for the finite elements of a finite element map and for the rules
+     * returned by quadratureRule(). Face embeddings are identified by the corners of the face
+     * in the reference element of the cell, rounded to multiples of \f$2^{-32}\f$.
+     *
+     * The tables are found in an immutable hash map, which is read without locking. Only the
+     * creation of a new table takes a lock and publishes a new map containing it, so after the
+     * first assembly all lookups are lock-free. Copies of a cache share its tables, e.g.
+     * between copies of a local operator.
+     */
+    template<class LocalBasisType>
+    class QuadratureBasisCache
+    {
+    public:
+      typedef TabulatedLocalBasis<LocalBasisType> Table;
+      typedef typename Table::DomainType DomainType;
+
+      QuadratureBasisCache ()
+        : _store(std::make_shared<Store>())
+      {}
+
+      //! \brief the table of a local basis at the points of a quadrature rule on the cell
+      template<typename QR>
+      const Table& table (const LocalBasisType& localbasis, const QR& rule) const
+      {
+        return lookup(key(localbasis,rule),localbasis,[&]()
+          {
+            std::vector<DomainType> positions;
+            positions.reserve(rule.size());
+            for (const auto& ip : rule)
+              positions.push_back(ip.position());
+            return positions;
+          });
+      }
+
+      //! \brief the table of a local basis at the points of a face quadrature rule, mapped into the cell by embedding
+      /**
+       * \param embedding The geometry of the face in the reference element of the cell,
+       *                  e.g. IntersectionGeometry::geometryInInside().
+       */
+      template<typename QR, typename LocalGeometry>
+      const Table& table (const LocalBasisType& localbasis, const QR& rule, const LocalGeometry& embedding) const
+      {
+        Key face_key = key(localbasis,rule);
+        if (std::size_t(embedding.corners()) > max_corners)
+          DUNE_THROW(RangeError,"QuadratureBasisCache: face embedding with more than "
+                     << max_corners << " corners");
+        face_key.corners = embedding.corners();
+        for (std::size_t i=0; i<face_key.corners; i++)
+          {
+            const auto corner = embedding.corner(i);
+            for (std::size_t j=0; j<dim; j++)
+              face_key.coordinates[i*dim+j] = std::llround(corner[j]*4294967296.0);
+          }
+        return lookup(face_key,localbasis,[&]()
+          {
+            std::vector<DomainType> positions;
+            positions.reserve(rule.size());
+            for (const auto& ip : rule)
+              positions.push_back(embedding.global(ip.position()));
+            return positions;
+          });
+      }
+
+    private:
+
+      static const std::size_t dim = DomainType::dimension;
+
+      // the maximum number of corners of a face, i.e. of a cube of dimension dim-1
+      static const std::size_t max_corners = std::size_t(1) << (dim > 0 ? dim-1 : 0);
+
+      struct Key
+      {
+        const LocalBasisType* localbasis;
+        const void* rule;
+        std::size_t points;
+        std::size_t corners;
+        std::array<long long,max_corners*dim> coordinates;
+
+        bool operator== (const Key& other) const
+        {
+          return localbasis==other.localbasis && rule==other.rule && points==other.points &&
+            corners==other.corners && coordinates==other.coordinates;
+        }
+      };
+
+      struct KeyHash
+      {
+        std::size_t operator() (const Key& key) const
+        {
+          std::size_t hash = std::hash<const void*>()(key.localbasis);
+          auto combine = [&](std::size_t value)
+            {
+              hash ^= value + 0x9e3779b9 + (hash<<6) + (hash>>2);
+            };
+          combine(std::hash<const void*>()(key.rule));
+          combine(key.points);
+          for (std::size_t i=0; i<key.corners*dim; i++)
+            combine(std::hash<long long>()(key.coordinates[i]));
+          return hash;
+        }
+      };
+
+      typedef std::unordered_map<Key,const Table*,KeyHash> Tables;
+
+      struct Store
+      {
+        Store ()
+        {
+          published.push_back(std::make_unique<const Tables>());
+          current.store(published.back().get());
+        }
+
+        // the map of all tables, replaced by a new map whenever a table is added
+        std::atomic<const Tables*> current;
+        // serializes the creation of tables
+        std::mutex mutex;
+        std::vector<std::unique_ptr<const Table>> tables;
+        // all maps ever published, as concurrent readers may still use an outdated one
+        std::vector<std::unique_ptr<const Tables>> published;
+      };
+
+      template<typename QR>
+      static Key key (const LocalBasisType& localbasis, const QR& rule)
+      {
+        Key key{};
+        key.localbasis = &localbasis;
+        // the points of a quadrature rule are stored contiguously, so the first one identifies the rule
+        key.rule = rule.size() > 0 ? &*rule.begin() : nullptr;
+        key.points = rule.size();
+        key.corners = 0;
+        return key;
+      }
+
+      template<typename Positions>
+      const Table& lookup (const Key& key, const LocalBasisType& localbasis, Positions&& positions) const
+      {
+        const Tables* map = _store->current.load(std::memory_order_acquire);
+        auto it = map->find(key);
+        if (it != map->end())
+          return *it->second;
+
+        std::lock_guard<std::mutex> guard(_store->mutex);
+        // another thread may have created the table in the meantime
+        map = _store->current.load(std::memory_order_relaxed);
+        it = map->find(key);
+        if (it != map->end())
+          return *it->second;
+
+        _store->tables.push_back(std::make_unique<const Table>(localbasis,positions()));
+        auto updated = std::make_unique<Tables>(*map);
+        updated->emplace(key,_store->tables.back().get());
+        _store->published.push_back(std::move(updated));
+        _store->current.store(_store->published.back().get(),std::memory_order_release);
+        return *_store->tables.back();
+      }
+
+      std::shared_ptr<Store> _store;
+    };
+
+  }
+}
+
+#endif // DUNE_PDELAB_FINITEELEMENT_QUADRATUREBASISCACHE_HH
@@ -0,0 +1,419 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_FINITEELEMENT_SUMFACTORIZATION_HH
+#define DUNE_PDELAB_FINITEELEMENT_SUMFACTORIZATION_HH
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/quadraturerules.hh>
+#include <dune/geometry/type.hh>
+
+#include <dune/pdelab/finiteelement/qkdglagrange.hh>
+#include <dune/pdelab/finiteelement/qkdglegendre.hh>
+#include <dune/pdelab/finiteelement/qkdglobatto.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \brief the one-dimensional polynomials a tensor product local basis is built from
+    /**
+     * Specializations for tensor product bases set isTensorProduct to true and provide the
+     * polynomial degree, the dimension and a method evaluate(x,values,derivatives) which
+     * evaluates all degree+1 one-dimensional polynomials and their derivatives at x. The
+     * basis function with multi-index alpha must be the product of the polynomials alpha[j]
+     * in direction j, and its index must be alpha[0] + (degree+1)*alpha[1] + ...
+     */
+    template<typename LocalBasis>
+    struct TensorProductPolynomials
+    {
+      static constexpr bool isTensorProduct = false;
+    };
+
+    //! \brief the Lagrange polynomials of QkDGLagrangeLocalFiniteElement
+    template<class D, class R, int k, int d>
+    struct TensorProductPolynomials<QkStuff::QkLocalBasis<D,R,k,d> >
+    {
+      static constexpr bool isTensorProduct = true;
+      static constexpr int degree = k;
+      static constexpr int dimension = d;
+
+      void evaluate (D x, R* values, R* derivatives) const
+      {
+        std::array<R,k+1> v, a;
+        QkStuff::lagrangePolynomials<D,R,k>(x,v,a);
+        std::copy(v.begin(),v.end(),values);
+        std::copy(a.begin(),a.end(),derivatives);
+      }
+    };
+
+    //! \brief the Legendre polynomials of QkDGLegendreLocalFiniteElement
+    template<class D, class R, int k, int d>
+    struct TensorProductPolynomials<LegendreStuff::DGLegendreLocalBasis<D,R,k,d> >
+    {
+      static constexpr bool isTensorProduct = true;
+      static constexpr int degree = k;
+      static constexpr int dimension = d;
+
+      void evaluate (D x, R* values, R* derivatives) const
+      {
+        std::array<R,k+1> v, a;
+        poly.pdp(x,v,a);
+        std::copy(v.begin(),v.end(),values);
+        std::copy(a.begin(),a.end(),derivatives);
+      }
+
+    private:
+      LegendreStuff::LegendrePolynomials1d<D,R,k> poly;
+    };
+
+    //! \brief the Gauss-Lobatto Lagrange polynomials of QkDGGLLocalFiniteElement
+    template<class D, class R, int k, int d>
+    struct TensorProductPolynomials<QkStuff::QkGLLocalBasis<D,R,k,d> >
+    {
+      static constexpr bool isTensorProduct = true;
+      static constexpr int degree = k;
+      static constexpr int dimension = d;
+
+      void evaluate (D x, R* values, R* derivatives) const
+      {
+        std::array<R,k+1> v, a;
+        poly.pdp(x,v,a);
+        std::copy(v.begin(),v.end(),values);
+        std::copy(a.begin(),a.end(),derivatives);
+      }
+
+    private:
+      QkStuff::GaussLobattoLagrangePolynomials<D,R,k> poly;
+    };
+
+    //! \brief sum-factorized evaluation and integration of a tensor product basis on the reference cube
+    /**
+     * The kernel tabulates the one-dimensional polynomials of the basis at the points of a
+     * one-dimensional Gauss-Legendre rule and works on the tensor product of that rule, in
+     * the cell and on its faces. Evaluating a finite element function at all quadrature
+     * points, or testing values at all quadrature points against all basis functions, is done
+     * by one contraction per direction with the one-dimensional tables. This costs
+     * O((k+1)^(d+1)) operations per cell instead of O((k+1)^(2d)) for the evaluation of each
+     * basis function at each point.
+     *
+     * Quadrature points are numbered lexicographically with the first direction running
+     * fastest, like the basis functions. Face f is the face x_{f/2} = f%2 of the reference
+     * cube; its points run over the remaining directions in increasing order, which matches
+     * IntersectionGeometry::geometryInInside() of axis-parallel grids like YaspGrid.
+     *
+     * All methods work on raw arrays, so a local operator running in the fast DG assembler
+     * can pass the data() pointers of its coefficient and residual views directly. Values to
+     * be integrated have to include the quadrature weights and integration elements, and
+     * gradients are taken with respect to the reference coordinates. The integration methods
+     * add to their output. Kernels can be shared between threads.
+     *
+     * \tparam D The field type of the reference coordinates
+     * \tparam R The field type of coefficients and values
+     * \tparam d The dimension of the cube
+     */
+    template<typename D, typename R, int d>
+    class SumFactorizationKernel
+    {
+    public:
+      typedef Dune::FieldVector<D,d> DomainType;
+
+      //! \brief tabulate the given one-dimensional polynomials for a quadrature rule of the given order
+      template<typename Polynomials>
+      SumFactorizationKernel (const Polynomials& polynomials, int quadrature_order)
+        : _n(Polynomials::degree+1)
+      {
+        const auto& rule = Dune::QuadratureRules<D,1>::rule(GeometryTypes::line,quadrature_order,Dune::QuadratureType::GaussLegendre);
+        _m = rule.size();
+        _points = _m;
+        _basis_size = _n;
+        for (int j=1; j<d; j++)
+          {
+            _points *= _m;
+            _basis_size *= _n;
+          }
+        _face_points = _points/_m;
+        for (const auto& ip : rule)
+          {
+            _positions.push_back(ip.position()[0]);
+            _weights.push_back(ip.weight());
+          }
+        _values.resize(_m*_n);
+        _derivatives.resize(_m*_n);
+        for (std::size_t q=0; q<_m; q++)
+          polynomials.evaluate(_positions[q],&_values[q*_n],&_derivatives[q*_n]);
+        for (int side=0; side<2; side++)
+          {
+            _face_values[side].resize(_n);
+            _face_derivatives[side].resize(_n);
+            polynomials.evaluate(D(side),_face_values[side].data(),_face_derivatives[side].data());
+          }
+      }
+
+      //! number of basis functions
+      std::size_t size () const { return _basis_size; }
+
+      //! number of quadrature points in the cell
+      std::size_t points () const { return _points; }
+
+      //! number of quadrature points on a face
+      std::size_t facePoints () const { return _face_points; }
+
+      //! reference position of quadrature point q in the cell
+      DomainType position (std::size_t q) const
+      {
+        DomainType x;
+        for (int j=0; j<d; j++, q/=_m)
+          x[j] = _positions[q%_m];
+        return x;
+      }
+
+      //! quadrature weight of point q in the cell
+      D weight (std::size_t q) const
+      {
+        D w(1.0);
+        for (int j=0; j<d; j++, q/=_m)
+          w *= _weights[q%_m];
+        return w;
+      }
+
+      //! reference position in the cell of quadrature point q on the given face
+      DomainType facePosition (int face, std::size_t q) const
+      {
+        DomainType x;
+        for (int j=0; j<d; j++)
+          if (j==face/2)
+            x[j] = face%2;
+          else
+            {
+              x[j] = _positions[q%_m];
+              q /= _m;
+            }
+        return x;
+      }
+
+      //! quadrature weight of point q on a face
+      D faceWeight (std::size_t q) const
+      {
+        D w(1.0);
+        for (int j=0; j<d-1; j++, q/=_m)
+          w *= _weights[q%_m];
+        return w;
+      }
+
+      //! \brief values at all quadrature points of the function with the given coefficients
+      void evaluate (const R* coefficients, R* values) const
+      {
+        std::array<const R*,d> matrices;
+        std::array<std::size_t,d> rows;
+        for (int j=0; j<d; j++)
+          setVolume(matrices,rows,j,false);
+        apply(coefficients,values,matrices,rows,false);
+      }
+
+      //! \brief reference gradients at all quadrature points, component j of point q at gradients[j*points()+q]
+      void evaluateGradient (const R* coefficients, R* gradients) const
+      {
+        std::array<const R*,d> matrices;
+        std::array<std::size_t,d> rows;
+        for (int i=0; i<d; i++)
+          {
+            for (int j=0; j<d; j++)
+              setVolume(matrices,rows,j,i==j);
+            apply(coefficients,gradients+i*_points,matrices,rows,false);
+          }
+      }
+
+      //! \brief add the values at all quadrature points tested against all basis functions to the residual
+      void integrate (const R* values, R* residual) const
+      {
+        std::array<const R*,d> matrices;
+        std::array<std::size_t,d> rows;
+        for (int j=0; j<d; j++)
+          setVolume(matrices,rows,j,false);
+        apply(values,residual,matrices,rows,true);
+      }
+
+      //! \brief add the vectors at all quadrature points tested against the reference gradients of all basis functions to the residual
+      /**
+       * \param vectors Component j at point q is stored at vectors[j*points()+q].
+       */
+      void integrateGradient (const R* vectors, R* residual) const
+      {
+        std::array<const R*,d> matrices;
+        std::array<std::size_t,d> rows;
+        for (int i=0; i<d; i++)
+          {
+            for (int j=0; j<d; j++)
+              setVolume(matrices,rows,j,i==j);
+            apply(vectors+i*_points,residual,matrices,rows,true);
+          }
+      }
+
+      //! \brief values at all quadrature points of the given face
+      void evaluateFace (int face, const R* coefficients, R* values) const
+      {
+        std::array<const R*,d> matrices;
+        std::array<std::size_t,d> rows;
+        for (int j=0; j<d; j++)
+          setFace(matrices,rows,face,j,false);
+        apply(coefficients,values,matrices,rows,false);
+      }
+
+      //! \brief reference gradients at all quadrature points of the given face, component j of point q at gradients[j*facePoints()+q]
+      void evaluateFaceGradient (int face, const R* coefficients, R* gradients) const
+      {
+        std::array<const R*,d> matrices;
+        std::array<std::size_t,d> rows;
+        for (int i=0; i<d; i++)
+          {
+            for (int j=0; j<d; j++)
+              setFace(matrices,rows,face,j,i==j);
+            apply(coefficients,gradients+i*_face_points,matrices,rows,false);
+          }
+      }
+
+      //! \brief add the values at all quadrature points of the given face tested against all basis functions to the residual
+      void integrateFace (int face, const R* values, R* residual) const
+      {
+        std::array<const R*,d> matrices;
+        std::array<std::size_t,d> rows;
+        for (int j=0; j<d; j++)
+          setFace(matrices,rows,face,j,false);
+        apply(values,residual,matrices,rows,true);
+      }
+
+      //! \brief add the vectors at all quadrature points of the given face tested against the reference gradients of all basis functions to the residual
+      void integrateFaceGradient (int face, const R* vectors, R* residual) const
+      {
+        std::array<const R*,d> matrices;
+        std::array<std::size_t,d> rows;
+        for (int i=0; i<d; i++)
+          {
+            for (int j=0; j<d; j++)
+              setFace(matrices,rows,face,j,i==j);
+            apply(vectors+i*_face_points,residual,matrices,rows,true);
+          }
+      }
+
+    private:
+
+      void setVolume (std::array<const R*,d>& matrices, std::array<std::size_t,d>& rows, int j, bool derivative) const
+      {
+        matrices[j] = derivative ? _derivatives.data() : _values.data();
+        rows[j] = _m;
+      }
+
+      void setFace (std::array<const R*,d>& matrices, std::array<std::size_t,d>& rows, int face, int j, bool derivative) const
+      {
+        if (j==face/2)
+          {
+            matrices[j] = derivative ? _face_derivatives[face%2].data() : _face_values[face%2].data();
+            rows[j] = 1;
+          }
+        else
+          setVolume(matrices,rows,j,derivative);
+      }
+
+      // Applies the matrix (rows x cols) or its transpose to direction j of a tensor with
+      // pre entries in the directions before and post entries in the directions after j.
+      static void contract (const R* in, R* out, const R* matrix, std::size_t rows, std::size_t cols,
+                            bool transpose, std::size_t pre, std::size_t post)
+      {
+        const std::size_t in_size = transpose ? rows : cols;
+        const std::size_t out_size = transpose ? cols : rows;
+        const std::size_t out_stride = transpose ? 1 : cols;
+        const std::size_t in_stride = transpose ? cols : 1;
+        for (std::size_t s=0; s<post; s++)
+          for (std::size_t o=0; o<out_size; o++)
+            {
+              R* target = out + pre*(o + out_size*s);
+              std::fill(target,target+pre,R(0));
+              for (std::size_t i=0; i<in_size; i++)
+                {
+                  const R a = matrix[o*out_stride + i*in_stride];
+                  const R* source = in + pre*(i + in_size*s);
+                  for (std::size_t p=0; p<pre; p++)
+                    target[p] += a*source[p];
+                }
+            }
+      }
+
+      // Contracts the tensor direction by direction. Evaluation maps the (k+1)^d coefficients
+      // to the points, integration applies the transposed matrices and adds to the output.
+      void apply (const R* in, R* out, const std::array<const R*,d>& matrices,
+                  const std::array<std::size_t,d>& rows, bool transpose) const
+      {
+        static thread_local std::vector<R> buffers[2];
+        const std::size_t capacity = std::max(_basis_size,_points);
+        buffers[0].resize(capacity);
+        buffers[1].resize(capacity);
+
+        std::array<std::size_t,d> shape;
+        for (int j=0; j<d; j++)
+          shape[j] = transpose ? rows[j] : _n;
+        const R* source = in;
+        for (int j=0; j<d; j++)
+          {
+            std::size_t pre = 1, post = 1;
+            for (int l=0; l<j; l++) pre *= shape[l];
+            for (int l=j+1; l<d; l++) post *= shape[l];
+            R* target = buffers[j%2].data();
+            contract(source,target,matrices[j],rows[j],_n,transpose,pre,post);
+            shape[j] = transpose ? _n : rows[j];
+            source = target;
+          }
+
+        std::size_t size = 1;
+        for (int j=0; j<d; j++) size *= shape[j];
+        if (transpose)
+          for (std::size_t i=0; i<size; i++)
+            out[i] += source[i];
+        else
+          std::copy(source,source+size,out);
+      }
+
+      std::size_t _n;
+      std::size_t _m;
+      std::size_t _basis_size;
+      std::size_t _points;
+      std::size_t _face_points;
+      std::vector<D> _positions;
+      std::vector<D> _weights;
+      std::vector<R> _values;
+      std::vector<R> _derivatives;
+      std::array<std::vector<R>,2> _face_values;
+      std::array<std::vector<R>,2> _face_derivatives;
+    };
+
+    //! \brief create the sum factorization kernel of a tensor product local basis type
+    template<typename LocalBasis>
+    SumFactorizationKernel<typename LocalBasis::Traits::DomainFieldType,
+                           typename LocalBasis::Traits::RangeFieldType,
+                           LocalBasis::Traits::dimDomain>
+    makeSumFactorizationKernel (int quadrature_order)
+    {
+      static_assert(TensorProductPolynomials<LocalBasis>::isTensorProduct,
+                    "sum factorization requires a tensor product local basis");
+      return { TensorProductPolynomials<LocalBasis>(), quadrature_order };
+    }
+
+    //! \brief create the sum factorization kernel of a tensor product local basis
+    template<typename LocalBasis>
+    SumFactorizationKernel<typename LocalBasis::Traits::DomainFieldType,
+                           typename LocalBasis::Traits::RangeFieldType,
+                           LocalBasis::Traits::dimDomain>
+    makeSumFactorizationKernel (const LocalBasis&, int quadrature_order)
+    {
+      return makeSumFactorizationKernel<LocalBasis>(quadrature_order);
+    }
+
+  }
+}
+
+#endif // DUNE_PDELAB_FINITEELEMENT_SUMFACTORIZATION_HH
@@ -98,15 +98,16 @@ namespace Dune {
 
       //! evaluate the function
       /**
-       * \tparam I Type of intersection
+       * \tparam I      Type of intersection
+       * \tparam cached Whether the intersection geometry is cached
        *
        * \param ig IntersectionGeometry of this boundary intersection.
        * \param x  Position in local coordinates where to evaluate.
        * \param y  The resulting value.
        */
-      template<typename I>
+      template<typename I, bool cached>
       inline void
-      evaluate(const IntersectionGeometry<I>& ig,
+      evaluate(const IntersectionGeometry<I,cached>& ig,
                const typename Traits::DomainType& x,
                typename Traits::RangeType& y) const
       {
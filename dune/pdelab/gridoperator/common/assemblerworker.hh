@@ -0,0 +1,454 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_ASSEMBLERWORKER_HH
+#define DUNE_PDELAB_GRIDOPERATOR_COMMON_ASSEMBLERWORKER_HH
+
+#include <tuple>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/pdelab/common/geometrycache.hh>
+#include <dune/pdelab/common/geometrywrapper.hh>
+#include <dune/pdelab/common/intersectiontype.hh>
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+#include <dune/pdelab/gridoperator/common/meshtopologycache.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+    /** \addtogroup GridOperator
+     *  \{
+     */
+
+    //! The assembly of individual cells shared by the global assemblers.
+    /**
+     * An AssemblerWorker owns a private set of local function spaces and index caches
+     * and drives a single local assembler engine through the assembly of individual
+     * cells and the intersections visited from them. DefaultAssembler uses a single
+     * worker, while threaded assemblers create one worker for each thread and hand it
+     * a private copy of the engine.
+     *
+     * The worker neither calls preAssembly() nor postAssembly() on the engine, this
+     * is the responsibility of the global assembler.
+     *
+     * If the worker is given a MeshTopologyCache, it takes the classification of the
+     * intersections, the decision which side visits a skeleton face and the outside cells
+     * from the cache. It does not traverse the intersections of cells without any
+     * intersections of interest to the engine and only dereferences the intersection
+     * iterator for faces that are actually assembled. If geometry_caching is true and the worker is given a
+     * GeometryCache, the geometries of the cells and intersections handed to the engine
+     * take their jacobians and integration elements from the cache. Otherwise, the engine
+     * sees the geometries of the grid.
+     *
+     * \tparam GFSU GridFunctionSpace for ansatz functions
+     * \tparam GFSV GridFunctionSpace for test functions
+     * \tparam CU   Constraints maps for the individual dofs (trial space)
+     * \tparam CV   Constraints maps for the individual dofs (test space)
+     * \tparam LAE  The local assembler engine
+     * \tparam geometry_caching Whether the geometries are wrapped in a CachedGeometry
+     */
+    template<typename GFSU, typename GFSV, typename CU, typename CV, typename LAE,
+             bool geometry_caching = false>
+    class AssemblerWorker
+    {
+
+    public:
+
+      using EntitySet = typename GFSU::Traits::EntitySet;
+      using Element = typename EntitySet::Element;
+      using Intersection = typename EntitySet::Intersection;
+
+      typedef LocalFunctionSpace<GFSU, TrialSpaceTag> LFSU;
+      typedef LocalFunctionSpace<GFSV, TestSpaceTag> LFSV;
+      typedef LFSIndexCache<LFSU,CU> LFSUCache;
+      typedef LFSIndexCache<LFSV,CV> LFSVCache;
+      typedef MeshTopologyCache<EntitySet> Topology;
+      typedef GeometryCache<EntitySet> Geometries;
+      typedef ElementGeometry<Element,geometry_caching> EG;
+      typedef IntersectionGeometry<Intersection,geometry_caching> IG;
+
+      /**
+       * \param topology    An optional cache of the mesh topology, which must have been built
+       *                    for the entity set of gfsu and must outlive the worker.
+       * \param geometries  An optional cache of the cell and intersection geometries, with the
+       *                    same requirements as the topology. It is only used if
+       *                    geometry_caching is true.
+       */
+      AssemblerWorker(const GFSU& gfsu, const GFSV& gfsv, const CU& cu, const CV& cv, LAE& assembler_engine,
+                      const Topology* topology = nullptr, Geometries* geometries = nullptr)
+        : _entity_set(gfsu.entitySet())
+        , _engine(assembler_engine)
+        , _topology(topology)
+        , _geometries(geometry_caching ? geometries : nullptr)
+        , _lfsu(gfsu)
+        , _lfsv(gfsv)
+        , _lfsun(gfsu)
+        , _lfsvn(gfsv)
+        , _needs_constraints_caching(assembler_engine.needsConstraintsCaching(cu,cv))
+        , _lfsu_cache(_lfsu,cu,_needs_constraints_caching)
+        , _lfsv_cache(_lfsv,cv,_needs_constraints_caching)
+        , _lfsun_cache(_lfsun,cu,_needs_constraints_caching)
+        , _lfsvn_cache(_lfsvn,cv,_needs_constraints_caching)
+        , _require_uv_skeleton(assembler_engine.requireUVSkeleton())
+        , _require_v_skeleton(assembler_engine.requireVSkeleton())
+        , _require_uv_boundary(assembler_engine.requireUVBoundary())
+        , _require_v_boundary(assembler_engine.requireVBoundary())
+        , _require_uv_processor(assembler_engine.requireUVBoundary())
+        , _require_v_processor(assembler_engine.requireVBoundary())
+        , _require_uv_post_skeleton(assembler_engine.requireUVVolumePostSkeleton())
+        , _require_v_post_skeleton(assembler_engine.requireVVolumePostSkeleton())
+        , _require_skeleton_two_sided(assembler_engine.requireSkeletonTwoSided())
+      {}
+
+      AssemblerWorker(const AssemblerWorker&) = delete;
+      AssemblerWorker& operator=(const AssemblerWorker&) = delete;
+
+      //! The engine driven by this worker.
+      LAE& engine()
+      {
+        return _engine;
+      }
+
+      //! Assembles all contributions of a single cell and the intersections visited from it.
+      void assemble(const Element& element)
+      {
+        auto& index_set = _entity_set.indexSet();
+
+        // The cached topology of the cell, if available
+        const typename Topology::Cell* cell = _topology ? &_topology->cell(element) : nullptr;
+
+        // Compute unique id
+        auto ids = cell ? 0 : index_set.uniqueIndex(element);
+
+        EG eg(element,_geometries ? &_geometries->element(element) : nullptr);
+
+        if(_engine.assembleCell(eg))
+          return;
+
+        // Bind local test function space to element
+        _lfsv.bind( element );
+        _lfsv_cache.update();
+
+        // Notify assembler engine about bind
+        _engine.onBindLFSV(eg,_lfsv_cache);
+
+        // Volume integration
+        _engine.assembleVVolume(eg,_lfsv_cache);
+
+        // Bind local trial function space to element
+        _lfsu.bind( element );
+        _lfsu_cache.update();
+
+        // Notify assembler engine about bind
+        _engine.onBindLFSUV(eg,_lfsu_cache,_lfsv_cache);
+
+        // Load coefficients of local functions
+        _engine.loadCoefficientsLFSUInside(_lfsu_cache);
+
+        // Volume integration
+        _engine.assembleUVVolume(eg,_lfsu_cache,_lfsv_cache);
+
+        // Skip if no intersection iterator is needed
+        if (requireIntersections(cell))
+          {
+            // Traverse intersections
+            unsigned int intersection_index = 0;
+            const auto end_intersection = _entity_set.iend(element);
+            for(auto intersection_it = _entity_set.ibegin(element);
+                intersection_it != end_intersection;
+                ++intersection_it, ++intersection_index)
+              {
+
+                IntersectionType intersection_type;
+                Element outside_element;
+                bool visit_face;
+                if (cell)
+                  {
+                    // Take the classification from the cache, skip faces that are not
+                    // assembled from this cell without dereferencing the iterator and
+                    // obtain the outside cell from its cached seed
+                    const auto& face = _topology->face(*cell,intersection_index);
+                    if (!requireFace(face))
+                      continue;
+                    intersection_type = face.type;
+                    visit_face = face.visit || _require_skeleton_two_sided;
+                    if (intersection_type == IntersectionType::skeleton ||
+                        intersection_type == IntersectionType::periodic)
+                      outside_element = _topology->element(face.neighbor);
+                  }
+
+                const auto& intersection = *intersection_it;
+
+                if (!cell)
+                  {
+                    auto intersection_data = classifyIntersection(_entity_set,intersection);
+                    intersection_type = std::get<0>(intersection_data);
+                    outside_element = std::move(std::get<1>(intersection_data));
+                    // compute unique id for neighbor and visit face if id is bigger
+                    visit_face = _require_skeleton_two_sided ||
+                      ((_require_uv_skeleton || _require_v_skeleton) &&
+                       (intersection_type == IntersectionType::skeleton ||
+                        intersection_type == IntersectionType::periodic) &&
+                       ids > index_set.uniqueIndex(outside_element));
+                  }
+
+                IG ig(intersection,intersection_index,
+                      _geometries ? &_geometries->intersection(element,intersection_index) : nullptr);
+
+                switch (intersection_type)
+                  {
+                  case IntersectionType::skeleton:
+                  case IntersectionType::periodic:
+                    if (_require_uv_skeleton || _require_v_skeleton)
+                      {
+                        // unique vist of intersection
+                        if (visit_face)
+                          {
+                            // Bind local test space to neighbor element
+                            _lfsvn.bind(outside_element);
+                            _lfsvn_cache.update();
+
+                            // Notify assembler engine about binds
+                            _engine.onBindLFSVOutside(ig,_lfsv_cache,_lfsvn_cache);
+
+                            // Skeleton integration
+                            _engine.assembleVSkeleton(ig,_lfsv_cache,_lfsvn_cache);
+
+                            if(_require_uv_skeleton){
+
+                              // Bind local trial space to neighbor element
+                              _lfsun.bind(outside_element);
+                              _lfsun_cache.update();
+
+                              // Notify assembler engine about binds
+                              _engine.onBindLFSUVOutside(ig,
+                                                         _lfsu_cache,_lfsv_cache,
+                                                         _lfsun_cache,_lfsvn_cache);
+
+                              // Load coefficients of local functions
+                              _engine.loadCoefficientsLFSUOutside(_lfsun_cache);
+
+                              // Skeleton integration
+                              _engine.assembleUVSkeleton(ig,_lfsu_cache,_lfsv_cache,_lfsun_cache,_lfsvn_cache);
+
+                              // Notify assembler engine about unbinds
+                              _engine.onUnbindLFSUVOutside(ig,
+                                                           _lfsu_cache,_lfsv_cache,
+                                                           _lfsun_cache,_lfsvn_cache);
+                            }
+
+                            // Notify assembler engine about unbinds
+                            _engine.onUnbindLFSVOutside(ig,_lfsv_cache,_lfsvn_cache);
+                          }
+                      }
+                    break;
+
+                  case IntersectionType::boundary:
+                    if(_require_uv_boundary || _require_v_boundary )
+                      {
+
+                        // Boundary integration
+                        _engine.assembleVBoundary(ig,_lfsv_cache);
+
+                        if(_require_uv_boundary){
+                          // Boundary integration
+                          _engine.assembleUVBoundary(ig,_lfsu_cache,_lfsv_cache);
+                        }
+                      }
+                    break;
+
+                  case IntersectionType::processor:
+                    if(_require_uv_processor || _require_v_processor )
+                      {
+
+                        // Processor integration
+                        _engine.assembleVProcessor(ig,_lfsv_cache);
+
+                        if(_require_uv_processor){
+                          // Processor integration
+                          _engine.assembleUVProcessor(ig,_lfsu_cache,_lfsv_cache);
+                        }
+                      }
+                    break;
+                  } // switch
+
+              } // iit
+          } // do skeleton
+
+        if(_require_uv_post_skeleton || _require_v_post_skeleton){
+          // Volume integration
+          _engine.assembleVVolumePostSkeleton(eg,_lfsv_cache);
+
+          if(_require_uv_post_skeleton){
+            // Volume integration
+            _engine.assembleUVVolumePostSkeleton(eg,_lfsu_cache,_lfsv_cache);
+          }
+        }
+
+        // Notify assembler engine about unbinds
+        _engine.onUnbindLFSUV(eg,_lfsu_cache,_lfsv_cache);
+
+        // Notify assembler engine about unbinds
+        _engine.onUnbindLFSV(eg,_lfsv_cache);
+      }
+
+      //! Returns the cells whose contributions depend on the coefficients of a set of marked cells.
+      /**
+       * Besides the marked cells themselves, these are the cells visiting a skeleton face
+       * shared with a marked cell if the engine assembles skeleton terms depending on the
+       * coefficients. Only the intersections of the marked cells are traversed, or none at
+       * all if the worker has a MeshTopologyCache. Every cell is contained once, the marked
+       * cells in traversal order followed by their neighbors.
+       *
+       * \param marked  A flag for every cell, indexed by the index set of the entity set.
+       */
+      std::vector<Element> affectedCells(const std::vector<bool>& marked) const
+      {
+        auto& index_set = _entity_set.indexSet();
+        if (marked.size() != std::size_t(_entity_set.size(0)))
+          DUNE_THROW(Dune::RangeError,"The marking of cells does not match the size of the entity set");
+
+        std::vector<Element> affected;
+
+        if (_topology)
+          {
+            // Take the cells and their neighbors from the cache
+            std::vector<std::size_t> indices;
+            for (std::size_t index : _topology->traversalOrder())
+              if (marked[index])
+                indices.push_back(index);
+
+            if (_require_uv_skeleton)
+              {
+                // the cells already contained in the list
+                std::vector<bool> contained(marked);
+                const std::size_t marked_cells = indices.size();
+                for (std::size_t c = 0; c < marked_cells; ++c)
+                  {
+                    const auto& cell = _topology->cell(indices[c]);
+                    for (unsigned int f = 0; f < cell.end - cell.begin; ++f)
+                      {
+                        // the neighbor visits the face if this cell does not
+                        const auto& face = _topology->face(cell,f);
+                        if ((face.type == IntersectionType::skeleton || face.type == IntersectionType::periodic) &&
+                            (_require_skeleton_two_sided || !face.visit) &&
+                            !contained[face.neighbor])
+                          {
+                            contained[face.neighbor] = true;
+                            indices.push_back(face.neighbor);
+                          }
+                      }
+                  }
+              }
+
+            affected.reserve(indices.size());
+            for (std::size_t index : indices)
+              affected.push_back(_topology->element(index));
+            return affected;
+          }
+
+        for (const auto& element : elements(_entity_set))
+          if (marked[index_set.index(element)])
+            affected.push_back(element);
+        if (!_require_uv_skeleton)
+          return affected;
+
+        // the cells already contained in the list
+        std::vector<bool> contained(marked);
+        const std::size_t marked_cells = affected.size();
+        for (std::size_t c = 0; c < marked_cells; ++c)
+          {
+            const Element element = affected[c];
+            const auto ids = index_set.uniqueIndex(element);
+
+            for (const auto& intersection : intersections(_entity_set,element))
+              {
+                auto intersection_data = classifyIntersection(_entity_set,intersection);
+                const IntersectionType intersection_type = std::get<0>(intersection_data);
+                if (intersection_type != IntersectionType::skeleton && intersection_type != IntersectionType::periodic)
+                  continue;
+                const auto& outside_element = std::get<1>(intersection_data);
+                const auto outside_index = index_set.index(outside_element);
+                if ((_require_skeleton_two_sided || index_set.uniqueIndex(outside_element) > ids) &&
+                    !contained[outside_index])
+                  {
+                    contained[outside_index] = true;
+                    affected.push_back(outside_element);
+                  }
+              }
+          }
+        return affected;
+      }
+
+    private:
+
+      //! Whether a cached face is assembled from the cell it belongs to.
+      bool requireFace(const typename Topology::Face& face) const
+      {
+        switch (face.type)
+          {
+          case IntersectionType::skeleton:
+          case IntersectionType::periodic:
+            return (_require_uv_skeleton || _require_v_skeleton) &&
+              (face.visit || _require_skeleton_two_sided);
+          case IntersectionType::boundary:
+            return _require_uv_boundary || _require_v_boundary;
+          case IntersectionType::processor:
+            return _require_uv_processor || _require_v_processor;
+          }
+        return false;
+      }
+
+      //! Whether the intersections of a cell have to be traversed.
+      bool requireIntersections(const typename Topology::Cell* cell) const
+      {
+        const bool skeleton = _require_uv_skeleton || _require_v_skeleton;
+        const bool boundary = _require_uv_boundary || _require_v_boundary;
+        const bool processor = _require_uv_processor || _require_v_processor;
+        if (!cell)
+          return skeleton || boundary || processor;
+        return
+          (skeleton && (_require_skeleton_two_sided ? cell->has_skeleton : cell->has_visited_skeleton)) ||
+          (boundary && cell->has_boundary) ||
+          (processor && cell->has_processor);
+      }
+
+      EntitySet _entity_set;
+      LAE& _engine;
+      const Topology* _topology;
+      Geometries* _geometries;
+
+      // local function spaces in local cell
+      LFSU _lfsu;
+      LFSV _lfsv;
+      // local function spaces in neighbor
+      LFSU _lfsun;
+      LFSV _lfsvn;
+
+      const bool _needs_constraints_caching;
+
+      LFSUCache _lfsu_cache;
+      LFSVCache _lfsv_cache;
+      LFSUCache _lfsun_cache;
+      LFSVCache _lfsvn_cache;
+
+      const bool _require_uv_skeleton;
+      const bool _require_v_skeleton;
+      const bool _require_uv_boundary;
+      const bool _require_v_boundary;
+      const bool _require_uv_processor;
+      const bool _require_v_processor;
+      const bool _require_uv_post_skeleton;
+      const bool _require_v_post_skeleton;
+      const bool _require_skeleton_two_sided;
+
+    };
+
+    //! \} group GridOperator
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDOPERATOR_COMMON_ASSEMBLERWORKER_HH
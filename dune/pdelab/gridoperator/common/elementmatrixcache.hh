@@ -0,0 +1,215 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_ELEMENTMATRIXCACHE_HH
+#define DUNE_PDELAB_GRIDOPERATOR_COMMON_ELEMENTMATRIXCACHE_HH
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace Dune{
+  namespace PDELab{
+
+    /** \addtogroup GridOperator
+     *  \{
+     */
+
+    //! The local matrices of all cells and faces of a linear operator, applied element by element.
+    /**
+     * An ElementMatrixCache stores the dense local matrices of the last jacobian assembly
+     * together with the container indices of the degrees of freedom they couple. Applying
+     * the operator then amounts to gathering the coefficients of each block, a dense
+     * matrix-vector product and scattering the result, which is much cheaper than calling
+     * the local operator again and does not require the sparsity pattern of a global matrix.
+     *
+     * All values are kept in a single contiguous arena in the order of assembly, and the
+     * container indices of each cell are stored only once, no matter how many blocks refer
+     * to them. The local matrices are stored column by column, like LocalMatrix.
+     *
+     * \tparam RowIndex The container index type of the test space
+     * \tparam ColIndex The container index type of the trial space
+     * \tparam T        The field type of the local matrices
+     */
+    template<typename RowIndex, typename ColIndex, typename T>
+    class ElementMatrixCache
+    {
+
+      static std::size_t none()
+      {
+        return std::numeric_limits<std::size_t>::max();
+      }
+
+      struct Block
+      {
+        std::size_t values;
+        std::size_t rows;
+        std::size_t cols;
+        std::size_t row_indices;
+        std::size_t col_indices;
+      };
+
+    public:
+
+      ElementMatrixCache()
+        : _valid(false)
+        , _weight(0)
+      {}
+
+      //! Returns whether the cache holds the local matrices of a complete assembly with the given weight.
+      bool valid(T weight) const
+      {
+        return _valid && _weight == weight;
+      }
+
+      //! Discards all stored local matrices.
+      void invalidate()
+      {
+        _valid = false;
+        _values.clear();
+        _values.shrink_to_fit();
+        _blocks.clear();
+        _blocks.shrink_to_fit();
+        _row_indices.clear();
+        _row_indices.shrink_to_fit();
+        _col_indices.clear();
+        _col_indices.shrink_to_fit();
+      }
+
+      //! Discards all stored local matrices and prepares the cache for an assembly with the given weight.
+      void beginRecording(T weight)
+      {
+        invalidate();
+        _weight = weight;
+        _cell_rows.clear();
+        _cell_cols.clear();
+      }
+
+      //! Stores the container indices of a cell, unless they have been stored before.
+      /**
+       * \param cell The index of the cell in the entity set of the trial space.
+       */
+      template<typename LFSUC, typename LFSVC>
+      void recordCell(std::size_t cell, const LFSUC& lfsu_cache, const LFSVC& lfsv_cache)
+      {
+        if (cell >= _cell_rows.size())
+          {
+            _cell_rows.resize(cell + 1,none());
+            _cell_cols.resize(cell + 1,none());
+          }
+        if (_cell_rows[cell] == none())
+          {
+            _cell_rows[cell] = _row_indices.size();
+            for (std::size_t i = 0; i < lfsv_cache.size(); ++i)
+              _row_indices.push_back(lfsv_cache.containerIndex(i));
+          }
+        if (_cell_cols[cell] == none())
+          {
+            _cell_cols[cell] = _col_indices.size();
+            for (std::size_t j = 0; j < lfsu_cache.size(); ++j)
+              _col_indices.push_back(lfsu_cache.containerIndex(j));
+          }
+      }
+
+      //! Stores the local matrix coupling the test functions of one cell with the trial functions of another one.
+      /**
+       * Both cells must have been recorded with recordCell(). Matrices without nonzero
+       * entries are skipped.
+       */
+      template<typename M>
+      void addBlock(std::size_t row_cell, std::size_t col_cell, M& local_matrix)
+      {
+        const std::size_t rows = local_matrix.nrows();
+        const std::size_t cols = local_matrix.ncols();
+        bool nonzero = false;
+        for (auto it = local_matrix.begin(); it != local_matrix.end(); ++it)
+          nonzero |= (*it != 0.0);
+        if (!nonzero)
+          return;
+
+        Block block;
+        block.values = _values.size();
+        block.rows = rows;
+        block.cols = cols;
+        block.row_indices = _cell_rows[row_cell];
+        block.col_indices = _cell_cols[col_cell];
+        _blocks.push_back(block);
+
+        _values.resize(_values.size() + rows * cols, T(0));
+        T* values = _values.data() + block.values;
+        for (auto it = local_matrix.begin(); it != local_matrix.end(); ++it)
+          values[it.col() * rows + it.row()] = *it;
+      }
+
+      //! Marks the cache as complete and releases the temporary data of the recording.
+      void finishRecording()
+      {
+        _cell_rows.clear();
+        _cell_rows.shrink_to_fit();
+        _cell_cols.clear();
+        _cell_cols.shrink_to_fit();
+        _values.shrink_to_fit();
+        _blocks.shrink_to_fit();
+        _row_indices.shrink_to_fit();
+        _col_indices.shrink_to_fit();
+        _valid = true;
+      }
+
+      //! Adds the product of the stored operator and x to y.
+      template<typename X, typename Y>
+      void apply(const X& x, Y& y) const
+      {
+        std::vector<T> x_local, y_local;
+        for (const auto& block : _blocks)
+          {
+            x_local.resize(block.cols);
+            y_local.assign(block.rows,T(0));
+            const ColIndex* col_indices = _col_indices.data() + block.col_indices;
+            for (std::size_t j = 0; j < block.cols; ++j)
+              x_local[j] = x[col_indices[j]];
+
+            const T* values = _values.data() + block.values;
+            for (std::size_t j = 0; j < block.cols; ++j, values += block.rows)
+              {
+                const T x_j = x_local[j];
+                for (std::size_t i = 0; i < block.rows; ++i)
+                  y_local[i] += values[i] * x_j;
+              }
+
+            const RowIndex* row_indices = _row_indices.data() + block.row_indices;
+            for (std::size_t i = 0; i < block.rows; ++i)
+              y[row_indices[i]] += y_local[i];
+          }
+      }
+
+      //! Returns the number of stored local matrices.
+      std::size_t blocks() const
+      {
+        return _blocks.size();
+      }
+
+      //! Returns the number of stored matrix entries.
+      std::size_t entries() const
+      {
+        return _values.size();
+      }
+
+    private:
+
+      bool _valid;
+      T _weight;
+      std::vector<T> _values;
+      std::vector<Block> _blocks;
+      std::vector<RowIndex> _row_indices;
+      std::vector<ColIndex> _col_indices;
+      // offsets of the container indices of each cell during recording
+      std::vector<std::size_t> _cell_rows;
+      std::vector<std::size_t> _cell_cols;
+
+    };
+
+    //! \} group GridOperator
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDOPERATOR_COMMON_ELEMENTMATRIXCACHE_HH
@@ -0,0 +1,186 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_GLOBALASSEMBLERBASE_HH
+#define DUNE_PDELAB_GRIDOPERATOR_COMMON_GLOBALASSEMBLERBASE_HH
+
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/pdelab/common/geometrycache.hh>
+#include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
+#include <dune/pdelab/gridoperator/common/assemblerworker.hh>
+#include <dune/pdelab/gridoperator/common/meshtopologycache.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+    /** \addtogroup GridOperator
+     *  \{
+     */
+
+    //! Common functionality of the global assemblers driving an AssemblerWorker.
+    /**
+     * GlobalAssemblerBase stores the function spaces and constraints, manages the optional
+     * caches of the mesh topology and the geometries and implements the reassembly of the
+     * cells affected by a set of marked cells. The derived assemblers implement the
+     * assembly of all cells, e.g. on multiple threads, and extend update() if they cache
+     * further information about the grid.
+     *
+     * \tparam GFSU GridFunctionSpace for ansatz functions
+     * \tparam GFSV GridFunctionSpace for test functions
+     * \tparam CU   Constraints maps for the individual dofs (trial space)
+     * \tparam CV   Constraints maps for the individual dofs (test space)
+     * \tparam geometry_caching Whether the cell and intersection geometries are cached across
+     *                          assemblies, see GeometryCache. If false, the local operators see
+     *                          the geometries of the grid.
+     */
+    template<typename GFSU, typename GFSV, typename CU, typename CV, bool geometry_caching = false>
+    class GlobalAssemblerBase
+    {
+    public:
+
+      using EntitySet = typename GFSU::Traits::EntitySet;
+
+      GlobalAssemblerBase (const GFSU& gfsu_, const GFSV& gfsv_, const CU& cu_, const CV& cv_)
+        : gfsu(gfsu_)
+        , gfsv(gfsv_)
+        , cu(cu_)
+        , cv(cv_)
+        , _topology_caching(false)
+      { }
+
+      GlobalAssemblerBase (const GFSU& gfsu_, const GFSV& gfsv_)
+        : gfsu(gfsu_)
+        , gfsv(gfsv_)
+        , cu()
+        , cv()
+        , _topology_caching(false)
+      { }
+
+      //! Get the trial grid function space
+      const GFSU& trialGridFunctionSpace() const
+      {
+        return gfsu;
+      }
+
+      //! Get the test grid function space
+      const GFSV& testGridFunctionSpace() const
+      {
+        return gfsv;
+      }
+
+      //! Enables or disables caching of the mesh topology across assemblies, see MeshTopologyCache.
+      void setTopologyCaching(bool enable)
+      {
+        _topology_caching = enable;
+        if (!enable)
+          _topology.invalidate();
+      }
+
+      //! Whether the mesh topology is cached across assemblies.
+      bool topologyCaching() const
+      {
+        return _topology_caching;
+      }
+
+      //! Whether the cell and intersection geometries are cached across assemblies.
+      static constexpr bool geometryCaching()
+      {
+        return geometry_caching;
+      }
+
+      //! Notifies the assembler about changes of the grid or the function spaces.
+      /**
+       * Discards the cached mesh topology and geometries, which are rebuilt on the next assembly.
+       */
+      void update()
+      {
+        _topology.invalidate();
+        _geometries.invalidate();
+      }
+
+      //! Reassembles the cells affected by changes of the coefficients on a set of marked cells.
+      /**
+       * Only the marked cells and the cells visiting a skeleton face shared with them are
+       * assembled, see AssemblerWorker::affectedCells(). This is used to update containers
+       * in place with engines in partial assembly mode, see GridOperator::residual(x,r,marked).
+       * The affected cells are few by assumption, so they are assembled on the calling thread.
+       */
+      template<class LocalAssemblerEngine>
+      void assemble(LocalAssemblerEngine & assembler_engine, const std::vector<bool>& marked) const
+      {
+        typedef AssemblerWorker<GFSU,GFSV,CU,CV,LocalAssemblerEngine,geometry_caching> Worker;
+
+        // Notify assembler engine about oncoming assembly
+        assembler_engine.preAssembly();
+
+        auto entity_set = gfsu.entitySet();
+
+        Worker worker(gfsu,gfsv,cu,cv,assembler_engine,topology(entity_set),geometries(entity_set));
+
+        // Traverse the affected cells
+        for (const auto& element : worker.affectedCells(marked))
+          worker.assemble(element);
+
+        // Notify assembler engine that assembly is finished
+        assembler_engine.postAssembly(gfsu,gfsv);
+
+      }
+
+    protected:
+
+      //! Returns the cached topology if caching is enabled, building it if necessary.
+      const MeshTopologyCache<EntitySet>* topology(const EntitySet& entity_set) const
+      {
+        if (!_topology_caching)
+          return nullptr;
+        if (!_topology.valid())
+          _topology.update(entity_set);
+        else if (_topology.size() != std::size_t(entity_set.size(0)))
+          DUNE_THROW(InvalidStateException,"The grid has changed since the mesh topology was cached, call GridOperator::update()");
+        return &_topology;
+      }
+
+      //! Returns the geometry cache if caching is enabled, allocating it if necessary.
+      GeometryCache<EntitySet>* geometries(const EntitySet& entity_set) const
+      {
+        if (!geometry_caching)
+          return nullptr;
+        if (!_geometries.valid())
+          _geometries.update(entity_set);
+        else if (_geometries.size() != std::size_t(entity_set.size(0)))
+          DUNE_THROW(InvalidStateException,"The grid has changed since the geometries were cached, call GridOperator::update()");
+        return &_geometries;
+      }
+
+      /* global function spaces */
+      const GFSU& gfsu;
+      const GFSV& gfsv;
+
+      typename std::conditional<
+        std::is_same<CU,EmptyTransformation>::value,
+        const CU,
+        const CU&
+        >::type cu;
+      typename std::conditional<
+        std::is_same<CV,EmptyTransformation>::value,
+        const CV,
+        const CV&
+        >::type cv;
+
+    private:
+
+      bool _topology_caching;
+      mutable MeshTopologyCache<EntitySet> _topology;
+      mutable GeometryCache<EntitySet> _geometries;
+
+    };
+
+    //! \} group GridOperator
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDOPERATOR_COMMON_GLOBALASSEMBLERBASE_HH
@@ -0,0 +1,253 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_JACOBIANSCATTERMAP_HH
+#define DUNE_PDELAB_GRIDOPERATOR_COMMON_JACOBIANSCATTERMAP_HH
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/std/type_traits.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+    /** \addtogroup GridOperator
+     *  \{
+     */
+
+#ifndef DOXYGEN
+    namespace Impl {
+
+      template<typename M>
+      using MatrixEntryFinder = decltype(std::declval<M&>().find(std::declval<const typename M::RowIndex&>(),
+                                                                 std::declval<const typename M::ColIndex&>()));
+
+      template<typename M>
+      typename M::ElementType* findMatrixEntry(M& matrix, const typename M::RowIndex& ri, const typename M::ColIndex& ci, std::true_type)
+      {
+        return matrix.find(ri,ci);
+      }
+
+      template<typename M>
+      typename M::ElementType* findMatrixEntry(M& matrix, const typename M::RowIndex& ri, const typename M::ColIndex& ci, std::false_type)
+      {
+        return nullptr;
+      }
+
+      template<typename M>
+      using MatrixPatternGeneration = decltype(std::declval<const M&>().patternGeneration());
+
+      template<typename M>
+      std::size_t matrixPatternGeneration(const M& matrix, std::true_type)
+      {
+        return matrix.patternGeneration();
+      }
+
+      template<typename M>
+      std::size_t matrixPatternGeneration(const M& matrix, std::false_type)
+      {
+        return 0;
+      }
+
+    }
+#endif // DOXYGEN
+
+    //! Cached addresses of the matrix entries written by the cells and faces of a grid.
+    /**
+     * A JacobianScatterMap stores, for every cell and every face visited from it, the
+     * addresses of all entries of the matrix touched by the local matrix blocks of that
+     * cell or face. It is recorded during one assembly and afterwards allows to scatter
+     * local matrices directly into the value storage of the matrix, avoiding the search
+     * for the column indices of every single entry.
+     *
+     * The blocks of the faces are identified by the index of the intersection within the
+     * cell, so a recorded map can safely be used by assemblies that visit only a subset
+     * of the faces. Blocks that have not been recorded are reported as missing, and the
+     * caller has to fall back to the regular scatter.
+     *
+     * The map is keyed on the pattern generation of the matrix, which changes whenever the
+     * matrix container builds, copies or attaches its storage, so a map is never applied to
+     * a matrix whose entries have moved. Changes of the grid or the function spaces have to
+     * be announced explicitly via invalidate(), see GridOperator::update().
+     *
+     * \tparam EntitySet The entity set of the trial grid function space
+     * \tparam M         The matrix container. Scatter maps can only be recorded if it
+     *                   provides a method find(ri,ci) returning a pointer to an entry
+     *                   or nullptr and a method patternGeneration(), see supported.
+     */
+    template<typename EntitySet, typename M>
+    class JacobianScatterMap
+    {
+
+    public:
+
+      typedef typename M::ElementType ElementType;
+      typedef typename EntitySet::Element Element;
+
+      //! Whether the matrix container allows to record a scatter map.
+      static constexpr bool supported =
+        Std::is_detected<Impl::MatrixEntryFinder,M>::value &&
+        Std::is_detected<Impl::MatrixPatternGeneration,M>::value;
+
+      //! The addresses of the entries touched by one local matrix, in row-major order.
+      struct Block
+      {
+        std::size_t begin = std::numeric_limits<std::size_t>::max();
+        std::size_t rows = 0;
+        std::size_t cols = 0;
+
+        bool valid() const
+        {
+          return begin != std::numeric_limits<std::size_t>::max();
+        }
+      };
+
+      JacobianScatterMap()
+        : _valid(false)
+        , _generation(0)
+      {}
+
+      //! Whether the map has been recorded completely for the current pattern generation of the given matrix.
+      bool matches(const M& matrix) const
+      {
+        return _valid && _generation != 0 &&
+          _generation == Impl::matrixPatternGeneration(matrix,Supported());
+      }
+
+      //! Discards all recorded information.
+      void invalidate()
+      {
+        _valid = false;
+        _generation = 0;
+        _cells.clear();
+        _faces.clear();
+        _entries.clear();
+      }
+
+      //! Starts recording for the given matrix.
+      void beginRecording(const EntitySet& entity_set, M& matrix)
+      {
+        invalidate();
+        _entity_set = std::make_unique<EntitySet>(entity_set);
+        _generation = Impl::matrixPatternGeneration(matrix,Supported());
+        _cells.resize(entity_set.size(0));
+      }
+
+      //! Marks the map as complete, must be called after a successful recording assembly.
+      void finishRecording()
+      {
+        _valid = _generation != 0;
+      }
+
+      //! Starts recording the blocks of a cell.
+      void beginCell(const Element& element)
+      {
+        Cell& cell = _cells[index(element)];
+        cell.faces_begin = _faces.size();
+        cell.faces_end = _faces.size();
+      }
+
+      //! Records the block of a face visited from a cell.
+      /**
+       * The blocks sn, ns and nn of a face have to be recorded in this order.
+       */
+      template<typename View>
+      void recordFaceBlock(const Element& element, unsigned int intersection_index, int block, M& matrix, const View& view)
+      {
+        Cell& cell = _cells[index(element)];
+        if (block == 0)
+          {
+            _faces.emplace_back();
+            _faces.back().intersection_index = intersection_index;
+            cell.faces_end = _faces.size();
+          }
+        _faces.back().blocks[block] = recordBlock(matrix,view);
+      }
+
+      //! Records the block of a cell.
+      template<typename View>
+      void recordCellBlock(const Element& element, M& matrix, const View& view)
+      {
+        _cells[index(element)].volume = recordBlock(matrix,view);
+      }
+
+      //! Returns the block of a cell, which is invalid if it has not been recorded.
+      Block cellBlock(const Element& element) const
+      {
+        return _cells[index(element)].volume;
+      }
+
+      //! Returns block (0 = sn, 1 = ns, 2 = nn) of a face, which is invalid if it has not been recorded.
+      Block faceBlock(const Element& element, unsigned int intersection_index, int block) const
+      {
+        const Cell& cell = _cells[index(element)];
+        for (std::size_t f = cell.faces_begin; f < cell.faces_end; ++f)
+          if (_faces[f].intersection_index == intersection_index)
+            return _faces[f].blocks[block];
+        return Block();
+      }
+
+      //! The address of an entry of a block, nullptr if the entry is not contained in the matrix pattern.
+      ElementType* entry(const Block& block, std::size_t i, std::size_t j) const
+      {
+        return _entries[block.begin + i * block.cols + j];
+      }
+
+    private:
+
+      typedef std::integral_constant<bool,supported> Supported;
+
+      struct Cell
+      {
+        Block volume;
+        std::size_t faces_begin = 0;
+        std::size_t faces_end = 0;
+      };
+
+      struct Face
+      {
+        unsigned int intersection_index = 0;
+        Block blocks[3];
+      };
+
+      std::size_t index(const Element& element) const
+      {
+        return _entity_set->indexSet().index(element);
+      }
+
+      template<typename View>
+      Block recordBlock(M& matrix, const View& view)
+      {
+        Block block;
+        block.begin = _entries.size();
+        block.rows = view.N();
+        block.cols = view.M();
+        for (std::size_t i = 0; i < block.rows; ++i)
+          for (std::size_t j = 0; j < block.cols; ++j)
+            {
+              const auto& ri = view.rowIndexCache().containerIndex(i);
+              const auto& ci = view.colIndexCache().containerIndex(j);
+              _entries.push_back(Impl::findMatrixEntry(matrix,ri,ci,Supported()));
+            }
+        return block;
+      }
+
+      bool _valid;
+      std::unique_ptr<EntitySet> _entity_set;
+      std::size_t _generation;
+      std::vector<Cell> _cells;
+      std::vector<Face> _faces;
+      std::vector<ElementType*> _entries;
+
+    };
+
+    //! \} group GridOperator
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDOPERATOR_COMMON_JACOBIANSCATTERMAP_HH
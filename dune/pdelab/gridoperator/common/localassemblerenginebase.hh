@@ -4,6 +4,11 @@
 #ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_LOCALASSEMBLERENGINEBASE_HH
 #define DUNE_PDELAB_GRIDOPERATOR_COMMON_LOCALASSEMBLERENGINEBASE_HH
 
+#include <cstddef>
+#include <vector>
+
+#include <dune/pdelab/gridoperator/common/taskbuffers.hh>
+
 namespace Dune {
   namespace PDELab {
 
@@ -104,6 +109,39 @@ namespace Dune {
           return Partitions::interiorBorder;
         }
 
+        //! Returns whether copies of this engine may assemble disjoint sets of cells concurrently.
+        /**
+         * Threaded global assemblers copy-construct one engine per thread from the engine
+         * they are handed and only call preAssembly() and postAssembly() on the original one.
+         * Engines returning false are always run on a single thread.
+         */
+        bool supportsThreadedAssembly() const
+        {
+          return false;
+        }
+
+        //! Returns whether copies of this engine may assemble arbitrary sets of cells concurrently.
+        /**
+         * Task-based global assemblers do not prevent neighboring cells from being assembled
+         * at the same time. They copy-construct one engine per thread and call beginTaskAssembly()
+         * on each copy before the first cell. Once all threads have finished, every thread calls
+         * mergeTaskAssembly() of the original engine with all copies and its own part, before
+         * postAssembly() is called.
+         */
+        bool supportsTaskAssembly() const
+        {
+          return false;
+        }
+
+        //! Prepares a copy of the engine for task-based assembly, e.g. by redirecting its output to the buffers of the thread.
+        void beginTaskAssembly(TaskBuffers& buffers, std::size_t thread)
+        {}
+
+        //! Collects the given part of the results of the copies of the engine after task-based assembly.
+        template<typename Engine>
+        void mergeTaskAssembly(const std::vector<Engine*>& copies, std::size_t part, std::size_t parts)
+        {}
+
         //! @}
 
         //! @name Callbacks for LocalFunctionSpace binding and unbinding events
@@ -0,0 +1,143 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_LOCALCONTRIBUTIONCACHE_HH
+#define DUNE_PDELAB_GRIDOPERATOR_COMMON_LOCALCONTRIBUTIONCACHE_HH
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Dune{
+  namespace PDELab{
+
+    /** \addtogroup GridOperator
+     *  \{
+     */
+
+    //! The local vectors or matrices scattered by all cells and faces during the last assembly.
+    /**
+     * A LocalContributionCache keeps a copy of every local container an engine adds to a
+     * global container, identified by the cell and, for face contributions, the index of
+     * the intersection within the cell it is visited from and a block number (e.g. for the
+     * coupling blocks of a skeleton face). It allows to update a global container in place
+     * after the coefficients changed on a few cells: the engine reassembles the affected
+     * cells and exchange() turns each new local container into its difference to the
+     * stored one, so that only the change is added to the global container.
+     *
+     * The entries of a cell must only be accessed by the thread assembling the cell.
+     * The cache has to be rebuilt whenever the grid changes.
+     *
+     * \tparam EntitySet The entity set of the trial grid function space
+     * \tparam T         The field type of the local containers
+     */
+    template<typename EntitySet, typename T>
+    class LocalContributionCache
+    {
+
+    public:
+
+      typedef typename EntitySet::Element Element;
+
+      /**
+       * \param face_blocks The number of local containers stored for each face.
+       */
+      explicit LocalContributionCache(std::size_t face_blocks)
+        : _face_blocks(face_blocks)
+        , _valid(false)
+        , _size(0)
+      {}
+
+      //! Returns whether the cache holds the contributions of an assembly on an entity set with the same number of cells.
+      bool valid(const EntitySet& entity_set) const
+      {
+        return _valid && _size == entity_set.size(0);
+      }
+
+      //! Discards all stored contributions.
+      void invalidate()
+      {
+        _valid = false;
+        _cells.clear();
+      }
+
+      //! Discards all stored contributions and prepares the cache for a full assembly on the entity set.
+      void update(const EntitySet& entity_set)
+      {
+        invalidate();
+        _entity_set = std::make_unique<EntitySet>(entity_set);
+        _size = entity_set.size(0);
+        _cells.resize(_size);
+        _valid = true;
+      }
+
+      //! Stores the local container added by a cell.
+      template<typename C>
+      void store(const Element& element, const C& local)
+      {
+        entry(element,0) = local.base();
+      }
+
+      //! Stores the local container added by a face.
+      template<typename C>
+      void store(const Element& inside, unsigned int intersection_index, std::size_t block, const C& local)
+      {
+        entry(inside,faceSlot(intersection_index,block)) = local.base();
+      }
+
+      //! Stores the local container of a cell and replaces it by its difference to the previously stored one.
+      template<typename C>
+      void exchange(const Element& element, C& local)
+      {
+        exchange(entry(element,0),local.base());
+      }
+
+      //! Stores the local container of a face and replaces it by its difference to the previously stored one.
+      template<typename C>
+      void exchange(const Element& inside, unsigned int intersection_index, std::size_t block, C& local)
+      {
+        exchange(entry(inside,faceSlot(intersection_index,block)),local.base());
+      }
+
+    private:
+
+      std::size_t faceSlot(unsigned int intersection_index, std::size_t block) const
+      {
+        return 1 + intersection_index * _face_blocks + block;
+      }
+
+      std::vector<T>& entry(const Element& element, std::size_t slot)
+      {
+        auto& cell = _cells[_entity_set->indexSet().index(element)];
+        if (cell.size() <= slot)
+          cell.resize(slot + 1);
+        return cell[slot];
+      }
+
+      template<typename V>
+      static void exchange(std::vector<T>& stored, V& values)
+      {
+        // a container that has not been stored before did not contribute anything
+        if (stored.size() != values.size())
+          stored.assign(values.size(),T(0));
+        for (std::size_t i = 0; i < values.size(); ++i)
+          {
+            const T value = values[i];
+            values[i] -= stored[i];
+            stored[i] = value;
+          }
+      }
+
+      const std::size_t _face_blocks;
+      bool _valid;
+      std::size_t _size;
+      std::unique_ptr<EntitySet> _entity_set;
+      std::vector<std::vector<std::vector<T> > > _cells;
+
+    };
+
+    //! \} group GridOperator
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDOPERATOR_COMMON_LOCALCONTRIBUTIONCACHE_HH
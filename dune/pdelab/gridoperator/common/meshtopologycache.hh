@@ -0,0 +1,193 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_MESHTOPOLOGYCACHE_HH
+#define DUNE_PDELAB_GRIDOPERATOR_COMMON_MESHTOPOLOGYCACHE_HH
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include <dune/pdelab/common/intersectiontype.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+    /** \addtogroup GridOperator
+     *  \{
+     */
+
+    //! Cached classification of the intersections of all cells of an entity set.
+    /**
+     * The global assemblers classify every intersection of every cell on each assembly
+     * and compare the unique indices of both cells of a skeleton intersection to decide
+     * which of them visits the face. On grids with expensive intersection and entity
+     * objects, this traversal of the topology is a noticeable part of the assembly time
+     * of DG and finite volume schemes. A MeshTopologyCache stores the results in flat
+     * arrays indexed by the cell index, so that the assemblers can skip cells without
+     * relevant intersections and faces that are visited from the other side without
+     * touching the grid. It also keeps the seeds of all cells in traversal order, from
+     * which the assemblers obtain the cells to assemble and the outside cells of visited
+     * faces. The intersections that are actually assembled still have to be obtained
+     * from the grid, as the local operators need them.
+     *
+     * The cache does not try to detect changes of the grid. It stays valid until it is
+     * invalidated explicitly, which the global assemblers do in update(), i.e. it has to
+     * be rebuilt by calling GridOperator::update() whenever the grid changes.
+     *
+     * \tparam EntitySet The entity set of the trial grid function space
+     */
+    template<typename EntitySet>
+    class MeshTopologyCache
+    {
+
+    public:
+
+      typedef typename EntitySet::Element Element;
+      typedef typename Element::EntitySeed ElementSeed;
+
+      //! The cached information about a single intersection.
+      struct Face
+      {
+        IntersectionType type = IntersectionType::processor;
+        //! Whether the face is visited from this cell if skeleton terms are assembled one-sided.
+        bool visit = false;
+        //! The index of the outside cell for skeleton and periodic intersections.
+        std::size_t neighbor = std::numeric_limits<std::size_t>::max();
+      };
+
+      //! The cached information about a single cell.
+      struct Cell
+      {
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        bool has_skeleton = false;
+        bool has_visited_skeleton = false;
+        bool has_boundary = false;
+        bool has_processor = false;
+      };
+
+      MeshTopologyCache()
+        : _valid(false)
+        , _size(0)
+      {}
+
+      //! Returns whether the cache has been built and not been invalidated since.
+      bool valid() const
+      {
+        return _valid;
+      }
+
+      //! Discards the cached topology.
+      void invalidate()
+      {
+        _valid = false;
+        _cells.clear();
+        _faces.clear();
+        _seeds.clear();
+        _order.clear();
+      }
+
+      //! Traverses the entity set and caches the classification of all intersections.
+      void update(const EntitySet& entity_set)
+      {
+        invalidate();
+        _entity_set = std::make_unique<EntitySet>(entity_set);
+        auto& index_set = entity_set.indexSet();
+        _size = entity_set.size(0);
+        _cells.resize(_size);
+        _seeds.resize(_size);
+        _order.reserve(_size);
+
+        for (const auto& element : elements(entity_set))
+          {
+            const auto ids = index_set.uniqueIndex(element);
+            const std::size_t index = index_set.index(element);
+            _seeds[index] = element.seed();
+            _order.push_back(index);
+            Cell& cell = _cells[index];
+            cell.begin = _faces.size();
+            for (const auto& intersection : intersections(entity_set,element))
+              {
+                auto intersection_data = classifyIntersection(entity_set,intersection);
+                Face face;
+                face.type = std::get<0>(intersection_data);
+                switch (face.type)
+                  {
+                  case IntersectionType::skeleton:
+                  case IntersectionType::periodic:
+                    face.visit = ids > index_set.uniqueIndex(std::get<1>(intersection_data));
+                    face.neighbor = index_set.index(std::get<1>(intersection_data));
+                    cell.has_skeleton = true;
+                    cell.has_visited_skeleton |= face.visit;
+                    break;
+                  case IntersectionType::boundary:
+                    cell.has_boundary = true;
+                    break;
+                  case IntersectionType::processor:
+                    cell.has_processor = true;
+                    break;
+                  }
+                _faces.push_back(face);
+              }
+            cell.end = _faces.size();
+          }
+
+        _valid = true;
+      }
+
+      //! The number of cells in the cached entity set.
+      std::size_t size() const
+      {
+        return _size;
+      }
+
+      //! The cached information about a cell.
+      const Cell& cell(const Element& element) const
+      {
+        return _cells[_entity_set->indexSet().index(element)];
+      }
+
+      //! The cached information about the cell with the given index.
+      const Cell& cell(std::size_t index) const
+      {
+        return _cells[index];
+      }
+
+      //! The cached information about the intersection with the given index of a cell.
+      const Face& face(const Cell& cell, unsigned int intersection_index) const
+      {
+        return _faces[cell.begin + intersection_index];
+      }
+
+      //! The indices of all cells in the traversal order of the entity set.
+      const std::vector<std::size_t>& traversalOrder() const
+      {
+        return _order;
+      }
+
+      //! Obtains the cell with the given index from its cached seed.
+      Element element(std::size_t index) const
+      {
+        return _entity_set->grid().entity(_seeds[index]);
+      }
+
+    private:
+
+      bool _valid;
+      std::size_t _size;
+      std::unique_ptr<EntitySet> _entity_set;
+      std::vector<Cell> _cells;
+      std::vector<Face> _faces;
+      std::vector<ElementSeed> _seeds;
+      std::vector<std::size_t> _order;
+
+    };
+
+    //! \} group GridOperator
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDOPERATOR_COMMON_MESHTOPOLOGYCACHE_HH
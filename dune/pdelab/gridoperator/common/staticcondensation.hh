@@ -0,0 +1,234 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_STATICCONDENSATION_HH
+#define DUNE_PDELAB_GRIDOPERATOR_COMMON_STATICCONDENSATION_HH
+
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/geometry/typeindex.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+    /** \addtogroup GridOperator
+     *  \{
+     */
+
+    //! Splits the DOFs of a local function space bound to a cell into cell interior and exterior DOFs.
+    /**
+     * A DOF is interior if it is attached to the cell itself rather than to one of its
+     * vertices, edges or faces, which is read off the geometry type stored in its DOFIndex.
+     * Interior DOFs of conforming spaces only couple with the DOFs of the same cell.
+     *
+     * \param cell_type  The geometry type of the cell
+     * \param lfs_cache  The index cache of the local function space bound to the cell
+     * \param interior   Receives the local indices of the interior DOFs
+     * \param exterior   Receives the local indices of all other DOFs
+     */
+    template<typename LFSCache>
+    void classifyCellDOFs(const GeometryType& cell_type, const LFSCache& lfs_cache,
+                          std::vector<std::size_t>& interior, std::vector<std::size_t>& exterior)
+    {
+      typedef typename LFSCache::LocalFunctionSpace::Traits::GridFunctionSpace::Ordering::Traits::DOFIndexAccessor DOFIndexAccessor;
+      const std::size_t cell_type_index = GlobalGeometryTypeIndex::index(cell_type);
+      interior.clear();
+      exterior.clear();
+      for (std::size_t i = 0; i < lfs_cache.size(); ++i)
+        if (DOFIndexAccessor::geometryType(lfs_cache.dofIndex(i)) == cell_type_index)
+          interior.push_back(i);
+        else
+          exterior.push_back(i);
+    }
+
+    //! Data for recovering the cell interior DOFs eliminated by static condensation.
+    /**
+     * For every cell with interior DOFs I and exterior DOFs E, static condensation replaces
+     * the local system
+     * \f[
+     *   \begin{pmatrix} A_{EE} & A_{EI} \\ A_{IE} & A_{II} \end{pmatrix}
+     *   \begin{pmatrix} z_E \\ z_I \end{pmatrix}
+     *   = \begin{pmatrix} r_E \\ r_I \end{pmatrix}
+     * \f]
+     * by the Schur complement \f$ A_{EE} - A_{EI} A_{II}^{-1} A_{IE} \f$ with right hand side
+     * \f$ r_E - A_{EI} A_{II}^{-1} r_I \f$. The cache stores \f$ B = A_{II}^{-1} A_{IE} \f$ and
+     * \f$ c = A_{II}^{-1} r_I \f$ of each cell, so that the interior values
+     * \f$ z_I = c - B z_E \f$ can be recovered once the condensed system has been solved.
+     *
+     * All values are kept in a single contiguous arena in the order of assembly.
+     *
+     * \tparam ContainerIndex The container index type of the function space
+     * \tparam T              The field type of the local matrices
+     */
+    template<typename ContainerIndex, typename T>
+    class StaticCondensationCache
+    {
+
+      struct Cell
+      {
+        std::size_t interior;
+        std::size_t interior_size;
+        std::size_t exterior;
+        std::size_t exterior_size;
+        std::size_t values;
+      };
+
+    public:
+
+      StaticCondensationCache()
+        : _valid(false)
+      {}
+
+      //! Returns whether the cache holds the data of a complete condensed assembly.
+      bool valid() const
+      {
+        return _valid;
+      }
+
+      //! Discards all stored data.
+      void invalidate()
+      {
+        _valid = false;
+        _cells.clear();
+        _interior_indices.clear();
+        _exterior_indices.clear();
+        _values.clear();
+      }
+
+      //! Prepares the cache for a new assembly.
+      void beginRecording()
+      {
+        invalidate();
+      }
+
+      //! Condenses the local system of a cell in place and stores the data for recovering its interior DOFs.
+      /**
+       * Afterwards, the rows and columns of the interior DOFs of the local matrix contain
+       * the identity and the interior entries of the local residual are zero.
+       *
+       * \param lfsu_cache The index cache of the trial space, which must match the test space
+       * \param lfsv_cache The index cache of the test space
+       * \param interior   The local indices of the interior DOFs
+       * \param exterior   The local indices of all other DOFs
+       * \param r          The local residual
+       * \param a          The local jacobian
+       */
+      template<typename LFSUC, typename LFSVC, typename R, typename M>
+      void condense(const LFSUC& lfsu_cache, const LFSVC& lfsv_cache,
+                    const std::vector<std::size_t>& interior, const std::vector<std::size_t>& exterior,
+                    R& r, M& a)
+      {
+        const auto& lfsu = lfsu_cache.localFunctionSpace();
+        const auto& lfsv = lfsv_cache.localFunctionSpace();
+        const std::size_t ni = interior.size();
+        const std::size_t ne = exterior.size();
+
+        _a_ii.resize(ni,ni);
+        for (std::size_t k = 0; k < ni; ++k)
+          for (std::size_t l = 0; l < ni; ++l)
+            _a_ii[k][l] = a(lfsv,interior[k],lfsu,interior[l]);
+        _a_ii.invert();
+
+        Cell cell;
+        cell.interior = _interior_indices.size();
+        cell.interior_size = ni;
+        cell.exterior = _exterior_indices.size();
+        cell.exterior_size = ne;
+        cell.values = _values.size();
+        _cells.push_back(cell);
+        for (std::size_t k = 0; k < ni; ++k)
+          _interior_indices.push_back(lfsu_cache.containerIndex(interior[k]));
+        for (std::size_t k = 0; k < ne; ++k)
+          _exterior_indices.push_back(lfsu_cache.containerIndex(exterior[k]));
+
+        // B = A_II^{-1} A_IE (row-major) and c = A_II^{-1} r_I
+        _values.resize(_values.size() + ni*ne + ni, T(0));
+        T* b = _values.data() + cell.values;
+        T* c = b + ni*ne;
+        for (std::size_t k = 0; k < ni; ++k)
+          for (std::size_t m = 0; m < ni; ++m)
+            {
+              const T inverse = _a_ii[k][m];
+              for (std::size_t l = 0; l < ne; ++l)
+                b[k*ne+l] += inverse * a(lfsv,interior[m],lfsu,exterior[l]);
+              c[k] += inverse * r(lfsv,interior[m]);
+            }
+
+        // A_EE -= A_EI B and r_E -= A_EI c
+        for (std::size_t k = 0; k < ne; ++k)
+          for (std::size_t m = 0; m < ni; ++m)
+            {
+              const T a_em = a(lfsv,exterior[k],lfsu,interior[m]);
+              if (a_em == 0.0)
+                continue;
+              for (std::size_t l = 0; l < ne; ++l)
+                a(lfsv,exterior[k],lfsu,exterior[l]) -= a_em * b[m*ne+l];
+              r(lfsv,exterior[k]) -= a_em * c[m];
+            }
+
+        // decouple the interior DOFs from the condensed system
+        for (std::size_t m = 0; m < ni; ++m)
+          {
+            for (std::size_t k = 0; k < lfsv.size(); ++k)
+              a(lfsv,k,lfsu,interior[m]) = 0.0;
+            for (std::size_t l = 0; l < lfsu.size(); ++l)
+              a(lfsv,interior[m],lfsu,l) = 0.0;
+            a(lfsv,interior[m],lfsu,interior[m]) = 1.0;
+            r(lfsv,interior[m]) = 0.0;
+          }
+      }
+
+      //! Marks the cache as complete.
+      void finishRecording()
+      {
+        _valid = true;
+      }
+
+      //! Overwrites the interior entries of z with the values recovered from its exterior entries.
+      template<typename V>
+      void recover(V& z) const
+      {
+        if (!_valid)
+          DUNE_THROW(InvalidStateException,"Interior DOFs can only be recovered after a condensed assembly");
+        for (const auto& cell : _cells)
+          {
+            const ContainerIndex* interior = _interior_indices.data() + cell.interior;
+            const ContainerIndex* exterior = _exterior_indices.data() + cell.exterior;
+            const T* b = _values.data() + cell.values;
+            const T* c = b + cell.interior_size*cell.exterior_size;
+            for (std::size_t k = 0; k < cell.interior_size; ++k, b += cell.exterior_size)
+              {
+                T z_k = c[k];
+                for (std::size_t l = 0; l < cell.exterior_size; ++l)
+                  z_k -= b[l] * z[exterior[l]];
+                z[interior[k]] = z_k;
+              }
+          }
+      }
+
+      //! Returns the number of condensed cells.
+      std::size_t cells() const
+      {
+        return _cells.size();
+      }
+
+    private:
+
+      bool _valid;
+      std::vector<Cell> _cells;
+      std::vector<ContainerIndex> _interior_indices;
+      std::vector<ContainerIndex> _exterior_indices;
+      std::vector<T> _values;
+      // workspace for the inverse of A_II
+      DynamicMatrix<T> _a_ii;
+
+    };
+
+    //! \} group GridOperator
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDOPERATOR_COMMON_STATICCONDENSATION_HH
@@ -0,0 +1,106 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_COMMON_TASKBUFFERS_HH
+#define DUNE_PDELAB_GRIDOPERATOR_COMMON_TASKBUFFERS_HH
+
+#include <cstddef>
+#include <memory>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#include <dune/pdelab/backend/interface.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+    /** \addtogroup GridOperator
+     *  \{
+     */
+
+    //! Thread-private global containers of the engine copies in task-based assembly.
+    /**
+     * Task-based assemblers let neighboring cells be assembled at the same time, so the
+     * engine copies accumulate vectors into private copies that are summed up after all
+     * cells have been assembled, see addTaskBuffers(). TaskBuffers keeps these copies
+     * alive across assemblies next to the thread team of the assembler, holding at most
+     * one container of every type per thread. Every thread only accesses its own
+     * containers, so no locking is required.
+     */
+    class TaskBuffers
+    {
+
+    public:
+
+      explicit TaskBuffers(std::size_t threads)
+        : _buffers(threads)
+      {}
+
+      //! The number of threads the buffers are kept for.
+      std::size_t size() const
+      {
+        return _buffers.size();
+      }
+
+      //! Returns the zeroed private copy of a vector for the given thread.
+      /**
+       * The copy of the preceding assembly is reused if it belongs to the same function
+       * space and still has the same size, otherwise a new one is allocated.
+       */
+      template<typename V>
+      V& vector(std::size_t thread, const V& v)
+      {
+        auto& buffer = _buffers[thread][std::type_index(typeid(V))];
+        V* copy = static_cast<V*>(buffer.get());
+        if (copy && &copy->gridFunctionSpace() == &v.gridFunctionSpace() && copy->N() == v.N())
+          *copy = 0.0;
+        else
+          {
+            auto fresh = std::make_shared<V>(v.gridFunctionSpace(),0.0);
+            copy = fresh.get();
+            buffer = std::move(fresh);
+          }
+        return *copy;
+      }
+
+      //! Releases all containers, e.g. after the function spaces have changed.
+      void clear()
+      {
+        for (auto& buffers : _buffers)
+          buffers.clear();
+      }
+
+    private:
+
+      std::vector<std::unordered_map<std::type_index,std::shared_ptr<void> > > _buffers;
+
+    };
+
+    //! Adds part of the private vectors of the engine copies to a vector.
+    /**
+     * The top-level blocks of v are split into the given number of contiguous parts, so
+     * that the parts can be summed up concurrently on the threads of the assembler. Every
+     * entry is only written by the thread summing up its part, so no atomic additions are
+     * required.
+     */
+    template<typename V>
+    void addTaskBuffers(V& v, const std::vector<const V*>& copies, std::size_t part, std::size_t parts)
+    {
+      auto& target = Backend::native(v);
+      const std::size_t begin = (target.size() * part) / parts;
+      const std::size_t end = (target.size() * (part + 1)) / parts;
+      for (const V* copy : copies)
+        {
+          const auto& source = Backend::native(*copy);
+          for (std::size_t i = begin; i < end; ++i)
+            target[i] += source[i];
+        }
+    }
+
+    //! \} group GridOperator
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_GRIDOPERATOR_COMMON_TASKBUFFERS_HH
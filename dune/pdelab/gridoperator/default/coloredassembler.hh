@@ -0,0 +1,323 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_DEFAULT_COLOREDASSEMBLER_HH
+#define DUNE_PDELAB_GRIDOPERATOR_DEFAULT_COLOREDASSEMBLER_HH
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+#include <dune/pdelab/common/intersectiontype.hh>
+#include <dune/pdelab/common/threading.hh>
+#include <dune/pdelab/gridoperator/common/assemblerworker.hh>
+#include <dune/pdelab/gridoperator/common/globalassemblerbase.hh>
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+    /**
+       \brief Multithreaded assembler based on a coloring of the grid cells
+
+       This assembler is a drop-in replacement for DefaultAssembler that can be
+       selected via the last template parameter of GridOperator. It partitions
+       the cells of the entity set into colors such that no two cells of the
+       same color write to the same row of the residual or the jacobian, i.e.
+       their local test spaces (including the spaces of all neighbors reached
+       by skeleton integrals and the DOFs that constrained DOFs are
+       redistributed to) are disjoint. The colors are processed one after
+       another, and the cells within a color are distributed dynamically among
+       the threads of a ThreadTeam, which is kept alive across assemblies.
+       Each thread owns its local function spaces, index caches and a copy of
+       the local assembler engine, so the scatter into the global containers
+       does not require any locking. As every row only receives contributions
+       from a single cell per color, the result does not depend on the number
+       of threads.
+
+       The coloring is computed on first use and cached until update() is
+       called or the number of cells in the entity set changes.
+
+       Engines that do not support threaded assembly (see
+       LocalAssemblerEngineBase::supportsThreadedAssembly()) are run serially.
+       This includes the pattern engine, as the matrix patterns share their
+       storage for rows with more entries than estimated.
+
+       \note The local operator must be safe to call concurrently from multiple
+       threads, i.e. it must not modify any state during assembly.
+
+       * \tparam GFSU GridFunctionSpace for ansatz functions
+       * \tparam GFSV GridFunctionSpace for test functions
+       * \tparam CU   Constraints maps for the individual dofs (trial space)
+       * \tparam CV   Constraints maps for the individual dofs (test space)
+       * \tparam geometry_caching Whether the jacobians and integration elements of the cell
+       *                          and intersection geometries are cached, see GlobalAssemblerBase.
+       */
+    template<typename GFSU, typename GFSV, typename CU, typename CV, bool geometry_caching = false>
+    class ColoredAssembler
+      : public GlobalAssemblerBase<GFSU,GFSV,CU,CV,geometry_caching>
+    {
+      typedef GlobalAssemblerBase<GFSU,GFSV,CU,CV,geometry_caching> Base;
+
+    public:
+
+      //! Types related to current grid view
+      //! @{
+      using EntitySet = typename GFSU::Traits::EntitySet;
+      using Element = typename EntitySet::Element;
+      using Intersection = typename EntitySet::Intersection;
+      using ElementSeed = typename Element::EntitySeed;
+      //! @}
+
+      //! Grid function spaces
+      //! @{
+      typedef GFSU TrialGridFunctionSpace;
+      typedef GFSV TestGridFunctionSpace;
+      //! @}
+
+      //! Size type as used in grid function space
+      typedef typename GFSU::Traits::SizeType SizeType;
+
+      //! Static check on whether this is a Galerkin method
+      static const bool isGalerkinMethod = std::is_same<GFSU,GFSV>::value;
+
+      //! A partitioning of the cells into sets of cells that can be assembled concurrently
+      typedef std::vector<std::vector<ElementSeed> > Coloring;
+
+      ColoredAssembler (const GFSU& gfsu_, const GFSV& gfsv_, const CU& cu_, const CV& cv_)
+        : Base(gfsu_,gfsv_,cu_,cv_)
+        , _threads(defaultThreadCount())
+        , _coloring_valid{{false,false}}
+        , _colored_cells{{0,0}}
+      { }
+
+      ColoredAssembler (const GFSU& gfsu_, const GFSV& gfsv_)
+        : Base(gfsu_,gfsv_)
+        , _threads(defaultThreadCount())
+        , _coloring_valid{{false,false}}
+        , _colored_cells{{0,0}}
+      { }
+
+      //! Set the number of threads used for assembling.
+      void setThreads(std::size_t threads)
+      {
+        _threads = std::max(threads,std::size_t(1));
+      }
+
+      //! The number of threads used for assembling.
+      std::size_t threads() const
+      {
+        return _threads;
+      }
+
+      //! Discards the cached coloring and topology, must be called after the grid or the function spaces have changed.
+      void update()
+      {
+        Base::update();
+        _coloring_valid = {{false,false}};
+        _coloring[0].clear();
+        _coloring[1].clear();
+      }
+
+      //! Returns the coloring used for engines with or without skeleton terms.
+      /**
+       * \param skeleton  If true, cells sharing a face must not have the same color either, as
+       *                  both of them write into the rows of the other one during the assembly
+       *                  of skeleton terms.
+       */
+      const Coloring& coloring(bool skeleton) const
+      {
+        auto entity_set = gfsu.entitySet();
+        if (!_coloring_valid[skeleton] || _colored_cells[skeleton] != entity_set.size(0))
+          {
+            buildColoring(skeleton,_coloring[skeleton]);
+            _colored_cells[skeleton] = entity_set.size(0);
+            _coloring_valid[skeleton] = true;
+          }
+        return _coloring[skeleton];
+      }
+
+      using Base::assemble;
+
+      template<class LocalAssemblerEngine>
+      void assemble(LocalAssemblerEngine & assembler_engine) const
+      {
+        typedef AssemblerWorker<GFSU,GFSV,CU,CV,LocalAssemblerEngine,geometry_caching> Worker;
+
+        // Notify assembler engine about oncoming assembly
+        assembler_engine.preAssembly();
+
+        auto entity_set = gfsu.entitySet();
+
+        // The caches have to be built before the threads are started
+        const MeshTopologyCache<EntitySet>* cached_topology = this->topology(entity_set);
+        GeometryCache<EntitySet>* cached_geometries = this->geometries(entity_set);
+
+        if (_threads <= 1 || !assembler_engine.supportsThreadedAssembly())
+          {
+            Worker worker(gfsu,gfsv,cu,cv,assembler_engine,cached_topology,cached_geometries);
+            for (const auto& element : elements(entity_set))
+              worker.assemble(element);
+          }
+        else
+          {
+            const bool skeleton = assembler_engine.requireUVSkeleton() || assembler_engine.requireVSkeleton();
+            const Coloring& colors = coloring(skeleton);
+
+            // per-color work counters for the dynamic distribution of cells
+            std::vector<std::atomic<std::size_t> > next(colors.size());
+            for (auto& n : next)
+              n.store(0);
+
+            ThreadBarrier barrier(_threads);
+            ThreadExceptionCollector exceptions;
+
+            team().run([&](std::size_t thread)
+              {
+                std::unique_ptr<LocalAssemblerEngine> engine;
+                std::unique_ptr<Worker> worker;
+                try
+                  {
+                    engine = std::make_unique<LocalAssemblerEngine>(assembler_engine);
+                    worker = std::make_unique<Worker>(gfsu,gfsv,cu,cv,*engine,cached_topology,cached_geometries);
+                  }
+                catch (...)
+                  {
+                    exceptions.capture();
+                  }
+
+                // all threads have to pass every barrier, even after a failure
+                for (std::size_t c = 0; c < colors.size(); ++c)
+                  {
+                    const auto& color = colors[c];
+                    const std::size_t chunk = std::max(color.size() / (8 * _threads),std::size_t(1));
+                    try
+                      {
+                        for (std::size_t begin = next[c].fetch_add(chunk);
+                             begin < color.size() && !exceptions.failed();
+                             begin = next[c].fetch_add(chunk))
+                          {
+                            const std::size_t end = std::min(begin + chunk,color.size());
+                            for (std::size_t i = begin; i < end; ++i)
+                              worker->assemble(entity_set.grid().entity(color[i]));
+                          }
+                      }
+                    catch (...)
+                      {
+                        exceptions.capture();
+                      }
+                    barrier.wait();
+                  }
+              });
+
+            exceptions.rethrow();
+          }
+
+        // Notify assembler engine that assembly is finished
+        assembler_engine.postAssembly(gfsu,gfsv);
+
+      }
+
+    private:
+
+      using Base::gfsu;
+      using Base::gfsv;
+      using Base::cu;
+      using Base::cv;
+
+      //! Returns the thread team, starting the threads on first use or after a change of their number.
+      ThreadTeam& team() const
+      {
+        if (!_team || _team->size() != _threads)
+          _team = std::make_shared<ThreadTeam>(_threads);
+        return *_team;
+      }
+
+      /* local function spaces */
+      typedef LocalFunctionSpace<GFSV, TestSpaceTag> LFSV;
+      typedef LFSIndexCache<LFSV,CV> LFSVCache;
+      typedef typename LFSVCache::ContainerIndex ContainerIndex;
+
+      //! Collects all rows the local test space writes into, including constraint contributors.
+      static void collectRows(const LFSVCache& lfsv_cache, std::vector<ContainerIndex>& rows)
+      {
+        for (std::size_t i = 0; i < lfsv_cache.size(); ++i)
+          {
+            rows.push_back(lfsv_cache.containerIndex(i));
+            if (lfsv_cache.isConstrained(i) && !lfsv_cache.isDirichletConstraint(i))
+              for (auto it = lfsv_cache.constraintsBegin(i); it != lfsv_cache.constraintsEnd(i); ++it)
+                rows.push_back(it->containerIndex());
+          }
+      }
+
+      //! Greedy first-fit coloring of the cells in traversal order.
+      void buildColoring(bool skeleton, Coloring& coloring) const
+      {
+        coloring.clear();
+
+        LFSV lfsv(gfsv);
+        LFSV lfsvn(gfsv);
+        LFSVCache lfsv_cache(lfsv,cv,true);
+        LFSVCache lfsvn_cache(lfsvn,cv,true);
+
+        std::vector<std::unordered_set<ContainerIndex> > color_rows;
+        std::vector<ContainerIndex> rows;
+
+        auto entity_set = gfsu.entitySet();
+        for (const auto& element : elements(entity_set))
+          {
+            rows.clear();
+
+            lfsv.bind(element);
+            lfsv_cache.update();
+            collectRows(lfsv_cache,rows);
+
+            if (skeleton)
+              for (const auto& intersection : intersections(entity_set,element))
+                {
+                  auto intersection_data = classifyIntersection(entity_set,intersection);
+                  auto intersection_type = std::get<0>(intersection_data);
+                  if (intersection_type == IntersectionType::skeleton ||
+                      intersection_type == IntersectionType::periodic)
+                    {
+                      lfsvn.bind(std::get<1>(intersection_data));
+                      lfsvn_cache.update();
+                      collectRows(lfsvn_cache,rows);
+                    }
+                }
+
+            std::size_t color = 0;
+            for (; color < color_rows.size(); ++color)
+              if (std::none_of(rows.begin(),rows.end(),
+                               [&](const ContainerIndex& ci) { return color_rows[color].count(ci) > 0; }))
+                break;
+
+            if (color == color_rows.size())
+              {
+                color_rows.emplace_back();
+                coloring.emplace_back();
+              }
+
+            color_rows[color].insert(rows.begin(),rows.end());
+            coloring[color].push_back(element.seed());
+          }
+      }
+
+      std::size_t _threads;
+      mutable std::shared_ptr<ThreadTeam> _team;
+
+
+      /* cached colorings without and with skeleton couplings */
+      mutable std::array<Coloring,2> _coloring;
+      mutable std::array<bool,2> _coloring_valid;
+      mutable std::array<std::size_t,2> _colored_cells;
+
+    };
+
+  }
+}
+#endif // DUNE_PDELAB_GRIDOPERATOR_DEFAULT_COLOREDASSEMBLER_HH
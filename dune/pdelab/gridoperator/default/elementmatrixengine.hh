@@ -0,0 +1,380 @@
+#ifndef DUNE_PDELAB_GRIDOPERATOR_DEFAULT_ELEMENTMATRIXENGINE_HH
+#define DUNE_PDELAB_GRIDOPERATOR_DEFAULT_ELEMENTMATRIXENGINE_HH
+
+#include <memory>
+
+#include <dune/pdelab/constraints/common/constraints.hh>
+#include <dune/pdelab/gridfunctionspace/localvector.hh>
+#include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
+#include <dune/pdelab/gridoperator/common/diagonallocalmatrix.hh>
+#include <dune/pdelab/gridoperator/common/elementmatrixcache.hh>
+#include <dune/pdelab/gridoperator/common/localassemblerenginebase.hh>
+#include <dune/pdelab/gridoperator/common/localmatrix.hh>
+#include <dune/pdelab/localoperator/callswitch.hh>
+#include <dune/pdelab/localoperator/flags.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+    /**
+       \brief The local assembler engine for DUNE grids which
+       stores the local matrices of a linear operator for
+       element-by-element application of the jacobian
+
+       The engine assembles the local matrices like
+       DefaultLocalJacobianAssemblerEngine, but keeps them in an
+       ElementMatrixCache instead of adding them to a global
+       matrix. apply() then computes the jacobian applied to a
+       vector from the cache without calling the local operator.
+
+       \tparam LA The local assembler
+
+    */
+    template<typename LA>
+    class DefaultLocalElementMatrixAssemblerEngine
+      : public LocalAssemblerEngineBase
+    {
+    public:
+
+      template<typename TrialConstraintsContainer, typename TestConstraintsContainer>
+      bool needsConstraintsCaching(const TrialConstraintsContainer& cu, const TestConstraintsContainer& cv) const
+      {
+        return false;
+      }
+
+      //! The type of the wrapping local assembler
+      typedef LA LocalAssembler;
+
+      //! The type of the local operator
+      typedef typename LA::LocalOperator LOP;
+
+      //! The local function spaces
+      typedef typename LA::LFSU LFSU;
+      typedef typename LA::LFSUCache LFSUCache;
+      typedef typename LFSU::Traits::GridFunctionSpace GFSU;
+      typedef typename LA::LFSV LFSV;
+      typedef typename LA::LFSVCache LFSVCache;
+      typedef typename LFSV::Traits::GridFunctionSpace GFSV;
+
+      //! The type of the result vector
+      typedef typename LA::Traits::Range Range;
+
+      //! The type of the solution vector
+      typedef typename LA::Traits::Domain Domain;
+      typedef typename Domain::ElementType DomainElement;
+
+      //! The field type of the local matrices
+      typedef typename LA::Traits::Jacobian::ElementType JacobianElement;
+
+      //! The cache holding the local matrices
+      typedef ElementMatrixCache<
+        typename LFSVCache::ContainerIndex,
+        typename LFSUCache::ContainerIndex,
+        JacobianElement
+        > Cache;
+
+      /**
+         \brief Constructor
+
+         \param [in] local_assembler_ The local assembler object which
+         creates this engine
+      */
+      DefaultLocalElementMatrixAssemblerEngine(const LocalAssembler & local_assembler_)
+        : local_assembler(local_assembler_),
+          lop(local_assembler_.localOperator()),
+          al_view(al,1.0),
+          al_sn_view(al_sn,1.0),
+          al_ns_view(al_ns,1.0),
+          al_nn_view(al_nn,1.0),
+          trial_space(nullptr),
+          cell(0),
+          outside_cell(0),
+          cache(std::make_shared<Cache>())
+      {}
+
+      /**
+         \brief Copy constructor
+
+         The copy shares the cache of the original engine, but uses
+         its own local containers.
+      */
+      DefaultLocalElementMatrixAssemblerEngine(const DefaultLocalElementMatrixAssemblerEngine& other)
+        : local_assembler(other.local_assembler),
+          lop(other.lop),
+          al_view(al,1.0),
+          al_sn_view(al_sn,1.0),
+          al_ns_view(al_ns,1.0),
+          al_nn_view(al_nn,1.0),
+          trial_space(other.trial_space),
+          cell(0),
+          outside_cell(0),
+          cache(other.cache)
+      {}
+
+      //! Query methods for the global grid assembler
+      //! @{
+      bool requireSkeleton() const
+      { return local_assembler.doAlphaSkeleton(); }
+      bool requireSkeletonTwoSided() const
+      { return local_assembler.doSkeletonTwoSided(); }
+      bool requireUVVolume() const
+      { return local_assembler.doAlphaVolume(); }
+      bool requireUVSkeleton() const
+      { return local_assembler.doAlphaSkeleton(); }
+      bool requireUVBoundary() const
+      { return local_assembler.doAlphaBoundary(); }
+      bool requireUVVolumePostSkeleton() const
+      { return local_assembler.doAlphaVolumePostSkeleton(); }
+      // the local matrices are appended to the cache in the order of assembly
+      bool supportsThreadedAssembly() const
+      { return false; }
+      bool supportsTaskAssembly() const
+      { return false; }
+      //! @}
+
+      //! Public access to the wrapping local assembler
+      const LocalAssembler & localAssembler() const
+      {
+        return local_assembler;
+      }
+
+      //! Trial space constraints
+      const typename LocalAssembler::Traits::TrialGridFunctionSpaceConstraints& trialConstraints() const
+      {
+        return localAssembler().trialConstraints();
+      }
+
+      //! Test space constraints
+      const typename LocalAssembler::Traits::TestGridFunctionSpaceConstraints& testConstraints() const
+      {
+        return localAssembler().testConstraints();
+      }
+
+      //! Whether the cache holds the local matrices for the current weight of the local assembler.
+      bool valid() const
+      {
+        return cache->valid(local_assembler.weight());
+      }
+
+      //! Discards the cached local matrices, must be called after the grid, the function spaces or the operator have changed.
+      void invalidate()
+      {
+        cache->invalidate();
+      }
+
+      //! Public access to the cached local matrices
+      const Cache& elementMatrixCache() const
+      {
+        return *cache;
+      }
+
+      //! Adds the jacobian applied to update to result, using the cached local matrices.
+      /**
+         Like DefaultLocalJacobianApplyAssemblerEngine, the rows of the
+         constrained test functions are reset to zero afterwards.
+      */
+      void apply(const Domain & update, Range & result) const
+      {
+        cache->apply(update,result);
+        if(local_assembler.doPostProcessing())
+          Dune::PDELab::constrain_residual(local_assembler.testConstraints(),result);
+      }
+
+      //! Called immediately after binding of local function space in
+      //! global assembler.
+      //! @{
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void onBindLFSUV(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        trial_space = &lfsu_cache.localFunctionSpace().gridFunctionSpace();
+        cell = index(eg.entity());
+        cache->recordCell(cell,lfsu_cache,lfsv_cache);
+        xl.assign(lfsu_cache.size(),0.0);
+        al.assign(lfsv_cache.size(),lfsu_cache.size(),0.0);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void onBindLFSUVOutside(const IG & ig,
+                              const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                              const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache)
+      {
+        outside_cell = index(ig.outside());
+        cache->recordCell(outside_cell,lfsu_n_cache,lfsv_n_cache);
+        xn.assign(lfsu_n_cache.size(),0.0);
+        al_sn.assign(lfsv_s_cache.size(),lfsu_n_cache.size(),0.0);
+        al_ns.assign(lfsv_n_cache.size(),lfsu_s_cache.size(),0.0);
+        al_nn.assign(lfsv_n_cache.size(),lfsu_n_cache.size(),0.0);
+      }
+      //! @}
+
+      //! Called when the local function space is about to be rebound or
+      //! discarded
+      //! @{
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void onUnbindLFSUV(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        cache->addBlock(cell,cell,al);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void onUnbindLFSUVOutside(const IG & ig,
+                                const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                                const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache)
+      {
+        cache->addBlock(cell,outside_cell,al_sn);
+        cache->addBlock(outside_cell,cell,al_ns);
+        cache->addBlock(outside_cell,outside_cell,al_nn);
+      }
+      //! @}
+
+      //! Methods for loading of the local function's coefficients
+      //! @{
+      // the jacobian of a linear operator does not depend on the coefficients,
+      // so the local operator is always evaluated for zero coefficients
+      template<typename LFSUC>
+      void loadCoefficientsLFSUInside(const LFSUC & lfsu_cache)
+      {}
+      template<typename LFSUC>
+      void loadCoefficientsLFSUOutside(const LFSUC & lfsu_n_cache)
+      {}
+      template<typename LFSUC>
+      void loadCoefficientsLFSUCoupling(const LFSUC & lfsu_c_cache)
+      {
+        DUNE_THROW(Dune::NotImplemented,"No coupling lfsu_cache available for ");
+      }
+      //! @}
+
+      //! Notifier functions, called immediately before and after assembling
+      //! @{
+      void preAssembly()
+      {
+        if (not LOP::isLinear)
+          DUNE_THROW(Dune::InvalidStateException,"Element matrix caching requires a linear local operator");
+        cache->beginRecording(local_assembler.weight());
+      }
+
+      void postAssembly(const GFSU& gfsu, const GFSV& gfsv)
+      {
+        cache->finishRecording();
+      }
+      //! @}
+
+      //! Assembling methods
+      //! @{
+
+      /** Assemble on a given cell without function spaces.
+
+          \return If true, the assembling for this cell is assumed to
+          be complete and the assembler continues with the next grid
+          cell.
+       */
+      template<typename EG>
+      bool assembleCell(const EG & eg)
+      {
+        return LocalAssembler::isNonOverlapping && eg.entity().partitionType() != Dune::InteriorEntity;
+      }
+
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void assembleUVVolume(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        al_view.setWeight(local_assembler.weight());
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaVolume>::
+          jacobian_volume(lop,eg,lfsu_cache.localFunctionSpace(),xl,lfsv_cache.localFunctionSpace(),al_view);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void assembleUVSkeleton(const IG & ig, const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                              const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache)
+      {
+        al_view.setWeight(local_assembler.weight());
+        al_sn_view.setWeight(local_assembler.weight());
+        al_ns_view.setWeight(local_assembler.weight());
+        al_nn_view.setWeight(local_assembler.weight());
+
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaSkeleton>::
+          jacobian_skeleton(lop,ig,lfsu_s_cache.localFunctionSpace(),xl,lfsv_s_cache.localFunctionSpace(),lfsu_n_cache.localFunctionSpace(),xn,lfsv_n_cache.localFunctionSpace(),al_view,al_sn_view,al_ns_view,al_nn_view);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void assembleUVBoundary(const IG & ig, const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache)
+      {
+        al_view.setWeight(local_assembler.weight());
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaBoundary>::
+          jacobian_boundary(lop,ig,lfsu_s_cache.localFunctionSpace(),xl,lfsv_s_cache.localFunctionSpace(),al_view);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      static void assembleUVEnrichedCoupling(const IG & ig,
+                                             const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                                             const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache,
+                                             const LFSUC & lfsu_coupling_cache, const LFSVC & lfsv_coupling_cache)
+      {
+        DUNE_THROW(Dune::NotImplemented,"Assembling of coupling spaces is not implemented for ");
+      }
+
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void assembleUVVolumePostSkeleton(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        al_view.setWeight(local_assembler.weight());
+        Dune::PDELab::LocalAssemblerCallSwitch<LOP,LOP::doAlphaVolumePostSkeleton>::
+          jacobian_volume_post_skeleton(lop,eg,lfsu_cache.localFunctionSpace(),xl,lfsv_cache.localFunctionSpace(),al_view);
+      }
+
+      //! @}
+
+    private:
+
+      template<typename Element>
+      std::size_t index(const Element& element) const
+      {
+        return trial_space->entitySet().indexSet().index(element);
+      }
+
+      //! Reference to the wrapping local assembler object which
+      //! constructed this engine
+      const LocalAssembler & local_assembler;
+
+      //! Reference to the local operator
+      const LOP & lop;
+
+      //! The local vectors and matrices as required for assembling
+      //! @{
+      typedef Dune::PDELab::TrialSpaceTag LocalTrialSpaceTag;
+
+      typedef Dune::PDELab::LocalVector<DomainElement, LocalTrialSpaceTag> SolutionVector;
+      typedef typename std::conditional<
+        std::is_base_of<
+          lop::DiagonalJacobian,
+          LOP
+          >::value,
+        Dune::PDELab::DiagonalLocalMatrix<JacobianElement>,
+        Dune::PDELab::LocalMatrix<JacobianElement>
+        >::type JacobianMatrix;
+
+      SolutionVector xl;
+      SolutionVector xn;
+
+      JacobianMatrix al;
+      JacobianMatrix al_sn;
+      JacobianMatrix al_ns;
+      JacobianMatrix al_nn;
+
+      typename JacobianMatrix::WeightedAccumulationView al_view;
+      typename JacobianMatrix::WeightedAccumulationView al_sn_view;
+      typename JacobianMatrix::WeightedAccumulationView al_ns_view;
+      typename JacobianMatrix::WeightedAccumulationView al_nn_view;
+      //! @}
+
+      //! The trial space and the indices of the current inside and outside cells
+      const GFSU* trial_space;
+      std::size_t cell;
+      std::size_t outside_cell;
+
+      //! The local matrices, shared by all copies of the engine
+      std::shared_ptr<Cache> cache;
+
+    }; // End of class DefaultLocalElementMatrixAssemblerEngine
+
+  }
+}
+#endif // DUNE_PDELAB_GRIDOPERATOR_DEFAULT_ELEMENTMATRIXENGINE_HH
@@ -1,6 +1,8 @@
 #ifndef DUNE_PDELAB_GRIDOPERATOR_DEFAULT_JACOBIANAPPLYENGINE_HH
 #define DUNE_PDELAB_GRIDOPERATOR_DEFAULT_JACOBIANAPPLYENGINE_HH
 
+#include <vector>
+
 #include <dune/pdelab/gridfunctionspace/localvector.hh>
 #include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
 #include <dune/pdelab/gridoperator/common/localassemblerenginebase.hh>
@@ -70,6 +72,25 @@ namespace Dune{
           result_view_outside(local_result_outside,1.0)
       {}
 
+      /**
+         \brief Copy constructor
+
+         The copy assembles into the same global vector as the original
+         engine, but uses its own local containers, e.g. on another thread.
+      */
+      DefaultLocalJacobianApplyAssemblerEngine(const DefaultLocalJacobianApplyAssemblerEngine& other)
+        : local_assembler(other.local_assembler),
+          lop(other.lop),
+          global_solution_view_inside(other.global_solution_view_inside),
+          global_solution_view_outside(other.global_solution_view_outside),
+          global_update_view_inside(other.global_update_view_inside),
+          global_update_view_outside(other.global_update_view_outside),
+          global_result_view_inside(other.global_result_view_inside),
+          global_result_view_outside(other.global_result_view_outside),
+          result_view_inside(local_result_inside,1.0),
+          result_view_outside(local_result_outside,1.0)
+      {}
+
       //! Query methods for the global grid assembler
       //! @{
       bool requireSkeleton() const
@@ -84,6 +105,10 @@ namespace Dune{
       { return local_assembler.doAlphaBoundary(); }
       bool requireUVVolumePostSkeleton() const
       { return local_assembler.doAlphaVolumePostSkeleton(); }
+      bool supportsThreadedAssembly() const
+      { return true; }
+      bool supportsTaskAssembly() const
+      { return true; }
       //! @}
 
       //! Public access to the wrapping local assembler
@@ -128,6 +153,22 @@ namespace Dune{
         global_result_view_outside.attach(result_);
       }
 
+      //! Redirects the contributions of this engine copy into the private result of the given thread.
+      void beginTaskAssembly(TaskBuffers& buffers, std::size_t thread)
+      {
+        setResult(buffers.vector(thread,global_result_view_inside.container()));
+      }
+
+      //! Adds the given part of the private results of the engine copies to the current result.
+      void mergeTaskAssembly(const std::vector<DefaultLocalJacobianApplyAssemblerEngine*>& copies,
+                             std::size_t part, std::size_t parts)
+      {
+        std::vector<const Range*> results;
+        for (auto copy : copies)
+          results.push_back(&copy->global_result_view_inside.container());
+        addTaskBuffers(global_result_view_inside.container(),results,part,parts);
+      }
+
       //! Called immediately after binding of local function space in
       //! global assembler.
       //! @{
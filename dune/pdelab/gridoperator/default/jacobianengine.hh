@@ -1,11 +1,17 @@
 #ifndef DUNE_PDELAB_GRIDOPERATOR_DEFAULT_JACOBIANENGINE_HH
 #define DUNE_PDELAB_GRIDOPERATOR_DEFAULT_JACOBIANENGINE_HH
 
+#include <memory>
+
+#include <dune/pdelab/backend/common/atomicaddmatrixview.hh>
+#include <dune/pdelab/backend/common/uppertriangularmatrixview.hh>
 #include <dune/pdelab/constraints/common/constraints.hh>
 #include <dune/pdelab/gridfunctionspace/localvector.hh>
 #include <dune/pdelab/gridoperator/common/localmatrix.hh>
 #include <dune/pdelab/gridoperator/common/diagonallocalmatrix.hh>
 #include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
+#include <dune/pdelab/gridoperator/common/jacobianscattermap.hh>
+#include <dune/pdelab/gridoperator/common/localcontributioncache.hh>
 #include <dune/pdelab/gridoperator/common/localassemblerenginebase.hh>
 #include <dune/pdelab/localoperator/callswitch.hh>
 #include <dune/pdelab/localoperator/flags.hh>
@@ -26,6 +32,10 @@ namespace Dune{
     {
     public:
 
+      // the fused residual and jacobian engine and the static condensation engine work on the local containers of this engine
+      template<typename> friend class DefaultLocalResidualJacobianAssemblerEngine;
+      template<typename> friend class DefaultLocalStaticCondensationAssemblerEngine;
+
       template<typename TrialConstraintsContainer, typename TestConstraintsContainer>
       bool needsConstraintsCaching(const TrialConstraintsContainer& cu, const TestConstraintsContainer& cv)
       {
@@ -51,6 +61,12 @@ namespace Dune{
       typedef typename Jacobian::ElementType JacobianElement;
       typedef typename Jacobian::template LocalView<LFSVCache,LFSUCache> JacobianView;
 
+      //! The map of matrix entries reused across assemblies into the same matrix
+      typedef JacobianScatterMap<typename GFSU::Traits::EntitySet,Jacobian> ScatterMap;
+
+      //! The local matrices of the last assembly, required for partial assembly
+      typedef LocalContributionCache<typename GFSU::Traits::EntitySet,JacobianElement> ContributionCache;
+
       //! The type of the solution vector
       typedef typename LA::Traits::Solution Solution;
       typedef typename Solution::ElementType SolutionElement;
@@ -68,7 +84,48 @@ namespace Dune{
           al_view(al,1.0),
           al_sn_view(al_sn,1.0),
           al_ns_view(al_ns,1.0),
-          al_nn_view(al_nn,1.0)
+          al_nn_view(al_nn,1.0),
+          atomic_scatter(false),
+          upper_triangular(false),
+          scatter_map(std::make_shared<ScatterMap>()),
+          use_scatter_map(false),
+          record_scatter_map(false),
+          recording_started(false),
+          contribution_cache(std::make_shared<ContributionCache>(3)),
+          contribution_caching(false),
+          partial_assembly(false)
+      {}
+
+      /**
+         \brief Copy constructor
+
+         The copy assembles into the same global matrix as the original
+         engine, but uses its own local containers, e.g. on another thread.
+         It shares the scatter map and the contribution cache of the
+         original engine.
+      */
+      DefaultLocalJacobianAssemblerEngine(const DefaultLocalJacobianAssemblerEngine& other)
+        : local_assembler(other.local_assembler),
+          lop(other.lop),
+          global_s_s_view(other.global_s_s_view),
+          global_s_n_view(other.global_s_n_view),
+          global_a_ss_view(other.global_a_ss_view),
+          global_a_sn_view(other.global_a_sn_view),
+          global_a_ns_view(other.global_a_ns_view),
+          global_a_nn_view(other.global_a_nn_view),
+          al_view(al,1.0),
+          al_sn_view(al_sn,1.0),
+          al_ns_view(al_ns,1.0),
+          al_nn_view(al_nn,1.0),
+          atomic_scatter(false),
+          upper_triangular(other.upper_triangular),
+          scatter_map(other.scatter_map),
+          use_scatter_map(other.use_scatter_map),
+          record_scatter_map(other.record_scatter_map),
+          recording_started(other.recording_started),
+          contribution_cache(other.contribution_cache),
+          contribution_caching(other.contribution_caching),
+          partial_assembly(other.partial_assembly)
       {}
 
       //! Query methods for the global grid assembler
@@ -85,6 +142,10 @@ namespace Dune{
       { return local_assembler.doAlphaBoundary(); }
       bool requireUVVolumePostSkeleton() const
       { return local_assembler.doAlphaVolumePostSkeleton(); }
+      bool supportsThreadedAssembly() const
+      { return !record_scatter_map; }
+      bool supportsTaskAssembly() const
+      { return !record_scatter_map; }
       //! @}
 
       //! Public access to the wrapping local assembler
@@ -123,6 +184,50 @@ namespace Dune{
         global_s_n_view.attach(solution_);
       }
 
+      //! Discards the scatter map, must be called after the grid or the function spaces have changed.
+      void invalidateScatterMap()
+      {
+        scatter_map->invalidate();
+      }
+
+      //! Enables or disables keeping the local matrices of the last assembly, see setPartialAssembly().
+      void setContributionCaching(bool enable)
+      {
+        contribution_caching = enable;
+        if (!enable)
+          contribution_cache->invalidate();
+      }
+
+      //! Whether the local matrices of the last assembly are kept.
+      bool contributionCaching() const
+      {
+        return contribution_caching;
+      }
+
+      //! Makes the next assembly add only the change of the local matrices to the current jacobian.
+      /**
+       * Partial assembly requires that the current jacobian is the result of the preceding
+       * assemblies with contribution caching enabled, the first of which must have been a
+       * full one. Each reassembled cell then adds the difference between its new and its
+       * cached local matrices, so that cells whose coefficients did not change can be skipped.
+       */
+      void setPartialAssembly(bool partial)
+      {
+        partial_assembly = partial;
+      }
+
+      //! Discards the cached local matrices, must be called after the grid or the function spaces have changed.
+      void invalidateContributionCache()
+      {
+        contribution_cache->invalidate();
+      }
+
+      //! Makes this engine copy scatter into the shared jacobian with atomic additions.
+      void beginTaskAssembly(TaskBuffers& buffers, std::size_t thread)
+      {
+        atomic_scatter = true;
+      }
+
       //! Called immediately after binding of local function space in
       //! global assembler.
       //! @{
@@ -133,6 +238,17 @@ namespace Dune{
         xl.resize(lfsu_cache.size());
         global_a_ss_view.bind(lfsv_cache,lfsu_cache);
         al.assign(lfsv_cache.size(),lfsu_cache.size(),0.0);
+
+        if (record_scatter_map)
+          {
+            if (!recording_started)
+              {
+                scatter_map->beginRecording(lfsu_cache.localFunctionSpace().gridFunctionSpace().entitySet(),
+                                            global_a_ss_view.container());
+                recording_started = true;
+              }
+            scatter_map->beginCell(eg.entity());
+          }
       }
 
       template<typename IG, typename LFSUC, typename LFSVC>
@@ -158,7 +274,16 @@ namespace Dune{
       template<typename EG, typename LFSUC, typename LFSVC>
       void onUnbindLFSUV(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
       {
-        local_assembler.scatter_jacobian(al,global_a_ss_view,false);
+        if (contribution_caching)
+          cacheContribution(eg.entity(),al);
+        if (use_scatter_map)
+          scatterMapped(al,global_a_ss_view,scatter_map->cellBlock(eg.entity()));
+        else
+          {
+            if (record_scatter_map)
+              scatter_map->recordCellBlock(eg.entity(),global_a_ss_view.container(),global_a_ss_view);
+            scatter(al,global_a_ss_view);
+          }
       }
 
       template<typename IG, typename LFSUC, typename LFSVC>
@@ -166,9 +291,37 @@ namespace Dune{
                                 const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
                                 const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache)
       {
-        local_assembler.scatter_jacobian(al_sn,global_a_sn_view,false);
-        local_assembler.scatter_jacobian(al_ns,global_a_ns_view,false);
-        local_assembler.scatter_jacobian(al_nn,global_a_nn_view,false);
+        if (contribution_caching)
+          {
+            const auto inside = ig.inside();
+            const unsigned int index = ig.intersectionIndex();
+            cacheContribution(inside,index,0,al_sn);
+            cacheContribution(inside,index,1,al_ns);
+            cacheContribution(inside,index,2,al_nn);
+          }
+        if (use_scatter_map)
+          {
+            const auto inside = ig.inside();
+            const unsigned int index = ig.intersectionIndex();
+            scatterMapped(al_sn,global_a_sn_view,scatter_map->faceBlock(inside,index,0));
+            scatterMapped(al_ns,global_a_ns_view,scatter_map->faceBlock(inside,index,1));
+            scatterMapped(al_nn,global_a_nn_view,scatter_map->faceBlock(inside,index,2));
+          }
+        else
+          {
+            if (record_scatter_map)
+              {
+                const auto inside = ig.inside();
+                const unsigned int index = ig.intersectionIndex();
+                Jacobian& jacobian = global_a_ss_view.container();
+                scatter_map->recordFaceBlock(inside,index,0,jacobian,global_a_sn_view);
+                scatter_map->recordFaceBlock(inside,index,1,jacobian,global_a_ns_view);
+                scatter_map->recordFaceBlock(inside,index,2,jacobian,global_a_nn_view);
+              }
+            scatter(al_sn,global_a_sn_view);
+            scatter(al_ns,global_a_ns_view);
+            scatter(al_nn,global_a_nn_view);
+          }
       }
 
       //! @}
@@ -194,8 +347,42 @@ namespace Dune{
 
       //! Notifier functions, called immediately before and after assembling
       //! @{
+      void preAssembly()
+      {
+        // Matrices storing only their upper triangle receive the upper part of the local
+        // matrices, with Dirichlet constraints applied symmetrically.
+        upper_triangular = upperTriangularStorage(global_a_ss_view.container());
+
+        // The scatter map bypasses the constraints handling of scatter_jacobian(), so it can
+        // only be used if the local matrices are added to the global matrix unmodified.
+        use_scatter_map = false;
+        record_scatter_map = false;
+        recording_started = false;
+        if (ScatterMap::supported && !upper_triangular && !needsConstraintsCaching(trialConstraints(),testConstraints()))
+          {
+            if (scatter_map->matches(global_a_ss_view.container()))
+              use_scatter_map = true;
+            // a partial assembly does not visit all cells, so it cannot record a complete map
+            else if (!partial_assembly)
+              record_scatter_map = true;
+          }
+
+        if (contribution_caching || partial_assembly)
+          {
+            const auto& entity_set = global_s_s_view.container().gridFunctionSpace().entitySet();
+            if (partial_assembly && !(contribution_caching && contribution_cache->valid(entity_set)))
+              DUNE_THROW(Dune::InvalidStateException,"Partial assembly of the jacobian requires a preceding full assembly with contribution caching");
+            if (!partial_assembly)
+              contribution_cache->update(entity_set);
+          }
+      }
+
       void postAssembly(const GFSU& gfsu, const GFSV& gfsv)
       {
+        if (record_scatter_map && recording_started)
+          scatter_map->finishRecording();
+        record_scatter_map = false;
+
         Jacobian& jacobian = global_a_ss_view.container();
         global_s_s_view.detach();
         global_s_n_view.detach();
@@ -283,6 +470,86 @@ namespace Dune{
       //! @}
 
     private:
+
+      //! Stores a local matrix in the contribution cache or, during partial assembly, replaces it by its change.
+      //! @{
+      template<typename Element, typename M>
+      void cacheContribution(const Element& element, M& local_matrix)
+      {
+        if (partial_assembly)
+          contribution_cache->exchange(element,local_matrix);
+        else
+          contribution_cache->store(element,local_matrix);
+      }
+
+      template<typename Element, typename M>
+      void cacheContribution(const Element& inside, unsigned int intersection_index, std::size_t block, M& local_matrix)
+      {
+        if (partial_assembly)
+          contribution_cache->exchange(inside,intersection_index,block,local_matrix);
+        else
+          contribution_cache->store(inside,intersection_index,block,local_matrix);
+      }
+      //! @}
+
+      //! Scatters a local matrix, atomically if other engine copies may write to the same entries.
+      template<typename M>
+      void scatter(M& local_matrix, JacobianView& global_view)
+      {
+        if (atomic_scatter)
+          {
+            AtomicAddMatrixView<JacobianView> atomic_view(global_view);
+            scatterToStorage(local_matrix,atomic_view);
+          }
+        else
+          scatterToStorage(local_matrix,global_view);
+      }
+
+      //! Scatters a local matrix, restricted to the upper triangle if the jacobian only stores that part.
+      template<typename M, typename View>
+      void scatterToStorage(M& local_matrix, View& global_view)
+      {
+        if (upper_triangular)
+          {
+            // a diagonal local matrix has no entries in the columns of other DOFs to clear
+            const bool symmetric_mode = !std::is_base_of<lop::DiagonalJacobian,LOP>::value;
+            UpperTriangularMatrixView<View> upper_view(global_view);
+            local_assembler.scatter_jacobian(local_matrix,upper_view,symmetric_mode);
+          }
+        else
+          local_assembler.scatter_jacobian(local_matrix,global_view,false);
+      }
+
+      //! Scatters a local matrix directly into the entries recorded in the scatter map.
+      template<typename M>
+      void scatterMapped(M& local_matrix, JacobianView& global_view, const typename ScatterMap::Block& block)
+      {
+        // fall back to the regular scatter if the block has not been recorded
+        if (!block.valid() || block.rows != local_matrix.nrows() || block.cols != local_matrix.ncols())
+          {
+            scatter(local_matrix,global_view);
+            return;
+          }
+
+        for (auto it = local_matrix.begin(); it != local_matrix.end(); ++it)
+          {
+            // skip 0 entries because they might not be present in the pattern
+            if (*it == 0.0)
+              continue;
+            JacobianElement* entry = scatter_map->entry(block,it.row(),it.col());
+            if (!entry)
+              {
+                // the entry is not part of the pattern, use the regular access
+                global_view.add(it.row(),it.col(),*it);
+                continue;
+              }
+            if (atomic_scatter)
+              atomicAdd(*entry,JacobianElement(*it));
+            else
+              *entry += *it;
+          }
+      }
+
       //! Reference to the wrapping local assembler object which
       //! constructed this engine
       const LocalAssembler & local_assembler;
@@ -330,6 +597,23 @@ namespace Dune{
 
       //! @}
 
+      //! Whether local matrices are scattered with atomic additions
+      bool atomic_scatter;
+
+      //! Whether the jacobian only stores its upper triangle
+      bool upper_triangular;
+
+      //! Addresses of the matrix entries of all local blocks, shared by all copies of the engine
+      std::shared_ptr<ScatterMap> scatter_map;
+      bool use_scatter_map;
+      bool record_scatter_map;
+      bool recording_started;
+
+      //! Local matrices of the last assembly, shared by all copies of the engine
+      std::shared_ptr<ContributionCache> contribution_cache;
+      bool contribution_caching;
+      bool partial_assembly;
+
     }; // End of class DefaultLocalJacobianAssemblerEngine
 
   }
@@ -7,6 +7,9 @@
 #include <dune/pdelab/gridoperator/default/patternengine.hh>
 #include <dune/pdelab/gridoperator/default/jacobianengine.hh>
 #include <dune/pdelab/gridoperator/default/jacobianapplyengine.hh>
+#include <dune/pdelab/gridoperator/default/residualjacobianengine.hh>
+#include <dune/pdelab/gridoperator/default/elementmatrixengine.hh>
+#include <dune/pdelab/gridoperator/default/staticcondensationengine.hh>
 #include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
 #include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
 
@@ -72,6 +75,9 @@ namespace Dune{
       typedef DefaultLocalResidualAssemblerEngine<DefaultLocalAssembler> LocalResidualAssemblerEngine;
       typedef DefaultLocalJacobianAssemblerEngine<DefaultLocalAssembler> LocalJacobianAssemblerEngine;
       typedef DefaultLocalJacobianApplyAssemblerEngine<DefaultLocalAssembler> LocalJacobianApplyAssemblerEngine;
+      typedef DefaultLocalResidualJacobianAssemblerEngine<DefaultLocalAssembler> LocalResidualJacobianAssemblerEngine;
+      typedef DefaultLocalElementMatrixAssemblerEngine<DefaultLocalAssembler> LocalElementMatrixAssemblerEngine;
+      typedef DefaultLocalStaticCondensationAssemblerEngine<DefaultLocalAssembler> LocalStaticCondensationAssemblerEngine;
 
       // friend declarations such that engines are able to call scatter_jacobian() and add_entry() from base class
       friend class DefaultLocalPatternAssemblerEngine<DefaultLocalAssembler>;
@@ -83,7 +89,12 @@ namespace Dune{
         : lop_(lop),  weight_(1.0), doPreProcessing_(true), doPostProcessing_(true),
           pattern_engine(*this,border_dof_exchanger), residual_engine(*this), jacobian_engine(*this)
         , jacobian_apply_engine(*this)
+        , residual_jacobian_engine(*this,residual_engine,jacobian_engine)
+        , element_matrix_engine(*this)
+        , static_condensation_engine(*this,residual_engine,jacobian_engine)
         , _reconstruct_border_entries(isNonOverlapping)
+        , _element_matrix_caching(false)
+        , _static_condensation(false)
       {}
 
       //! Constructor for non trivial constraints
@@ -93,7 +104,12 @@ namespace Dune{
           lop_(lop),  weight_(1.0), doPreProcessing_(true), doPostProcessing_(true),
           pattern_engine(*this,border_dof_exchanger), residual_engine(*this), jacobian_engine(*this)
         , jacobian_apply_engine(*this)
+        , residual_jacobian_engine(*this,residual_engine,jacobian_engine)
+        , element_matrix_engine(*this)
+        , static_condensation_engine(*this,residual_engine,jacobian_engine)
         , _reconstruct_border_entries(isNonOverlapping)
+        , _element_matrix_caching(false)
+        , _static_condensation(false)
       {}
 
       //! get a reference to the local operator
@@ -136,6 +152,55 @@ namespace Dune{
       Real suggestTimestep (Real dt) const{return lop_.suggestTimestep(dt); }
       //! @}
 
+      //! Discards the information about the grid and the matrix layout cached by the engines.
+      void update()
+      {
+        jacobian_engine.invalidateScatterMap();
+        residual_engine.invalidateContributionCache();
+        jacobian_engine.invalidateContributionCache();
+        element_matrix_engine.invalidate();
+        static_condensation_engine.invalidate();
+      }
+
+      //! Enables or disables keeping the local residuals and matrices of the last assembly for partial assembly.
+      void setContributionCaching(bool enable)
+      {
+        residual_engine.setContributionCaching(enable);
+        jacobian_engine.setContributionCaching(enable);
+      }
+
+      //! Whether the local residuals and matrices of the last assembly are kept.
+      bool contributionCaching() const
+      {
+        return residual_engine.contributionCaching();
+      }
+
+      //! Enables or disables applying the jacobian of a linear operator with cached local matrices.
+      void setElementMatrixCaching(bool enable)
+      {
+        _element_matrix_caching = enable;
+        element_matrix_engine.invalidate();
+      }
+
+      //! Whether the jacobian of a linear operator is applied with cached local matrices.
+      bool elementMatrixCaching() const
+      {
+        return _element_matrix_caching;
+      }
+
+      //! Enables or disables static condensation of the cell interior DOFs in the matrix pattern.
+      void setStaticCondensation(bool enable)
+      {
+        _static_condensation = enable;
+        static_condensation_engine.invalidate();
+      }
+
+      //! Whether the matrix pattern omits the couplings of the cell interior DOFs.
+      bool staticCondensation() const
+      {
+        return _static_condensation;
+      }
+
       bool reconstructBorderEntries() const
       {
         return _reconstruct_border_entries;
@@ -160,6 +225,7 @@ namespace Dune{
       {
         residual_engine.setResidual(r);
         residual_engine.setSolution(x);
+        residual_engine.setPartialAssembly(false);
         return residual_engine;
       }
 
@@ -170,6 +236,7 @@ namespace Dune{
       {
         jacobian_engine.setJacobian(a);
         jacobian_engine.setSolution(x);
+        jacobian_engine.setPartialAssembly(false);
         return jacobian_engine;
       }
 
@@ -194,6 +261,48 @@ namespace Dune{
         return jacobian_apply_engine;
       }
 
+      //! Returns a reference to the engine which stores the local
+      //! matrices for element matrix caching.
+      LocalElementMatrixAssemblerEngine & localElementMatrixAssemblerEngine()
+      {
+        return element_matrix_engine;
+      }
+
+      //! Returns a reference to the requested engine. This engine is
+      //! completely configured and ready to use.
+      LocalResidualJacobianAssemblerEngine & localResidualJacobianAssemblerEngine
+      (typename Traits::Residual & r, typename Traits::Jacobian & a, const typename Traits::Solution & x)
+      {
+        residual_engine.setResidual(r);
+        residual_engine.setSolution(x);
+        residual_engine.setPartialAssembly(false);
+        jacobian_engine.setJacobian(a);
+        jacobian_engine.setSolution(x);
+        jacobian_engine.setPartialAssembly(false);
+        return residual_jacobian_engine;
+      }
+
+      //! Returns a reference to the requested engine. This engine is
+      //! completely configured and ready to use.
+      LocalStaticCondensationAssemblerEngine & localStaticCondensationAssemblerEngine
+      (typename Traits::Residual & r, typename Traits::Jacobian & a, const typename Traits::Solution & x)
+      {
+        residual_engine.setResidual(r);
+        residual_engine.setSolution(x);
+        residual_engine.setPartialAssembly(false);
+        jacobian_engine.setJacobian(a);
+        jacobian_engine.setSolution(x);
+        jacobian_engine.setPartialAssembly(false);
+        return static_condensation_engine;
+      }
+
+      //! Returns a reference to the engine which stores the data for
+      //! recovering the cell interior DOFs.
+      const LocalStaticCondensationAssemblerEngine & localStaticCondensationAssemblerEngine() const
+      {
+        return static_condensation_engine;
+      }
+
       //! @}
 
       //! \brief Query methods for the assembler engines. Theses methods
@@ -268,9 +377,14 @@ namespace Dune{
       LocalResidualAssemblerEngine residual_engine;
       LocalJacobianAssemblerEngine jacobian_engine;
       LocalJacobianApplyAssemblerEngine jacobian_apply_engine;
+      LocalResidualJacobianAssemblerEngine residual_jacobian_engine;
+      LocalElementMatrixAssemblerEngine element_matrix_engine;
+      LocalStaticCondensationAssemblerEngine static_condensation_engine;
       //! @}
 
       bool _reconstruct_border_entries;
+      bool _element_matrix_caching;
+      bool _static_condensation;
     };
 
   } // end namespace PDELab
@@ -1,10 +1,14 @@
 #ifndef DUNE_PDELAB_GRIDOPERATOR_DEFAULT_PATTERNENGINE_HH
 #define DUNE_PDELAB_GRIDOPERATOR_DEFAULT_PATTERNENGINE_HH
 
+#include <algorithm>
+#include <vector>
+
 #include <dune/pdelab/gridfunctionspace/localvector.hh>
 #include <dune/pdelab/gridoperator/common/localmatrix.hh>
 #include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
 #include <dune/pdelab/gridoperator/common/localassemblerenginebase.hh>
+#include <dune/pdelab/gridoperator/common/staticcondensation.hh>
 #include <dune/pdelab/constraints/common/constraints.hh>
 #include <dune/pdelab/localoperator/callswitch.hh>
 
@@ -158,12 +162,36 @@ namespace Dune{
       }
 
 
+      //! Removes the couplings of the cell interior DOFs eliminated by static condensation,
+      //! only their diagonal entries remain in the pattern.
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void remove_interior_links(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        classifyCellDOFs(eg.entity().type(),lfsv_cache,interior,exterior);
+        if (interior.empty())
+          return;
+        is_interior.assign(lfsv_cache.size(),false);
+        for (auto i : interior)
+          {
+            is_interior[i] = true;
+            local_assembler.add_entry(*pattern,lfsv_cache,i,lfsu_cache,i);
+          }
+        localpattern.erase(std::remove_if(localpattern.begin(),localpattern.end(),
+                                          [&](const SparsityLink& link)
+                                          {
+                                            return is_interior[link.i()] || is_interior[link.j()];
+                                          }),
+                           localpattern.end());
+      }
+
       //! Called when the local function space is about to be rebound or
       //! discarded
       //! @{
       template<typename EG, typename LFSUC, typename LFSVC>
       void onUnbindLFSUV(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
       {
+        if (local_assembler.staticCondensation())
+          remove_interior_links(eg,lfsu_cache,lfsv_cache);
         add_pattern(lfsv_cache,lfsu_cache,localpattern);
         localpattern.clear();
       }
@@ -290,6 +318,10 @@ namespace Dune{
       LocalPattern localpattern;
       LocalPattern localpattern_sn, localpattern_ns;
 
+      //! Classification of the DOFs for static condensation
+      std::vector<std::size_t> interior, exterior;
+      std::vector<bool> is_interior;
+
       BorderPattern _border_pattern;
 
       std::shared_ptr<BorderDOFExchanger> _border_dof_exchanger;
@@ -1,8 +1,12 @@
 #ifndef DUNE_PDELAB_GRIDOPERATOR_DEFAULT_RESIDUALENGINE_HH
 #define DUNE_PDELAB_GRIDOPERATOR_DEFAULT_RESIDUALENGINE_HH
 
+#include <memory>
+#include <vector>
+
 #include <dune/pdelab/gridfunctionspace/localvector.hh>
 #include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
+#include <dune/pdelab/gridoperator/common/localcontributioncache.hh>
 #include <dune/pdelab/gridoperator/common/localassemblerenginebase.hh>
 #include <dune/pdelab/constraints/common/constraints.hh>
 #include <dune/pdelab/localoperator/callswitch.hh>
@@ -23,6 +27,10 @@ namespace Dune{
     {
     public:
 
+      // the fused residual and jacobian engine and the static condensation engine work on the local containers of this engine
+      template<typename> friend class DefaultLocalResidualJacobianAssemblerEngine;
+      template<typename> friend class DefaultLocalStaticCondensationAssemblerEngine;
+
       template<typename TrialConstraintsContainer, typename TestConstraintsContainer>
       bool needsConstraintsCaching(const TrialConstraintsContainer& cu, const TestConstraintsContainer& cv) const
       {
@@ -54,6 +62,9 @@ namespace Dune{
       typedef typename Solution::template ConstLocalView<LFSUCache> SolutionView;
       typedef typename Residual::template LocalView<LFSVCache> ResidualView;
 
+      //! The local residuals of the last assembly, required for partial assembly
+      typedef LocalContributionCache<typename GFSU::Traits::EntitySet,ResidualElement> ContributionCache;
+
       /**
          \brief Constructor
 
@@ -64,7 +75,31 @@ namespace Dune{
         : local_assembler(local_assembler_),
           lop(local_assembler_.localOperator()),
           rl_view(rl,1.0),
-          rn_view(rn,1.0)
+          rn_view(rn,1.0),
+          contribution_cache(std::make_shared<ContributionCache>(1)),
+          contribution_caching(false),
+          partial_assembly(false)
+      {}
+
+      /**
+         \brief Copy constructor
+
+         The copy assembles into the same global vectors as the original
+         engine, but uses its own local containers, e.g. on another thread.
+         It shares the contribution cache of the original engine.
+      */
+      DefaultLocalResidualAssemblerEngine(const DefaultLocalResidualAssemblerEngine& other)
+        : local_assembler(other.local_assembler),
+          lop(other.lop),
+          global_rl_view(other.global_rl_view),
+          global_rn_view(other.global_rn_view),
+          global_sl_view(other.global_sl_view),
+          global_sn_view(other.global_sn_view),
+          rl_view(rl,1.0),
+          rn_view(rn,1.0),
+          contribution_cache(other.contribution_cache),
+          contribution_caching(other.contribution_caching),
+          partial_assembly(other.partial_assembly)
       {}
 
       //! Query methods for the global grid assembler
@@ -89,6 +124,10 @@ namespace Dune{
       { return local_assembler.doAlphaVolumePostSkeleton(); }
       bool requireVVolumePostSkeleton() const
       { return local_assembler.doLambdaVolumePostSkeleton(); }
+      bool supportsThreadedAssembly() const
+      { return true; }
+      bool supportsTaskAssembly() const
+      { return true; }
       //! @}
 
       //! Public access to the wrapping local assembler
@@ -125,6 +164,54 @@ namespace Dune{
         global_sn_view.attach(solution_);
       }
 
+      //! Enables or disables keeping the local residuals of the last assembly, see setPartialAssembly().
+      void setContributionCaching(bool enable)
+      {
+        contribution_caching = enable;
+        if (!enable)
+          contribution_cache->invalidate();
+      }
+
+      //! Whether the local residuals of the last assembly are kept.
+      bool contributionCaching() const
+      {
+        return contribution_caching;
+      }
+
+      //! Makes the next assembly add only the change of the local residuals to the current residual.
+      /**
+       * Partial assembly requires that the current residual is the result of the preceding
+       * assemblies with contribution caching enabled, the first of which must have been a
+       * full one. Each reassembled cell then adds the difference between its new and its
+       * cached local residuals, so that cells whose coefficients did not change can be skipped.
+       */
+      void setPartialAssembly(bool partial)
+      {
+        partial_assembly = partial;
+      }
+
+      //! Discards the cached local residuals, must be called after the grid or the function spaces have changed.
+      void invalidateContributionCache()
+      {
+        contribution_cache->invalidate();
+      }
+
+      //! Redirects the contributions of this engine copy into the private residual of the given thread.
+      void beginTaskAssembly(TaskBuffers& buffers, std::size_t thread)
+      {
+        setResidual(buffers.vector(thread,global_rl_view.container()));
+      }
+
+      //! Adds the given part of the private residuals of the engine copies to the current residual.
+      void mergeTaskAssembly(const std::vector<DefaultLocalResidualAssemblerEngine*>& copies,
+                             std::size_t part, std::size_t parts)
+      {
+        std::vector<const Residual*> residuals;
+        for (auto copy : copies)
+          residuals.push_back(&copy->global_rl_view.container());
+        addTaskBuffers(global_rl_view.container(),residuals,part,parts);
+      }
+
       //! Called immediately after binding of local function space in
       //! global assembler.
       //! @{
@@ -182,6 +269,8 @@ namespace Dune{
       template<typename EG, typename LFSVC>
       void onUnbindLFSV(const EG & eg, const LFSVC & lfsv_cache)
       {
+        if (contribution_caching)
+          cacheContribution(eg.entity(),rl);
         global_rl_view.add(rl);
         global_rl_view.commit();
       }
@@ -198,6 +287,8 @@ namespace Dune{
                                const LFSVC & lfsv_s_cache,
                                const LFSVC & lfsv_n_cache)
       {
+        if (contribution_caching)
+          cacheContribution(ig.inside(),ig.intersectionIndex(),rn);
         global_rn_view.add(rn);
         global_rn_view.commit();
       }
@@ -225,6 +316,18 @@ namespace Dune{
       //! Notifier functions, called immediately before and after assembling
       //! @{
 
+      void preAssembly()
+      {
+        if (contribution_caching || partial_assembly)
+          {
+            const auto& entity_set = global_sl_view.container().gridFunctionSpace().entitySet();
+            if (partial_assembly && !(contribution_caching && contribution_cache->valid(entity_set)))
+              DUNE_THROW(Dune::InvalidStateException,"Partial assembly of the residual requires a preceding full assembly with contribution caching");
+            if (!partial_assembly)
+              contribution_cache->update(entity_set);
+          }
+      }
+
       void postAssembly(const GFSU& gfsu, const GFSV& gfsv)
       {
         if(local_assembler.doPostProcessing())
@@ -340,6 +443,28 @@ namespace Dune{
       //! @}
 
     private:
+
+      //! Stores a local residual in the contribution cache or, during partial assembly, replaces it by its change.
+      //! @{
+      template<typename Element, typename C>
+      void cacheContribution(const Element& element, C& local)
+      {
+        if (partial_assembly)
+          contribution_cache->exchange(element,local);
+        else
+          contribution_cache->store(element,local);
+      }
+
+      template<typename Element, typename C>
+      void cacheContribution(const Element& inside, unsigned int intersection_index, C& local)
+      {
+        if (partial_assembly)
+          contribution_cache->exchange(inside,intersection_index,0,local);
+        else
+          contribution_cache->store(inside,intersection_index,0,local);
+      }
+      //! @}
+
       //! Reference to the wrapping local assembler object which
       //! constructed this engine
       const LocalAssembler & local_assembler;
@@ -377,6 +502,11 @@ namespace Dune{
       typename ResidualVector::WeightedAccumulationView rn_view;
       //! @}
 
+      //! Local residuals of the last assembly, shared by all copies of the engine
+      std::shared_ptr<ContributionCache> contribution_cache;
+      bool contribution_caching;
+      bool partial_assembly;
+
     }; // End of class DefaultLocalResidualAssemblerEngine
 
   }
@@ -0,0 +1,526 @@
+#ifndef DUNE_PDELAB_GRIDOPERATOR_DEFAULT_RESIDUALJACOBIANENGINE_HH
+#define DUNE_PDELAB_GRIDOPERATOR_DEFAULT_RESIDUALJACOBIANENGINE_HH
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/std/type_traits.hh>
+
+#include <dune/pdelab/gridoperator/common/localassemblerenginebase.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+#ifndef DOXYGEN
+    namespace Impl {
+
+      template<typename LOP, typename EG, typename LFSU, typename X, typename LFSV, typename R, typename M>
+      using AlphaAndJacobianVolume = decltype(std::declval<const LOP&>().alpha_and_jacobian_volume(
+        std::declval<const EG&>(),std::declval<const LFSU&>(),std::declval<const X&>(),std::declval<const LFSV&>(),
+        std::declval<R&>(),std::declval<M&>()));
+
+      template<typename LOP, typename EG, typename LFSU, typename X, typename LFSV, typename R, typename M>
+      using AlphaAndJacobianVolumePostSkeleton = decltype(std::declval<const LOP&>().alpha_and_jacobian_volume_post_skeleton(
+        std::declval<const EG&>(),std::declval<const LFSU&>(),std::declval<const X&>(),std::declval<const LFSV&>(),
+        std::declval<R&>(),std::declval<M&>()));
+
+      template<typename LOP, typename IG, typename LFSU, typename X, typename LFSV, typename R, typename M>
+      using AlphaAndJacobianBoundary = decltype(std::declval<const LOP&>().alpha_and_jacobian_boundary(
+        std::declval<const IG&>(),std::declval<const LFSU&>(),std::declval<const X&>(),std::declval<const LFSV&>(),
+        std::declval<R&>(),std::declval<M&>()));
+
+      template<typename LOP, typename IG, typename LFSU, typename X, typename LFSV, typename R, typename M>
+      using AlphaAndJacobianSkeleton = decltype(std::declval<const LOP&>().alpha_and_jacobian_skeleton(
+        std::declval<const IG&>(),
+        std::declval<const LFSU&>(),std::declval<const X&>(),std::declval<const LFSV&>(),
+        std::declval<const LFSU&>(),std::declval<const X&>(),std::declval<const LFSV&>(),
+        std::declval<R&>(),std::declval<R&>(),
+        std::declval<M&>(),std::declval<M&>(),std::declval<M&>(),std::declval<M&>()));
+
+    }
+#endif // DOXYGEN
+
+    /**
+       \brief The local assembler engine for DUNE grids which
+       assembles the residual vector and the jacobian matrix in a
+       single grid traversal
+
+       The engine drives the residual and the jacobian engine of the
+       local assembler, so the grid is traversed, the local function
+       spaces are bound and the coefficients are loaded only once for
+       both. Local operators may additionally provide the methods
+
+       \code
+       alpha_and_jacobian_volume(eg,lfsu,x,lfsv,r,mat)
+       alpha_and_jacobian_volume_post_skeleton(eg,lfsu,x,lfsv,r,mat)
+       alpha_and_jacobian_boundary(ig,lfsu_s,x_s,lfsv_s,r_s,mat_ss)
+       alpha_and_jacobian_skeleton(ig,lfsu_s,x_s,lfsv_s,lfsu_n,x_n,lfsv_n,r_s,r_n,mat_ss,mat_sn,mat_ns,mat_nn)
+       \endcode
+
+       to evaluate the residual and the jacobian in one pass over the
+       quadrature points. They are called instead of the separate
+       alpha_*() and jacobian_*() methods if present.
+
+       \tparam LA The local assembler
+
+    */
+    template<typename LA>
+    class DefaultLocalResidualJacobianAssemblerEngine
+      : public LocalAssemblerEngineBase
+    {
+    public:
+
+      //! The type of the wrapping local assembler
+      typedef LA LocalAssembler;
+
+      //! The type of the local operator
+      typedef typename LA::LocalOperator LOP;
+
+      //! The engines assembling the residual and the jacobian
+      typedef typename LA::LocalResidualAssemblerEngine ResidualEngine;
+      typedef typename LA::LocalJacobianAssemblerEngine JacobianEngine;
+
+      //! The local function spaces
+      typedef typename LA::LFSU LFSU;
+      typedef typename LFSU::Traits::GridFunctionSpace GFSU;
+      typedef typename LA::LFSV LFSV;
+      typedef typename LFSV::Traits::GridFunctionSpace GFSV;
+
+      template<typename TrialConstraintsContainer, typename TestConstraintsContainer>
+      bool needsConstraintsCaching(const TrialConstraintsContainer& cu, const TestConstraintsContainer& cv) const
+      {
+        return jacobian_engine->needsConstraintsCaching(cu,cv);
+      }
+
+      /**
+         \brief Constructor
+
+         \param [in] local_assembler_ The local assembler object which
+         creates this engine
+         \param [in] residual_engine_ The residual engine of the local assembler
+         \param [in] jacobian_engine_ The jacobian engine of the local assembler
+      */
+      DefaultLocalResidualJacobianAssemblerEngine(const LocalAssembler & local_assembler_,
+                                                  ResidualEngine & residual_engine_,
+                                                  JacobianEngine & jacobian_engine_)
+        : local_assembler(local_assembler_),
+          lop(local_assembler_.localOperator()),
+          residual_engine(&residual_engine_),
+          jacobian_engine(&jacobian_engine_)
+      {}
+
+      /**
+         \brief Copy constructor
+
+         The copy owns copies of the residual and the jacobian engine,
+         so it assembles into the same global containers as the
+         original engine, but uses its own local containers, e.g. on
+         another thread.
+      */
+      DefaultLocalResidualJacobianAssemblerEngine(const DefaultLocalResidualJacobianAssemblerEngine& other)
+        : local_assembler(other.local_assembler),
+          lop(other.lop),
+          residual_engine_copy(std::make_unique<ResidualEngine>(*other.residual_engine)),
+          jacobian_engine_copy(std::make_unique<JacobianEngine>(*other.jacobian_engine)),
+          residual_engine(residual_engine_copy.get()),
+          jacobian_engine(jacobian_engine_copy.get())
+      {}
+
+      //! Query methods for the global grid assembler
+      //! @{
+      bool requireSkeleton() const
+      { return residual_engine->requireSkeleton() || jacobian_engine->requireSkeleton(); }
+      bool requireSkeletonTwoSided() const
+      { return residual_engine->requireSkeletonTwoSided() || jacobian_engine->requireSkeletonTwoSided(); }
+      bool requireUVVolume() const
+      { return residual_engine->requireUVVolume() || jacobian_engine->requireUVVolume(); }
+      bool requireVVolume() const
+      { return residual_engine->requireVVolume() || jacobian_engine->requireVVolume(); }
+      bool requireUVSkeleton() const
+      { return residual_engine->requireUVSkeleton() || jacobian_engine->requireUVSkeleton(); }
+      bool requireVSkeleton() const
+      { return residual_engine->requireVSkeleton() || jacobian_engine->requireVSkeleton(); }
+      bool requireUVBoundary() const
+      { return residual_engine->requireUVBoundary() || jacobian_engine->requireUVBoundary(); }
+      bool requireVBoundary() const
+      { return residual_engine->requireVBoundary() || jacobian_engine->requireVBoundary(); }
+      bool requireUVVolumePostSkeleton() const
+      { return residual_engine->requireUVVolumePostSkeleton() || jacobian_engine->requireUVVolumePostSkeleton(); }
+      bool requireVVolumePostSkeleton() const
+      { return residual_engine->requireVVolumePostSkeleton() || jacobian_engine->requireVVolumePostSkeleton(); }
+      bool supportsThreadedAssembly() const
+      { return residual_engine->supportsThreadedAssembly() && jacobian_engine->supportsThreadedAssembly(); }
+      bool supportsTaskAssembly() const
+      { return residual_engine->supportsTaskAssembly() && jacobian_engine->supportsTaskAssembly(); }
+      //! @}
+
+      //! Public access to the wrapping local assembler
+      const LocalAssembler & localAssembler() const
+      {
+        return local_assembler;
+      }
+
+      //! Prepares the copies of both engines for task-based assembly.
+      void beginTaskAssembly(TaskBuffers& buffers, std::size_t thread)
+      {
+        residual_engine->beginTaskAssembly(buffers,thread);
+        jacobian_engine->beginTaskAssembly(buffers,thread);
+      }
+
+      //! Collects the given part of the results of the engines of the copies after task-based assembly.
+      void mergeTaskAssembly(const std::vector<DefaultLocalResidualJacobianAssemblerEngine*>& copies,
+                             std::size_t part, std::size_t parts)
+      {
+        std::vector<ResidualEngine*> residual_engines;
+        std::vector<JacobianEngine*> jacobian_engines;
+        for (auto copy : copies)
+          {
+            residual_engines.push_back(copy->residual_engine);
+            jacobian_engines.push_back(copy->jacobian_engine);
+          }
+        residual_engine->mergeTaskAssembly(residual_engines,part,parts);
+        jacobian_engine->mergeTaskAssembly(jacobian_engines,part,parts);
+      }
+
+      //! Called immediately after binding of local function space in
+      //! global assembler.
+      //! @{
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void onBindLFSUV(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        residual_engine->onBindLFSUV(eg,lfsu_cache,lfsv_cache);
+        jacobian_engine->onBindLFSUV(eg,lfsu_cache,lfsv_cache);
+      }
+
+      template<typename EG, typename LFSVC>
+      void onBindLFSV(const EG & eg, const LFSVC & lfsv_cache)
+      {
+        residual_engine->onBindLFSV(eg,lfsv_cache);
+        jacobian_engine->onBindLFSV(eg,lfsv_cache);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void onBindLFSUVInside(const IG & ig, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        residual_engine->onBindLFSUVInside(ig,lfsu_cache,lfsv_cache);
+        jacobian_engine->onBindLFSUVInside(ig,lfsu_cache,lfsv_cache);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void onBindLFSUVOutside(const IG & ig,
+                              const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                              const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache)
+      {
+        residual_engine->onBindLFSUVOutside(ig,lfsu_s_cache,lfsv_s_cache,lfsu_n_cache,lfsv_n_cache);
+        jacobian_engine->onBindLFSUVOutside(ig,lfsu_s_cache,lfsv_s_cache,lfsu_n_cache,lfsv_n_cache);
+      }
+
+      template<typename IG, typename LFSVC>
+      void onBindLFSVInside(const IG & ig, const LFSVC & lfsv_cache)
+      {
+        residual_engine->onBindLFSVInside(ig,lfsv_cache);
+        jacobian_engine->onBindLFSVInside(ig,lfsv_cache);
+      }
+
+      template<typename IG, typename LFSVC>
+      void onBindLFSVOutside(const IG & ig,
+                             const LFSVC & lfsv_s_cache,
+                             const LFSVC & lfsv_n_cache)
+      {
+        residual_engine->onBindLFSVOutside(ig,lfsv_s_cache,lfsv_n_cache);
+        jacobian_engine->onBindLFSVOutside(ig,lfsv_s_cache,lfsv_n_cache);
+      }
+      //! @}
+
+      //! Called when the local function space is about to be rebound or
+      //! discarded
+      //! @{
+      template<typename EG, typename LFSVC>
+      void onUnbindLFSV(const EG & eg, const LFSVC & lfsv_cache)
+      {
+        residual_engine->onUnbindLFSV(eg,lfsv_cache);
+        jacobian_engine->onUnbindLFSV(eg,lfsv_cache);
+      }
+
+      template<typename IG, typename LFSVC>
+      void onUnbindLFSVInside(const IG & ig, const LFSVC & lfsv_cache)
+      {
+        residual_engine->onUnbindLFSVInside(ig,lfsv_cache);
+        jacobian_engine->onUnbindLFSVInside(ig,lfsv_cache);
+      }
+
+      template<typename IG, typename LFSVC>
+      void onUnbindLFSVOutside(const IG & ig,
+                               const LFSVC & lfsv_s_cache,
+                               const LFSVC & lfsv_n_cache)
+      {
+        residual_engine->onUnbindLFSVOutside(ig,lfsv_s_cache,lfsv_n_cache);
+        jacobian_engine->onUnbindLFSVOutside(ig,lfsv_s_cache,lfsv_n_cache);
+      }
+
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void onUnbindLFSUV(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        residual_engine->onUnbindLFSUV(eg,lfsu_cache,lfsv_cache);
+        jacobian_engine->onUnbindLFSUV(eg,lfsu_cache,lfsv_cache);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void onUnbindLFSUVOutside(const IG & ig,
+                                const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                                const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache)
+      {
+        residual_engine->onUnbindLFSUVOutside(ig,lfsu_s_cache,lfsv_s_cache,lfsu_n_cache,lfsv_n_cache);
+        jacobian_engine->onUnbindLFSUVOutside(ig,lfsu_s_cache,lfsv_s_cache,lfsu_n_cache,lfsv_n_cache);
+      }
+      //! @}
+
+      //! Methods for loading of the local function's coefficients
+      /**
+       * The coefficients are read from the solution vector once and
+       * copied to the local containers of the jacobian engine.
+       */
+      //! @{
+      template<typename LFSUC>
+      void loadCoefficientsLFSUInside(const LFSUC & lfsu_s_cache)
+      {
+        residual_engine->loadCoefficientsLFSUInside(lfsu_s_cache);
+        jacobian_engine->xl = residual_engine->xl;
+      }
+      template<typename LFSUC>
+      void loadCoefficientsLFSUOutside(const LFSUC & lfsu_n_cache)
+      {
+        residual_engine->loadCoefficientsLFSUOutside(lfsu_n_cache);
+        jacobian_engine->xn = residual_engine->xn;
+      }
+      template<typename LFSUC>
+      void loadCoefficientsLFSUCoupling(const LFSUC & lfsu_c_cache)
+      {
+        DUNE_THROW(Dune::NotImplemented,"No coupling lfsu available for ");
+      }
+      //! @}
+
+      //! Notifier functions, called immediately before and after assembling
+      //! @{
+      void preAssembly()
+      {
+        residual_engine->preAssembly();
+        jacobian_engine->preAssembly();
+      }
+
+      void postAssembly(const GFSU& gfsu, const GFSV& gfsv)
+      {
+        residual_engine->postAssembly(gfsu,gfsv);
+        jacobian_engine->postAssembly(gfsu,gfsv);
+      }
+      //! @}
+
+      //! Assembling methods
+      //! @{
+
+      /** Assemble on a given cell without function spaces.
+
+          \return If true, the assembling for this cell is assumed to
+          be complete and the assembler continues with the next grid
+          cell.
+       */
+      template<typename EG>
+      bool assembleCell(const EG & eg)
+      {
+        const bool abort_r = residual_engine->assembleCell(eg);
+        const bool abort_j = jacobian_engine->assembleCell(eg);
+        return abort_r && abort_j;
+      }
+
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void assembleUVVolume(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        assembleUVVolume(eg,lfsu_cache,lfsv_cache,
+                         std::integral_constant<bool,LOP::doAlphaVolume &&
+                         Std::is_detected<Impl::AlphaAndJacobianVolume,LOP,EG,LFSU,SolutionVector,LFSV,ResidualView,JacobianView>::value>());
+      }
+
+      template<typename EG, typename LFSVC>
+      void assembleVVolume(const EG & eg, const LFSVC & lfsv_cache)
+      {
+        residual_engine->assembleVVolume(eg,lfsv_cache);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void assembleUVSkeleton(const IG & ig, const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                              const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache)
+      {
+        assembleUVSkeleton(ig,lfsu_s_cache,lfsv_s_cache,lfsu_n_cache,lfsv_n_cache,
+                           std::integral_constant<bool,LOP::doAlphaSkeleton &&
+                           Std::is_detected<Impl::AlphaAndJacobianSkeleton,LOP,IG,LFSU,SolutionVector,LFSV,ResidualView,JacobianView>::value>());
+      }
+
+      template<typename IG, typename LFSVC>
+      void assembleVSkeleton(const IG & ig, const LFSVC & lfsv_s_cache, const LFSVC & lfsv_n_cache)
+      {
+        residual_engine->assembleVSkeleton(ig,lfsv_s_cache,lfsv_n_cache);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void assembleUVBoundary(const IG & ig, const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache)
+      {
+        assembleUVBoundary(ig,lfsu_s_cache,lfsv_s_cache,
+                           std::integral_constant<bool,LOP::doAlphaBoundary &&
+                           Std::is_detected<Impl::AlphaAndJacobianBoundary,LOP,IG,LFSU,SolutionVector,LFSV,ResidualView,JacobianView>::value>());
+      }
+
+      template<typename IG, typename LFSVC>
+      void assembleVBoundary(const IG & ig, const LFSVC & lfsv_s_cache)
+      {
+        residual_engine->assembleVBoundary(ig,lfsv_s_cache);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      static void assembleUVEnrichedCoupling(const IG & ig,
+                                             const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                                             const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache,
+                                             const LFSUC & lfsu_coupling_cache, const LFSVC & lfsv_coupling_cache)
+      {
+        DUNE_THROW(Dune::NotImplemented,"Assembling of coupling spaces is not implemented for ");
+      }
+
+      template<typename IG, typename LFSVC>
+      static void assembleVEnrichedCoupling(const IG & ig,
+                                            const LFSVC & lfsv_s_cache,
+                                            const LFSVC & lfsv_n_cache,
+                                            const LFSVC & lfsv_coupling_cache)
+      {
+        DUNE_THROW(Dune::NotImplemented,"Assembling of coupling spaces is not implemented for ");
+      }
+
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void assembleUVVolumePostSkeleton(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        assembleUVVolumePostSkeleton(eg,lfsu_cache,lfsv_cache,
+                                     std::integral_constant<bool,LOP::doAlphaVolumePostSkeleton &&
+                                     Std::is_detected<Impl::AlphaAndJacobianVolumePostSkeleton,LOP,EG,LFSU,SolutionVector,LFSV,ResidualView,JacobianView>::value>());
+      }
+
+      template<typename EG, typename LFSVC>
+      void assembleVVolumePostSkeleton(const EG & eg, const LFSVC & lfsv_cache)
+      {
+        residual_engine->assembleVVolumePostSkeleton(eg,lfsv_cache);
+      }
+
+      //! @}
+
+    protected:
+
+      //! The local containers of the residual and the jacobian engine
+      //! @{
+      typedef decltype(std::declval<ResidualEngine&>().xl) SolutionVector;
+      typedef decltype(std::declval<ResidualEngine&>().rl_view) ResidualView;
+      typedef decltype(std::declval<JacobianEngine&>().al_view) JacobianView;
+      //! @}
+
+      //! Sets the weight of the local containers used by the combined local operator methods.
+      void setWeights()
+      {
+        residual_engine->rl_view.setWeight(local_assembler.weight());
+        residual_engine->rn_view.setWeight(local_assembler.weight());
+        jacobian_engine->al_view.setWeight(local_assembler.weight());
+        jacobian_engine->al_sn_view.setWeight(local_assembler.weight());
+        jacobian_engine->al_ns_view.setWeight(local_assembler.weight());
+        jacobian_engine->al_nn_view.setWeight(local_assembler.weight());
+      }
+
+      //! Assembling methods for local operators with and without combined residual and jacobian methods
+      //! @{
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void assembleUVVolume(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache, std::true_type)
+      {
+        setWeights();
+        lop.alpha_and_jacobian_volume(eg,
+                                      lfsu_cache.localFunctionSpace(),residual_engine->xl,lfsv_cache.localFunctionSpace(),
+                                      residual_engine->rl_view,jacobian_engine->al_view);
+      }
+
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void assembleUVVolume(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache, std::false_type)
+      {
+        residual_engine->assembleUVVolume(eg,lfsu_cache,lfsv_cache);
+        jacobian_engine->assembleUVVolume(eg,lfsu_cache,lfsv_cache);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void assembleUVSkeleton(const IG & ig, const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                              const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache, std::true_type)
+      {
+        setWeights();
+        lop.alpha_and_jacobian_skeleton(ig,
+                                        lfsu_s_cache.localFunctionSpace(),residual_engine->xl,lfsv_s_cache.localFunctionSpace(),
+                                        lfsu_n_cache.localFunctionSpace(),residual_engine->xn,lfsv_n_cache.localFunctionSpace(),
+                                        residual_engine->rl_view,residual_engine->rn_view,
+                                        jacobian_engine->al_view,jacobian_engine->al_sn_view,
+                                        jacobian_engine->al_ns_view,jacobian_engine->al_nn_view);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void assembleUVSkeleton(const IG & ig, const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache,
+                              const LFSUC & lfsu_n_cache, const LFSVC & lfsv_n_cache, std::false_type)
+      {
+        residual_engine->assembleUVSkeleton(ig,lfsu_s_cache,lfsv_s_cache,lfsu_n_cache,lfsv_n_cache);
+        jacobian_engine->assembleUVSkeleton(ig,lfsu_s_cache,lfsv_s_cache,lfsu_n_cache,lfsv_n_cache);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void assembleUVBoundary(const IG & ig, const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache, std::true_type)
+      {
+        setWeights();
+        lop.alpha_and_jacobian_boundary(ig,
+                                        lfsu_s_cache.localFunctionSpace(),residual_engine->xl,lfsv_s_cache.localFunctionSpace(),
+                                        residual_engine->rl_view,jacobian_engine->al_view);
+      }
+
+      template<typename IG, typename LFSUC, typename LFSVC>
+      void assembleUVBoundary(const IG & ig, const LFSUC & lfsu_s_cache, const LFSVC & lfsv_s_cache, std::false_type)
+      {
+        residual_engine->assembleUVBoundary(ig,lfsu_s_cache,lfsv_s_cache);
+        jacobian_engine->assembleUVBoundary(ig,lfsu_s_cache,lfsv_s_cache);
+      }
+
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void assembleUVVolumePostSkeleton(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache, std::true_type)
+      {
+        setWeights();
+        lop.alpha_and_jacobian_volume_post_skeleton(eg,
+                                                    lfsu_cache.localFunctionSpace(),residual_engine->xl,lfsv_cache.localFunctionSpace(),
+                                                    residual_engine->rl_view,jacobian_engine->al_view);
+      }
+
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void assembleUVVolumePostSkeleton(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache, std::false_type)
+      {
+        residual_engine->assembleUVVolumePostSkeleton(eg,lfsu_cache,lfsv_cache);
+        jacobian_engine->assembleUVVolumePostSkeleton(eg,lfsu_cache,lfsv_cache);
+      }
+      //! @}
+
+      //! Reference to the wrapping local assembler object which
+      //! constructed this engine
+      const LocalAssembler & local_assembler;
+
+      //! Reference to the local operator
+      const LOP & lop;
+
+      //! Engines owned by a copy of this engine
+      std::unique_ptr<ResidualEngine> residual_engine_copy;
+      std::unique_ptr<JacobianEngine> jacobian_engine_copy;
+
+      //! The engines driven by this engine
+      ResidualEngine * residual_engine;
+      JacobianEngine * jacobian_engine;
+
+    }; // End of class DefaultLocalResidualJacobianAssemblerEngine
+
+  }
+}
+#endif // DUNE_PDELAB_GRIDOPERATOR_DEFAULT_RESIDUALJACOBIANENGINE_HH
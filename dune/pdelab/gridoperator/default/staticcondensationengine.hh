@@ -0,0 +1,170 @@
+#ifndef DUNE_PDELAB_GRIDOPERATOR_DEFAULT_STATICCONDENSATIONENGINE_HH
+#define DUNE_PDELAB_GRIDOPERATOR_DEFAULT_STATICCONDENSATIONENGINE_HH
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/pdelab/gridoperator/common/staticcondensation.hh>
+#include <dune/pdelab/gridoperator/default/residualjacobianengine.hh>
+#include <dune/pdelab/localoperator/flags.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+    /**
+       \brief The local assembler engine for DUNE grids which
+       assembles the residual and the jacobian with the cell
+       interior DOFs eliminated by static condensation
+
+       The engine assembles the residual and the jacobian like
+       DefaultLocalResidualJacobianAssemblerEngine. Before the local
+       containers of a cell are added to the global ones, the DOFs
+       attached to the cell itself are eliminated by a Schur
+       complement of the local matrix, see StaticCondensationCache.
+       The global system then only couples the DOFs on vertices,
+       edges and faces, the rows of the interior DOFs are trivial.
+       After solving it for the correction z, recover() computes the
+       interior entries of z.
+
+       The elimination is only exact if the interior DOFs of a cell
+       do not couple with other cells, so local operators with
+       skeleton terms are rejected. The local operator must also be
+       a Galerkin method with a full local jacobian.
+
+       \tparam LA The local assembler
+
+    */
+    template<typename LA>
+    class DefaultLocalStaticCondensationAssemblerEngine
+      : public DefaultLocalResidualJacobianAssemblerEngine<LA>
+    {
+
+      typedef DefaultLocalResidualJacobianAssemblerEngine<LA> Base;
+
+      using Base::local_assembler;
+      using Base::residual_engine;
+      using Base::jacobian_engine;
+
+    public:
+
+      //! The type of the wrapping local assembler
+      typedef LA LocalAssembler;
+
+      //! The type of the local operator
+      typedef typename LA::LocalOperator LOP;
+
+      //! The engines assembling the residual and the jacobian
+      typedef typename LA::LocalResidualAssemblerEngine ResidualEngine;
+      typedef typename LA::LocalJacobianAssemblerEngine JacobianEngine;
+
+      //! The local function spaces
+      typedef typename LA::LFSU LFSU;
+      typedef typename LFSU::Traits::GridFunctionSpace GFSU;
+      typedef typename LA::LFSV LFSV;
+      typedef typename LFSV::Traits::GridFunctionSpace GFSV;
+
+      //! The data for recovering the interior DOFs
+      typedef StaticCondensationCache<
+        typename GFSU::Ordering::Traits::ContainerIndex,
+        typename LA::Traits::JacobianField
+        > Cache;
+
+      /**
+         \brief Constructor
+
+         \param [in] local_assembler_ The local assembler object which
+         creates this engine
+         \param [in] residual_engine_ The residual engine of the local assembler
+         \param [in] jacobian_engine_ The jacobian engine of the local assembler
+      */
+      DefaultLocalStaticCondensationAssemblerEngine(const LocalAssembler & local_assembler_,
+                                                    ResidualEngine & residual_engine_,
+                                                    JacobianEngine & jacobian_engine_)
+        : Base(local_assembler_,residual_engine_,jacobian_engine_),
+          cache(std::make_shared<Cache>())
+      {}
+
+      //! Query methods for the global grid assembler
+      //! @{
+      bool supportsThreadedAssembly() const
+      { return false; }
+      bool supportsTaskAssembly() const
+      { return false; }
+      //! @}
+
+      //! Returns whether recover() can be called, i.e. whether a condensed assembly has been completed.
+      bool valid() const
+      {
+        return cache->valid();
+      }
+
+      //! Discards the data for recovering the interior DOFs.
+      void invalidate()
+      {
+        cache->invalidate();
+      }
+
+      //! Computes the interior entries of a solution of the condensed system from its exterior entries.
+      template<typename V>
+      void recover(V& z) const
+      {
+        cache->recover(z);
+      }
+
+      //! Returns the data for recovering the interior DOFs.
+      const Cache& staticCondensationCache() const
+      {
+        return *cache;
+      }
+
+      //! Called when the local function space is about to be rebound or
+      //! discarded
+      //! @{
+      template<typename EG, typename LFSUC, typename LFSVC>
+      void onUnbindLFSUV(const EG & eg, const LFSUC & lfsu_cache, const LFSVC & lfsv_cache)
+      {
+        static_assert(!std::is_base_of<lop::DiagonalJacobian,LOP>::value,
+                      "Static condensation requires a full local jacobian");
+        classifyCellDOFs(eg.entity().type(),lfsv_cache,interior,exterior);
+        if (!interior.empty())
+          cache->condense(lfsu_cache,lfsv_cache,interior,exterior,residual_engine->rl,jacobian_engine->al);
+        Base::onUnbindLFSUV(eg,lfsu_cache,lfsv_cache);
+      }
+      //! @}
+
+      //! Notifier functions, called immediately before and after assembling
+      //! @{
+      void preAssembly()
+      {
+        if (!std::is_same<GFSU,GFSV>::value)
+          DUNE_THROW(Dune::NotImplemented,"Static condensation requires a Galerkin method");
+        if (LOP::doAlphaSkeleton || LOP::doLambdaSkeleton)
+          DUNE_THROW(Dune::NotImplemented,"Static condensation is not possible for local operators with skeleton terms");
+        cache->beginRecording();
+        Base::preAssembly();
+      }
+
+      void postAssembly(const GFSU& gfsu, const GFSV& gfsv)
+      {
+        Base::postAssembly(gfsu,gfsv);
+        cache->finishRecording();
+      }
+      //! @}
+
+    private:
+
+      //! The recovery data, shared by all copies of the engine
+      std::shared_ptr<Cache> cache;
+
+      //! The local indices of the interior and exterior DOFs of the current cell
+      std::vector<std::size_t> interior;
+      std::vector<std::size_t> exterior;
+
+    }; // End of class DefaultLocalStaticCondensationAssemblerEngine
+
+  }
+}
+#endif // DUNE_PDELAB_GRIDOPERATOR_DEFAULT_STATICCONDENSATIONENGINE_HH
@@ -0,0 +1,260 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_PDELAB_GRIDOPERATOR_DEFAULT_TASKASSEMBLER_HH
+#define DUNE_PDELAB_GRIDOPERATOR_DEFAULT_TASKASSEMBLER_HH
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <dune/pdelab/common/threading.hh>
+#include <dune/pdelab/gridoperator/common/assemblerworker.hh>
+#include <dune/pdelab/gridoperator/common/globalassemblerbase.hh>
+#include <dune/pdelab/gridoperator/common/taskbuffers.hh>
+
+namespace Dune{
+  namespace PDELab{
+
+    /**
+       \brief Multithreaded assembler based on work stealing
+
+       This assembler is a drop-in replacement for DefaultAssembler that can be
+       selected via the last template parameter of GridOperator. It splits the
+       cells of the entity set into chunks of consecutive cells which are
+       scheduled with a WorkStealingScheduler on a ThreadTeam that is kept
+       alive across assemblies. Contrary to ColoredAssembler, neighboring cells
+       may be assembled at the same time, so there are no synchronization
+       points between colors and the load stays balanced on unstructured meshes
+       where a coloring yields colors of very different sizes.
+
+       Each thread works on a private copy of the local assembler engine that
+       has been prepared with beginTaskAssembly(): the default residual and
+       jacobian application engines accumulate into thread-private vectors,
+       which are kept in TaskBuffers across assemblies and summed up in
+       parallel after all cells have been assembled, while the jacobian engine
+       scatters its local matrices into the preallocated matrix with atomic
+       additions. As the distribution of the cells among the threads is not
+       fixed, the results may differ from the serial assembly by round-off.
+
+       Engines that do not support task-based assembly (see
+       LocalAssemblerEngineBase::supportsTaskAssembly()), e.g. the pattern
+       engine, are run serially.
+
+       \note The local operator must be safe to call concurrently from multiple
+       threads, i.e. it must not modify any state during assembly.
+
+       * \tparam GFSU GridFunctionSpace for ansatz functions
+       * \tparam GFSV GridFunctionSpace for test functions
+       * \tparam CU   Constraints maps for the individual dofs (trial space)
+       * \tparam CV   Constraints maps for the individual dofs (test space)
+       * \tparam geometry_caching Whether the jacobians and integration elements of the cell
+       *                          and intersection geometries are cached, see GlobalAssemblerBase.
+       */
+    template<typename GFSU, typename GFSV, typename CU, typename CV, bool geometry_caching = false>
+    class TaskAssembler
+      : public GlobalAssemblerBase<GFSU,GFSV,CU,CV,geometry_caching>
+    {
+      typedef GlobalAssemblerBase<GFSU,GFSV,CU,CV,geometry_caching> Base;
+
+    public:
+
+      //! Types related to current grid view
+      //! @{
+      using EntitySet = typename GFSU::Traits::EntitySet;
+      using Element = typename EntitySet::Element;
+      using Intersection = typename EntitySet::Intersection;
+      using ElementSeed = typename Element::EntitySeed;
+      //! @}
+
+      //! Grid function spaces
+      //! @{
+      typedef GFSU TrialGridFunctionSpace;
+      typedef GFSV TestGridFunctionSpace;
+      //! @}
+
+      //! Size type as used in grid function space
+      typedef typename GFSU::Traits::SizeType SizeType;
+
+      //! Static check on whether this is a Galerkin method
+      static const bool isGalerkinMethod = std::is_same<GFSU,GFSV>::value;
+
+      TaskAssembler (const GFSU& gfsu_, const GFSV& gfsv_, const CU& cu_, const CV& cv_)
+        : Base(gfsu_,gfsv_,cu_,cv_)
+        , _threads(defaultThreadCount())
+        , _grain_size(0)
+        , _seeds_valid(false)
+      { }
+
+      TaskAssembler (const GFSU& gfsu_, const GFSV& gfsv_)
+        : Base(gfsu_,gfsv_)
+        , _threads(defaultThreadCount())
+        , _grain_size(0)
+        , _seeds_valid(false)
+      { }
+
+      //! Set the number of threads used for assembling.
+      void setThreads(std::size_t threads)
+      {
+        _threads = std::max(threads,std::size_t(1));
+      }
+
+      //! The number of threads used for assembling.
+      std::size_t threads() const
+      {
+        return _threads;
+      }
+
+      //! Set the number of cells per task, 0 selects a value based on the number of cells and threads.
+      void setGrainSize(std::size_t grain_size)
+      {
+        _grain_size = grain_size;
+      }
+
+      //! The number of cells per task as set by setGrainSize().
+      std::size_t grainSize() const
+      {
+        return _grain_size;
+      }
+
+      //! Discards the cached list of cells, topology and thread-private vectors, must be called after the grid has changed.
+      void update()
+      {
+        Base::update();
+        _seeds_valid = false;
+        _seeds.clear();
+        if (_buffers)
+          _buffers->clear();
+      }
+
+      using Base::assemble;
+
+      template<class LocalAssemblerEngine>
+      void assemble(LocalAssemblerEngine & assembler_engine) const
+      {
+        typedef AssemblerWorker<GFSU,GFSV,CU,CV,LocalAssemblerEngine,geometry_caching> Worker;
+
+        // Notify assembler engine about oncoming assembly
+        assembler_engine.preAssembly();
+
+        auto entity_set = gfsu.entitySet();
+
+        // The caches have to be built before the threads are started
+        const MeshTopologyCache<EntitySet>* cached_topology = this->topology(entity_set);
+        GeometryCache<EntitySet>* cached_geometries = this->geometries(entity_set);
+
+        if (_threads <= 1 || !assembler_engine.supportsTaskAssembly())
+          {
+            Worker worker(gfsu,gfsv,cu,cv,assembler_engine,cached_topology,cached_geometries);
+            for (const auto& element : elements(entity_set))
+              worker.assemble(element);
+          }
+        else
+          {
+            const std::vector<ElementSeed>& seeds = elementSeeds();
+            const std::size_t grain_size = _grain_size > 0
+              ? _grain_size
+              : std::max(seeds.size() / (16 * _threads),std::size_t(1));
+            const std::size_t tasks = (seeds.size() + grain_size - 1) / grain_size;
+
+            ThreadTeam& threads = team();
+            TaskBuffers& buffers = *_buffers;
+            WorkStealingScheduler scheduler(_threads,tasks);
+            ThreadBarrier barrier(_threads);
+            ThreadExceptionCollector exceptions;
+            std::vector<std::unique_ptr<LocalAssemblerEngine> > engines(_threads);
+
+            threads.run([&](std::size_t thread)
+              {
+                try
+                  {
+                    engines[thread] = std::make_unique<LocalAssemblerEngine>(assembler_engine);
+                    engines[thread]->beginTaskAssembly(buffers,thread);
+                    Worker worker(gfsu,gfsv,cu,cv,*engines[thread],cached_topology,cached_geometries);
+
+                    std::size_t task;
+                    while (!exceptions.failed() && scheduler.next(thread,task))
+                      {
+                        const std::size_t end = std::min((task + 1) * grain_size,seeds.size());
+                        for (std::size_t i = task * grain_size; i < end; ++i)
+                          worker.assemble(entity_set.grid().entity(seeds[i]));
+                      }
+                  }
+                catch (...)
+                  {
+                    exceptions.capture();
+                  }
+
+                // Sum up the thread-private results once all threads have finished, every
+                // thread takes its part of the global containers
+                barrier.wait();
+                if (exceptions.failed())
+                  return;
+                try
+                  {
+                    std::vector<LocalAssemblerEngine*> copies;
+                    for (auto& engine : engines)
+                      copies.push_back(engine.get());
+                    assembler_engine.mergeTaskAssembly(copies,thread,_threads);
+                  }
+                catch (...)
+                  {
+                    exceptions.capture();
+                  }
+              });
+
+            exceptions.rethrow();
+          }
+
+        // Notify assembler engine that assembly is finished
+        assembler_engine.postAssembly(gfsu,gfsv);
+
+      }
+
+    private:
+
+      using Base::gfsu;
+      using Base::gfsv;
+      using Base::cu;
+      using Base::cv;
+
+      //! Returns the thread team, starting the threads and allocating their buffers on first use or after a change of their number.
+      ThreadTeam& team() const
+      {
+        if (!_team || _team->size() != _threads)
+          {
+            _team = std::make_shared<ThreadTeam>(_threads);
+            _buffers = std::make_shared<TaskBuffers>(_threads);
+          }
+        return *_team;
+      }
+
+      //! Returns the seeds of all cells in traversal order.
+      const std::vector<ElementSeed>& elementSeeds() const
+      {
+        auto entity_set = gfsu.entitySet();
+        if (!_seeds_valid || _seeds.size() != entity_set.size(0))
+          {
+            _seeds.clear();
+            _seeds.reserve(entity_set.size(0));
+            for (const auto& element : elements(entity_set))
+              _seeds.push_back(element.seed());
+            _seeds_valid = true;
+          }
+        return _seeds;
+      }
+
+      std::size_t _threads;
+      mutable std::shared_ptr<ThreadTeam> _team;
+      mutable std::shared_ptr<TaskBuffers> _buffers;
+
+      std::size_t _grain_size;
+
+      /* cached seeds of all cells for random access to the chunks */
+      mutable std::vector<ElementSeed> _seeds;
+      mutable bool _seeds_valid;
+
+    };
+
+  }
+}
+#endif // DUNE_PDELAB_GRIDOPERATOR_DEFAULT_TASKASSEMBLER_HH
@@ -2,6 +2,7 @@
 #define DUNE_PDELAB_GRIDOPERATOR_GRIDOPERATOR_HH
 
 #include <tuple>
+#include <vector>
 
 #include <dune/common/hybridutilities.hh>
 
@@ -25,19 +26,27 @@ namespace Dune{
        \tparam JF The jacobian field type
        \tparam CU   Constraints maps for the individual dofs (trial space)
        \tparam CV   Constraints maps for the individual dofs (test space)
+       \tparam GA   The global assembler, e.g. ColoredAssembler<GFSU,GFSV,CU,CV> or
+                    TaskAssembler<GFSU,GFSV,CU,CV> for multithreaded assembly. The
+                    multithreaded assemblers are not included by this header, include
+                    dune/pdelab/gridoperator/default/coloredassembler.hh or
+                    dune/pdelab/gridoperator/default/taskassembler.hh where they are used.
+                    All assemblers cache the cell and intersection geometries if their
+                    last template parameter geometry_caching is true.
 
     */
     template<typename GFSU, typename GFSV, typename LOP,
              typename MB, typename DF, typename RF, typename JF,
              typename CU=Dune::PDELab::EmptyTransformation,
-             typename CV=Dune::PDELab::EmptyTransformation
+             typename CV=Dune::PDELab::EmptyTransformation,
+             typename GA=DefaultAssembler<GFSU,GFSV,CU,CV>
              >
     class GridOperator
     {
     public:
 
       //! The global assembler type
-      typedef DefaultAssembler<GFSU,GFSV,CU,CV> Assembler;
+      typedef GA Assembler;
 
       //! The type of the domain (solution).
       using Domain = Dune::PDELab::Backend::Vector<GFSU,DF>;
@@ -184,11 +193,142 @@ namespace Dune{
         global_assembler.assemble(jacobian_engine);
       }
 
+      //! Assemble residual and jacobian in a single grid traversal
+      /**
+       * The result is the same as calling residual(x,r) and jacobian(x,a), but the
+       * grid is traversed, the local function spaces are bound and the coefficients
+       * of x are loaded only once.
+       */
+      void residual_and_jacobian(const Domain & x, Range & r, Jacobian & a) const
+      {
+        typedef typename LocalAssembler::LocalResidualJacobianAssemblerEngine ResidualJacobianEngine;
+        ResidualJacobianEngine & residual_jacobian_engine = local_assembler.localResidualJacobianAssemblerEngine(r,a,x);
+        global_assembler.assemble(residual_jacobian_engine);
+      }
+
+      //! Enables or disables static condensation of the cell interior DOFs.
+      /**
+       * With static condensation, the matrix pattern only contains the diagonal entries of DOFs
+       * attached to the interior of a cell, so the flag has to be set before the jacobian
+       * container is constructed. Only condensed_residual_and_jacobian() can assemble into such
+       * a container. It requires a Galerkin method without skeleton terms, e.g. conforming
+       * finite elements of high order.
+       */
+      void setStaticCondensation(bool enable)
+      {
+        local_assembler.setStaticCondensation(enable);
+      }
+
+      //! Whether the cell interior DOFs are eliminated by static condensation.
+      bool staticCondensation() const
+      {
+        return local_assembler.staticCondensation();
+      }
+
+      //! Assemble residual and jacobian with the cell interior DOFs eliminated
+      /**
+       * Within each cell, the interior DOFs are eliminated from the local system by a Schur
+       * complement before it is added to r and a. The rows of the interior DOFs in a contain
+       * the identity and their entries in r are zero, so a solution z of the condensed system
+       * a z = r has the correct values on all other DOFs. recover_interior(z) then computes
+       * the interior values, which completes the correction of the full system.
+       */
+      void condensed_residual_and_jacobian(const Domain & x, Range & r, Jacobian & a) const
+      {
+        if (!local_assembler.staticCondensation())
+          DUNE_THROW(Dune::InvalidStateException,"Static condensation has to be enabled before constructing the jacobian");
+        typedef typename LocalAssembler::LocalStaticCondensationAssemblerEngine StaticCondensationEngine;
+        StaticCondensationEngine & static_condensation_engine = local_assembler.localStaticCondensationAssemblerEngine(r,a,x);
+        global_assembler.assemble(static_condensation_engine);
+      }
+
+      //! Computes the cell interior entries of a solution of the last condensed system.
+      void recover_interior(Domain & z) const
+      {
+        local_assembler.localStaticCondensationAssemblerEngine().recover(z);
+      }
+
+      //! Enables or disables keeping the local residuals and matrices of each assembly, required for partial reassembly.
+      void setContributionCaching(bool enable)
+      {
+        local_assembler.setContributionCaching(enable);
+      }
+
+      //! Whether the local residuals and matrices of each assembly are kept.
+      bool contributionCaching() const
+      {
+        return local_assembler.contributionCaching();
+      }
+
+      //! Update a residual in place after the solution changed on a set of marked cells
+      /**
+       * Only the marked cells and the cells visiting a skeleton face shared with them are
+       * reassembled, and only the change of their local residuals is added to r. This
+       * requires contribution caching, see setContributionCaching(), and r has to be the
+       * result of the preceding residual assemblies, the first of which must have been a
+       * full one. The solution must not have changed outside of the marked cells since.
+       *
+       * \param marked  A flag for every cell, indexed by the index set of the entity set
+       *                of the trial grid function space.
+       */
+      void residual(const Domain & x, Range & r, const std::vector<bool> & marked) const
+      {
+        typedef typename LocalAssembler::LocalResidualAssemblerEngine ResidualEngine;
+        ResidualEngine & residual_engine = local_assembler.localResidualAssemblerEngine(r,x);
+        residual_engine.setPartialAssembly(true);
+        global_assembler.assemble(residual_engine,marked);
+      }
+
+      //! Update a jacobian in place after the solution changed on a set of marked cells
+      /**
+       * Only the marked cells and the cells visiting a skeleton face shared with them are
+       * reassembled, and only the change of their local matrices is added to a, see
+       * residual(x,r,marked) for the requirements.
+       */
+      void jacobian(const Domain & x, Jacobian & a, const std::vector<bool> & marked) const
+      {
+        typedef typename LocalAssembler::LocalJacobianAssemblerEngine JacobianEngine;
+        JacobianEngine & jacobian_engine = local_assembler.localJacobianAssemblerEngine(a,x);
+        jacobian_engine.setPartialAssembly(true);
+        global_assembler.assemble(jacobian_engine,marked);
+      }
+
+      //! Enables or disables applying the jacobian of a linear operator with cached local matrices.
+      /**
+       * With element matrix caching, the first call of jacobian_apply(update,result) assembles
+       * and stores the local matrices of all cells and faces. Subsequent calls gather the
+       * coefficients of each local matrix, multiply and scatter the result, without calling
+       * the local operator and without a global matrix, see ElementMatrixCache.
+       *
+       * The cache is rebuilt when the weight of the local assembler changes, and discarded by
+       * update() and by calling this method. It has to be discarded as well if the local
+       * operator changes, e.g. because its parameters depend on time.
+       */
+      void setElementMatrixCaching(bool enable)
+      {
+        local_assembler.setElementMatrixCaching(enable);
+      }
+
+      //! Whether the jacobian of a linear operator is applied with cached local matrices.
+      bool elementMatrixCaching() const
+      {
+        return local_assembler.elementMatrixCaching();
+      }
+
       //! Apply jacobian matrix to the vector update without explicitly assembling it
       void jacobian_apply(const Domain & update, Range & result) const
       {
         if (not local_assembler.localOperator().isLinear)
           DUNE_THROW(Dune::Exception, "Your trying to use a non linear jacobian apply for a linear problem.");
+        if (local_assembler.elementMatrixCaching())
+          {
+            typedef typename LocalAssembler::LocalElementMatrixAssemblerEngine ElementMatrixEngine;
+            ElementMatrixEngine & element_matrix_engine = local_assembler.localElementMatrixAssemblerEngine();
+            if (!element_matrix_engine.valid())
+              global_assembler.assemble(element_matrix_engine);
+            element_matrix_engine.apply(update, result);
+            return;
+          }
         global_assembler.assemble(local_assembler.localJacobianApplyAssemblerEngine(update, result));
       }
 
@@ -216,6 +356,11 @@ namespace Dune{
 
       void update()
       {
+        // the global assembler may cache information about the grid
+        global_assembler.update();
+        // the jacobian engine caches the location of the matrix entries of each cell,
+        // and the engines may cache the local contributions of each cell
+        local_assembler.update();
         // the DOF exchanger has matrix information, so we need to update it
         dof_exchanger->update(*this);
       }
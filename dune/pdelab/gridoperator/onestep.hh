@@ -3,8 +3,12 @@
 #ifndef DUNE_PDELAB_GRIDOPERATOR_ONESTEP_HH
 #define DUNE_PDELAB_GRIDOPERATOR_ONESTEP_HH
 
+#include <cstddef>
+#include <memory>
 #include <tuple>
+#include <utility>
 
+#include <dune/pdelab/backend/interface.hh>
 #include <dune/pdelab/constraints/common/constraints.hh>
 #include <dune/pdelab/gridfunctionspace/genericdatahandle.hh>
 #include <dune/pdelab/gridoperator/common/gridoperatorutilities.hh>
@@ -69,13 +73,17 @@ namespace Dune{
       //! The type of the one step method parameters
       typedef typename LocalAssembler::OneStepParameters OneStepParameters;
 
+      //! The type identifying the Jacobian of a stage, see jacobianState()
+      typedef std::tuple<std::size_t,Real,Real> JacobianState;
+
       //! Constructor for non trivial constraints
       OneStepGridOperator(GO0 & go0_, GO1 & go1_)
         : global_assembler(go0_.assembler()),
           go0(go0_), go1(go1_),
           la0(go0_.localAssembler()), la1(go1_.localAssembler()),
           const_residual( go0_.testGridFunctionSpace() ),
-          local_assembler(la0,la1, const_residual)
+          local_assembler(la0,la1, const_residual),
+          constant_jacobian(false), jacobian_generation(0), constant_mass(false)
       {
         GO0::setupGridOperators(std::tie(go0_,go1_));
         if(not implicit)
@@ -98,6 +106,76 @@ namespace Dune{
         local_assembler.setDTAssemblingMode(LocalAssembler::MultiplyOperator0ByDT);
       }
 
+      //! Declare that the Jacobians of both operators depend neither on time nor on the solution
+      /**
+       * Then all stage Jacobians with the same weights coincide, e.g. those of the stages of
+       * SDIRK schemes with a constant diagonal like Alexander2Parameter and of subsequent time
+       * steps with the same step size. Newton's method records jacobianState() together with its
+       * matrix and keeps the matrix as long as jacobianUnchanged() confirms the recorded state,
+       * letting the linear solver reuse its preconditioner. The matrix is only reassembled when
+       * the time step size or the diagonal coefficient of the method changes.
+       */
+      void setConstantJacobian(bool enable)
+      {
+        if(enable and ((not la0.localOperator().isLinear) or (not la1.localOperator().isLinear)))
+          DUNE_THROW(Dune::Exception,"A constant Jacobian requires linear local operators");
+        constant_jacobian = enable;
+        ++jacobian_generation;
+      }
+
+      //! Return whether the Jacobians are declared to be constant, see setConstantJacobian()
+      bool constantJacobian() const
+      {
+        return constant_jacobian;
+      }
+
+      //! Declare that the operator of order one, i.e. the mass term, is linear and independent of time
+      /**
+       * Its matrix M is then assembled once, on the first call to jacobian() or residual(), and
+       * kept until update() is called. Stage Jacobians are formed as the Jacobian of the
+       * operator GO0 plus a multiple of M, and the mass term of stage residuals is a
+       * matrix-vector product with M, so both skip the local operator of order one. The
+       * constant part of the residual assembled by preStage() is not affected.
+       *
+       * The mass term must not contain source terms, and the solutions have to satisfy the
+       * constraints. Only ISTL matrices are supported.
+       */
+      void setConstantMass(bool enable)
+      {
+        if(not implicit)
+          DUNE_THROW(Dune::Exception,"This function should not be called in explicit mode");
+        if(enable and ((not la1.localOperator().isLinear) or LocalAssemblerDT1::doLambdaVolume()
+                       or LocalAssemblerDT1::doLambdaSkeleton() or LocalAssemblerDT1::doLambdaBoundary()
+                       or LocalAssemblerDT1::doLambdaVolumePostSkeleton()))
+          DUNE_THROW(Dune::Exception,"A constant mass matrix requires a linear temporal operator without source terms");
+        constant_mass = enable;
+        mass_matrix.reset();
+      }
+
+      //! Return whether the mass matrix is declared to be constant, see setConstantMass()
+      bool constantMass() const
+      {
+        return constant_mass;
+      }
+
+      //! Identifies the Jacobian of the current stage, see jacobianUnchanged()
+      /**
+       * The state consists of the weights of both operators and a counter that is increased
+       * by setConstantJacobian() and update(). Callers record it together with the matrix they
+       * assemble, so that several consumers of the same grid operator do not interfere.
+       */
+      JacobianState jacobianState() const
+      {
+        const std::pair<Real,Real> weights = local_assembler.jacobianWeights();
+        return JacobianState(jacobian_generation,weights.first,weights.second);
+      }
+
+      //! Return whether the Jacobian of the current stage equals one assembled in the given state
+      bool jacobianUnchanged(const JacobianState& state) const
+      {
+        return constant_jacobian and jacobianState() == state;
+      }
+
       //! Get the trial grid function space
       const typename Traits::TrialGridFunctionSpace& trialGridFunctionSpace() const
       {
@@ -155,15 +233,49 @@ namespace Dune{
         global_assembler.assemble(prestage_engine);
       }
 
+      //! Add the residual of an explicitly treated operator to the constant part of the residual
+      /**
+       * This allows to split the spatial operator into a part assembled by this grid operator
+       * and a part whose residual r was evaluated at a previous stage, as in IMEX schemes. The
+       * residual is weighted like the operator GO0, i.e. with weight times the time step size
+       * unless the mass term is divided by it. Must be called after preStage(), which resets
+       * the constant part.
+       */
+      void addToConstResidual(Real weight, const Range & r)
+      {
+        if(not implicit)
+          DUNE_THROW(Dune::Exception,"This function should not be called in explicit mode");
+
+        const_residual.axpy(weight * local_assembler.dtFactor0(), r);
+      }
+
       //! Assemble residual
       void residual(const Domain & x, Range & r) const
       {
         if(not implicit)
           DUNE_THROW(Dune::Exception,"This function should not be called in explicit mode");
 
-        typedef typename LocalAssembler::LocalResidualAssemblerEngine ResidualEngine;
-        ResidualEngine & residual_engine = local_assembler.localResidualAssemblerEngine(r,x);
-        global_assembler.assemble(residual_engine);
+        if(constant_mass)
+        {
+          // spatial part, then the mass term as a matrix-vector product
+          assembleMass(x);
+          if(local_assembler.implicitStage())
+          {
+            la0.setTime(local_assembler.timeAtStage());
+            la0.setWeight(local_assembler.jacobianWeights().first);
+            go0.residual(x,r);
+          }
+          r += const_residual;
+          using Backend::native;
+          native(*mass_matrix).usmv(local_assembler.jacobianWeights().second,native(x),native(r));
+          local_assembler.constrainResidual(r);
+        }
+        else
+        {
+          typedef typename LocalAssembler::LocalResidualAssemblerEngine ResidualEngine;
+          ResidualEngine & residual_engine = local_assembler.localResidualAssemblerEngine(r,x);
+          global_assembler.assemble(residual_engine);
+        }
       }
 
       //! Assemble jacobian
@@ -172,9 +284,27 @@ namespace Dune{
         if(not implicit)
           DUNE_THROW(Dune::Exception,"This function should not be called in explicit mode");
 
-        typedef typename LocalAssembler::LocalJacobianAssemblerEngine JacobianEngine;
-        JacobianEngine & jacobian_engine = local_assembler.localJacobianAssemblerEngine(a,x);
-        global_assembler.assemble(jacobian_engine);
+        if(constant_mass)
+        {
+          // spatial part, then the mass matrix added on the shared pattern
+          assembleMass(x);
+          const std::pair<Real,Real> weights = local_assembler.jacobianWeights();
+          if(local_assembler.implicitStage())
+          {
+            la0.setTime(local_assembler.timeAtStage());
+            la0.setWeight(weights.first);
+            go0.jacobian(x,a);
+          }
+          using Backend::native;
+          native(a).axpy(weights.second,native(*mass_matrix));
+          local_assembler.constrainJacobian(testGridFunctionSpace(),a);
+        }
+        else
+        {
+          typedef typename LocalAssembler::LocalJacobianAssemblerEngine JacobianEngine;
+          JacobianEngine & jacobian_engine = local_assembler.localJacobianAssemblerEngine(a,x);
+          global_assembler.assemble(jacobian_engine);
+        }
       }
 
       //! Assemble jacobian and residual simultaneously for explicit treatment
@@ -194,6 +324,24 @@ namespace Dune{
         global_assembler.assemble(jacobian_residual_engine);
       }
 
+      //! Assemble the residual for explicit treatment without the jacobian
+      /**
+       * This is explicit_jacobian_residual() without the jacobian, for callers which keep
+       * the matrix of a linear, time independent temporal operator from an earlier stage.
+       */
+      void explicit_residual(unsigned int stage, const std::vector<Domain*> & x,
+                             Range & r1, Range & r0)
+      {
+        if(implicit)
+          DUNE_THROW(Dune::Exception,"This function should not be called in implicit mode");
+
+        local_assembler.setStage(stage);
+
+        typedef typename LocalAssembler::LocalPreStageAssemblerEngine PreStageEngine;
+        PreStageEngine & prestage_engine = local_assembler.localExplicitResidualAssemblerEngine(r0,r1,x);
+        global_assembler.assemble(prestage_engine);
+      }
+
       //! Apply jacobian matrix to the vector update without explicitly assembling it
       void jacobian_apply(const Domain & update, Range & result) const
       {
@@ -276,6 +424,8 @@ namespace Dune{
         go0.update();
         go1.update();
         const_residual = Range(go0.testGridFunctionSpace());
+        ++jacobian_generation;
+        mass_matrix.reset();
       }
 
       void make_consistent(Jacobian& a) const
@@ -294,6 +444,17 @@ namespace Dune{
       }
 
     private:
+
+      //! Assemble the mass matrix on the pattern of the stage Jacobians unless it is cached
+      void assembleMass(const Domain & x) const
+      {
+        if(mass_matrix)
+          return;
+        mass_matrix = std::make_shared<Jacobian>(*this,0.0);
+        la1.setWeight(1.0);
+        go1.jacobian(x,*mass_matrix);
+      }
+
       Assembler & global_assembler;
       GO0 & go0;
       GO1 & go1;
@@ -301,6 +462,10 @@ namespace Dune{
       LocalAssemblerDT1 & la1;
       Range const_residual;
       mutable LocalAssembler local_assembler;
+      bool constant_jacobian;
+      std::size_t jacobian_generation;
+      bool constant_mass;
+      mutable std::shared_ptr<Jacobian> mass_matrix;
     };
 
   }
@@ -1,6 +1,11 @@
 #ifndef DUNE_PDELAB_GRIDOPERATOR_ONESTEP_ENGINEBASE_HH
 #define DUNE_PDELAB_GRIDOPERATOR_ONESTEP_ENGINEBASE_HH
 
+#include <cstddef>
+#include <vector>
+
+#include <dune/pdelab/gridoperator/common/taskbuffers.hh>
+
 namespace Dune{
   namespace PDELab{
 
@@ -116,6 +121,24 @@ namespace Dune{
         return localAssemblerEngineDT0().partition();
       }
 
+      //! The subordinate engines are shared, so one-step engines are always run on a single thread.
+      bool supportsThreadedAssembly() const
+      {
+        return false;
+      }
+
+      bool supportsTaskAssembly() const
+      {
+        return false;
+      }
+
+      void beginTaskAssembly(TaskBuffers& buffers, std::size_t thread)
+      {}
+
+      template<typename Engine>
+      void mergeTaskAssembly(const std::vector<Engine*>& copies, std::size_t part, std::size_t parts)
+      {}
+
       void setLocalAssemblerEngineDT0(LocalAssemblerEngineDT0& lae0_)
       {
         lae0 = &lae0_;
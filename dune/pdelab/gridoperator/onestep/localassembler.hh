@@ -1,6 +1,9 @@
 #ifndef DUNE_PDELAB_GRIDOPERATOR_ONESTEP_LOCALASSEMBLER_HH
 #define DUNE_PDELAB_GRIDOPERATOR_ONESTEP_LOCALASSEMBLER_HH
 
+#include <cmath>
+#include <utility>
+
 #include <dune/typetree/typetree.hh>
 
 #include <dune/pdelab/gridoperator/onestep/residualengine.hh>
@@ -10,6 +13,8 @@
 #include <dune/pdelab/gridoperator/onestep/prestageengine.hh>
 #include <dune/pdelab/gridoperator/onestep/jacobianresidualengine.hh>
 
+#include <dune/pdelab/constraints/common/constraints.hh>
+
 #include <dune/pdelab/instationary/onestepparameter.hh>
 
 #include <dune/pdelab/gridoperator/common/assemblerutilities.hh>
@@ -158,6 +163,45 @@ namespace Dune{
         dt_mode = dt_mode_;
       }
 
+      //! Weights of the operators of order zero and one in the Jacobian
+      //! of the current stage
+      std::pair<Real,Real> jacobianWeights() const
+      {
+        return std::make_pair(osp_method->b(stage,stage)*dt_factor0, dt_factor1);
+      }
+
+      //! Whether the operator of order zero contributes to the Jacobian
+      //! of the current stage
+      bool implicitStage() const
+      {
+        using std::abs;
+        return abs(osp_method->b(stage,stage)) > 1e-6;
+      }
+
+      //! Apply the constraints to a stage residual which was not
+      //! assembled by the residual engine
+      void constrainResidual(typename Traits::Residual & r) const
+      {
+        if(la1.doPostProcessing())
+          Dune::PDELab::constrain_residual(this->testConstraints(),r);
+      }
+
+      //! Reset the rows of constrained DOFs in a stage Jacobian which
+      //! was not assembled by the jacobian engine
+      template<typename GFSV>
+      void constrainJacobian(const GFSV & gfsv, typename Traits::Jacobian & a) const
+      {
+        if(la1.doPostProcessing())
+          this->handle_dirichlet_constraints(gfsv,a);
+      }
+
+      //! Factor of the time step size in the weights of the operator of
+      //! order zero, which depends on the assembling mode
+      Real dtFactor0() const
+      {
+        return dt_factor0;
+      }
+
       //! Access time at given stage
       Real timeAtStage(int stage_) const
       {
@@ -246,6 +290,18 @@ namespace Dune{
         return explicit_jacobian_residual_engine;
       }
 
+      //! Returns a reference to the requested engine. This engine is
+      //! completely configured and ready to use. It assembles the
+      //! residuals of explicit methods without the jacobian.
+      LocalPreStageAssemblerEngine & localExplicitResidualAssemblerEngine
+      (typename Traits::Residual & r0, typename Traits::Residual & r1,
+       const std::vector<typename Traits::Solution*> & x)
+      {
+        prestage_engine.setSolutions(x);
+        prestage_engine.setConstResiduals(r0,r1);
+        return prestage_engine;
+      }
+
       //! Returns a reference to the requested engine. This engine is
       //! completely configured and ready to use.
       LocalJacobianApplyAssemblerEngine & localJacobianApplyAssemblerEngine
@@ -0,0 +1,232 @@
+// -*- tab-width: 2; indent-tabs-mode: nil -*-
+// vi: set et ts=2 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_INSTATIONARY_BLOCKDIAGONALMASSINVERSE_HH
+#define DUNE_PDELAB_INSTATIONARY_BLOCKDIAGONALMASSINVERSE_HH
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/exceptions.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    /**
+     *  @addtogroup OneStepMethod
+     *  @{
+     */
+
+    //! Inverse of a matrix whose couplings are restricted to the DOFs of single cells
+    /**
+     * The mass matrices of discontinuous Galerkin spaces are block diagonal with one dense
+     * block per cell. This class extracts these blocks from an assembled matrix, inverts them
+     * once and stores the blocks together with their inverses and the container indices of
+     * their DOFs in contiguous arrays, so that solving with the matrix afterwards is a loop of
+     * small dense matrix-vector products without any traversal of the grid.
+     *
+     * If all blocks turn out to be diagonal, as for orthonormal bases on affine cells or lumped
+     * mass matrices, only the diagonals are kept and solving becomes a pointwise scaling.
+     *
+     * \tparam GFS The grid function space, all of whose DOFs must be attached to single cells
+     * \tparam T   The field type of the matrix
+     */
+    template<typename GFS, typename T>
+    class BlockDiagonalMassInverse
+    {
+
+      typedef LocalFunctionSpace<GFS> LFS;
+      typedef LFSIndexCache<LFS> LFSCache;
+      typedef typename LFSCache::ContainerIndex ContainerIndex;
+
+    public:
+
+      BlockDiagonalMassInverse()
+        : _valid(false)
+        , _diagonal(false)
+      {}
+
+      //! Returns whether the inverse of a matrix has been computed.
+      bool valid() const
+      {
+        return _valid;
+      }
+
+      //! Returns whether all blocks of the matrix are diagonal.
+      bool diagonal() const
+      {
+        return _diagonal;
+      }
+
+      //! Discards the stored blocks, e.g. after the grid or the function space changed.
+      void invalidate()
+      {
+        _valid = false;
+        _diagonal = false;
+        _offsets.clear();
+        _indices.clear();
+        _matrix.clear();
+        _inverse.clear();
+      }
+
+      //! Extracts the cell blocks of the matrix a and inverts them.
+      /**
+       * \param gfs The grid function space for both rows and columns of a
+       * \param a   The matrix, which must not couple DOFs of different cells
+       * \param tol Off-diagonal entries below tol times the largest diagonal entry of their
+       *            block are treated as zero when detecting diagonal blocks
+       */
+      template<typename M>
+      void update(const GFS& gfs, M& a, T tol = 1e-12)
+      {
+        invalidate();
+
+        LFS lfs(gfs);
+        LFSCache lfs_cache(lfs);
+        _offsets.push_back(0);
+        bool diagonal = true;
+        for (const auto& element : elements(gfs.entitySet()))
+          {
+            lfs.bind(element);
+            lfs_cache.update();
+            const std::size_t n = lfs_cache.size();
+            T max_diagonal(0);
+            for (std::size_t i = 0; i < n; ++i)
+              {
+                _indices.push_back(lfs_cache.containerIndex(i));
+                for (std::size_t j = 0; j < n; ++j)
+                  {
+                    // entries outside of the pattern, e.g. of lumped mass matrices, are zero
+                    const auto* entry = a.find(lfs_cache.containerIndex(i),lfs_cache.containerIndex(j));
+                    _matrix.push_back(entry ? T(*entry) : T(0));
+                  }
+                max_diagonal = std::max(max_diagonal,std::abs(_matrix[_matrix.size()-n+i]));
+              }
+            const T* block = _matrix.data() + _matrix.size() - n*n;
+            for (std::size_t i = 0; i < n && diagonal; ++i)
+              for (std::size_t j = 0; j < n; ++j)
+                if (i != j && std::abs(block[i*n+j]) > tol*max_diagonal)
+                  {
+                    diagonal = false;
+                    break;
+                  }
+            _offsets.push_back(_indices.size());
+          }
+
+        if (_indices.size() != gfs.globalSize())
+          {
+            invalidate();
+            DUNE_THROW(Dune::InvalidStateException,"BlockDiagonalMassInverse requires a function space whose DOFs are attached to single cells");
+          }
+
+        const std::size_t cells = _offsets.size() - 1;
+        if (diagonal)
+          {
+            // keep only the diagonals
+            std::vector<T> values(_indices.size());
+            std::size_t pos = 0;
+            for (std::size_t c = 0; c < cells; ++c)
+              {
+                const std::size_t n = _offsets[c+1] - _offsets[c];
+                for (std::size_t i = 0; i < n; ++i)
+                  values[_offsets[c]+i] = _matrix[pos + i*n + i];
+                pos += n*n;
+              }
+            _matrix.swap(values);
+            _inverse.resize(_matrix.size());
+            for (std::size_t i = 0; i < _matrix.size(); ++i)
+              _inverse[i] = T(1) / _matrix[i];
+          }
+        else
+          {
+            _inverse.resize(_matrix.size());
+            DynamicMatrix<T> block;
+            std::size_t pos = 0;
+            for (std::size_t c = 0; c < cells; ++c)
+              {
+                const std::size_t n = _offsets[c+1] - _offsets[c];
+                block.resize(n,n);
+                for (std::size_t i = 0; i < n; ++i)
+                  for (std::size_t j = 0; j < n; ++j)
+                    block[i][j] = _matrix[pos + i*n + j];
+                block.invert();
+                for (std::size_t i = 0; i < n; ++i)
+                  for (std::size_t j = 0; j < n; ++j)
+                    _inverse[pos + i*n + j] = block[i][j];
+                pos += n*n;
+              }
+          }
+
+        _diagonal = diagonal;
+        _valid = true;
+      }
+
+      //! Computes y = A x with the stored blocks.
+      template<typename X, typename Y>
+      void mv(const X& x, Y& y) const
+      {
+        apply(_matrix,x,y);
+      }
+
+      //! Computes the solution z of A z = r with the stored inverse blocks.
+      template<typename Z, typename R>
+      void solve(Z& z, const R& r) const
+      {
+        apply(_inverse,r,z);
+      }
+
+    private:
+
+      template<typename X, typename Y>
+      void apply(const std::vector<T>& values, const X& x, Y& y) const
+      {
+        if (!_valid)
+          DUNE_THROW(Dune::InvalidStateException,"BlockDiagonalMassInverse has not been computed");
+
+        if (_diagonal)
+          {
+            for (std::size_t i = 0; i < _indices.size(); ++i)
+              y[_indices[i]] = values[i] * x[_indices[i]];
+            return;
+          }
+
+        std::vector<T> xl;
+        const T* block = values.data();
+        for (std::size_t c = 0; c + 1 < _offsets.size(); ++c)
+          {
+            const std::size_t begin = _offsets[c];
+            const std::size_t n = _offsets[c+1] - begin;
+            xl.resize(n);
+            for (std::size_t j = 0; j < n; ++j)
+              xl[j] = x[_indices[begin+j]];
+            for (std::size_t i = 0; i < n; ++i)
+              {
+                T sum(0);
+                for (std::size_t j = 0; j < n; ++j)
+                  sum += block[i*n+j] * xl[j];
+                y[_indices[begin+i]] = sum;
+              }
+            block += n*n;
+          }
+      }
+
+      bool _valid;
+      bool _diagonal;
+      std::vector<std::size_t> _offsets;
+      std::vector<ContainerIndex> _indices;
+      std::vector<T> _matrix;
+      std::vector<T> _inverse;
+    };
+
+    /** @} */
+  } // end namespace PDELab
+} // end namespace Dune
+#endif // DUNE_PDELAB_INSTATIONARY_BLOCKDIAGONALMASSINVERSE_HH
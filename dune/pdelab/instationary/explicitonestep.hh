@@ -4,12 +4,19 @@
 #ifndef DUNE_PDELAB_INSTATIONARY_EXPLICITONESTEP_HH
 #define DUNE_PDELAB_INSTATIONARY_EXPLICITONESTEP_HH
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <limits>
+#include <memory>
+#include <vector>
 
 #include <dune/common/ios_state.hh>
 #include <dune/pdelab/common/logtag.hh>
+#include <dune/pdelab/instationary/blockdiagonalmassinverse.hh>
 #include <dune/pdelab/instationary/onestepparameter.hh>
+#include <dune/pdelab/instationary/vectorpool.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -96,8 +103,142 @@ namespace Dune {
     };
 
 
+    //! Step size control from the error estimate of an embedded Runge-Kutta scheme
+    /**
+     * The error of a step is measured in the scaled maximum norm
+     * \f[
+     *   \mathrm{err} = \max_i \frac{|\hat u_i - u_i|}{\mathrm{atol} + \mathrm{rtol}\max(|u^k_i|,|u_i|)}
+     * \f]
+     * over all processes, and a step is accepted if \f$ \mathrm{err} \le 1 \f$. After an
+     * accepted step, the next step size follows the PI controller of Gustafsson,
+     * \f[
+     *   \Delta t^{k+1} = \Delta t^k \cdot \mathrm{safety}\cdot\mathrm{err}^{-\alpha}
+     *   \cdot\mathrm{err}_{\mathrm{prev}}^{\beta}
+     * \f]
+     * with \f$ \alpha = 0.7/q \f$, \f$ \beta = 0.4/q \f$, where q is the lowest order of the
+     * pair plus one. A rejected step is repeated with \f$ \mathrm{safety}\cdot\mathrm{err}^{-1/q} \f$
+     * times its size. The factors are limited to [minFactor,maxFactor]. A step whose error is
+     * not finite, e.g. because the solution blew up, is rejected and repeated with minFactor
+     * times its size.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class PIStepSizeController
+    {
+    public:
+      typedef R RealType;
+
+      PIStepSizeController (R atol_, R rtol_, R safety_=0.9, R min_factor_=0.2, R max_factor_=5.0)
+        : atol(atol_), rtol(rtol_), safety(safety_), min_factor(min_factor_), max_factor(max_factor_),
+          min_dt(0.0), previous_error(1.0), accepted_steps(0), rejected_steps(0)
+      {}
+
+      //! Step sizes below this value make the step fail with an exception.
+      /**
+       * Steps of size zero always fail, so repeatedly rejected steps terminate even without
+       * a minimum step size, but only after the step size underflowed.
+       */
+      void setMinTimestep (R min_dt_)
+      {
+        min_dt = min_dt_;
+      }
+
+      R minTimestep () const
+      {
+        return min_dt;
+      }
+
+      //! Computes the scaled maximum norm of the difference of the solution and the embedded solution.
+      /**
+       * Returns infinity if any of the entries is not finite on any process.
+       */
+      template<typename V>
+      R errorNorm (const V& xold, const V& xnew, const V& xembedded) const
+      {
+        using std::abs;
+        using std::isfinite;
+        using std::max;
+        R error(0.0);
+        auto it_old = xold.begin();
+        auto it_new = xnew.begin();
+        for (auto it_emb = xembedded.begin(); it_emb != xembedded.end(); ++it_emb, ++it_old, ++it_new)
+          {
+            const R e = abs(*it_emb - *it_new) / (atol + rtol*max(abs(*it_old),abs(*it_new)));
+            // max() drops NaN, so map it to infinity before the reduction
+            if (not isfinite(e))
+              {
+                error = std::numeric_limits<R>::infinity();
+                break;
+              }
+            error = max(error,e);
+          }
+        return xnew.gridFunctionSpace().gridView().comm().max(error);
+      }
+
+      //! Returns whether a step with the given error is accepted and updates the statistics.
+      bool accept (R error)
+      {
+        if (error <= 1.0)
+          {
+            ++accepted_steps;
+            return true;
+          }
+        ++rejected_steps;
+        return false;
+      }
+
+      //! Returns the factor for the size of the next step.
+      /**
+       * \param error    The error of the last step
+       * \param q        The lowest order of the embedded pair plus one
+       * \param accepted Whether the last step was accepted
+       */
+      R factor (R error, unsigned q, bool accepted)
+      {
+        using std::isfinite;
+        using std::pow;
+        using std::min;
+        using std::max;
+        if (not isfinite(error))
+          return min_factor;
+        if (not accepted)
+          return max(min_factor, min(R(1.0), safety*R(pow(error,-1.0/q))));
+        R f = error > 0.0 ? safety*R(pow(error,-0.7/q)*pow(previous_error,0.4/q)) : max_factor;
+        previous_error = max(error,R(1e-4));
+        return max(min_factor, min(max_factor, f));
+      }
+
+      //! Forgets the error of the last accepted step, e.g. after a discontinuity.
+      void reset ()
+      {
+        previous_error = 1.0;
+      }
+
+      //! Number of accepted steps
+      unsigned accepted () const
+      {
+        return accepted_steps;
+      }
+
+      //! Number of rejected steps
+      unsigned rejected () const
+      {
+        return rejected_steps;
+      }
+
+    private:
+      R atol, rtol, safety, min_factor, max_factor, min_dt;
+      R previous_error;
+      unsigned accepted_steps, rejected_steps;
+    };
+
+
     //! Do one step of an explicit time-stepping scheme
     /**
+     * The stage and residual vectors are allocated in the first step and reused in
+     * all further steps, see clearVectors().
+     *
      * \tparam T          type to represent time values
      * \tparam IGOS       assembler for instationary problems
      * \tparam LS         backend to solve diagonal linear system
@@ -110,6 +251,7 @@ namespace Dune {
     {
       typedef typename TrlV::ElementType Real;
       typedef typename IGOS::template MatrixContainer<Real>::Type M;
+      typedef BlockDiagonalMassInverse<typename IGOS::Traits::TrialGridFunctionSpace,Real> MassInverse;
 
     public:
       //! construct a new one step scheme
@@ -126,7 +268,7 @@ namespace Dune {
        */
       ExplicitOneStepMethod(const TimeSteppingParameterInterface<T>& method_, IGOS& igos_, LS& ls_)
         : method(&method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1), D(igos),
-          tc(new SimpleTimeController<T>()), allocated(true)
+          tc(new SimpleTimeController<T>()), allocated(true), cache_mass_inverse(false)
       {
         if (method->implicit())
           DUNE_THROW(Exception,"explicit one step method called with implicit scheme");
@@ -148,7 +290,7 @@ namespace Dune {
        */
       ExplicitOneStepMethod(const TimeSteppingParameterInterface<T>& method_, IGOS& igos_, LS& ls_, TC& tc_)
         : method(&method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1), D(igos),
-          tc(&tc_), allocated(false)
+          tc(&tc_), allocated(false), cache_mass_inverse(false)
       {
         if (method->implicit())
           DUNE_THROW(Exception,"explicit one step method called with implicit scheme");
@@ -171,6 +313,45 @@ namespace Dune {
       //! change number of current step
       void setStepNumber(int newstep) { step = newstep; }
 
+      //! Enables or disables keeping the inverse of the block diagonal mass matrix
+      /**
+       * With discontinuous Galerkin spaces, the matrix of the temporal operator is block
+       * diagonal with one block per cell. If caching is enabled, this matrix is assembled
+       * only once, its cell blocks are inverted and all further stages only assemble the
+       * residuals and apply the stored inverse blocks instead of calling the linear solver,
+       * see BlockDiagonalMassInverse. Diagonal blocks, e.g. of orthonormal bases on affine
+       * cells or of lumped mass matrices, are detected and reduce the solve to a scaling.
+       *
+       * This requires a linear and time independent temporal operator. Call
+       * invalidateMassInverse() after the grid or the function space changed.
+       */
+      void setMassInverseCaching (bool enable)
+      {
+        cache_mass_inverse = enable;
+        if (not enable)
+          mass_inverse.invalidate();
+      }
+
+      //! Whether the inverse of the block diagonal mass matrix is kept between stages.
+      bool massInverseCaching () const
+      {
+        return cache_mass_inverse;
+      }
+
+      //! Discards the stored inverse mass matrix, which is recomputed in the next stage.
+      void invalidateMassInverse ()
+      {
+        mass_inverse.invalidate();
+      }
+
+      //! Frees the stage and residual vectors kept between time steps.
+      void clearVectors ()
+      {
+        stage_vectors.clear();
+        residual_vectors.clear();
+        correction_vectors.clear();
+      }
+
       //! redefine the method to be used; can be done before every step
       /**
        * \param method_ Parameter object.
@@ -220,7 +401,8 @@ namespace Dune {
         if(verbosityLevel>=4)
           std::cout << mytag << "Creating residual vectors alpha and beta..."
                     << std::endl;
-        TstV alpha(igos.testGridFunctionSpace()), beta(igos.testGridFunctionSpace()); // split residual vectors
+        TstV& alpha = residual_vectors.get(0,igos.testGridFunctionSpace()); // split residual vectors
+        TstV& beta = residual_vectors.get(1,igos.testGridFunctionSpace());
         if(verbosityLevel>=4)
           std::cout << mytag
                     << "Creating residual vectors alpha and beta... done."
@@ -279,16 +461,18 @@ namespace Dune {
             else
               {
                 // intermediate step
-                x.push_back(new TrlV(igos.trialGridFunctionSpace()));
+                x.push_back(&stage_vectors.get(r-1,igos.trialGridFunctionSpace()));
                 if (r>1)
                   *(x[r]) = *(x[r-1]); // use result of last stage as initial guess
                 else
                   *(x[r]) = xnew;
               }
 
-            // compute residuals and jacobian
+            // compute residuals and jacobian, the latter only if its inverse is not kept
+            const bool assemble_D = not (cache_mass_inverse and mass_inverse.valid());
             if (verbosityLevel>=4) std::cout << "assembling D, alpha, beta ..." << std::endl;
-            D = Real(0.0);
+            if (assemble_D)
+              D = Real(0.0);
             alpha = 0.0;
             beta = 0.0;
 
@@ -297,7 +481,12 @@ namespace Dune {
 
             if(verbosityLevel>=4)
               std::cout << stagetag << "Assembling residual..." << std::endl;
-            igos.explicit_jacobian_residual(r,x,D,alpha,beta);
+            if (assemble_D)
+              igos.explicit_jacobian_residual(r,x,D,alpha,beta);
+            else
+              igos.explicit_residual(r,x,alpha,beta);
+            if (assemble_D and cache_mass_inverse)
+              mass_inverse.update(igos.trialGridFunctionSpace(),D);
             if(verbosityLevel>=4)
               std::cout << stagetag << "Assembling residual... done."
                         << std::endl;
@@ -348,7 +537,10 @@ namespace Dune {
             if (verbosityLevel>=4)
               std::cout << stagetag << "Solving diagonal system..."
                         << std::endl;
-            ls.apply(D,*x[r],alpha,0.99); // dummy reduction
+            if (cache_mass_inverse)
+              mass_inverse.solve(*x[r],alpha);
+            else
+              ls.apply(D,*x[r],alpha,0.99); // dummy reduction
             if (verbosityLevel>=4)
               std::cout << stagetag << "Solving diagonal system... done."
                         << std::endl;
@@ -367,9 +559,6 @@ namespace Dune {
               std::cout << stagetag << "Finished." << std::endl;
           }
 
-        // delete intermediate steps
-        for(unsigned i=1; i<method->s(); ++i) delete x[i];
-
         // step cleanup
         if (verbosityLevel>=4)
           std::cout << mytag << "Cleanup..." << std::endl;
@@ -381,6 +570,59 @@ namespace Dune {
         return dt;
       }
 
+      /*! \brief do one step with control of the step size by an embedded error estimate;
+       *
+       * The step is repeated with smaller step sizes until the controller accepts its
+       * error, which requires a method derived from EmbeddedTimeSteppingParameterInterface.
+       * The embedded solution is combined from the stages of the step and a single
+       * additional residual at the new solution, see embeddedSolution().
+       *
+       * \param[in]  time start of time step
+       * \param[in,out] dt step size to try first; contains the size proposed for the next step on exit
+       * \param[in]  xold value at begin of time step
+       * \param[in,out] xnew value at end of time step; contains initial guess for first substep on entry
+       * \param[in,out] controller step size controller
+       * \return size of the accepted step
+       */
+      T applyAdaptive (T time, T& dt, TrlV& xold, TrlV& xnew, PIStepSizeController<T>& controller)
+      {
+        const EmbeddedTimeSteppingParameterInterface<T>* embedded_method =
+          dynamic_cast<const EmbeddedTimeSteppingParameterInterface<T>*>(method);
+        if (not embedded_method)
+          DUNE_THROW(Exception,"adaptive time stepping requires an embedded Runge-Kutta method");
+        const unsigned q = std::min(embedded_method->order(),embedded_method->embeddedOrder()) + 1;
+
+        TrlV& xembedded = correction_vectors.get(2,igos.trialGridFunctionSpace());
+        TrlV& xinit = correction_vectors.get(3,igos.trialGridFunctionSpace());
+        xinit = xnew;
+        while (true)
+          {
+            if (not (dt > 0.0) or dt < controller.minTimestep())
+              DUNE_THROW(Exception,"time step size fell below the minimum of the step size controller");
+
+            xnew = xinit;
+            const T taken = apply(time,dt,xold,xnew);
+            embeddedSolution(*embedded_method,time,taken,xold,xnew,xembedded);
+            const T error = controller.errorNorm(xold,xnew,xembedded);
+            const bool accepted = controller.accept(error);
+            dt = taken*controller.factor(error,q,accepted);
+            if (accepted)
+              return taken;
+
+            // rejected steps do not count
+            step--;
+            if (verbosityLevel>=1)
+              {
+                std::ios_base::fmtflags oldflags = std::cout.flags();
+                std::cout << "rejected step with error " << std::setw(12) << std::setprecision(4)
+                          << std::scientific << error << ", retrying with dt "
+                          << std::setw(12) << std::setprecision(4) << std::scientific << dt
+                          << std::endl;
+                std::cout.flags(oldflags);
+              }
+          }
+      }
+
       /*! \brief do one step;
        * \param[in]  time start of time step
        * \param[in]  dt suggested time step size
@@ -418,7 +660,8 @@ namespace Dune {
         if(verbosityLevel>=4)
           std::cout << mytag << "Creating residual vectors alpha and beta..."
                     << std::endl;
-        TstV alpha(igos.testGridFunctionSpace()), beta(igos.testGridFunctionSpace()); // split residual vectors
+        TstV& alpha = residual_vectors.get(0,igos.testGridFunctionSpace()); // split residual vectors
+        TstV& beta = residual_vectors.get(1,igos.testGridFunctionSpace());
         if(verbosityLevel>=4)
           std::cout << mytag
                     << "Creating residual vectors alpha and beta... done."
@@ -431,8 +674,8 @@ namespace Dune {
         if(verbosityLevel>=4)
           std::cout << mytag << "Creating residual vector and update for residual formulation of linear problem per stage"
                     << std::endl;
-        TrlV residual(igos.testGridFunctionSpace());
-        TrlV update(igos.testGridFunctionSpace());
+        TrlV& residual = correction_vectors.get(0,igos.testGridFunctionSpace());
+        TrlV& update = correction_vectors.get(1,igos.testGridFunctionSpace());
         if(verbosityLevel>=4)
           std::cout << mytag << "Creating residual vector and update for residual... done."
                     << std::endl;
@@ -491,16 +734,18 @@ namespace Dune {
             else
               {
                 // intermediate step
-                x.push_back(new TrlV(igos.trialGridFunctionSpace()));
+                x.push_back(&stage_vectors.get(r-1,igos.trialGridFunctionSpace()));
                 if (r>1)
                   *(x[r]) = *(x[r-1]); // use result of last stage as initial guess
                 else
                   *(x[r]) = xnew;
               }
 
-            // compute residuals and jacobian
+            // compute residuals and jacobian, the latter only if its inverse is not kept
+            const bool assemble_D = not (cache_mass_inverse and mass_inverse.valid());
             if (verbosityLevel>=4) std::cout << "assembling D, alpha, beta ..." << std::endl;
-            D = Real(0.0);
+            if (assemble_D)
+              D = Real(0.0);
             alpha = 0.0;
             beta = 0.0;
 
@@ -512,7 +757,12 @@ namespace Dune {
 
             if(verbosityLevel>=4)
               std::cout << stagetag << "Assembling residual..." << std::endl;
-            igos.explicit_jacobian_residual(r,x,D,alpha,beta);
+            if (assemble_D)
+              igos.explicit_jacobian_residual(r,x,D,alpha,beta);
+            else
+              igos.explicit_residual(r,x,alpha,beta);
+            if (assemble_D and cache_mass_inverse)
+              mass_inverse.update(igos.trialGridFunctionSpace(),D);
             if(verbosityLevel>=4)
               std::cout << stagetag << "Assembling residual... done."
                         << std::endl;
@@ -564,14 +814,20 @@ namespace Dune {
             // Set up residual formulation (for Dx[r]=alpha) and
             // compute update by solving diagonal system
             using Backend::native;
-            native(D).mv(native(*x[r]), native(residual));
+            if (cache_mass_inverse)
+              mass_inverse.mv(*x[r], residual);
+            else
+              native(D).mv(native(*x[r]), native(residual));
             residual -= alpha;
             auto cc = igos.trialConstraints();
             Dune::PDELab::set_constrained_dofs(cc, 0.0, residual);
             if (verbosityLevel>=4)
               std::cout << stagetag << "Solving diagonal system..."
                         << std::endl;
-            ls.apply(D, update, residual, 0.99); // dummy reduction
+            if (cache_mass_inverse)
+              mass_inverse.solve(update, residual);
+            else
+              ls.apply(D, update, residual, 0.99); // dummy reduction
             if (verbosityLevel>=4)
               std::cout << stagetag << "Solving diagonal system... done."
                         << std::endl;
@@ -591,9 +847,6 @@ namespace Dune {
               std::cout << stagetag << "Finished." << std::endl;
           }
 
-        // delete intermediate steps
-        for(unsigned i=1; i<method->s(); ++i) delete x[i];
-
         // step cleanup
         if (verbosityLevel>=4)
           std::cout << mytag << "Cleanup..." << std::endl;
@@ -620,6 +873,87 @@ namespace Dune {
         {}
       };
 
+      //! Computes the embedded solution of the last step from its stages.
+      /**
+       * With \f$ k_j = M^{-1} r_0(u_h^{(j)}) \f$, stage r of the step solved
+       * \f[
+       *   \sum_{j=0}^{r} a_{rj} u_h^{(j)} + \Delta t \sum_{j=0}^{r-1} b_{rj} k_j = 0,
+       * \f]
+       * so as \f$ b_{r,r-1} \neq 0 \f$, the scaled derivatives \f$ \Delta t k_0,\ldots,\Delta t k_{s-1} \f$
+       * are linear combinations of the stages \f$ u_h^{(0)},\ldots,u_h^{(s)} \f$. Only
+       * \f$ \Delta t k_s \f$ requires another residual, which is assembled in an explicit Euler
+       * stage \f$ y = u_h^{(s)} - \Delta t k_s \f$ at the time of the last stage. The embedded
+       * solution, i.e. stage s+1 of the method, is then a linear combination of the stages and y.
+       */
+      void embeddedSolution (const EmbeddedTimeSteppingParameterInterface<T>& embedded_method,
+                             T time, T dt, TrlV& xold, TrlV& xnew, TrlV& xembedded)
+      {
+        using std::abs;
+        const unsigned s = embedded_method.s();
+
+        // y = x_s - dt k_s
+        TrlV& y = correction_vectors.get(4,igos.trialGridFunctionSpace());
+        y = xnew;
+        std::vector<TrlV*> x = {&xnew, &y};
+        igos.preStep(euler,time+embedded_method.d(s)*dt,dt);
+        TstV& alpha = residual_vectors.get(0,igos.testGridFunctionSpace());
+        TstV& beta = residual_vectors.get(1,igos.testGridFunctionSpace());
+        const bool assemble_D = not (cache_mass_inverse and mass_inverse.valid());
+        if (assemble_D)
+          D = Real(0.0);
+        alpha = 0.0;
+        beta = 0.0;
+        if (assemble_D)
+          igos.explicit_jacobian_residual(1,x,D,alpha,beta);
+        else
+          igos.explicit_residual(1,x,alpha,beta);
+        if (assemble_D and cache_mass_inverse)
+          mass_inverse.update(igos.trialGridFunctionSpace(),D);
+        alpha.axpy(dt,beta);
+        if (cache_mass_inverse)
+          mass_inverse.solve(y,alpha);
+        else
+          ls.apply(D,y,alpha,0.99); // dummy reduction
+        igos.postStage();
+        igos.postStep();
+
+        // coefficients of dt k_j, j=0,...,s, with respect to x_0,...,x_s,y
+        const unsigned n = s+2;
+        std::vector<T> c((s+1)*n,0.0);
+        c[s*n+s] = 1.0;
+        c[s*n+s+1] = -1.0;
+        for (unsigned r=1; r<=s; ++r)
+          {
+            const T pivot = embedded_method.b(r,r-1);
+            if (abs(pivot) < 1e-14)
+              DUNE_THROW(Exception,"the embedded solution requires b(r,r-1) != 0 in every stage");
+            T* row = &c[(r-1)*n];
+            for (unsigned j=0; j<=r; ++j)
+              row[j] += embedded_method.a(r,j);
+            for (unsigned j=0; j+1<r; ++j)
+              for (unsigned i=0; i<n; ++i)
+                row[i] += embedded_method.b(r,j)*c[j*n+i];
+            for (unsigned i=0; i<n; ++i)
+              row[i] /= -pivot;
+          }
+
+        // the embedded solution is stage s+1 of the method
+        std::vector<T> weights(n,0.0);
+        for (unsigned j=0; j<=s; ++j)
+          {
+            weights[j] += embedded_method.a(s+1,j);
+            for (unsigned i=0; i<n; ++i)
+              weights[i] += embedded_method.b(s+1,j)*c[j*n+i];
+          }
+        const T diagonal = embedded_method.a(s+1,s+1);
+        xembedded = xold;
+        xembedded *= -weights[0]/diagonal;
+        for (unsigned i=1; i<s; ++i)
+          xembedded.axpy(-weights[i]/diagonal,stage_vectors.get(i-1,igos.trialGridFunctionSpace()));
+        xembedded.axpy(-weights[s]/diagonal,xnew);
+        xembedded.axpy(-weights[s+1]/diagonal,y);
+      }
+
       const TimeSteppingParameterInterface<T> *method;
       IGOS& igos;
       LS& ls;
@@ -628,6 +962,230 @@ namespace Dune {
       M D;
       TimeControllerInterface<T> *tc;
       bool allocated;
+      bool cache_mass_inverse;
+      MassInverse mass_inverse;
+      VectorPool<TrlV> stage_vectors;
+      VectorPool<TstV> residual_vectors;
+      VectorPool<TrlV> correction_vectors;
+      ExplicitEulerParameter<T> euler;
+    };
+
+    //! Do one step of a low-storage explicit Runge-Kutta scheme
+    /**
+     * Unlike ExplicitOneStepMethod, which has to keep the solutions of all stages of a
+     * generic scheme, this method only keeps the solution, one increment, the spatial
+     * residual and its product with the inverse mass matrix, independent of the number
+     * of stages, see LowStorageRKParameterInterface. It works on the grid operators of the
+     * spatial and the temporal residual forms directly, and all vectors are kept between
+     * time steps.
+     *
+     * The matrix of the temporal operator is assembled in the first step and reused
+     * afterwards, which requires a linear and time independent temporal operator. Call
+     * invalidateMass() after the grid or the function space changed.
+     *
+     * \tparam T          type to represent time values
+     * \tparam GO0        grid operator of the spatial residual form
+     * \tparam GO1        grid operator of the temporal residual form
+     * \tparam LS         backend to solve the (block) diagonal mass system
+     * \tparam V          vector type to represent coefficients of solutions
+     * \tparam TC         time controller class
+     */
+    template<class T, class GO0, class GO1, class LS, class V, class TC = SimpleTimeController<T> >
+    class LowStorageExplicitOneStepMethod
+    {
+      typedef typename V::ElementType Real;
+      typedef typename GO0::Traits::Range W;
+      typedef typename GO1::Traits::Jacobian M;
+      typedef BlockDiagonalMassInverse<typename GO1::Traits::TrialGridFunctionSpace,Real> MassInverse;
+
+    public:
+      //! construct a new one step scheme
+      /**
+       * \param method_    Parameter object.
+       * \param go0_       Grid operator of the spatial residual form.
+       * \param go1_       Grid operator of the temporal residual form.
+       * \param ls_        Linear solver for the mass matrix.
+       *
+       * Use SimpleTimeController that does not control the time step.
+       */
+      LowStorageExplicitOneStepMethod(const LowStorageRKParameterInterface<T>& method_, GO0& go0_, GO1& go1_, LS& ls_)
+        : method(&method_), go0(go0_), go1(go1_), ls(ls_), verbosityLevel(1), step(1),
+          tc(new SimpleTimeController<T>()), allocated(true), cache_mass_inverse(false)
+      {
+        if (go0.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+      }
+
+      //! construct a new one step scheme
+      /**
+       * \param method_    Parameter object.
+       * \param go0_       Grid operator of the spatial residual form.
+       * \param go1_       Grid operator of the temporal residual form.
+       * \param ls_        Linear solver for the mass matrix.
+       * \param tc_        a time controller object
+       */
+      LowStorageExplicitOneStepMethod(const LowStorageRKParameterInterface<T>& method_, GO0& go0_, GO1& go1_, LS& ls_, TC& tc_)
+        : method(&method_), go0(go0_), go1(go1_), ls(ls_), verbosityLevel(1), step(1),
+          tc(&tc_), allocated(false), cache_mass_inverse(false)
+      {}
+
+      ~LowStorageExplicitOneStepMethod ()
+      {
+        if (allocated) delete tc;
+      }
+
+      //! change verbosity level; 0 means completely quiet
+      void setVerbosityLevel (int level)
+      {
+        if (go0.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+        else
+          verbosityLevel = level;
+      }
+
+      //! change number of current step
+      void setStepNumber(int newstep) { step = newstep; }
+
+      //! redefine the method to be used; can be done before every step
+      void setMethod (const LowStorageRKParameterInterface<T>& method_)
+      {
+        method = &method_;
+      }
+
+      //! Solve with the cell blocks of the mass matrix instead of the linear solver, see BlockDiagonalMassInverse.
+      void setMassInverseCaching (bool enable)
+      {
+        cache_mass_inverse = enable;
+        invalidateMass();
+      }
+
+      //! Discards the mass matrix, which is reassembled in the next step.
+      void invalidateMass ()
+      {
+        mass.reset();
+        mass_inverse.invalidate();
+      }
+
+      /*! \brief do one step;
+       * \param[in]  time start of time step
+       * \param[in]  dt suggested time step size
+       * \param[in]  xold value at begin of time step
+       * \param[out] xnew value at end of time step
+       * \return time step size
+       */
+      T apply (T time, T dt, const V& xold, V& xnew)
+      {
+        // save formatting attributes
+        ios_base_all_saver format_attribute_saver(std::cout);
+
+        if (verbosityLevel>=1){
+          std::cout << "TIME STEP [" << method->name() << "] "
+                    << std::setw(6) << step
+                    << " time (from): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time
+                    << " dt: "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << dt
+                    << " time (to): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time+dt
+                    << std::endl;
+        }
+
+        V& delta = vectors.get(0,go0.trialGridFunctionSpace());
+        V& z = vectors.get(1,go0.trialGridFunctionSpace());
+        W& r = residuals.get(0,go0.testGridFunctionSpace());
+
+        // assemble the mass matrix once
+        if (!mass)
+          {
+            mass = std::make_unique<M>(go1,Real(0.0));
+            go1.localAssembler().setWeight(1.0);
+            go1.jacobian(xold,*mass);
+            if (cache_mass_inverse)
+              mass_inverse.update(go1.trialGridFunctionSpace(),*mass);
+          }
+
+        go0.localAssembler().preStep(time,dt,method->s());
+        go0.localAssembler().setWeight(1.0);
+
+        if (&xnew != &xold)
+          xnew = xold;
+        delta = 0.0;
+
+        for (unsigned i=0; i<method->s(); ++i)
+          {
+            const T stage_time = time+method->c(i)*dt;
+            if (verbosityLevel>=2){
+              std::cout << "STAGE "
+                        << i+1
+                        << " time: "
+                        << std::setw(12) << std::setprecision(4) << std::scientific
+                        << stage_time
+                        << "." << std::endl;
+            }
+
+            // spatial residual at the current solution
+            go0.localAssembler().preStage(stage_time,i+1);
+            go0.localAssembler().setTime(stage_time);
+            r = 0.0;
+            go0.residual(xnew,r);
+
+            // let time controller compute the optimal dt in first stage
+            if (i==0)
+              {
+                T newdt = std::min(tc->suggestTimestep(time,dt), dt);
+                if (verbosityLevel>=2 && newdt!=dt)
+                  std::cout << "changed dt to "
+                            << std::setw(12) << std::setprecision(4) << std::scientific
+                            << newdt
+                            << std::endl;
+                dt = newdt;
+              }
+
+            // z = M^{-1} r
+            z = 0.0;
+            if (cache_mass_inverse)
+              mass_inverse.solve(z,r);
+            else
+              ls.apply(*mass,z,r,0.99); // dummy reduction
+
+            // delta = a_i delta - dt z, u = u + b_i delta
+            delta *= method->a(i);
+            delta.axpy(-dt,z);
+            xnew.axpy(method->b(i),delta);
+
+            go0.localAssembler().postStage();
+          }
+
+        go0.localAssembler().postStep();
+
+        step++;
+        return dt;
+      }
+
+      //! Frees the vectors kept between time steps.
+      void clearVectors ()
+      {
+        vectors.clear();
+        residuals.clear();
+      }
+
+    private:
+      const LowStorageRKParameterInterface<T> *method;
+      GO0& go0;
+      GO1& go1;
+      LS& ls;
+      int verbosityLevel;
+      int step;
+      TimeControllerInterface<T> *tc;
+      bool allocated;
+      bool cache_mass_inverse;
+      std::unique_ptr<M> mass;
+      MassInverse mass_inverse;
+      VectorPool<V> vectors;
+      VectorPool<W> residuals;
     };
 
     /** @} */
@@ -0,0 +1,304 @@
+// -*- tab-width: 2; indent-tabs-mode: nil -*-
+// vi: set et ts=2 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_INSTATIONARY_IMEXONESTEP_HH
+#define DUNE_PDELAB_INSTATIONARY_IMEXONESTEP_HH
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <dune/common/ios_state.hh>
+#include <dune/pdelab/instationary/implicitonestep.hh>
+#include <dune/pdelab/instationary/onestepparameter.hh>
+#include <dune/pdelab/instationary/vectorpool.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    /**
+     *  @addtogroup OneStepMethod
+     *  @{
+     */
+
+    //! Do one step of an additive implicit-explicit (IMEX) Runge-Kutta scheme
+    /**
+     * The spatial operator is split into two grid operators. The implicitly treated part,
+     * e.g. diffusion and reaction, is the spatial operator of the instationary grid operator
+     * igos together with the temporal operator, and each stage solves for it with the PDE
+     * solver like OneStepMethod. The explicitly treated part, e.g. convection, is a
+     * stationary grid operator on the same spaces. Its residual is assembled once for each
+     * stage solution, kept for the rest of the step and only added to the constant part of
+     * the stage residuals, see OneStepGridOperator::addToConstResidual(). Thus Newton's
+     * method and the linear solver only see the Jacobian of the implicit part.
+     *
+     * \tparam T          type to represent time values
+     * \tparam IGOS       assembler for instationary problems of the implicit part
+     * \tparam GOE        grid operator of the explicit part
+     * \tparam PDESOLVER  solver problem in each stage (typically Newton)
+     * \tparam TrlV       vector type to represent coefficients of solutions
+     * \tparam TstV       vector type to represent residuals
+     */
+    template<class T, class IGOS, class GOE, class PDESOLVER, class TrlV, class TstV = TrlV>
+    class IMEXOneStepMethod
+    {
+      typedef typename PDESOLVER::Result PDESolverResult;
+
+    public:
+      typedef OneStepMethodResult Result;
+
+      //! construct a new IMEX one step scheme
+      /**
+       * \param method_    Parameter object. This chooses the actual method
+       *                   used.
+       * \param igos_      Assembler object of the implicit part (instationary grid operator space).
+       * \param goe_       Grid operator of the explicit part.
+       * \param pdesolver_ solver object for igos_ (typically Newton).
+       *
+       * The contructed method object stores references to the object it is
+       * constructed with, so these objects should be valid for as long as the
+       * constructed object is used.
+       */
+      IMEXOneStepMethod(const IMEXParameterInterface<T>& method_,
+                        IGOS& igos_, GOE& goe_, PDESOLVER& pdesolver_)
+        : method(&method_), igos(igos_), goe(goe_), pdesolver(pdesolver_), verbosityLevel(1), step(1), res()
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+      }
+
+      //! change verbosity level; 0 means completely quiet
+      void setVerbosityLevel (int level)
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+        else
+          verbosityLevel = level;
+      }
+
+      //! change number of current step
+      void setStepNumber(int newstep) { step = newstep; }
+
+      //! Access to the (non) linear solver
+      const PDESOLVER & getPDESolver() const
+      {
+        return pdesolver;
+      }
+
+      //! Access to the (non) linear solver
+      PDESOLVER & getPDESolver()
+      {
+        return pdesolver;
+      }
+
+      const Result& result() const
+      {
+        return res;
+      }
+
+      //! redefine the method to be used; can be done before every step
+      void setMethod (const IMEXParameterInterface<T>& method_)
+      {
+        method = &method_;
+      }
+
+      //! Frees the stage vectors and explicit residuals kept between the steps.
+      void clearVectors ()
+      {
+        stage_vectors.clear();
+        explicit_residuals.clear();
+      }
+
+      /*! \brief do one step;
+       * \param[in]  time start of time step
+       * \param[in]  dt suggested time step size
+       * \param[in]  xold value at begin of time step
+       * \param[in,out] xnew value at end of time step; contains initial guess for first substep on entry
+       * \return selected time step size
+       */
+      T apply (T time, T dt, TrlV& xold, TrlV& xnew)
+      {
+        auto initialize = [&xnew](unsigned r, const std::vector<TrlV*>& x)
+          {
+            // use result of last stage as initial guess
+            if (r>1)
+              *(x[r]) = *(x[r-1]);
+            else if (x[r] != &xnew)
+              *(x[r]) = xnew;
+          };
+        return doStep(time,dt,xold,xnew,initialize);
+      }
+
+      /*! \brief do one step;
+       * This is a version which interpolates constraints at the start of each stage
+       *
+       * \param[in]  time start of time step
+       * \param[in]  dt suggested time step size
+       * \param[in]  xold value at begin of time step
+       * \param[in]  f function to interpolate boundary conditions from
+       * \param[in,out] xnew value at end of time step; contains initial guess for first substep on entry
+       * \return selected time step size
+       */
+      template<typename F>
+      T apply (T time, T dt, TrlV& xold, F& f, TrlV& xnew)
+      {
+        auto initialize = [this,&f](unsigned r, const std::vector<TrlV*>& x)
+          {
+            igos.interpolate(r,*x[r-1],f,*x[r]);
+          };
+        return doStep(time,dt,xold,xnew,initialize);
+      }
+
+    private:
+
+      template<typename Initialize>
+      T doStep (T time, T dt, TrlV& xold, TrlV& xnew, Initialize& initialize)
+      {
+        // save formatting attributes
+        ios_base_all_saver format_attribute_saver(std::cout);
+
+        // do statistics
+        OneStepMethodPartialResult step_result;
+
+        std::vector<TrlV*> x(1); // vector of pointers to all steps
+        x[0] = &xold;            // initially we have only one
+
+        if (verbosityLevel>=1){
+          std::ios_base::fmtflags oldflags = std::cout.flags();
+          std::cout << "TIME STEP [" << method->name() << "] "
+                    << std::setw(6) << step
+                    << " time (from): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time
+                    << " dt: "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << dt
+                    << " time (to): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time+dt
+                    << std::endl;
+          std::cout.flags(oldflags);
+        }
+
+        // prepare assemblers
+        igos.preStep(*method,time,dt);
+        goe.localAssembler().preStep(time,dt,method->s());
+
+        // loop over all stages
+        for (unsigned r=1; r<=method->s(); ++r)
+          {
+            if (verbosityLevel>=2){
+              std::ios_base::fmtflags oldflags = std::cout.flags();
+              std::cout << "STAGE "
+                        << r
+                        << " time (to): "
+                        << std::setw(12) << std::setprecision(4) << std::scientific
+                        << time+method->d(r)*dt
+                        << "." << std::endl;
+              std::cout.flags(oldflags);
+            }
+
+            // explicit residual of the previous stage, the older ones are kept
+            TstV& explicit_residual = explicit_residuals.get(r-1,goe.testGridFunctionSpace());
+            explicit_residual = 0.0;
+            goe.localAssembler().preStage(time+method->d(r-1)*dt,r-1);
+            goe.localAssembler().setTime(time+method->d(r-1)*dt);
+            goe.residual(*x[r-1],explicit_residual);
+            goe.localAssembler().postStage();
+
+            // prepare stage, the constant part of the residual combines implicit and explicit parts
+            igos.preStage(r,x);
+            for (unsigned j=0; j<r; ++j)
+              {
+                using std::abs;
+                const T weight = method->explicitB(r,j);
+                if (abs(weight) > 1e-6)
+                  igos.addToConstResidual(weight,explicit_residuals.get(j,goe.testGridFunctionSpace()));
+              }
+
+            // get vector for current stage
+            if (r==method->s())
+              x.push_back(&xnew); // last stage
+            else
+              x.push_back(&stage_vectors.get(r-1,igos.trialGridFunctionSpace()));
+            initialize(r,x);
+
+            // solve stage
+            try {
+              pdesolver.apply(*x[r]);
+            }
+            catch (...)
+              {
+                // time step failed -> accumulate to total only
+                PDESolverResult pderes = pdesolver.result();
+                step_result.assembler_time += pderes.assembler_time;
+                step_result.linear_solver_time += pderes.linear_solver_time;
+                step_result.linear_solver_iterations += pderes.linear_solver_iterations;
+                step_result.nonlinear_solver_iterations += pderes.iterations;
+                res.total.assembler_time += step_result.assembler_time;
+                res.total.linear_solver_time += step_result.linear_solver_time;
+                res.total.linear_solver_iterations += step_result.linear_solver_iterations;
+                res.total.nonlinear_solver_iterations += step_result.nonlinear_solver_iterations;
+                res.total.timesteps += 1;
+                throw;
+              }
+            PDESolverResult pderes = pdesolver.result();
+            step_result.assembler_time += pderes.assembler_time;
+            step_result.linear_solver_time += pderes.linear_solver_time;
+            step_result.linear_solver_iterations += pderes.linear_solver_iterations;
+            step_result.nonlinear_solver_iterations += pderes.iterations;
+
+            // stage cleanup
+            igos.postStage();
+          }
+
+        // step cleanup
+        igos.postStep();
+        goe.localAssembler().postStep();
+
+        // update statistics
+        res.total.assembler_time += step_result.assembler_time;
+        res.total.linear_solver_time += step_result.linear_solver_time;
+        res.total.linear_solver_iterations += step_result.linear_solver_iterations;
+        res.total.nonlinear_solver_iterations += step_result.nonlinear_solver_iterations;
+        res.total.timesteps += 1;
+        res.successful.assembler_time += step_result.assembler_time;
+        res.successful.linear_solver_time += step_result.linear_solver_time;
+        res.successful.linear_solver_iterations += step_result.linear_solver_iterations;
+        res.successful.nonlinear_solver_iterations += step_result.nonlinear_solver_iterations;
+        res.successful.timesteps += 1;
+        if (verbosityLevel>=1){
+          std::ios_base::fmtflags oldflags = std::cout.flags();
+          std::cout << "::: timesteps      " << std::setw(6) << res.successful.timesteps
+                    << " (" << res.total.timesteps << ")" << std::endl;
+          std::cout << "::: nl iterations  " << std::setw(6) << res.successful.nonlinear_solver_iterations
+                    << " (" << res.total.nonlinear_solver_iterations << ")" << std::endl;
+          std::cout << "::: lin iterations " << std::setw(6) << res.successful.linear_solver_iterations
+                    << " (" << res.total.linear_solver_iterations << ")" << std::endl;
+          std::cout << "::: assemble time  " << std::setw(12) << std::setprecision(4) << std::scientific
+                    << res.successful.assembler_time << " (" << res.total.assembler_time << ")" << std::endl;
+          std::cout << "::: lin solve time " << std::setw(12) << std::setprecision(4) << std::scientific
+                    << res.successful.linear_solver_time << " (" << res.total.linear_solver_time << ")" << std::endl;
+          std::cout.flags(oldflags);
+        }
+
+        step++;
+        return dt;
+      }
+
+      const IMEXParameterInterface<T> *method;
+      IGOS& igos;
+      GOE& goe;
+      PDESOLVER& pdesolver;
+      int verbosityLevel;
+      int step;
+      Result res;
+      VectorPool<TrlV> stage_vectors;
+      VectorPool<TstV> explicit_residuals;
+    };
+
+    /** @} */
+  } // end namespace PDELab
+} // end namespace Dune
+#endif // DUNE_PDELAB_INSTATIONARY_IMEXONESTEP_HH
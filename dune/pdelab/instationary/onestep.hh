@@ -6,5 +6,6 @@
 
 #include <dune/pdelab/instationary/explicitonestep.hh>
 #include <dune/pdelab/instationary/implicitonestep.hh>
+#include <dune/pdelab/instationary/imexonestep.hh>
 
 #endif // DUNE_PDELAB_INSTATIONARY_ONESTEP_HH
@@ -4,6 +4,8 @@
 #ifndef DUNE_PDELAB_INSTATIONARY_ONESTEPPARAMETER_HH
 #define DUNE_PDELAB_INSTATIONARY_ONESTEPPARAMETER_HH
 
+#include <cmath>
+
 #include <dune/common/exceptions.hh>
 #include <dune/common/fmatrix.hh>
 #include <dune/common/fvector.hh>
@@ -435,6 +437,196 @@ namespace Dune {
 
 
 
+    //! Base parameter class for explicit Runge-Kutta schemes with an embedded solution of lower order
+    /**
+     * In addition to the s stages of TimeSteppingParameterInterface, a(s+1,i), b(s+1,i)
+     * and d(s+1) describe one more stage in the same form, which computes the embedded
+     * solution from the stages \f$ u_h^{(0)},\ldots,u_h^{(s)} \f$. Its difference to
+     * \f$ u_h^{(s)} \f$ estimates the error of the step, see
+     * ExplicitOneStepMethod::applyAdaptive(). ExplicitOneStepMethod does not assemble this
+     * stage, but combines the stages of the step, which requires b(r,r-1) to be nonzero
+     * for all stages r.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class EmbeddedTimeSteppingParameterInterface : public TimeSteppingParameterInterface<R>
+    {
+    public:
+
+      /*! \brief Return the order of the solution
+       */
+      virtual unsigned order () const = 0;
+
+      /*! \brief Return the order of the embedded solution
+       */
+      virtual unsigned embeddedOrder () const = 0;
+    };
+
+    /**
+     * \brief Parameters of the third order Runge-Kutta scheme of Bogacki and Shampine
+     * with an embedded solution of second order
+     *
+     * The embedded solution uses the derivative at the new solution (first same as last),
+     * which costs one residual assembly per step, as it is not reused in the next step.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class BogackiShampineParameter : public EmbeddedTimeSteppingParameterInterface<R>
+    {
+    public:
+
+      BogackiShampineParameter ()
+      {
+        D[0] = 0.0; D[1] = 0.5; D[2] = 0.75; D[3] = 1.0; D[4] = 1.0;
+
+        A = 0.0;
+        B = 0.0;
+        for (int r=0; r<4; ++r)
+          {
+            A[r][0] = -1.0;
+            A[r][r+1] = 1.0;
+          }
+
+        B[0][0] = 0.5;
+        B[1][0] = 0.0;      B[1][1] = 0.75;
+        B[2][0] = 2.0/9.0;  B[2][1] = 1.0/3.0; B[2][2] = 4.0/9.0;
+        B[3][0] = 7.0/24.0; B[3][1] = 0.25;    B[3][2] = 1.0/3.0; B[3][3] = 0.125;
+      }
+
+      virtual bool implicit () const override
+      {
+        return false;
+      }
+
+      virtual unsigned s () const override
+      {
+        return 3;
+      }
+
+      virtual R a (int r, int i) const override
+      {
+        return A[r-1][i];
+      }
+
+      virtual R b (int r, int i) const override
+      {
+        return B[r-1][i];
+      }
+
+      virtual R d (int i) const override
+      {
+        return D[i];
+      }
+
+      virtual std::string name () const override
+      {
+        return std::string("Bogacki-Shampine 3(2)");
+      }
+
+      virtual unsigned order () const override
+      {
+        return 3;
+      }
+
+      virtual unsigned embeddedOrder () const override
+      {
+        return 2;
+      }
+
+    private:
+      Dune::FieldVector<R,5> D;
+      Dune::FieldMatrix<R,4,5> A;
+      Dune::FieldMatrix<R,4,5> B;
+    };
+
+    /**
+     * \brief Parameters of the fifth order Runge-Kutta scheme of Dormand and Prince
+     * with an embedded solution of fourth order
+     *
+     * The embedded solution uses the derivative at the new solution (first same as last),
+     * which costs one residual assembly per step, as it is not reused in the next step.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class DormandPrinceParameter : public EmbeddedTimeSteppingParameterInterface<R>
+    {
+    public:
+
+      DormandPrinceParameter ()
+      {
+        D[0] = 0.0; D[1] = 0.2; D[2] = 0.3; D[3] = 0.8; D[4] = 8.0/9.0; D[5] = 1.0; D[6] = 1.0; D[7] = 1.0;
+
+        A = 0.0;
+        B = 0.0;
+        for (int r=0; r<7; ++r)
+          {
+            A[r][0] = -1.0;
+            A[r][r+1] = 1.0;
+          }
+
+        B[0][0] = 0.2;
+        B[1][0] = 3.0/40.0;        B[1][1] = 9.0/40.0;
+        B[2][0] = 44.0/45.0;       B[2][1] = -56.0/15.0;      B[2][2] = 32.0/9.0;
+        B[3][0] = 19372.0/6561.0;  B[3][1] = -25360.0/2187.0; B[3][2] = 64448.0/6561.0;
+        B[3][3] = -212.0/729.0;
+        B[4][0] = 9017.0/3168.0;   B[4][1] = -355.0/33.0;     B[4][2] = 46732.0/5247.0;
+        B[4][3] = 49.0/176.0;      B[4][4] = -5103.0/18656.0;
+        B[5][0] = 35.0/384.0;      B[5][1] = 0.0;             B[5][2] = 500.0/1113.0;
+        B[5][3] = 125.0/192.0;     B[5][4] = -2187.0/6784.0;  B[5][5] = 11.0/84.0;
+        B[6][0] = 5179.0/57600.0;  B[6][1] = 0.0;             B[6][2] = 7571.0/16695.0;
+        B[6][3] = 393.0/640.0;     B[6][4] = -92097.0/339200.0; B[6][5] = 187.0/2100.0;
+        B[6][6] = 1.0/40.0;
+      }
+
+      virtual bool implicit () const override
+      {
+        return false;
+      }
+
+      virtual unsigned s () const override
+      {
+        return 6;
+      }
+
+      virtual R a (int r, int i) const override
+      {
+        return A[r-1][i];
+      }
+
+      virtual R b (int r, int i) const override
+      {
+        return B[r-1][i];
+      }
+
+      virtual R d (int i) const override
+      {
+        return D[i];
+      }
+
+      virtual std::string name () const override
+      {
+        return std::string("Dormand-Prince 5(4)");
+      }
+
+      virtual unsigned order () const override
+      {
+        return 5;
+      }
+
+      virtual unsigned embeddedOrder () const override
+      {
+        return 4;
+      }
+
+    private:
+      Dune::FieldVector<R,8> D;
+      Dune::FieldMatrix<R,7,8> A;
+      Dune::FieldMatrix<R,7,8> B;
+    };
+
     /**
      * \brief Parameters to turn the OneStepMethod into an
      * Alexander scheme.
@@ -691,6 +883,739 @@ namespace Dune {
       Dune::FieldMatrix<R,3,4> B;
     };
 
+    //! Base parameter class for low-storage explicit Runge-Kutta schemes
+    /**
+     * Runge-Kutta schemes in the 2N-storage form of Williamson [1] only need the
+     * solution \f$ u \f$ and one increment \f$ \delta \f$ between stages:
+     * \f[
+     * \begin{aligned}
+     *   \delta &\leftarrow A_i \delta + \Delta t\, L\left(u, t^k + c_i\Delta t\right)\\
+     *   u &\leftarrow u + B_i \delta & i=0,\ldots,s-1
+     * \end{aligned}
+     * \f]
+     * with \f$ A_0 = 0 \f$, where \f$ L(u) = -M^{-1} r_h(u) \f$ is the spatial residual
+     * form applied to the inverse of the mass matrix. These schemes are used by the
+     * LowStorageExplicitOneStepMethod.
+     *
+     * [1] J. H. Williamson. Low-storage Runge-Kutta schemes. J. Comput. Phys., 35:48–56, 1980
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class LowStorageRKParameterInterface
+    {
+    public:
+      typedef R RealType;
+
+      /*! \brief Return number of stages of the method
+       */
+      virtual unsigned s () const = 0;
+
+      /*! \brief Return the factor of the previous increment in stage i
+        \note that i ∈ 0,...,s-1
+      */
+      virtual R a (int i) const = 0;
+
+      /*! \brief Return the factor of the increment in the update of the solution in stage i
+        \note that i ∈ 0,...,s-1
+      */
+      virtual R b (int i) const = 0;
+
+      /*! \brief Return the relative time at which stage i evaluates the spatial residual
+        \note that i ∈ 0,...,s-1
+      */
+      virtual R c (int i) const = 0;
+
+      /*! \brief Return name of the scheme
+       */
+      virtual std::string name () const = 0;
+
+      //! every abstract base class has a virtual destructor
+      virtual ~LowStorageRKParameterInterface () {}
+    };
+
+    /**
+     * \brief Parameters of the three stage, third order low-storage Runge-Kutta
+     * scheme of Williamson
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class Williamson3Parameter : public LowStorageRKParameterInterface<R>
+    {
+    public:
+
+      Williamson3Parameter ()
+      {
+        A[0] = 0.0;       A[1] = -5.0/9.0;   A[2] = -153.0/128.0;
+        B[0] = 1.0/3.0;   B[1] = 15.0/16.0;  B[2] = 8.0/15.0;
+        C[0] = 0.0;       C[1] = 1.0/3.0;    C[2] = 3.0/4.0;
+      }
+
+      virtual unsigned s () const override
+      {
+        return 3;
+      }
+
+      virtual R a (int i) const override
+      {
+        return A[i];
+      }
+
+      virtual R b (int i) const override
+      {
+        return B[i];
+      }
+
+      virtual R c (int i) const override
+      {
+        return C[i];
+      }
+
+      virtual std::string name () const override
+      {
+        return std::string("low-storage RK3 (Williamson)");
+      }
+
+    private:
+      Dune::FieldVector<R,3> A;
+      Dune::FieldVector<R,3> B;
+      Dune::FieldVector<R,3> C;
+    };
+
+    /**
+     * \brief Parameters of the five stage, fourth order low-storage Runge-Kutta
+     * scheme of Carpenter and Kennedy
+     *
+     * M. H. Carpenter and C. A. Kennedy. Fourth-order 2N-storage Runge-Kutta schemes.
+     * NASA TM-109112, 1994
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class CarpenterKennedy4Parameter : public LowStorageRKParameterInterface<R>
+    {
+    public:
+
+      CarpenterKennedy4Parameter ()
+      {
+        A[0] = 0.0;
+        A[1] = -567301805773.0/1357537059087.0;
+        A[2] = -2404267990393.0/2016746695238.0;
+        A[3] = -3550918686646.0/2091501179385.0;
+        A[4] = -1275806237668.0/842570457699.0;
+
+        B[0] = 1432997174477.0/9575080441755.0;
+        B[1] = 5161836677717.0/13612068292357.0;
+        B[2] = 1720146321549.0/2090206949498.0;
+        B[3] = 3134564353537.0/4481467310338.0;
+        B[4] = 2277821191437.0/14882151754819.0;
+
+        C[0] = 0.0;
+        C[1] = 1432997174477.0/9575080441755.0;
+        C[2] = 2526269341429.0/6820363962896.0;
+        C[3] = 2006345519317.0/3224310063776.0;
+        C[4] = 2802321613138.0/2924317926251.0;
+      }
+
+      virtual unsigned s () const override
+      {
+        return 5;
+      }
+
+      virtual R a (int i) const override
+      {
+        return A[i];
+      }
+
+      virtual R b (int i) const override
+      {
+        return B[i];
+      }
+
+      virtual R c (int i) const override
+      {
+        return C[i];
+      }
+
+      virtual std::string name () const override
+      {
+        return std::string("low-storage RK4 (Carpenter-Kennedy)");
+      }
+
+    private:
+      Dune::FieldVector<R,5> A;
+      Dune::FieldVector<R,5> B;
+      Dune::FieldVector<R,5> C;
+    };
+
+    //! Base parameter class for additive implicit-explicit (IMEX) Runge-Kutta schemes
+    /**
+     * The spatial operator is split into a part \f$ r_E \f$ treated explicitly, e.g. convection,
+     * and a part \f$ r_I \f$ treated implicitly, e.g. diffusion and reaction. Stage r solves
+     * \f[
+     *   \sum_{j=0}^{r} \left[ a_{rj} m\left(u_h^{(j)},v;t^k+d_j\Delta t^k\right)
+     *   + b_{rj} \Delta t^k r_I\left(u_h^{(j)},v;t^k+d_j\Delta t^k\right) \right]
+     *   + \sum_{j=0}^{r-1} \hat b_{rj} \Delta t^k r_E\left(u_h^{(j)},v;t^k+d_j\Delta t^k\right) = 0,
+     * \f]
+     * where a, b and d are given by the methods of TimeSteppingParameterInterface and
+     * \f$ \hat b_{rj} \f$ by explicitB(). As in the other schemes \f$ u_h^{(s)} \f$ is the new
+     * solution, so schemes whose explicit part is not stiffly accurate append one more stage
+     * with \f$ b_{ss}=0 \f$ which only solves with the mass matrix.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class IMEXParameterInterface : public TimeSteppingParameterInterface<R>
+    {
+    public:
+
+      /*! \brief Return true if method is implicit
+       */
+      virtual bool implicit () const override
+      {
+        return true;
+      }
+
+      /*! \brief Return entries of the B matrix of the explicit part
+        \note that r ∈ 1,...,s and i ∈ 0,...,r-1
+      */
+      virtual R explicitB (int r, int i) const = 0;
+    };
+
+    /**
+     * \brief Parameters of the second order IMEX scheme ARS(2,2,2) of Ascher, Ruuth and Spiteri
+     *
+     * The implicit part is L-stable, both parts are stiffly accurate.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class ARS222Parameter : public IMEXParameterInterface<R>
+    {
+    public:
+
+      ARS222Parameter ()
+      {
+        using std::sqrt;
+        const R gamma = 1.0 - 1.0/sqrt(2.0);
+        const R delta = 1.0 - 1.0/(2.0*gamma);
+
+        D[0] = 0.0; D[1] = gamma; D[2] = 1.0;
+
+        A = 0.0;
+        B = 0.0;
+        BE = 0.0;
+        for (int r=0; r<2; ++r)
+          {
+            A[r][0] = -1.0;
+            A[r][r+1] = 1.0;
+          }
+
+        B[0][1] = gamma;
+        B[1][1] = 1.0-gamma; B[1][2] = gamma;
+
+        BE[0][0] = gamma;
+        BE[1][0] = delta;    BE[1][1] = 1.0-delta;
+      }
+
+      virtual unsigned s () const override
+      {
+        return 2;
+      }
+
+      virtual R a (int r, int i) const override
+      {
+        return A[r-1][i];
+      }
+
+      virtual R b (int r, int i) const override
+      {
+        return B[r-1][i];
+      }
+
+      virtual R explicitB (int r, int i) const override
+      {
+        return BE[r-1][i];
+      }
+
+      virtual R d (int i) const override
+      {
+        return D[i];
+      }
+
+      virtual std::string name () const override
+      {
+        return std::string("IMEX ARS(2,2,2)");
+      }
+
+    private:
+      Dune::FieldVector<R,3> D;
+      Dune::FieldMatrix<R,2,3> A;
+      Dune::FieldMatrix<R,2,3> B;
+      Dune::FieldMatrix<R,2,3> BE;
+    };
+
+    /**
+     * \brief Parameters of the third order IMEX scheme ARS(4,4,3) of Ascher, Ruuth and Spiteri
+     *
+     * The implicit part is L-stable, both parts are stiffly accurate.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class ARS443Parameter : public IMEXParameterInterface<R>
+    {
+    public:
+
+      ARS443Parameter ()
+      {
+        D[0] = 0.0; D[1] = 0.5; D[2] = 2.0/3.0; D[3] = 0.5; D[4] = 1.0;
+
+        A = 0.0;
+        B = 0.0;
+        BE = 0.0;
+        for (int r=0; r<4; ++r)
+          {
+            A[r][0] = -1.0;
+            A[r][r+1] = 1.0;
+          }
+
+        B[0][1] = 0.5;
+        B[1][1] = 1.0/6.0; B[1][2] = 0.5;
+        B[2][1] = -0.5;    B[2][2] = 0.5;  B[2][3] = 0.5;
+        B[3][1] = 1.5;     B[3][2] = -1.5; B[3][3] = 0.5; B[3][4] = 0.5;
+
+        BE[0][0] = 0.5;
+        BE[1][0] = 11.0/18.0; BE[1][1] = 1.0/18.0;
+        BE[2][0] = 5.0/6.0;   BE[2][1] = -5.0/6.0; BE[2][2] = 0.5;
+        BE[3][0] = 0.25;      BE[3][1] = 1.75;     BE[3][2] = 0.75; BE[3][3] = -1.75;
+      }
+
+      virtual unsigned s () const override
+      {
+        return 4;
+      }
+
+      virtual R a (int r, int i) const override
+      {
+        return A[r-1][i];
+      }
+
+      virtual R b (int r, int i) const override
+      {
+        return B[r-1][i];
+      }
+
+      virtual R explicitB (int r, int i) const override
+      {
+        return BE[r-1][i];
+      }
+
+      virtual R d (int i) const override
+      {
+        return D[i];
+      }
+
+      virtual std::string name () const override
+      {
+        return std::string("IMEX ARS(4,4,3)");
+      }
+
+    private:
+      Dune::FieldVector<R,5> D;
+      Dune::FieldMatrix<R,4,5> A;
+      Dune::FieldMatrix<R,4,5> B;
+      Dune::FieldMatrix<R,4,5> BE;
+    };
+
+    /**
+     * \brief Parameters of the third order additive Runge-Kutta scheme ARK3(2)4L[2]SA of
+     * Kennedy and Carpenter
+     *
+     * The implicit part is an L-stable, stiffly accurate ESDIRK scheme. The explicit part is
+     * not stiffly accurate, so the solution is computed in an additional fourth stage.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class KennedyCarpenterARK3Parameter : public IMEXParameterInterface<R>
+    {
+    public:
+
+      KennedyCarpenterARK3Parameter ()
+      {
+        const R gamma = 1767732205903.0/4055673282236.0;
+        const R b1 = 1471266399579.0/7840856788654.0;
+        const R b2 = -4482444167858.0/7529755066697.0;
+        const R b3 = 11266239266428.0/11593286722821.0;
+
+        D[0] = 0.0; D[1] = 2.0*gamma; D[2] = 0.6; D[3] = 1.0; D[4] = 1.0;
+
+        A = 0.0;
+        B = 0.0;
+        BE = 0.0;
+        for (int r=0; r<4; ++r)
+          {
+            A[r][0] = -1.0;
+            A[r][r+1] = 1.0;
+          }
+
+        B[0][0] = gamma; B[0][1] = gamma;
+        B[1][0] = 2746238789719.0/10658868560708.0; B[1][1] = -640167445237.0/6845629431997.0;
+        B[1][2] = gamma;
+        B[2][0] = b1; B[2][1] = b2; B[2][2] = b3; B[2][3] = gamma;
+        B[3][0] = b1; B[3][1] = b2; B[3][2] = b3; B[3][3] = gamma;
+
+        BE[0][0] = 1767732205903.0/2027836641118.0;
+        BE[1][0] = 5535828885825.0/10492691773637.0; BE[1][1] = 788022342437.0/10882634858940.0;
+        BE[2][0] = 6485989280629.0/16251701735622.0; BE[2][1] = -4246266847089.0/9704473918619.0;
+        BE[2][2] = 10755448449292.0/10357097424841.0;
+        BE[3][0] = b1; BE[3][1] = b2; BE[3][2] = b3; BE[3][3] = gamma;
+      }
+
+      virtual unsigned s () const override
+      {
+        return 4;
+      }
+
+      virtual R a (int r, int i) const override
+      {
+        return A[r-1][i];
+      }
+
+      virtual R b (int r, int i) const override
+      {
+        return B[r-1][i];
+      }
+
+      virtual R explicitB (int r, int i) const override
+      {
+        return BE[r-1][i];
+      }
+
+      virtual R d (int i) const override
+      {
+        return D[i];
+      }
+
+      virtual std::string name () const override
+      {
+        return std::string("IMEX ARK3(2)4L[2]SA (Kennedy-Carpenter)");
+      }
+
+    private:
+      Dune::FieldVector<R,5> D;
+      Dune::FieldMatrix<R,4,5> A;
+      Dune::FieldMatrix<R,4,5> B;
+      Dune::FieldMatrix<R,4,5> BE;
+    };
+
+    //! Base parameter class for Rosenbrock methods
+    /**
+     * Rosenbrock methods linearize the problem
+     * \f$ m(\partial_t u_h,v) + r(u_h,v;t) = 0 \f$ once per step. With the Jacobian
+     * \f$ J \f$ of the spatial residual at \f$ (u_h^k,t^k) \f$, stage \f$ i=1,\ldots,s \f$
+     * solves the linear system
+     * \f[
+     *   \left(\frac{1}{\gamma\Delta t^k} M + J\right) U_i
+     *   = -r\left(Y_i;t^k+\alpha_i\Delta t^k\right)
+     *   + \frac{1}{\Delta t^k} M\sum_{j=1}^{i-1} c_{ij} U_j
+     *   - \gamma_i\Delta t^k \partial_t r\left(u_h^k;t^k\right),
+     *   \qquad Y_i = u_h^k + \sum_{j=1}^{i-1} a_{ij} U_j,
+     * \f]
+     * and the new solution is \f$ u_h^{k+1} = u_h^k + \sum_{i=1}^s m_i U_i \f$. This is the
+     * transformed form of Hairer and Wanner, in which all stages share the matrix and no
+     * matrix-vector products with J are needed.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class RosenbrockParameterInterface
+    {
+    public:
+      typedef R RealType;
+
+      /*! \brief Return number of stages of the method
+       */
+      virtual unsigned s () const = 0;
+
+      /*! \brief Return the diagonal entry gamma of the method
+       */
+      virtual R gamma () const = 0;
+
+      /*! \brief Return the coefficient of U_j in the stage value Y_i
+        \note that i ∈ 1,...,s and j ∈ 1,...,i-1
+      */
+      virtual R a (int i, int j) const = 0;
+
+      /*! \brief Return the coefficient of U_j in the right hand side of stage i
+        \note that i ∈ 1,...,s and j ∈ 1,...,i-1
+      */
+      virtual R c (int i, int j) const = 0;
+
+      /*! \brief Return the weight of U_i in the new solution
+        \note that i ∈ 1,...,s
+      */
+      virtual R m (int i) const = 0;
+
+      /*! \brief Return the relative time of stage i
+        \note that i ∈ 1,...,s
+      */
+      virtual R alpha (int i) const = 0;
+
+      /*! \brief Return the weight of the time derivative of the residual in stage i
+        \note that i ∈ 1,...,s
+      */
+      virtual R gammaSum (int i) const = 0;
+
+      /*! \brief Return name of the scheme
+       */
+      virtual std::string name () const = 0;
+
+      //! every abstract base class has a virtual destructor
+      virtual ~RosenbrockParameterInterface () {}
+    };
+
+    /**
+     * \brief Parameters of the second order, L-stable Rosenbrock method ROS2 of Verwer et al.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class ROS2Parameter : public RosenbrockParameterInterface<R>
+    {
+    public:
+
+      ROS2Parameter ()
+      {
+        using std::sqrt;
+        g = 1.0 + 1.0/sqrt(2.0);
+
+        A = 0.0;
+        C = 0.0;
+        A[1][0] = 1.0/g;
+        C[1][0] = -2.0/g;
+        M[0] = 1.5/g; M[1] = 0.5/g;
+        Alpha[0] = 0.0; Alpha[1] = 1.0;
+        GammaSum[0] = g; GammaSum[1] = -g;
+      }
+
+      virtual unsigned s () const override
+      {
+        return 2;
+      }
+
+      virtual R gamma () const override
+      {
+        return g;
+      }
+
+      virtual R a (int i, int j) const override
+      {
+        return A[i-1][j-1];
+      }
+
+      virtual R c (int i, int j) const override
+      {
+        return C[i-1][j-1];
+      }
+
+      virtual R m (int i) const override
+      {
+        return M[i-1];
+      }
+
+      virtual R alpha (int i) const override
+      {
+        return Alpha[i-1];
+      }
+
+      virtual R gammaSum (int i) const override
+      {
+        return GammaSum[i-1];
+      }
+
+      virtual std::string name () const override
+      {
+        return std::string("Rosenbrock ROS2");
+      }
+
+    private:
+      R g;
+      Dune::FieldMatrix<R,2,2> A;
+      Dune::FieldMatrix<R,2,2> C;
+      Dune::FieldVector<R,2> M;
+      Dune::FieldVector<R,2> Alpha;
+      Dune::FieldVector<R,2> GammaSum;
+    };
+
+    /**
+     * \brief Parameters of the third order Rosenbrock method ROS3P of Lang and Verwer
+     *
+     * The method does not suffer from order reduction for parabolic problems.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class ROS3PParameter : public RosenbrockParameterInterface<R>
+    {
+    public:
+
+      ROS3PParameter ()
+      {
+        g = 7.886751345948129e-01;
+
+        A = 0.0;
+        C = 0.0;
+        A[1][0] = 1.267949192431123;
+        A[2][0] = 1.267949192431123;
+        C[1][0] = -1.607695154586736;
+        C[2][0] = -3.464101615137755; C[2][1] = -1.732050807568877;
+        M[0] = 2.0; M[1] = 5.773502691896258e-01; M[2] = 4.226497308103742e-01;
+        Alpha[0] = 0.0; Alpha[1] = 1.0; Alpha[2] = 1.0;
+        GammaSum[0] = 7.886751345948129e-01; GammaSum[1] = -2.113248654051871e-01;
+        GammaSum[2] = -1.077350269189626;
+      }
+
+      virtual unsigned s () const override
+      {
+        return 3;
+      }
+
+      virtual R gamma () const override
+      {
+        return g;
+      }
+
+      virtual R a (int i, int j) const override
+      {
+        return A[i-1][j-1];
+      }
+
+      virtual R c (int i, int j) const override
+      {
+        return C[i-1][j-1];
+      }
+
+      virtual R m (int i) const override
+      {
+        return M[i-1];
+      }
+
+      virtual R alpha (int i) const override
+      {
+        return Alpha[i-1];
+      }
+
+      virtual R gammaSum (int i) const override
+      {
+        return GammaSum[i-1];
+      }
+
+      virtual std::string name () const override
+      {
+        return std::string("Rosenbrock ROS3P");
+      }
+
+    private:
+      R g;
+      Dune::FieldMatrix<R,3,3> A;
+      Dune::FieldMatrix<R,3,3> C;
+      Dune::FieldVector<R,3> M;
+      Dune::FieldVector<R,3> Alpha;
+      Dune::FieldVector<R,3> GammaSum;
+    };
+
+    /**
+     * \brief Parameters of the fourth order, stiffly accurate Rosenbrock method RODASP of Steinebach
+     *
+     * RODASP modifies the coefficients of RODAS of Hairer and Wanner to avoid order reduction
+     * for parabolic problems.
+     *
+     * \tparam R C++ type of the floating point parameters
+     */
+    template<class R>
+    class RODASPParameter : public RosenbrockParameterInterface<R>
+    {
+    public:
+
+      RODASPParameter ()
+      {
+        g = 0.25;
+
+        A = 0.0;
+        C = 0.0;
+        A[1][0] = 3.0;
+        A[2][0] = 1.831036793486759;   A[2][1] = 0.4955183967433795;
+        A[3][0] = 2.304376582692669;   A[3][1] = -0.05249275245743001; A[3][2] = -1.176798761832782;
+        A[4][0] = -7.170454962423024;  A[4][1] = -4.741636671481785;   A[4][2] = -16.31002631330971;
+        A[4][3] = -1.062004044111401;
+        A[5][0] = A[4][0]; A[5][1] = A[4][1]; A[5][2] = A[4][2]; A[5][3] = A[4][3]; A[5][4] = 1.0;
+
+        C[1][0] = -12.0;
+        C[2][0] = -8.791795173947035;  C[2][1] = -2.207865586973518;
+        C[3][0] = 10.81793056857153;   C[3][1] = 6.780270611428266;    C[3][2] = 19.53485944642410;
+        C[4][0] = 34.19095006749676;   C[4][1] = 15.49671153725963;    C[4][2] = 54.74760875964130;
+        C[4][3] = 14.16005392148534;
+        C[5][0] = 34.62605830930532;   C[5][1] = 15.30084976114473;    C[5][2] = 56.99955578662667;
+        C[5][3] = 18.40807009793095;   C[5][4] = -5.714285714285717;
+
+        M[0] = A[4][0]; M[1] = A[4][1]; M[2] = A[4][2]; M[3] = A[4][3]; M[4] = 1.0; M[5] = 1.0;
+        Alpha[0] = 0.0; Alpha[1] = 0.75; Alpha[2] = 0.21; Alpha[3] = 0.63; Alpha[4] = 1.0; Alpha[5] = 1.0;
+        GammaSum[0] = 0.25; GammaSum[1] = -0.5; GammaSum[2] = -0.023504; GammaSum[3] = -0.0362;
+        GammaSum[4] = 0.0; GammaSum[5] = 0.0;
+      }
+
+      virtual unsigned s () const override
+      {
+        return 6;
+      }
+
+      virtual R gamma () const override
+      {
+        return g;
+      }
+
+      virtual R a (int i, int j) const override
+      {
+        return A[i-1][j-1];
+      }
+
+      virtual R c (int i, int j) const override
+      {
+        return C[i-1][j-1];
+      }
+
+      virtual R m (int i) const override
+      {
+        return M[i-1];
+      }
+
+      virtual R alpha (int i) const override
+      {
+        return Alpha[i-1];
+      }
+
+      virtual R gammaSum (int i) const override
+      {
+        return GammaSum[i-1];
+      }
+
+      virtual std::string name () const override
+      {
+        return std::string("Rosenbrock RODASP");
+      }
+
+    private:
+      R g;
+      Dune::FieldMatrix<R,6,6> A;
+      Dune::FieldMatrix<R,6,6> C;
+      Dune::FieldVector<R,6> M;
+      Dune::FieldVector<R,6> Alpha;
+      Dune::FieldVector<R,6> GammaSum;
+    };
+
   } // end namespace PDELab
 } // end namespace Dune
 #endif // DUNE_PDELAB_INSTATIONARY_ONESTEPPARAMETER_HH
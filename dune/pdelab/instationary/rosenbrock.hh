@@ -0,0 +1,373 @@
+// -*- tab-width: 2; indent-tabs-mode: nil -*-
+// vi: set et ts=2 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_INSTATIONARY_ROSENBROCK_HH
+#define DUNE_PDELAB_INSTATIONARY_ROSENBROCK_HH
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/ios_state.hh>
+#include <dune/pdelab/instationary/implicitonestep.hh>
+#include <dune/pdelab/instationary/onestepparameter.hh>
+#include <dune/pdelab/instationary/vectorpool.hh>
+#include <dune/pdelab/solver/newton.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    /**
+     *  @addtogroup OneStepMethod
+     *  @{
+     */
+
+    namespace Impl {
+
+      // A single stage M (u - z) + beta dt r(u;t+delta dt) = 0, in terms of which the
+      // OneStepGridOperator assembles the matrix and the residuals of Rosenbrock methods
+      template<class R>
+      class RosenbrockStageParameter : public TimeSteppingParameterInterface<R>
+      {
+      public:
+
+        RosenbrockStageParameter ()
+          : beta(1.0), delta(0.0)
+        {}
+
+        void set (R beta_, R delta_)
+        {
+          beta = beta_;
+          delta = delta_;
+        }
+
+        virtual bool implicit () const override
+        {
+          return true;
+        }
+
+        virtual unsigned s () const override
+        {
+          return 1;
+        }
+
+        virtual R a (int r, int i) const override
+        {
+          return i == 0 ? -1.0 : 1.0;
+        }
+
+        virtual R b (int r, int i) const override
+        {
+          return i == 0 ? 0.0 : beta;
+        }
+
+        virtual R d (int i) const override
+        {
+          return i == 0 ? 0.0 : delta;
+        }
+
+        virtual std::string name () const override
+        {
+          return std::string("Rosenbrock stage");
+        }
+
+      private:
+        R beta, delta;
+      };
+
+      template<typename LS>
+      void setRosenbrockReuse (LS& ls, bool reuse, std::true_type)
+      {
+        ls.setReuse(reuse);
+      }
+
+      template<typename LS>
+      void setRosenbrockReuse (LS& ls, bool reuse, std::false_type)
+      {}
+
+    } // end namespace Impl
+
+    //! Do one step of a Rosenbrock method
+    /**
+     * The matrix \f$ M + \gamma\Delta t J \f$ is assembled by the instationary grid operator
+     * once per step at the old solution, and every stage is a single linear solve with it, see
+     * RosenbrockParameterInterface. Compared to OneStepMethod with Newton's method in every
+     * stage, this saves the Jacobian assemblies and most residual evaluations. Linear solver
+     * backends providing setReuse() keep their preconditioner, e.g. the AMG hierarchy, from the
+     * first stage for all further stages of the step.
+     *
+     * The time derivative of the residual is approximated by a finite difference, which costs one
+     * more residual evaluation per step. It can be switched off for autonomous problems.
+     *
+     * The mass term must be linear and independent of time. Constrained DOFs keep the values of
+     * the old solution.
+     *
+     * \tparam T    type to represent time values
+     * \tparam IGOS assembler for instationary problems
+     * \tparam LS   linear solver backend
+     * \tparam TrlV vector type to represent coefficients of solutions
+     * \tparam TstV vector type to represent residuals
+     */
+    template<class T, class IGOS, class LS, class TrlV, class TstV = TrlV>
+    class RosenbrockOneStepMethod
+    {
+      typedef typename IGOS::Traits::Jacobian M;
+
+    public:
+      typedef OneStepMethodResult Result;
+
+      //! construct a new Rosenbrock one step scheme
+      /**
+       * \param method_    Parameter object. This chooses the actual method
+       *                   used.
+       * \param igos_      Assembler object (instationary grid operator space).
+       * \param ls_        Linear solver backend.
+       *
+       * The contructed method object stores references to the object it is
+       * constructed with, so these objects should be valid for as long as the
+       * constructed object is used.
+       */
+      RosenbrockOneStepMethod(const RosenbrockParameterInterface<T>& method_, IGOS& igos_, LS& ls_)
+        : method(&method_), igos(igos_), ls(ls_), verbosityLevel(1), step(1), res(),
+          linear_reduction(1e-10), time_derivative(true)
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+      }
+
+      //! change verbosity level; 0 means completely quiet
+      void setVerbosityLevel (int level)
+      {
+        if (igos.trialGridFunctionSpace().gridView().comm().rank()>0)
+          verbosityLevel = 0;
+        else
+          verbosityLevel = level;
+      }
+
+      //! change number of current step
+      void setStepNumber(int newstep) { step = newstep; }
+
+      //! redefine the method to be used; can be done before every step
+      void setMethod (const RosenbrockParameterInterface<T>& method_)
+      {
+        method = &method_;
+      }
+
+      //! set the reduction of the linear solver in every stage
+      void setLinearReduction (T reduction)
+      {
+        linear_reduction = reduction;
+      }
+
+      //! include the time derivative of the residual, which is only zero for autonomous problems
+      void setTimeDerivative (bool enable)
+      {
+        time_derivative = enable;
+      }
+
+      const Result& result() const
+      {
+        return res;
+      }
+
+      //! Frees the matrix and the stage vectors kept between the steps, e.g. after the grid changed.
+      void clearVectors ()
+      {
+        matrix.reset();
+        stage_vectors.clear();
+        residual_vectors.clear();
+      }
+
+      /*! \brief do one step;
+       * \param[in]  time start of time step
+       * \param[in]  dt time step size
+       * \param[in]  xold value at begin of time step
+       * \param[out] xnew value at end of time step
+       * \return time step size
+       */
+      T apply (T time, T dt, TrlV& xold, TrlV& xnew)
+      {
+        // save formatting attributes
+        ios_base_all_saver format_attribute_saver(std::cout);
+
+        using Clock = std::chrono::steady_clock;
+        auto to_seconds = [](Clock::duration duration){
+          return std::chrono::duration<double>(duration).count();
+        };
+        OneStepMethodPartialResult step_result;
+
+        if (verbosityLevel>=1){
+          std::ios_base::fmtflags oldflags = std::cout.flags();
+          std::cout << "TIME STEP [" << method->name() << "] "
+                    << std::setw(6) << step
+                    << " time (from): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time
+                    << " dt: "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << dt
+                    << " time (to): "
+                    << std::setw(12) << std::setprecision(4) << std::scientific
+                    << time+dt
+                    << std::endl;
+          std::cout.flags(oldflags);
+        }
+
+        const auto& gfsu = igos.trialGridFunctionSpace();
+        const auto& gfsv = igos.testGridFunctionSpace();
+        const T gamma = method->gamma();
+        std::vector<TrlV*> z(1);
+
+        // the matrix M + gamma dt J at the old solution
+        auto start = Clock::now();
+        igos.preStep(stage_parameter,time,dt);
+        if (not matrix)
+          matrix = std::make_unique<M>(igos);
+        *matrix = 0.0;
+        stage_parameter.set(gamma,0.0);
+        z[0] = &xold;
+        igos.preStage(1,z);
+        igos.jacobian(xold,*matrix);
+
+        // finite difference of the residual in time, completed in the first stage
+        using std::abs;
+        using std::max;
+        using std::sqrt;
+        const T delta = sqrt(std::numeric_limits<T>::epsilon()) * max(abs(time),dt);
+        TstV& residual_dt = residual_vectors.get(1,gfsv);
+        if (time_derivative)
+          {
+            stage_parameter.set(gamma,delta/dt);
+            residual_dt = 0.0;
+            igos.residual(xold,residual_dt);
+            stage_parameter.set(gamma,0.0);
+          }
+        step_result.assembler_time += to_seconds(Clock::now()-start);
+
+        TstV& residual = residual_vectors.get(0,gfsv);
+        TrlV& y = stage_vectors.get(0,gfsu);
+        TrlV& shift = stage_vectors.get(1,gfsu);
+        for (unsigned i=1; i<=method->s(); ++i)
+          {
+            if (verbosityLevel>=2){
+              std::ios_base::fmtflags oldflags = std::cout.flags();
+              std::cout << "STAGE "
+                        << i
+                        << " time (to): "
+                        << std::setw(12) << std::setprecision(4) << std::scientific
+                        << time+method->alpha(i)*dt
+                        << "." << std::endl;
+              std::cout.flags(oldflags);
+            }
+
+            // stage value Y_i and the shift Y_i + gamma sum_j c_ij U_j of the mass term
+            start = Clock::now();
+            TrlV& u = stage_vectors.get(i+1,gfsu);
+            y = xold;
+            shift = xold;
+            for (unsigned j=1; j<i; ++j)
+              {
+                const TrlV& uj = stage_vectors.get(j+1,gfsu);
+                y.axpy(method->a(i,j),uj);
+                shift.axpy(method->a(i,j) + gamma*method->c(i,j),uj);
+              }
+
+            // right hand side, scaled by gamma dt like the matrix
+            stage_parameter.set(gamma,method->alpha(i));
+            if (i>1)
+              {
+                z[0] = &shift;
+                igos.preStage(1,z);
+              }
+            residual = 0.0;
+            igos.residual(y,residual);
+            if (time_derivative)
+              {
+                if (i==1)
+                  residual_dt -= residual;
+                if (abs(method->gammaSum(i)) > 0.0)
+                  residual.axpy(method->gammaSum(i)*dt/delta,residual_dt);
+              }
+            residual *= -1.0;
+            step_result.assembler_time += to_seconds(Clock::now()-start);
+
+            // solve with the matrix of the step
+            start = Clock::now();
+            Impl::setRosenbrockReuse(ls,i>1,Impl::HasSetReuse<LS>());
+            u = 0.0;
+            ls.apply(*matrix,u,residual,linear_reduction);
+            step_result.linear_solver_time += to_seconds(Clock::now()-start);
+            step_result.linear_solver_iterations += ls.result().iterations;
+            if (not ls.result().converged)
+              {
+                res.total.assembler_time += step_result.assembler_time;
+                res.total.linear_solver_time += step_result.linear_solver_time;
+                res.total.linear_solver_iterations += step_result.linear_solver_iterations;
+                res.total.timesteps += 1;
+                DUNE_THROW(MathError,"RosenbrockOneStepMethod: linear solver did not converge in stage " << i);
+              }
+
+            igos.postStage();
+          }
+
+        // new solution, xold is not needed anymore and may be the same vector
+        xnew = xold;
+        for (unsigned i=1; i<=method->s(); ++i)
+          xnew.axpy(method->m(i),stage_vectors.get(i+1,gfsu));
+
+        // step cleanup
+        igos.postStep();
+
+        // update statistics
+        res.total.assembler_time += step_result.assembler_time;
+        res.total.linear_solver_time += step_result.linear_solver_time;
+        res.total.linear_solver_iterations += step_result.linear_solver_iterations;
+        res.total.timesteps += 1;
+        res.successful.assembler_time += step_result.assembler_time;
+        res.successful.linear_solver_time += step_result.linear_solver_time;
+        res.successful.linear_solver_iterations += step_result.linear_solver_iterations;
+        res.successful.timesteps += 1;
+        if (verbosityLevel>=1){
+          std::ios_base::fmtflags oldflags = std::cout.flags();
+          std::cout << "::: timesteps      " << std::setw(6) << res.successful.timesteps
+                    << " (" << res.total.timesteps << ")" << std::endl;
+          std::cout << "::: lin iterations " << std::setw(6) << res.successful.linear_solver_iterations
+                    << " (" << res.total.linear_solver_iterations << ")" << std::endl;
+          std::cout << "::: assemble time  " << std::setw(12) << std::setprecision(4) << std::scientific
+                    << res.successful.assembler_time << " (" << res.total.assembler_time << ")" << std::endl;
+          std::cout << "::: lin solve time " << std::setw(12) << std::setprecision(4) << std::scientific
+                    << res.successful.linear_solver_time << " (" << res.total.linear_solver_time << ")" << std::endl;
+          std::cout.flags(oldflags);
+        }
+
+        step++;
+        return dt;
+      }
+
+    private:
+      const RosenbrockParameterInterface<T> *method;
+      IGOS& igos;
+      LS& ls;
+      int verbosityLevel;
+      int step;
+      Result res;
+      T linear_reduction;
+      bool time_derivative;
+      Impl::RosenbrockStageParameter<T> stage_parameter;
+      std::unique_ptr<M> matrix;
+      VectorPool<TrlV> stage_vectors;
+      VectorPool<TstV> residual_vectors;
+    };
+
+    /** @} */
+  } // end namespace PDELab
+} // end namespace Dune
+#endif // DUNE_PDELAB_INSTATIONARY_ROSENBROCK_HH
@@ -0,0 +1,64 @@
+// -*- tab-width: 2; indent-tabs-mode: nil -*-
+// vi: set et ts=2 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_INSTATIONARY_VECTORPOOL_HH
+#define DUNE_PDELAB_INSTATIONARY_VECTORPOOL_HH
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Dune {
+  namespace PDELab {
+
+    /**
+     *  @addtogroup OneStepMethod
+     *  @{
+     */
+
+    //! Keeps the temporary vectors of a time stepping scheme alive between time steps
+    /**
+     * The vectors are allocated on first use and reused afterwards, so time stepping
+     * schemes do not allocate and free their stage vectors in every step. A vector is
+     * reallocated if its size does not match its grid function space anymore, e.g.
+     * after the grid was adapted. The contents of a vector returned by get() are
+     * unspecified.
+     *
+     * \tparam V The vector type
+     */
+    template<typename V>
+    class VectorPool
+    {
+    public:
+
+      //! Returns the vector with the given index, allocating it for gfs if necessary.
+      template<typename GFS>
+      V& get (std::size_t i, const GFS& gfs)
+      {
+        if (i >= _vectors.size())
+          _vectors.resize(i+1);
+        if (!_vectors[i] || _vectors[i]->flatsize() != gfs.globalSize())
+          _vectors[i] = std::make_unique<V>(gfs);
+        return *_vectors[i];
+      }
+
+      //! Returns the number of vector slots of the pool.
+      std::size_t size () const
+      {
+        return _vectors.size();
+      }
+
+      //! Frees all vectors.
+      void clear ()
+      {
+        _vectors.clear();
+      }
+
+    private:
+      std::vector<std::unique_ptr<V>> _vectors;
+    };
+
+    /** @} */
+  } // end namespace PDELab
+} // end namespace Dune
+#endif // DUNE_PDELAB_INSTATIONARY_VECTORPOOL_HH
@@ -0,0 +1,235 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+#ifndef DUNE_PDELAB_LOCALOPERATOR_ADJACOBIAN_HH
+#define DUNE_PDELAB_LOCALOPERATOR_ADJACOBIAN_HH
+
+#include <cstddef>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/pdelab/common/dualnumber.hh>
+#include <dune/pdelab/gridfunctionspace/localvector.hh>
+#include <dune/pdelab/gridoperator/common/localmatrix.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup LocalOperatorDefaultImp
+    //! \ingroup LocalOperator
+    //! \{
+
+    ////////////////////////////////////////////////////////////////////////
+    //
+    //  Implementation of jacobian_*() in terms of alpha_*() by forward-mode
+    //  automatic differentiation
+    //
+
+    namespace Impl {
+
+      //! Copies the local coefficients x into a vector of dual numbers, seeding the coefficients of lfsu starting at offset.
+      template<typename Dual, typename LFSU, typename X>
+      LocalVector<Dual,TrialSpaceTag> seedCoefficients (const LFSU& lfsu, const X& x, std::size_t offset)
+      {
+        if (offset + lfsu.size() > Dual::size)
+          DUNE_THROW(Dune::RangeError,"The local function spaces have " << offset + lfsu.size()
+                     << " degrees of freedom, but the dual numbers of the AD jacobian only carry "
+                     << Dual::size << " derivatives");
+
+        LocalVector<Dual,TrialSpaceTag> u(x.size());
+        for (std::size_t k = 0; k < x.size(); ++k)
+          u.base()[k] = x.base()[k];
+        for (std::size_t j = 0; j < lfsu.size(); ++j)
+          u(lfsu,j) = Dual::seed(x(lfsu,j),offset+j);
+        return u;
+      }
+
+      //! Accumulates the derivatives of the residual r of lfsv with respect to the coefficients of lfsu starting at offset.
+      template<typename LFSV, typename R, typename LFSU, typename Jacobian>
+      void accumulateDerivatives (const LFSV& lfsv, const R& r, const LFSU& lfsu, std::size_t offset, Jacobian& mat)
+      {
+        for (std::size_t i = 0; i < lfsv.size(); ++i)
+          {
+            const auto& ri = r(lfsv,i);
+            for (std::size_t j = 0; j < lfsu.size(); ++j)
+              mat.rawAccumulate(lfsv,i,lfsu,j,ri.derivative(offset+j));
+          }
+      }
+
+    } // namespace Impl
+
+    //! Implement jacobian_volume() based on alpha_volume() by automatic differentiation
+    /**
+     * Derive from this class to add an exact jacobian for the volume term, computed by a
+     * single evaluation of alpha_volume() with DualNumber coefficients. In contrast to
+     * NumericalJacobianVolume, which evaluates alpha_volume() once per local degree of freedom
+     * and suffers from truncation errors, the result is exact up to rounding.
+     *
+     * The derived class needs to implement alpha_volume() generically in the value type of the
+     * coefficients and the residual, i.e. all quantities depending on the coefficients have to
+     * be of type `typename X::value_type` (or be deduced with `auto`), and elementary functions
+     * have to be called unqualified.
+     *
+     * \tparam Imp Type of the derived class (CRTP-trick).
+     * \tparam N   The number of derivatives carried along, at least the number of local degrees
+     *             of freedom of the trial space.
+     */
+    template<typename Imp, std::size_t N>
+    class ADJacobianVolume
+    {
+    public:
+
+      //! compute local jacobian of the volume term
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_volume
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        Jacobian& mat) const
+      {
+        typedef DualNumber<typename Jacobian::value_type,N> Dual;
+        typedef LocalVector<Dual,TestSpaceTag,typename Jacobian::weight_type> ResidualVector;
+
+        auto u = Impl::seedCoefficients<Dual>(lfsu,x,0);
+
+        // Notice that in general lfsv.size() != mat.nrows()
+        ResidualVector r(mat.nrows(),Dual(0.0));
+        auto rview = r.weightedAccumulationView(mat.weight());
+        asImp().alpha_volume(eg,lfsu,u,lfsv,rview);
+
+        Impl::accumulateDerivatives(lfsv,r,lfsu,0,mat);
+      }
+
+    private:
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
+    //! Implement jacobian_volume_post_skeleton() based on alpha_volume_post_skeleton() by automatic differentiation
+    /**
+     * See ADJacobianVolume for the requirements on alpha_volume_post_skeleton().
+     *
+     * \tparam Imp Type of the derived class (CRTP-trick).
+     * \tparam N   The number of derivatives carried along, at least the number of local degrees
+     *             of freedom of the trial space.
+     */
+    template<typename Imp, std::size_t N>
+    class ADJacobianVolumePostSkeleton
+    {
+    public:
+
+      //! compute local post-skeleton jacobian of the volume term
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_volume_post_skeleton
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        Jacobian& mat) const
+      {
+        typedef DualNumber<typename Jacobian::value_type,N> Dual;
+        typedef LocalVector<Dual,TestSpaceTag,typename Jacobian::weight_type> ResidualVector;
+
+        auto u = Impl::seedCoefficients<Dual>(lfsu,x,0);
+
+        // Notice that in general lfsv.size() != mat.nrows()
+        ResidualVector r(mat.nrows(),Dual(0.0));
+        auto rview = r.weightedAccumulationView(mat.weight());
+        asImp().alpha_volume_post_skeleton(eg,lfsu,u,lfsv,rview);
+
+        Impl::accumulateDerivatives(lfsv,r,lfsu,0,mat);
+      }
+
+    private:
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
+    //! Implement jacobian_skeleton() based on alpha_skeleton() by automatic differentiation
+    /**
+     * The coefficients of both cells are differentiated in a single evaluation of
+     * alpha_skeleton(), see ADJacobianVolume for its requirements.
+     *
+     * \tparam Imp Type of the derived class (CRTP-trick).
+     * \tparam N   The number of derivatives carried along, at least the sum of the numbers of
+     *             local degrees of freedom of the trial space in the inside and the outside cell.
+     */
+    template<typename Imp, std::size_t N>
+    class ADJacobianSkeleton
+    {
+    public:
+
+      //! compute local jacobian of the skeleton term
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_skeleton
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+        Jacobian& mat_ss, Jacobian& mat_sn,
+        Jacobian& mat_ns, Jacobian& mat_nn) const
+      {
+        typedef DualNumber<typename Jacobian::value_type,N> Dual;
+        typedef LocalVector<Dual,TestSpaceTag,typename Jacobian::weight_type> ResidualVector;
+
+        // the derivatives with respect to the outside coefficients follow the inside ones
+        const std::size_t n_s = lfsu_s.size();
+        auto u_s = Impl::seedCoefficients<Dual>(lfsu_s,x_s,0);
+        auto u_n = Impl::seedCoefficients<Dual>(lfsu_n,x_n,n_s);
+
+        // Notice that in general lfsv.size() != mat.nrows()
+        ResidualVector r_s(mat_ss.nrows(),Dual(0.0));
+        ResidualVector r_n(mat_nn.nrows(),Dual(0.0));
+        auto rview_s = r_s.weightedAccumulationView(mat_ss.weight());
+        auto rview_n = r_n.weightedAccumulationView(mat_nn.weight());
+        asImp().alpha_skeleton(ig,lfsu_s,u_s,lfsv_s,lfsu_n,u_n,lfsv_n,rview_s,rview_n);
+
+        Impl::accumulateDerivatives(lfsv_s,r_s,lfsu_s,0,mat_ss);
+        Impl::accumulateDerivatives(lfsv_s,r_s,lfsu_n,n_s,mat_sn);
+        Impl::accumulateDerivatives(lfsv_n,r_n,lfsu_s,0,mat_ns);
+        Impl::accumulateDerivatives(lfsv_n,r_n,lfsu_n,n_s,mat_nn);
+      }
+
+    private:
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
+    //! Implement jacobian_boundary() based on alpha_boundary() by automatic differentiation
+    /**
+     * See ADJacobianVolume for the requirements on alpha_boundary().
+     *
+     * \tparam Imp Type of the derived class (CRTP-trick).
+     * \tparam N   The number of derivatives carried along, at least the number of local degrees
+     *             of freedom of the trial space.
+     */
+    template<typename Imp, std::size_t N>
+    class ADJacobianBoundary
+    {
+    public:
+
+      //! compute local jacobian of the boundary term
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_boundary
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        Jacobian& mat_ss) const
+      {
+        typedef DualNumber<typename Jacobian::value_type,N> Dual;
+        typedef LocalVector<Dual,TestSpaceTag,typename Jacobian::weight_type> ResidualVector;
+
+        auto u_s = Impl::seedCoefficients<Dual>(lfsu_s,x_s,0);
+
+        // Notice that in general lfsv.size() != mat.nrows()
+        ResidualVector r_s(mat_ss.nrows(),Dual(0.0));
+        auto rview_s = r_s.weightedAccumulationView(mat_ss.weight());
+        asImp().alpha_boundary(ig,lfsu_s,u_s,lfsv_s,rview_s);
+
+        Impl::accumulateDerivatives(lfsv_s,r_s,lfsu_s,0,mat_ss);
+      }
+
+    private:
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
+    //! \} group LocalOperatorDefaultImp
+  }
+}
+
+#endif // DUNE_PDELAB_LOCALOPERATOR_ADJACOBIAN_HH
@@ -0,0 +1,340 @@
+// -*- tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=8 sw=2 sts=2:
+#ifndef DUNE_PDELAB_LOCALOPERATOR_BATCHEDNUMERICALJACOBIAN_HH
+#define DUNE_PDELAB_LOCALOPERATOR_BATCHEDNUMERICALJACOBIAN_HH
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <dune/pdelab/common/perturbationbatch.hh>
+#include <dune/pdelab/gridfunctionspace/localvector.hh>
+#include <dune/pdelab/gridoperator/common/localmatrix.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup LocalOperatorDefaultImp
+    //! \ingroup LocalOperator
+    //! \{
+
+    ////////////////////////////////////////////////////////////////////////
+    //
+    //  Numerical implementation of jacobian_*() in terms of alpha_*(),
+    //  evaluating a batch of perturbations in each call
+    //
+
+    namespace Impl {
+
+      //! The local coefficients of a single cell for the batched evaluation of alpha_*().
+      template<typename Batch, typename LFSU, typename X>
+      class BatchedCoefficients
+      {
+      public:
+        typedef typename Batch::value_type T;
+
+        BatchedCoefficients (const LFSU& lfsu, const X& x, double epsilon)
+          : _lfsu(lfsu)
+          , _x(x)
+          , _u(x.size())
+          , _delta(lfsu.size())
+        {
+          using std::abs;
+          for (std::size_t k = 0; k < x.size(); ++k)
+            _u.base()[k] = Batch(x.base()[k]);
+          for (std::size_t j = 0; j < lfsu.size(); ++j)
+            _delta[j] = epsilon*(1.0+abs(x(lfsu,j)));
+        }
+
+        //! Perturbs coefficient j in the given lane.
+        void perturb (std::size_t j, std::size_t lane)
+        {
+          _u(_lfsu,j).lane(lane) += _delta[j];
+        }
+
+        //! Removes the perturbation of coefficient j.
+        void reset (std::size_t j)
+        {
+          _u(_lfsu,j) = Batch(_x(_lfsu,j));
+        }
+
+        //! The perturbation of coefficient j.
+        T delta (std::size_t j) const
+        {
+          return _delta[j];
+        }
+
+        const LocalVector<Batch,TrialSpaceTag>& coefficients () const
+        {
+          return _u;
+        }
+
+      private:
+        const LFSU& _lfsu;
+        const X& _x;
+        LocalVector<Batch,TrialSpaceTag> _u;
+        std::vector<T> _delta;
+      };
+
+      //! Accumulates the difference quotients of the residual r of lfsv in the given lane as column j of mat.
+      template<typename LFSV, typename R, typename LFSU, typename Jacobian, typename T>
+      void accumulateDifferenceQuotients (const LFSV& lfsv, const R& r, const LFSU& lfsu, std::size_t j,
+                                          std::size_t lane, T delta, Jacobian& mat)
+      {
+        for (std::size_t i = 0; i < lfsv.size(); ++i)
+          mat.rawAccumulate(lfsv,i,lfsu,j,(r(lfsv,i).lane(lane)-r(lfsv,i).lane(0))/delta);
+      }
+
+      //! Computes a local jacobian by batched evaluations of a residual method on a single cell.
+      template<std::size_t L, typename LFSU, typename X, typename LFSV, typename Jacobian, typename Alpha>
+      void batchedNumericalJacobian (const LFSU& lfsu, const X& x, const LFSV& lfsv, Jacobian& mat,
+                                     double epsilon, Alpha&& alpha)
+      {
+        typedef PerturbationBatch<typename Jacobian::value_type,L> Batch;
+        typedef LocalVector<Batch,TestSpaceTag,typename Jacobian::weight_type> ResidualVector;
+
+        const std::size_t n = lfsu.size();
+        BatchedCoefficients<Batch,LFSU,X> u(lfsu,x,epsilon);
+
+        // Notice that in general lfsv.size() != mat.nrows()
+        ResidualVector r(mat.nrows());
+        auto rview = r.weightedAccumulationView(mat.weight());
+
+        // lane 0 holds the unperturbed residual, each other lane one column
+        for (std::size_t first = 0; first < n; first += L-1)
+          {
+            const std::size_t last = std::min(first+L-1,n);
+            for (std::size_t j = first; j < last; ++j)
+              u.perturb(j,j-first+1);
+            r = Batch(0.0);
+            alpha(u.coefficients(),rview);
+            for (std::size_t j = first; j < last; ++j)
+              {
+                accumulateDifferenceQuotients(lfsv,r,lfsu,j,j-first+1,u.delta(j),mat);
+                u.reset(j);
+              }
+          }
+      }
+
+    } // namespace Impl
+
+    //! Implement jacobian_volume() based on alpha_volume(), evaluating a batch of perturbations at once
+    /**
+     * Derive from this class to add a numerical jacobian for the volume term that evaluates
+     * alpha_volume() with PerturbationBatch coefficients. Each evaluation yields the unperturbed
+     * residual and L-1 columns of the jacobian, so a cell with n local degrees of freedom needs
+     * ceil(n/(L-1)) evaluations instead of the n+1 evaluations of NumericalJacobianVolume, and
+     * the arithmetic of each evaluation is vectorized over the lanes.
+     *
+     * The derived class needs to implement alpha_volume() generically in the value type of the
+     * coefficients and the residual, i.e. all quantities depending on the coefficients have to
+     * be of type `typename X::value_type` (or be deduced with `auto`), and elementary functions
+     * have to be called unqualified. Branches are taken as for the unperturbed coefficients.
+     *
+     * \tparam Imp Type of the derived class (CRTP-trick).
+     * \tparam L   The number of lanes of each batch, including the unperturbed one.
+     */
+    template<typename Imp, std::size_t L = 8>
+    class BatchedNumericalJacobianVolume
+    {
+      static_assert(L > 1, "A batch needs at least one perturbed lane");
+
+    public:
+      BatchedNumericalJacobianVolume ()
+        : epsilon(1e-7)
+      {}
+
+      BatchedNumericalJacobianVolume (double epsilon_)
+        : epsilon(epsilon_)
+      {}
+
+      //! compute local jacobian of the volume term
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_volume
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        Jacobian& mat) const
+      {
+        Impl::batchedNumericalJacobian<L>(lfsu,x,lfsv,mat,epsilon,[&](const auto& u, auto& r)
+          {
+            asImp().alpha_volume(eg,lfsu,u,lfsv,r);
+          });
+      }
+
+    private:
+      const double epsilon;
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
+    //! Implement jacobian_volume_post_skeleton() based on alpha_volume_post_skeleton(), evaluating a batch of perturbations at once
+    /**
+     * See BatchedNumericalJacobianVolume for the requirements on alpha_volume_post_skeleton().
+     *
+     * \tparam Imp Type of the derived class (CRTP-trick).
+     * \tparam L   The number of lanes of each batch, including the unperturbed one.
+     */
+    template<typename Imp, std::size_t L = 8>
+    class BatchedNumericalJacobianVolumePostSkeleton
+    {
+      static_assert(L > 1, "A batch needs at least one perturbed lane");
+
+    public:
+      BatchedNumericalJacobianVolumePostSkeleton ()
+        : epsilon(1e-7)
+      {}
+
+      BatchedNumericalJacobianVolumePostSkeleton (double epsilon_)
+        : epsilon(epsilon_)
+      {}
+
+      //! compute local post-skeleton jacobian of the volume term
+      template<typename EG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_volume_post_skeleton
+      ( const EG& eg,
+        const LFSU& lfsu, const X& x, const LFSV& lfsv,
+        Jacobian& mat) const
+      {
+        Impl::batchedNumericalJacobian<L>(lfsu,x,lfsv,mat,epsilon,[&](const auto& u, auto& r)
+          {
+            asImp().alpha_volume_post_skeleton(eg,lfsu,u,lfsv,r);
+          });
+      }
+
+    private:
+      const double epsilon;
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
+    //! Implement jacobian_skeleton() based on alpha_skeleton(), evaluating a batch of perturbations at once
+    /**
+     * The columns of the inside and the outside coefficients are numbered consecutively and
+     * share the lanes of each evaluation, so a face with n_s inside and n_n outside degrees of
+     * freedom needs ceil((n_s+n_n)/(L-1)) evaluations of alpha_skeleton(). See
+     * BatchedNumericalJacobianVolume for its requirements.
+     *
+     * \tparam Imp Type of the derived class (CRTP-trick).
+     * \tparam L   The number of lanes of each batch, including the unperturbed one.
+     */
+    template<typename Imp, std::size_t L = 8>
+    class BatchedNumericalJacobianSkeleton
+    {
+      static_assert(L > 1, "A batch needs at least one perturbed lane");
+
+    public:
+      BatchedNumericalJacobianSkeleton ()
+        : epsilon(1e-7)
+      {}
+
+      BatchedNumericalJacobianSkeleton (double epsilon_)
+        : epsilon(epsilon_)
+      {}
+
+      //! compute local jacobian of the skeleton term
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_skeleton
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+        Jacobian& mat_ss, Jacobian& mat_sn,
+        Jacobian& mat_ns, Jacobian& mat_nn) const
+      {
+        typedef PerturbationBatch<typename Jacobian::value_type,L> Batch;
+        typedef LocalVector<Batch,TestSpaceTag,typename Jacobian::weight_type> ResidualVector;
+
+        const std::size_t n_s = lfsu_s.size();
+        const std::size_t n = n_s + lfsu_n.size();
+        Impl::BatchedCoefficients<Batch,LFSU,X> u_s(lfsu_s,x_s,epsilon);
+        Impl::BatchedCoefficients<Batch,LFSU,X> u_n(lfsu_n,x_n,epsilon);
+
+        // Notice that in general lfsv.size() != mat.nrows()
+        ResidualVector r_s(mat_ss.nrows());
+        ResidualVector r_n(mat_nn.nrows());
+        auto rview_s = r_s.weightedAccumulationView(mat_ss.weight());
+        auto rview_n = r_n.weightedAccumulationView(mat_nn.weight());
+
+        // column c < n_s perturbs the inside coefficient c, all others the outside coefficient c-n_s
+        for (std::size_t first = 0; first < n; first += L-1)
+          {
+            const std::size_t last = std::min(first+L-1,n);
+            for (std::size_t c = first; c < last; ++c)
+              if (c < n_s)
+                u_s.perturb(c,c-first+1);
+              else
+                u_n.perturb(c-n_s,c-first+1);
+
+            r_s = Batch(0.0);
+            r_n = Batch(0.0);
+            asImp().alpha_skeleton(ig,lfsu_s,u_s.coefficients(),lfsv_s,lfsu_n,u_n.coefficients(),lfsv_n,
+                                   rview_s,rview_n);
+
+            for (std::size_t c = first; c < last; ++c)
+              if (c < n_s)
+                {
+                  Impl::accumulateDifferenceQuotients(lfsv_s,r_s,lfsu_s,c,c-first+1,u_s.delta(c),mat_ss);
+                  Impl::accumulateDifferenceQuotients(lfsv_n,r_n,lfsu_s,c,c-first+1,u_s.delta(c),mat_ns);
+                  u_s.reset(c);
+                }
+              else
+                {
+                  const std::size_t j = c-n_s;
+                  Impl::accumulateDifferenceQuotients(lfsv_s,r_s,lfsu_n,j,c-first+1,u_n.delta(j),mat_sn);
+                  Impl::accumulateDifferenceQuotients(lfsv_n,r_n,lfsu_n,j,c-first+1,u_n.delta(j),mat_nn);
+                  u_n.reset(j);
+                }
+          }
+      }
+
+    private:
+      const double epsilon;
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
+    //! Implement jacobian_boundary() based on alpha_boundary(), evaluating a batch of perturbations at once
+    /**
+     * See BatchedNumericalJacobianVolume for the requirements on alpha_boundary().
+     *
+     * \tparam Imp Type of the derived class (CRTP-trick).
+     * \tparam L   The number of lanes of each batch, including the unperturbed one.
+     */
+    template<typename Imp, std::size_t L = 8>
+    class BatchedNumericalJacobianBoundary
+    {
+      static_assert(L > 1, "A batch needs at least one perturbed lane");
+
+    public:
+      BatchedNumericalJacobianBoundary ()
+        : epsilon(1e-7)
+      {}
+
+      BatchedNumericalJacobianBoundary (double epsilon_)
+        : epsilon(epsilon_)
+      {}
+
+      //! compute local jacobian of the boundary term
+      template<typename IG, typename LFSU, typename X, typename LFSV,
+               typename Jacobian>
+      void jacobian_boundary
+      ( const IG& ig,
+        const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+        Jacobian& mat_ss) const
+      {
+        Impl::batchedNumericalJacobian<L>(lfsu_s,x_s,lfsv_s,mat_ss,epsilon,[&](const auto& u, auto& r)
+          {
+            asImp().alpha_boundary(ig,lfsu_s,u,lfsv_s,r);
+          });
+      }
+
+    private:
+      const double epsilon;
+      const Imp& asImp () const { return static_cast<const Imp &>(*this); }
+    };
+
+    //! \} group LocalOperatorDefaultImp
+  }
+}
+
+#endif // DUNE_PDELAB_LOCALOPERATOR_BATCHEDNUMERICALJACOBIAN_HH
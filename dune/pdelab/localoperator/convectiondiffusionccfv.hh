@@ -530,11 +530,15 @@ namespace Dune {
      * \f{align*}{
          \int_\Omega d(x) uv dx
      * \f}
+     *
+     * The mass matrix of cell-centered finite volumes is diagonal, so it
+     * needs no lumping and is assembled with diagonal local matrices.
      */
     template<class TP>
     class ConvectionDiffusionCCFVTemporalOperator :
       public FullVolumePattern,
       public LocalOperatorDefaultFlags,
+      public lop::DiagonalJacobian,
       public InstationaryLocalOperatorDefaultMethods<typename TP::Traits::RangeFieldType>
     {
     public:
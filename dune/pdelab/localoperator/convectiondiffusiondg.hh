@@ -13,7 +13,7 @@
 #include<dune/pdelab/localoperator/flags.hh>
 #include<dune/pdelab/localoperator/idefault.hh>
 #include<dune/pdelab/localoperator/defaultimp.hh>
-#include<dune/pdelab/finiteelement/localbasiscache.hh>
+#include<dune/pdelab/finiteelement/quadraturebasiscache.hh>
 
 #include"convectiondiffusionparameter.hh"
 
@@ -94,7 +94,6 @@ namespace Dune {
         , alpha(alpha_)
         , intorderadd(intorderadd_)
         , quadrature_factor(2)
-        , cache(20)
       {
         theta = 1.0;
         if (method==ConvectionDiffusionDGMethod::SIPG) theta = -1.0;
@@ -137,8 +136,13 @@ namespace Dune {
 
         // loop over quadrature points
         auto intorder = intorderadd + quadrature_factor * order;
-        for (const auto& ip : quadratureRule(geo,intorder))
+        auto rule = quadratureRule(geo,intorder);
+        const auto& basis_u = cache.table(lfsu.finiteElement().localBasis(),rule);
+        const auto& basis_v = cache.table(lfsv.finiteElement().localBasis(),rule);
+        for (std::size_t q=0; q<rule.size(); ++q)
           {
+            const auto& ip = rule[q];
+
             // update all variables dependent on A if A is not cell-wise constant
             if (!Impl::permeabilityIsConstantPerCell<T>(param))
             {
@@ -146,8 +150,8 @@ namespace Dune {
             }
 
             // evaluate basis functions
-            auto& phi = cache[order].evaluateFunction(ip.position(),lfsu.finiteElement().localBasis());
-            auto& psi = cache[order].evaluateFunction(ip.position(),lfsv.finiteElement().localBasis());
+            auto phi = basis_u.function(q);
+            auto psi = basis_v.function(q);
 
             // evaluate u
             RF u=0.0;
@@ -155,8 +159,8 @@ namespace Dune {
               u += x(lfsu,i)*phi[i];
 
             // evaluate gradient of basis functions
-            auto& js = cache[order].evaluateJacobian(ip.position(),lfsu.finiteElement().localBasis());
-            auto& js_v = cache[order].evaluateJacobian(ip.position(),lfsv.finiteElement().localBasis());
+            auto js = basis_u.jacobian(q);
+            auto js_v = basis_v.jacobian(q);
 
             // transform gradients of shape functions to real element
             jac = geo.jacobianInverseTransposed(ip.position());
@@ -229,8 +233,12 @@ namespace Dune {
 
         // loop over quadrature points
         auto intorder = intorderadd + quadrature_factor * order;
-        for (const auto& ip : quadratureRule(geo,intorder))
+        auto rule = quadratureRule(geo,intorder);
+        const auto& basis_u = cache.table(lfsu.finiteElement().localBasis(),rule);
+        for (std::size_t q=0; q<rule.size(); ++q)
           {
+            const auto& ip = rule[q];
+
             // update all variables dependent on A if A is not cell-wise constant
             if (!Impl::permeabilityIsConstantPerCell<T>(param))
             {
@@ -238,10 +246,10 @@ namespace Dune {
             }
 
             // evaluate basis functions
-            auto& phi = cache[order].evaluateFunction(ip.position(),lfsu.finiteElement().localBasis());
+            auto phi = basis_u.function(q);
 
             // evaluate gradient of basis functions
-            auto& js = cache[order].evaluateJacobian(ip.position(),lfsu.finiteElement().localBasis());
+            auto js = basis_u.jacobian(q);
 
             // transform gradients of shape functions to real element
             jac = geo.jacobianInverseTransposed(ip.position());
@@ -358,8 +366,15 @@ namespace Dune {
 
         // loop over quadrature points
         auto intorder = intorderadd+quadrature_factor*order;
-        for (const auto& ip : quadratureRule(geo,intorder))
+        auto rule = quadratureRule(geo,intorder);
+        const auto& basis_u_s = cache.table(lfsu_s.finiteElement().localBasis(),rule,geo_in_inside);
+        const auto& basis_u_n = cache.table(lfsu_n.finiteElement().localBasis(),rule,geo_in_outside);
+        const auto& basis_v_s = cache.table(lfsv_s.finiteElement().localBasis(),rule,geo_in_inside);
+        const auto& basis_v_n = cache.table(lfsv_n.finiteElement().localBasis(),rule,geo_in_outside);
+        for (std::size_t q=0; q<rule.size(); ++q)
           {
+            const auto& ip = rule[q];
+
             // exact normal
             auto n_F_local = ig.unitOuterNormal(ip.position());
 
@@ -387,10 +402,10 @@ namespace Dune {
             auto iplocal_n = geo_in_outside.global(ip.position());
 
             // evaluate basis functions
-            auto& phi_s = cache[order_s].evaluateFunction(iplocal_s,lfsu_s.finiteElement().localBasis());
-            auto& phi_n = cache[order_n].evaluateFunction(iplocal_n,lfsu_n.finiteElement().localBasis());
-            auto& psi_s = cache[order_s].evaluateFunction(iplocal_s,lfsv_s.finiteElement().localBasis());
-            auto& psi_n = cache[order_n].evaluateFunction(iplocal_n,lfsv_n.finiteElement().localBasis());
+            auto phi_s = basis_u_s.function(q);
+            auto phi_n = basis_u_n.function(q);
+            auto psi_s = basis_v_s.function(q);
+            auto psi_n = basis_v_n.function(q);
 
             // evaluate u
             RF u_s=0.0;
@@ -401,10 +416,10 @@ namespace Dune {
               u_n += x_n(lfsu_n,i)*phi_n[i];
 
             // evaluate gradient of basis functions
-            auto& gradphi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsu_s.finiteElement().localBasis());
-            auto& gradphi_n = cache[order_n].evaluateJacobian(iplocal_n,lfsu_n.finiteElement().localBasis());
-            auto& gradpsi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsv_s.finiteElement().localBasis());
-            auto& gradpsi_n = cache[order_n].evaluateJacobian(iplocal_n,lfsv_n.finiteElement().localBasis());
+            auto gradphi_s = basis_u_s.jacobian(q);
+            auto gradphi_n = basis_u_n.jacobian(q);
+            auto gradpsi_s = basis_v_s.jacobian(q);
+            auto gradpsi_n = basis_v_n.jacobian(q);
 
             // transform gradients of shape functions to real element
             jac = geo_inside.jacobianInverseTransposed(iplocal_s);
@@ -568,8 +583,13 @@ namespace Dune {
 
         // loop over quadrature points
         const int intorder = intorderadd+quadrature_factor*order;
-        for (const auto& ip : quadratureRule(geo,intorder))
+        auto rule = quadratureRule(geo,intorder);
+        const auto& basis_u_s = cache.table(lfsu_s.finiteElement().localBasis(),rule,geo_in_inside);
+        const auto& basis_u_n = cache.table(lfsu_n.finiteElement().localBasis(),rule,geo_in_outside);
+        for (std::size_t q=0; q<rule.size(); ++q)
           {
+            const auto& ip = rule[q];
+
             // exact normal
             auto n_F_local = ig.unitOuterNormal(ip.position());
 
@@ -596,12 +616,12 @@ namespace Dune {
             auto iplocal_n = geo_in_outside.global(ip.position());
 
             // evaluate basis functions
-            auto& phi_s = cache[order_s].evaluateFunction(iplocal_s,lfsu_s.finiteElement().localBasis());
-            auto& phi_n = cache[order_n].evaluateFunction(iplocal_n,lfsu_n.finiteElement().localBasis());
+            auto phi_s = basis_u_s.function(q);
+            auto phi_n = basis_u_n.function(q);
 
             // evaluate gradient of basis functions
-            auto& gradphi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsu_s.finiteElement().localBasis());
-            auto& gradphi_n = cache[order_n].evaluateJacobian(iplocal_n,lfsu_n.finiteElement().localBasis());
+            auto gradphi_s = basis_u_s.jacobian(q);
+            auto gradphi_n = basis_u_n.jacobian(q);
 
             // transform gradients of shape functions to real element
             jac = geo_inside.jacobianInverseTransposed(iplocal_s);
@@ -743,8 +763,13 @@ namespace Dune {
 
         // loop over quadrature points
         auto intorder = intorderadd+quadrature_factor*order;
-        for (const auto& ip : quadratureRule(geo,intorder))
+        auto rule = quadratureRule(geo,intorder);
+        const auto& basis_u_s = cache.table(lfsu_s.finiteElement().localBasis(),rule,geo_in_inside);
+        const auto& basis_v_s = cache.table(lfsv_s.finiteElement().localBasis(),rule,geo_in_inside);
+        for (std::size_t q=0; q<rule.size(); ++q)
           {
+            const auto& ip = rule[q];
+
             // local normal
             auto n_F_local = ig.unitOuterNormal(ip.position());
 
@@ -769,8 +794,8 @@ namespace Dune {
             auto iplocal_s = geo_in_inside.global(ip.position());
 
             // evaluate basis functions
-            auto& phi_s = cache[order_s].evaluateFunction(iplocal_s,lfsu_s.finiteElement().localBasis());
-            auto& psi_s = cache[order_s].evaluateFunction(iplocal_s,lfsv_s.finiteElement().localBasis());
+            auto phi_s = basis_u_s.function(q);
+            auto psi_s = basis_v_s.function(q);
 
             // integration factor
             RF factor = ip.weight() * geo.integrationElement(ip.position());
@@ -823,8 +848,8 @@ namespace Dune {
 
             // evaluate gradient of basis functions
             assert (bctype == ConvectionDiffusionBoundaryConditions::Dirichlet);
-            auto& gradphi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsu_s.finiteElement().localBasis());
-            auto& gradpsi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsv_s.finiteElement().localBasis());
+            auto gradphi_s = basis_u_s.jacobian(q);
+            auto gradpsi_s = basis_v_s.jacobian(q);
 
             // transform gradients of shape functions to real element
             jac = geo_inside.jacobianInverseTransposed(iplocal_s);
@@ -959,8 +984,12 @@ namespace Dune {
 
         // loop over quadrature points
         auto intorder = intorderadd+quadrature_factor*order;
-        for (const auto& ip : quadratureRule(geo,intorder))
+        auto rule = quadratureRule(geo,intorder);
+        const auto& basis_u_s = cache.table(lfsu_s.finiteElement().localBasis(),rule,geo_in_inside);
+        for (std::size_t q=0; q<rule.size(); ++q)
           {
+            const auto& ip = rule[q];
+
             // local normal
             auto n_F_local = ig.unitOuterNormal(ip.position());
 
@@ -986,7 +1015,7 @@ namespace Dune {
             auto iplocal_s = geo_in_inside.global(ip.position());
 
             // evaluate basis functions
-            auto& phi_s = cache[order_s].evaluateFunction(iplocal_s,lfsu_s.finiteElement().localBasis());
+            auto phi_s = basis_u_s.function(q);
 
             // integration factor
             auto factor = ip.weight() * geo.integrationElement(ip.position());
@@ -1012,7 +1041,7 @@ namespace Dune {
               }
 
             // evaluate gradient of basis functions
-            auto& gradphi_s = cache[order_s].evaluateJacobian(iplocal_s,lfsu_s.finiteElement().localBasis());
+            auto gradphi_s = basis_u_s.jacobian(q);
 
             // transform gradients of shape functions to real element
             jac = geo_inside.jacobianInverseTransposed(iplocal_s);
@@ -1059,10 +1088,14 @@ namespace Dune {
         // loop over quadrature points
         auto order = lfsv.finiteElement().localBasis().order();
         auto intorder = intorderadd + 2 * order;
-        for (const auto& ip : quadratureRule(geo,intorder))
+        auto rule = quadratureRule(geo,intorder);
+        const auto& basis_v = cache.table(lfsv.finiteElement().localBasis(),rule);
+        for (std::size_t q=0; q<rule.size(); ++q)
           {
+            const auto& ip = rule[q];
+
             // evaluate shape functions
-            auto& phi = cache[order].evaluateFunction(ip.position(),lfsv.finiteElement().localBasis());
+            auto phi = basis_v.function(q);
 
             // evaluate right hand side parameter function
             auto f = param.f(cell,ip.position());
@@ -1091,18 +1124,10 @@ namespace Dune {
       Real theta;
 
       using LocalBasisType = typename FiniteElementMap::Traits::FiniteElementType::Traits::LocalBasisType;
-      using Cache = Dune::PDELab::LocalBasisCache<LocalBasisType>;
-
-      // In theory it is possible that one and the same local operator is
-      // called first with a finite element of one type and later with a
-      // finite element of another type.  Since finite elements of different
-      // type will usually produce different results for the same local
-      // coordinate they cannot share a cache.  Here we use a vector of caches
-      // to allow for different orders of the shape functions, which should be
-      // enough to support p-adaptivity.  (Another likely candidate would be
-      // differing geometry types, i.e. hybrid meshes.)
-
-      std::vector<Cache> cache;
+
+      // The tables are kept per local basis and quadrature rule, so finite elements of
+      // different orders (p-adaptivity) or geometry types (hybrid meshes) do not interfere.
+      Dune::PDELab::QuadratureBasisCache<LocalBasisType> cache;
 
       template<class GEO>
       void element_size (const GEO& geo, typename GEO::ctype& hmin, typename GEO::ctype hmax) const
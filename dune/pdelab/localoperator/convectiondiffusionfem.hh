@@ -14,7 +14,7 @@
 #include<dune/pdelab/localoperator/flags.hh>
 #include<dune/pdelab/localoperator/idefault.hh>
 #include<dune/pdelab/localoperator/defaultimp.hh>
-#include<dune/pdelab/finiteelement/localbasiscache.hh>
+#include<dune/pdelab/finiteelement/quadraturebasiscache.hh>
 
 #include"convectiondiffusionparameter.hh"
 
@@ -91,8 +91,12 @@ namespace Dune {
 
         // loop over quadrature points
         auto intorder = intorderadd+2*lfsu.finiteElement().localBasis().order();
-        for (const auto& ip : quadratureRule(geo,intorder))
+        auto rule = quadratureRule(geo,intorder);
+        const auto& basis_u = cache.table(lfsu.finiteElement().localBasis(),rule);
+        for (std::size_t q=0; q<rule.size(); ++q)
           {
+            const auto& ip = rule[q];
+
             // update all variables dependent on A if A is not cell-wise constant
             if (!Impl::permeabilityIsConstantPerCell<T>(param))
             {
@@ -100,7 +104,7 @@ namespace Dune {
             }
 
             // evaluate basis functions
-            auto& phi = cache.evaluateFunction(ip.position(),lfsu.finiteElement().localBasis());
+            auto phi = basis_u.function(q);
 
             // evaluate u
             RF u=0.0;
@@ -108,7 +112,7 @@ namespace Dune {
               u += x(lfsu,i)*phi[i];
 
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            auto& js = cache.evaluateJacobian(ip.position(),lfsu.finiteElement().localBasis());
+            auto js = basis_u.jacobian(q);
 
             // transform gradients of shape functions to real element
             jac = geo.jacobianInverseTransposed(ip.position());
@@ -168,8 +172,12 @@ namespace Dune {
 
         // loop over quadrature points
         auto intorder = intorderadd+2*lfsu.finiteElement().localBasis().order();
-        for (const auto& ip : quadratureRule(geo,intorder))
+        auto rule = quadratureRule(geo,intorder);
+        const auto& basis_u = cache.table(lfsu.finiteElement().localBasis(),rule);
+        for (std::size_t q=0; q<rule.size(); ++q)
           {
+            const auto& ip = rule[q];
+
             // update all variables dependent on A if A is not cell-wise constant
             if (!Impl::permeabilityIsConstantPerCell<T>(param))
             {
@@ -177,7 +185,7 @@ namespace Dune {
             }
 
             // evaluate gradient of shape functions (we assume Galerkin method lfsu=lfsv)
-            auto& js = cache.evaluateJacobian(ip.position(),lfsu.finiteElement().localBasis());
+            auto js = basis_u.jacobian(q);
 
             // transform gradient to real element
             jac = geo.jacobianInverseTransposed(ip.position());
@@ -188,7 +196,7 @@ namespace Dune {
               }
 
             // evaluate basis functions
-            auto& phi = cache.evaluateFunction(ip.position(),lfsu.finiteElement().localBasis());
+            auto phi = basis_u.function(q);
 
             // evaluate velocity field, sink term and source term
             auto b = param.b(cell,ip.position());
@@ -233,13 +241,17 @@ namespace Dune {
 
         // loop over quadrature points and integrate normal flux
         auto intorder = intorderadd+2*lfsu_s.finiteElement().localBasis().order();
-        for (const auto& ip : quadratureRule(geo,intorder))
+        auto rule = quadratureRule(geo,intorder);
+        const auto& basis_u_s = cache.table(lfsu_s.finiteElement().localBasis(),rule,geo_in_inside);
+        for (std::size_t q=0; q<rule.size(); ++q)
           {
+            const auto& ip = rule[q];
+
             // position of quadrature point in local coordinates of element
             auto local = geo_in_inside.global(ip.position());
 
             // evaluate shape functions (assume Galerkin method)
-            auto& phi = cache.evaluateFunction(local,lfsu_s.finiteElement().localBasis());
+            auto phi = basis_u_s.function(q);
 
             if (bctype==ConvectionDiffusionBoundaryConditions::Neumann)
               {
@@ -304,13 +316,17 @@ namespace Dune {
 
         // loop over quadrature points and integrate normal flux
         auto intorder = intorderadd+2*lfsu_s.finiteElement().localBasis().order();
-        for (const auto& ip : quadratureRule(geo,intorder))
+        auto rule = quadratureRule(geo,intorder);
+        const auto& basis_u_s = cache.table(lfsu_s.finiteElement().localBasis(),rule,geo_in_inside);
+        for (std::size_t q=0; q<rule.size(); ++q)
           {
+            const auto& ip = rule[q];
+
             // position of quadrature point in local coordinates of element
             auto local = geo_in_inside.global(ip.position());
 
             // evaluate shape functions (assume Galerkin method)
-            auto& phi = cache.evaluateFunction(local,lfsu_s.finiteElement().localBasis());
+            auto phi = basis_u_s.function(q);
 
             // evaluate velocity field and outer unit normal
             auto b = param.b(cell_inside,local);
@@ -335,7 +351,7 @@ namespace Dune {
       T& param;
       int intorderadd;
       using LocalBasisType = typename FiniteElementMap::Traits::FiniteElementType::Traits::LocalBasisType;
-      Dune::PDELab::LocalBasisCache<LocalBasisType> cache;
+      Dune::PDELab::QuadratureBasisCache<LocalBasisType> cache;
     };
 
 
@@ -0,0 +1,453 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifndef DUNE_PDELAB_LOCALOPERATOR_HYBRIDIZEDDIFFUSIONMIXED_HH
+#define DUNE_PDELAB_LOCALOPERATOR_HYBRIDIZEDDIFFUSIONMIXED_HH
+
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/pdelab/common/quadraturerules.hh>
+#include <dune/pdelab/gridfunctionspace/lfsindexcache.hh>
+#include <dune/pdelab/gridfunctionspace/localfunctionspace.hh>
+
+#include "defaultimp.hh"
+#include "pattern.hh"
+#include "flags.hh"
+#include "convectiondiffusionparameter.hh"
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup LocalOperator
+    //! \ingroup PDELab
+    //! \{
+
+    /** \brief Hybridized lowest order Raviart-Thomas discretization of the Poisson equation
+
+        Solves the same problem as DiffusionMixed,
+        \f{align*}{
+          \nabla\cdot\sigma + a_0 u &= f   \mbox{ in } \Omega, \\
+                             \sigma &= -K \nabla u \mbox{ in } \Omega, \\
+                                  u &= g   \mbox{ on } \partial\Omega_D, \\
+                   \sigma \cdot \nu &= j   \mbox{ on } \partial\Omega_N,
+        \f}
+        with RT0 velocities and P0 pressures, but without the saddle point system. The
+        normal continuity of the velocity is relaxed and enforced by Lagrange multipliers
+        \f$\lambda\f$, which are constant on each face and approximate the pressure there.
+        On every cell, the local mixed system
+        \f[
+          \begin{pmatrix} M & B \\ B^T & D \end{pmatrix}
+          \begin{pmatrix} \sigma_T \\ u_T \end{pmatrix}
+          = - \begin{pmatrix} C \lambda \\ f_T \end{pmatrix}
+        \f]
+        is solved for the velocity and the pressure, which leaves the symmetric positive
+        definite system \f$ C^T (L^{-1})_{\sigma\sigma} C \lambda = \ldots \f$ for the face
+        values, asserting that the normal fluxes of neighboring cells match. It is suited
+        for CG with AMG preconditioning.
+
+        The local operator works on a scalar trace space, i.e. a grid function space on
+        the Raviart-Thomas finite element map of order 0, whose face DOFs are interpreted
+        as the multipliers. Dirichlet faces are constrained, e.g. with
+        ConformingDirichletConstraints, and their values are set by
+        interpolateDirichletTraces(). After solving, reconstruct() computes the
+        coefficients of the velocity and the pressure in the composite space of
+        DiffusionMixed. The velocity has to use the same finite element map as the trace
+        space and the pressure has to be P0. As DiffusionMixed, the operator requires
+        affine cells and a diffusion tensor that is constant on each cell.
+
+        \tparam PARAM Parameter class, see ConvectionDiffusionModelProblem
+    */
+    template<typename PARAM>
+    class HybridizedDiffusionMixed : public FullVolumePattern,
+                                     public LocalOperatorDefaultFlags
+    {
+
+      using BCType = typename ConvectionDiffusionBoundaryConditions::Type;
+
+    public:
+      // pattern assembly flags
+      enum { doPatternVolume = true };
+
+      // residual assembly flags
+      enum { doAlphaVolume = true };
+      enum { doLambdaBoundary = true };
+
+      HybridizedDiffusionMixed ( const PARAM& param_,
+                                 int qorder_v_=2,
+                                 int qorder_p_=1 )
+        : param(param_),
+          qorder_v(qorder_v_),
+          qorder_p(qorder_p_)
+      {
+      }
+
+      // volume integral depending on test and ansatz functions
+      template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+      void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+      {
+        using RF = typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType;
+
+        LocalSystem<RF> system;
+        assembleLocalSystem(eg.entity(),lfsu,system);
+
+        std::vector<RF> lambda(lfsu.size());
+        for (std::size_t k=0; k<lfsu.size(); k++)
+          lambda[k] = x(lfsu,k);
+        std::vector<RF> solution;
+        system.solve(lambda,solution);
+
+        // the multipliers test the jump of the normal flux
+        for (std::size_t k=0; k<lfsv.size(); k++)
+          {
+            RF flux = 0.0;
+            for (std::size_t i=0; i<system.n; i++)
+              flux += system.C[i][k]*solution[i];
+            r.accumulate(lfsv,k,-flux);
+          }
+      }
+
+      // jacobian of volume term
+      template<typename EG, typename LFSU, typename X, typename LFSV, typename M>
+      void jacobian_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, M& mat) const
+      {
+        using RF = typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType;
+
+        LocalSystem<RF> system;
+        assembleLocalSystem(eg.entity(),lfsu,system);
+        Dune::DynamicMatrix<RF> S;
+        system.schurComplement(S);
+
+        for (std::size_t k=0; k<lfsv.size(); k++)
+          for (std::size_t l=0; l<lfsu.size(); l++)
+            mat.accumulate(lfsv,k,lfsu,l,S[k][l]);
+      }
+
+      // jacobian apply of volume term
+      template<typename EG, typename LFSU, typename X, typename LFSV, typename Y>
+      void jacobian_apply_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, Y& y) const
+      {
+        using RF = typename LFSU::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType;
+
+        LocalSystem<RF> system;
+        assembleLocalSystem(eg.entity(),lfsu,system);
+        Dune::DynamicMatrix<RF> S;
+        system.schurComplement(S);
+
+        for (std::size_t k=0; k<lfsv.size(); k++)
+          {
+            RF value = 0.0;
+            for (std::size_t l=0; l<lfsu.size(); l++)
+              value += S[k][l]*x(lfsu,l);
+            y.accumulate(lfsv,k,value);
+          }
+      }
+
+      // boundary integral independent of ansatz functions
+      template<typename IG, typename LFSV, typename R>
+      void lambda_boundary (const IG& ig, const LFSV& lfsv, R& r) const
+      {
+        // the normal flux is prescribed on Neumann faces
+        auto geo = ig.geometry();
+        auto ref_el = referenceElement(geo);
+        if (param.bctype(ig.intersection(),ref_el.position(0,0)) != ConvectionDiffusionBoundaryConditions::Neumann)
+          return;
+
+        using RF = typename LFSV::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType;
+        RF flux = 0.0;
+        for (const auto& ip : quadratureRule(geo,qorder_v))
+          flux += param.j(ig.intersection(),ip.position())*ip.weight()*geo.integrationElement(ip.position());
+
+        const auto& coefficients = lfsv.finiteElement().localCoefficients();
+        for (std::size_t k=0; k<lfsv.size(); k++)
+          if (static_cast<int>(coefficients.localKey(k).subEntity()) == ig.indexInInside())
+            r.accumulate(lfsv,k,flux);
+      }
+
+      //! Sets the multipliers of all Dirichlet faces to the mean value of g on the face.
+      template<typename GFS, typename X>
+      void interpolateDirichletTraces (const GFS& gfs, X& lambda) const
+      {
+        using LFS = LocalFunctionSpace<GFS>;
+        using LFSCache = LFSIndexCache<LFS>;
+        using RF = typename LFS::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType;
+        LFS lfs(gfs);
+        LFSCache lfs_cache(lfs);
+        typename X::template LocalView<LFSCache> lambda_view(lambda);
+
+        for (const auto& cell : elements(gfs.entitySet()))
+          {
+            lfs.bind(cell);
+            lfs_cache.update();
+            lambda_view.bind(lfs_cache);
+            const auto& coefficients = lfs.finiteElement().localCoefficients();
+
+            for (const auto& intersection : intersections(gfs.gridView(),cell))
+              {
+                if (!intersection.boundary())
+                  continue;
+                auto geo = intersection.geometry();
+                auto ref_el = referenceElement(geo);
+                if (param.bctype(intersection,ref_el.position(0,0)) != ConvectionDiffusionBoundaryConditions::Dirichlet)
+                  continue;
+
+                // L2 projection of g onto the constants
+                auto geo_in_inside = intersection.geometryInInside();
+                RF integral = 0.0;
+                RF volume = 0.0;
+                for (const auto& ip : quadratureRule(geo,qorder_v))
+                  {
+                    const auto factor = ip.weight()*geo.integrationElement(ip.position());
+                    integral += param.g(cell,geo_in_inside.global(ip.position()))*factor;
+                    volume += factor;
+                  }
+
+                for (std::size_t k=0; k<lfs.size(); k++)
+                  if (static_cast<int>(coefficients.localKey(k).subEntity()) == intersection.indexInInside())
+                    lambda_view[k] = integral/volume;
+              }
+
+            lambda_view.commit();
+            lambda_view.unbind();
+          }
+        lambda_view.detach();
+      }
+
+      //! Computes the velocity and the pressure of the mixed problem from the multipliers.
+      /**
+       * \param trace_gfs The trace space the multipliers live in
+       * \param lambda    The multipliers
+       * \param mixed_gfs The composite space of velocity and pressure used with DiffusionMixed,
+       *                  the velocity space has to use the finite element map of the trace space
+       * \param x         Receives the coefficients of the velocity and the pressure
+       */
+      template<typename TraceGFS, typename X, typename MixedGFS, typename Y>
+      void reconstruct (const TraceGFS& trace_gfs, const X& lambda, const MixedGFS& mixed_gfs, Y& x) const
+      {
+        using TraceLFS = LocalFunctionSpace<TraceGFS>;
+        using TraceLFSCache = LFSIndexCache<TraceLFS>;
+        using MixedLFS = LocalFunctionSpace<MixedGFS>;
+        using MixedLFSCache = LFSIndexCache<MixedLFS>;
+        using RF = typename TraceLFS::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType;
+        TraceLFS trace_lfs(trace_gfs);
+        TraceLFSCache trace_lfs_cache(trace_lfs);
+        MixedLFS mixed_lfs(mixed_gfs);
+        MixedLFSCache mixed_lfs_cache(mixed_lfs);
+        typename X::template ConstLocalView<TraceLFSCache> lambda_view(lambda);
+        typename Y::template LocalView<MixedLFSCache> x_view(x);
+
+        using namespace Indices;
+        const auto& velocityspace = child(mixed_lfs,_0);
+        const auto& pressurespace = child(mixed_lfs,_1);
+
+        LocalSystem<RF> system;
+        std::vector<RF> lambda_local;
+        std::vector<RF> solution;
+
+        for (const auto& cell : elements(trace_gfs.entitySet()))
+          {
+            trace_lfs.bind(cell);
+            trace_lfs_cache.update();
+            lambda_view.bind(trace_lfs_cache);
+            mixed_lfs.bind(cell);
+            mixed_lfs_cache.update();
+            x_view.bind(mixed_lfs_cache);
+
+            if (velocityspace.size() != trace_lfs.size() || pressurespace.size() != 1)
+              DUNE_THROW(Dune::Exception,"The mixed space must consist of the RT0 space of the traces and a P0 space");
+
+            assembleLocalSystem(cell,trace_lfs,system);
+            lambda_local.resize(trace_lfs.size());
+            for (std::size_t k=0; k<trace_lfs.size(); k++)
+              lambda_local[k] = lambda_view[k];
+            system.solve(lambda_local,solution);
+
+            // fluxes through shared faces agree, so both cells write the same coefficient
+            for (std::size_t i=0; i<velocityspace.size(); i++)
+              x_view[velocityspace.localIndex(i)] = solution[i];
+            x_view[pressurespace.localIndex(0)] = solution[system.n];
+
+            x_view.commit();
+            x_view.unbind();
+            lambda_view.unbind();
+          }
+        x_view.detach();
+        lambda_view.detach();
+      }
+
+    private:
+
+      //! The local mixed system of a cell, see the class documentation.
+      template<typename RF>
+      struct LocalSystem
+      {
+        //! The number of velocity DOFs, the pressure is stored after them
+        std::size_t n;
+        //! The inverse of the local mixed matrix L
+        Dune::DynamicMatrix<RF> Linv;
+        //! The fluxes of the velocity basis functions (rows) through the faces of the multipliers (columns)
+        Dune::DynamicMatrix<RF> C;
+        //! The integral of the source term
+        RF f;
+
+        //! Computes velocity and pressure for the given multipliers.
+        void solve (const std::vector<RF>& lambda, std::vector<RF>& solution) const
+        {
+          std::vector<RF> rhs(n+1,0.0);
+          for (std::size_t i=0; i<n; i++)
+            for (std::size_t k=0; k<lambda.size(); k++)
+              rhs[i] -= C[i][k]*lambda[k];
+          rhs[n] = -f;
+
+          solution.assign(n+1,0.0);
+          for (std::size_t i=0; i<=n; i++)
+            for (std::size_t j=0; j<=n; j++)
+              solution[i] += Linv[i][j]*rhs[j];
+        }
+
+        //! Computes the local jacobian of the multipliers, C^T (L^{-1})_{\sigma\sigma} C.
+        void schurComplement (Dune::DynamicMatrix<RF>& S) const
+        {
+          const std::size_t m = C.M();
+          Dune::DynamicMatrix<RF> LinvC(n,m,0.0);
+          for (std::size_t i=0; i<n; i++)
+            for (std::size_t j=0; j<n; j++)
+              for (std::size_t l=0; l<m; l++)
+                LinvC[i][l] += Linv[i][j]*C[j][l];
+          S.resize(m,m);
+          S = 0.0;
+          for (std::size_t k=0; k<m; k++)
+            for (std::size_t i=0; i<n; i++)
+              for (std::size_t l=0; l<m; l++)
+                S[k][l] += C[i][k]*LinvC[i][l];
+        }
+      };
+
+      // assembles and inverts the local mixed system of a cell, the trace space provides the velocity basis
+      template<typename Cell, typename LFS, typename RF>
+      void assembleLocalSystem (const Cell& cell, const LFS& lfs, LocalSystem<RF>& system) const
+      {
+        // Define types
+        using DF = typename LFS::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::DomainFieldType;
+        using VelocityJacobianType = typename LFS::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::JacobianType;
+        using VelocityRangeType = typename LFS::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeType;
+
+        // dimensions
+        const int dim = Cell::Geometry::mydimension;
+        const std::size_t n = lfs.size();
+
+        // Get geometry
+        auto geo = cell.geometry();
+        auto ref_el = referenceElement(geo);
+
+        const auto& basis = lfs.finiteElement().localBasis();
+        const auto& coefficients = lfs.finiteElement().localCoefficients();
+        if (n != std::size_t(ref_el.size(1)))
+          DUNE_THROW(Dune::NotImplemented,"Hybridization requires exactly one DOF per face");
+        for (std::size_t k=0; k<n; k++)
+          if (coefficients.localKey(k).codim() != 1)
+            DUNE_THROW(Dune::NotImplemented,"Hybridization requires exactly one DOF per face");
+
+        // evaluate transformation which must be linear
+        Dune::FieldVector<DF,dim> pos;
+        pos=0.0;
+        auto jac = geo.jacobianInverseTransposed(pos);
+        jac.invert();
+        auto det = geo.integrationElement(pos);
+
+        // evaluate inverse diffusion tensor at cell center, assume it is constant over elements
+        auto tensor = param.A(cell,ref_el.position(0,0));
+        tensor.invert();
+
+        system.n = n;
+        Dune::DynamicMatrix<RF> L(n+1,n+1,0.0);
+        std::vector<VelocityRangeType> vbasis(n);
+        std::vector<VelocityRangeType> vtransformedbasis(n);
+        std::vector<VelocityJacobianType> vjacbasis(n);
+        VelocityRangeType Kinvphi;
+
+        // (K^{-1} sigma, v) term
+        for (const auto& ip : quadratureRule(geo,qorder_v))
+          {
+            basis.evaluateFunction(ip.position(),vbasis);
+            for (std::size_t i=0; i<n; i++)
+              {
+                vtransformedbasis[i] = 0.0;
+                jac.umtv(vbasis[i],vtransformedbasis[i]);
+              }
+            auto factor = ip.weight() / det;
+            for (std::size_t j=0; j<n; j++)
+              {
+                tensor.mv(vtransformedbasis[j],Kinvphi);
+                for (std::size_t i=0; i<n; i++)
+                  L[i][j] += (Kinvphi*vtransformedbasis[i])*factor;
+              }
+          }
+
+        // u div v and div sigma q terms, a0 u q term and source term
+        system.f = 0.0;
+        for (const auto& ip : quadratureRule(geo,qorder_p))
+          {
+            basis.evaluateJacobian(ip.position(),vjacbasis);
+            RF factor = ip.weight();
+            for (std::size_t i=0; i<n; i++)
+              {
+                RF divergence = 0.0;
+                for (int j=0; j<dim; j++)
+                  divergence += vjacbasis[i][j][j];
+                L[i][n] -= divergence*factor;
+                L[n][i] -= divergence*factor;
+              }
+            auto volume_factor = factor*geo.integrationElement(ip.position());
+            L[n][n] -= param.c(cell,ip.position())*volume_factor;
+            system.f += param.f(cell,ip.position())*volume_factor;
+          }
+
+        L.invert();
+        system.Linv = L;
+
+        // fluxes through the faces, the Piola transformation preserves them, so they are
+        // computed on the reference element
+        system.C.resize(n,n);
+        system.C = 0.0;
+        for (std::size_t k=0; k<n; k++)
+          {
+            const int face = coefficients.localKey(k).subEntity();
+            auto face_geo = ref_el.template geometry<1>(face);
+            auto normal = ref_el.integrationOuterNormal(face);
+            normal /= normal.two_norm();
+            for (const auto& ip : quadratureRule(face_geo,qorder_v))
+              {
+                basis.evaluateFunction(face_geo.global(ip.position()),vbasis);
+                auto factor = ip.weight()*face_geo.integrationElement(ip.position());
+                for (std::size_t i=0; i<n; i++)
+                  system.C[i][k] += (vbasis[i]*normal)*factor;
+              }
+          }
+      }
+
+      const PARAM& param;
+      int qorder_v;
+      int qorder_p;
+    };
+
+    //! \} group LocalOperator
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_LOCALOPERATOR_HYBRIDIZEDDIFFUSIONMIXED_HH
@@ -15,6 +15,7 @@
 #include <dune/pdelab/localoperator/flags.hh>
 #include <dune/pdelab/localoperator/idefault.hh>
 #include <dune/pdelab/localoperator/blockdiagonal.hh>
+#include <dune/pdelab/localoperator/masslumping.hh>
 
 namespace Dune {
   namespace PDELab {
@@ -35,9 +36,10 @@ namespace Dune {
         // Residual assembly flags
         enum { doAlphaVolume = true };
 
-        ScalarL2 (int intorderadd, double scaling)
+        ScalarL2 (int intorderadd, double scaling, MassLumping lumping = MassLumping::none)
           : _intorderadd(intorderadd)
           , _scaling(scaling)
+          , _lumping(lumping)
         {}
 
         // Volume integral depending on test and ansatz functions
@@ -64,6 +66,16 @@ namespace Dune {
           // determine integration order
           auto intorder = 2*FESwitch::basis(lfsu.finiteElement()).order() + _intorderadd;
 
+          // Lumped mass matrix
+          if (_lumping != MassLumping::none)
+            {
+              std::vector<RF> diagonal;
+              lumpedMassDiagonal(geo,FESwitch::basis(lfsu.finiteElement()),_lumping,intorder,diagonal);
+              for (size_type i=0; i<lfsu.size(); i++)
+                r.accumulate(lfsv,i, _scaling*diagonal[i]*x(lfsu,i));
+              return;
+            }
+
           // Loop over quadrature points
           for (const auto& qp : quadratureRule(geo,intorder))
             {
@@ -100,18 +112,29 @@ namespace Dune {
             typename FESwitch::Basis>;
 
           // Define types
+          using RF = typename BasisSwitch::RangeField;
           using RangeType = typename BasisSwitch::Range;
           using size_type = typename LFSU::Traits::SizeType;
 
           // Get geometry
           auto geo = eg.geometry();
 
-          // Inititialize vectors outside for loop
-          std::vector<RangeType> phi(lfsu.size());
-
           // determine integration order
           auto intorder = 2*FESwitch::basis(lfsu.finiteElement()).order() + _intorderadd;
 
+          // Lumped mass matrix
+          if (_lumping != MassLumping::none)
+            {
+              std::vector<RF> diagonal;
+              lumpedMassDiagonal(geo,FESwitch::basis(lfsu.finiteElement()),_lumping,intorder,diagonal);
+              for (size_type i=0; i<lfsu.size(); i++)
+                mat.accumulate(lfsv,i,lfsu,i, _scaling*diagonal[i]);
+              return;
+            }
+
+          // Inititialize vectors outside for loop
+          std::vector<RangeType> phi(lfsu.size());
+
           // Loop over quadrature points
           for (const auto& qp : quadratureRule(geo,intorder))
             {
@@ -129,6 +152,7 @@ namespace Dune {
       private:
         int _intorderadd;
         double _scaling;
+        MassLumping _lumping;
       };
 
     } // namespace impl
@@ -145,6 +169,9 @@ namespace Dune {
      *
      * This operator also works for trees of function spaces by applying
      * the L2 operator on the block diagonal.
+     *
+     * With mass lumping, the operator is approximated by a diagonal matrix,
+     * which makes explicit time stepping schemes cheap, see MassLumping.
      */
     class L2 :
       public BlockDiagonalLocalOperatorFullCoupling<impl::ScalarL2>
@@ -160,11 +187,31 @@ namespace Dune {
        *                    and test space as its integration order. This parameter gets added to
        *                    that value and lets you modify the default.
        * \param scaling     The output of the operator will be scaled by this value.
+       * \param lumping     Replaces the mass matrix by a diagonal approximation.
        */
-      L2 (int intorderadd = 0, double scaling = 1.0)
-        : BlockDiagonalLocalOperatorFullCoupling<impl::ScalarL2>(intorderadd,scaling)
+      L2 (int intorderadd = 0, double scaling = 1.0, MassLumping lumping = MassLumping::none)
+        : BlockDiagonalLocalOperatorFullCoupling<impl::ScalarL2>(intorderadd,scaling,lumping)
+        , _lumping(lumping)
       {}
 
+      // define sparsity pattern of operator representation, a lumped mass matrix is diagonal
+      template<typename LFSU, typename LFSV, typename LocalPattern>
+      void pattern_volume (const LFSU& lfsu, const LFSV& lfsv,
+                           LocalPattern& pattern) const
+      {
+        if (_lumping == MassLumping::none)
+          {
+            BlockDiagonalLocalOperatorFullCoupling<impl::ScalarL2>::pattern_volume(lfsu,lfsv,pattern);
+            return;
+          }
+        for (size_t i=0; i<lfsv.size(); ++i)
+          pattern.addLink(lfsv,i,lfsu,i);
+      }
+
+    private:
+
+      MassLumping _lumping;
+
     };
 
     //! \} group LocalOperator
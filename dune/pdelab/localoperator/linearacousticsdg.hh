@@ -15,6 +15,7 @@
 #include<dune/pdelab/localoperator/flags.hh>
 #include<dune/pdelab/localoperator/idefault.hh>
 #include<dune/pdelab/localoperator/defaultimp.hh>
+#include<dune/pdelab/localoperator/masslumping.hh>
 #include<dune/pdelab/finiteelement/localbasiscache.hh>
 
 #include"linearacousticsparameter.hh"
@@ -592,8 +593,8 @@ namespace Dune {
       // residual assembly flags
       enum { doAlphaVolume = true };
 
-      DGLinearAcousticsTemporalOperator (T& param_, int overintegration_=0)
-        : param(param_), overintegration(overintegration_), cache(20)
+      DGLinearAcousticsTemporalOperator (T& param_, int overintegration_=0, MassLumping lumping_=MassLumping::none)
+        : param(param_), overintegration(overintegration_), lumping(lumping_), cache(20)
       {}
 
       // define sparsity pattern of operator representation
@@ -607,10 +608,14 @@ namespace Dune {
         if (TypeTree::degree(lfsv)!=dim+1)
           DUNE_THROW(Dune::Exception,"need exactly dim+1 components!");
 
+        // a lumped mass matrix is diagonal
         for (size_t k=0; k<TypeTree::degree(lfsv); k++)
           for (size_t i=0; i<lfsv.child(k).size(); ++i)
-            for (size_t j=0; j<lfsu.child(k).size(); ++j)
-              pattern.addLink(lfsv.child(k),i,lfsu.child(k),j);
+            if (lumping != MassLumping::none)
+              pattern.addLink(lfsv.child(k),i,lfsu.child(k),i);
+            else
+              for (size_t j=0; j<lfsu.child(k).size(); ++j)
+                pattern.addLink(lfsv.child(k),i,lfsu.child(k),j);
       }
 
       // volume integral depending on test and ansatz functions
@@ -636,6 +641,17 @@ namespace Dune {
         // loop over quadrature points
         const int order = dgspace.finiteElement().localBasis().order();
         const int intorder = overintegration+2*order;
+
+        // lumped mass matrix, the same for all components
+        if (lumping != MassLumping::none)
+          {
+            std::vector<RF> diagonal;
+            lumpedMassDiagonal(geo,dgspace.finiteElement().localBasis(),lumping,intorder,diagonal);
+            for (size_type k=0; k<=dim; k++) // for all components
+              for (size_type i=0; i<dgspace.size(); i++) // for all test functions of this component
+                r.accumulate(lfsv.child(k),i, diagonal[i]*x(lfsv.child(k),i));
+            return;
+          }
         for (const auto& ip : quadratureRule(geo,intorder))
           {
             // evaluate basis functions
@@ -663,6 +679,8 @@ namespace Dune {
         // get types
         using namespace Indices;
         using DGSpace = TypeTree::Child<LFSV,_0>;
+        using RF = typename DGSpace::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType;
         using size_type = typename DGSpace::Traits::SizeType;
 
         // get local function space that is identical for all components
@@ -674,6 +692,17 @@ namespace Dune {
         // loop over quadrature points
         const int order = dgspace.finiteElement().localBasis().order();
         const int intorder = overintegration+2*order;
+
+        // lumped mass matrix, the same for all components
+        if (lumping != MassLumping::none)
+          {
+            std::vector<RF> diagonal;
+            lumpedMassDiagonal(geo,dgspace.finiteElement().localBasis(),lumping,intorder,diagonal);
+            for (size_type k=0; k<=dim; k++) // for all components
+              for (size_type i=0; i<dgspace.size(); i++) // for all test functions of this component
+                mat.accumulate(lfsv.child(k),i,lfsu.child(k),i, diagonal[i]);
+            return;
+          }
         for (const auto& ip : quadratureRule(geo,intorder))
           {
             // evaluate basis functions
@@ -691,6 +720,7 @@ namespace Dune {
     private:
       T& param;
       int overintegration;
+      MassLumping lumping;
       using LocalBasisType = typename FEM::Traits::FiniteElementType::Traits::LocalBasisType;
       using Cache = Dune::PDELab::LocalBasisCache<LocalBasisType>;
       std::vector<Cache> cache;
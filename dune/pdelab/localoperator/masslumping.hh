@@ -0,0 +1,95 @@
+// -*- tab-width: 2; indent-tabs-mode: nil -*-
+#ifndef DUNE_PDELAB_LOCALOPERATOR_MASSLUMPING_HH
+#define DUNE_PDELAB_LOCALOPERATOR_MASSLUMPING_HH
+
+#include <algorithm>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/geometry/quadraturerules.hh>
+
+#include <dune/pdelab/common/quadraturerules.hh>
+
+namespace Dune {
+  namespace PDELab {
+
+    //! \addtogroup LocalOperator
+    //! \ingroup PDELab
+    //! \{
+
+    //! Approximations of the mass matrix by a diagonal matrix.
+    /**
+     * Temporal local operators with a lumped mass matrix only add diagonal entries to the
+     * sparsity pattern, so the jacobian assembled by ExplicitOneStepMethod has a single entry
+     * per row and ISTLBackend_SEQ_ExplicitDiagonal inverts it exactly by scaling.
+     */
+    enum class MassLumping
+    {
+      //! Use the consistent mass matrix.
+      none,
+      //! Move the sum of each row of the consistent mass matrix to its diagonal.
+      rowSum,
+      //! Integrate with the Gauss-Lobatto rule matching the polynomial degree and drop the off-diagonal entries.
+      /**
+       * For Lagrange bases with Gauss-Lobatto nodes, e.g. Q1 or QkDGLocalFiniteElementMap with
+       * QkDGBasisPolynomial::lobatto,
+       * the nodal quadrature yields a diagonal mass matrix, so nothing is dropped. Only cube
+       * cells are supported.
+       */
+      nodal
+    };
+
+    //! Computes the diagonal of the lumped mass matrix of a scalar local basis on a cell.
+    /**
+     * \param geo       The geometry of the cell
+     * \param basis     The local basis
+     * \param lumping   The lumping method, must not be MassLumping::none
+     * \param intorder  The quadrature order used for MassLumping::rowSum
+     * \param diagonal  Receives the diagonal entries
+     */
+    template<typename Geometry, typename LocalBasis, typename RF>
+    void lumpedMassDiagonal(const Geometry& geo, const LocalBasis& basis, MassLumping lumping,
+                            int intorder, std::vector<RF>& diagonal)
+    {
+      using RangeType = typename LocalBasis::Traits::RangeType;
+      std::vector<RangeType> phi(basis.size());
+      diagonal.assign(basis.size(),0.0);
+
+      if (lumping == MassLumping::rowSum)
+        {
+          for (const auto& qp : quadratureRule(geo,intorder))
+            {
+              basis.evaluateFunction(qp.position(),phi);
+              RangeType sum(0.0);
+              for (std::size_t j=0; j<basis.size(); j++)
+                sum += phi[j];
+              auto factor = qp.weight() * geo.integrationElement(qp.position());
+              for (std::size_t i=0; i<basis.size(); i++)
+                diagonal[i] += (phi[i]*sum)*factor;
+            }
+          return;
+        }
+
+      if (lumping != MassLumping::nodal)
+        DUNE_THROW(Dune::Exception,"lumpedMassDiagonal() requires a lumping method");
+      if (!geo.type().isCube())
+        DUNE_THROW(Dune::NotImplemented,"Nodal mass lumping is only implemented for cube cells");
+
+      // the Gauss-Lobatto rule with k+1 points per direction is exact up to order 2k-1
+      const int order = std::max(2*int(basis.order())-1,1);
+      for (const auto& qp : quadratureRule(geo,order,QuadratureType::GaussLobatto))
+        {
+          basis.evaluateFunction(qp.position(),phi);
+          auto factor = qp.weight() * geo.integrationElement(qp.position());
+          for (std::size_t i=0; i<basis.size(); i++)
+            diagonal[i] += (phi[i]*phi[i])*factor;
+        }
+    }
+
+    //! \} group LocalOperator
+
+  } // namespace PDELab
+} // namespace Dune
+
+#endif // DUNE_PDELAB_LOCALOPERATOR_MASSLUMPING_HH
@@ -15,6 +15,7 @@
 #include<dune/pdelab/common/geometrywrapper.hh>
 #include<dune/pdelab/finiteelement/localbasiscache.hh>
 #include<dune/pdelab/localoperator/defaultimp.hh>
+#include<dune/pdelab/localoperator/masslumping.hh>
 #include<dune/pdelab/localoperator/flags.hh>
 #include<dune/pdelab/localoperator/idefault.hh>
 #include<dune/pdelab/localoperator/pattern.hh>
@@ -790,8 +791,8 @@ namespace Dune {
       // residual assembly flags
       enum { doAlphaVolume = true };
 
-      DGMaxwellTemporalOperator (T& param_, int overintegration_=0)
-        : param(param_), overintegration(overintegration_), cache(20)
+      DGMaxwellTemporalOperator (T& param_, int overintegration_=0, MassLumping lumping_=MassLumping::none)
+        : param(param_), overintegration(overintegration_), lumping(lumping_), cache(20)
       {}
 
       // define sparsity pattern of operator representation
@@ -803,10 +804,14 @@ namespace Dune {
         static_assert(TypeTree::StaticDegree<LFSU>::value==TypeTree::StaticDegree<LFSV>::value, "need U=V!");
         static_assert(TypeTree::StaticDegree<LFSV>::value==dim*2, "need exactly dim*2 components!");
 
+        // a lumped mass matrix is diagonal
         for (size_t k=0; k<TypeTree::degree(lfsv); k++)
           for (size_t i=0; i<lfsv.child(k).size(); ++i)
-            for (size_t j=0; j<lfsu.child(k).size(); ++j)
-              pattern.addLink(lfsv.child(k),i,lfsu.child(k),j);
+            if (lumping != MassLumping::none)
+              pattern.addLink(lfsv.child(k),i,lfsu.child(k),i);
+            else
+              for (size_t j=0; j<lfsu.child(k).size(); ++j)
+                pattern.addLink(lfsv.child(k),i,lfsu.child(k),j);
       }
 
       // volume integral depending on test and ansatz functions
@@ -832,6 +837,17 @@ namespace Dune {
         // loop over quadrature points
         const int order = dgspace.finiteElement().localBasis().order();
         const int intorder = overintegration+2*order;
+
+        // lumped mass matrix, the same for all components
+        if (lumping != MassLumping::none)
+          {
+            std::vector<RF> diagonal;
+            lumpedMassDiagonal(geo,dgspace.finiteElement().localBasis(),lumping,intorder,diagonal);
+            for (size_type k=0; k<dim*2; k++) // for all components
+              for (size_type i=0; i<dgspace.size(); i++) // for all test functions of this component
+                r.accumulate(lfsv.child(k),i,diagonal[i]*x(lfsv.child(k),i));
+            return;
+          }
         for (const auto& qp : quadratureRule(geo,intorder))
           {
             // evaluate basis functions
@@ -860,6 +876,8 @@ namespace Dune {
         // Define types
         using namespace Indices;
         using DGSpace = TypeTree::Child<LFSV,0>;
+        using RF = typename DGSpace::Traits::FiniteElementType::
+          Traits::LocalBasisType::Traits::RangeFieldType;
         using size_type = typename DGSpace::Traits::SizeType;
 
         // Get local function space that is identical for all components
@@ -871,6 +889,17 @@ namespace Dune {
         // Loop over quadrature points
         const int order = dgspace.finiteElement().localBasis().order();
         const int intorder = overintegration+2*order;
+
+        // Lumped mass matrix, the same for all components
+        if (lumping != MassLumping::none)
+          {
+            std::vector<RF> diagonal;
+            lumpedMassDiagonal(geo,dgspace.finiteElement().localBasis(),lumping,intorder,diagonal);
+            for (size_type k=0; k<dim*2; k++) // for all components
+              for (size_type i=0; i<dgspace.size(); i++) // for all test functions of this component
+                mat.accumulate(lfsv.child(k),i,lfsu.child(k),i,diagonal[i]);
+            return;
+          }
         for (const auto& qp : quadratureRule(geo,intorder))
           {
             // Evaluate basis functions
@@ -888,6 +917,7 @@ namespace Dune {
     private:
       T& param;
       int overintegration;
+      MassLumping lumping;
       typedef typename FEM::Traits::FiniteElementType::Traits::LocalBasisType LocalBasisType;
       typedef Dune::PDELab::LocalBasisCache<LocalBasisType> Cache;
       std::vector<Cache> cache;
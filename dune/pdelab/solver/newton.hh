@@ -3,6 +3,8 @@
 #ifndef DUNE_PDELAB_SOLVER_NEWTON_HH
 #define DUNE_PDELAB_SOLVER_NEWTON_HH
 
+#include <tuple>
+
 #include <dune/common/exceptions.hh>
 #include <dune/common/ios_state.hh>
 
@@ -44,6 +46,71 @@ namespace Dune::PDELab
     {
       setLinearSystemReuse(solver_backend, reuse, HasSetReuse<T>());
     }
+
+    // Check whether a grid operator can assemble residual and Jacobian in a single grid traversal
+    template<typename T1, typename = void>
+    struct HasResidualAndJacobian
+      : std::false_type
+    {};
+
+    template<typename T>
+    struct HasResidualAndJacobian<T, decltype(std::declval<const T>().residual_and_jacobian(
+                                                std::declval<const typename T::Traits::Domain&>(),
+                                                std::declval<typename T::Traits::Range&>(),
+                                                std::declval<typename T::Traits::Jacobian&>()), void())>
+      : std::true_type
+    {};
+
+    template<typename GO>
+    inline bool residualAndJacobian(const GO& gridOperator, const typename GO::Traits::Domain& solution,
+                                    typename GO::Traits::Range& residual, typename GO::Traits::Jacobian& jacobian,
+                                    std::true_type)
+    {
+      gridOperator.residual_and_jacobian(solution, residual, jacobian);
+      return true;
+    }
+
+    template<typename GO>
+    inline bool residualAndJacobian(const GO&, const typename GO::Traits::Domain&,
+                                    typename GO::Traits::Range&, typename GO::Traits::Jacobian&,
+                                    std::false_type)
+    {
+      return false;
+    }
+
+    // Record the state of a grid operator's Jacobian and check later whether it would
+    // still be the same, if the grid operator supports this
+    template<typename T1, typename = void>
+    struct JacobianState
+    {
+      using type = std::tuple<>;
+
+      static type get(const T1&)
+      {
+        return type();
+      }
+
+      static bool unchanged(const T1&, const type&)
+      {
+        return false;
+      }
+    };
+
+    template<typename T>
+    struct JacobianState<T, decltype(std::declval<const T>().jacobianUnchanged(std::declval<const T>().jacobianState()), void())>
+    {
+      using type = decltype(std::declval<const T>().jacobianState());
+
+      static type get(const T& gridOperator)
+      {
+        return gridOperator.jacobianState();
+      }
+
+      static bool unchanged(const T& gridOperator, const type& state)
+      {
+        return gridOperator.jacobianUnchanged(state);
+      }
+    };
   }
 
 
@@ -110,11 +177,27 @@ namespace Dune::PDELab
           // Interpolate periodic constraints / hanging nodes
           _gridOperator.localAssembler().backtransform(solution);
         }
-        if (_verbosity>=3)
-              std::cout << "      Reassembling matrix..." << std::endl;
-        *_jacobian = Real(0.0);
-        _gridOperator.jacobian(solution, *_jacobian);
-        _reassembled = true;
+        if (_jacobianAssembled){
+          // The matrix has already been assembled together with the residual in updateDefect()
+          if (_verbosity>=3)
+            std::cout << "      Matrix was assembled with the residual" << std::endl;
+          _reassembled = true;
+        }
+        else if (jacobianReusable()){
+          // The grid operator guarantees that the matrix would not change, so the
+          // linear solver may also keep its preconditioner
+          if (_verbosity>=3)
+            std::cout << "      Reusing unchanged matrix" << std::endl;
+        }
+        else{
+          if (_verbosity>=3)
+                std::cout << "      Reassembling matrix..." << std::endl;
+          *_jacobian = Real(0.0);
+          _gridOperator.jacobian(solution, *_jacobian);
+          _jacobianState = Impl::JacobianState<GridOperator>::get(_gridOperator);
+          _jacobianValid = true;
+          _reassembled = true;
+        }
       }
 
       _linearReduction = _minLinearReduction;
@@ -186,6 +269,15 @@ namespace Dune::PDELab
         };
       auto start_solve = Clock::now();
 
+      //=================================================
+      // Set up Jacobian matrix (it may be assembled with
+      // the initial defect if fused assembly is enabled)
+      //=================================================
+      if (not _jacobian){
+        _jacobian = std::make_shared<Jacobian>(_gridOperator);
+        _jacobianValid = false;
+      }
+
       //=========================
       // Calculate initial defect
       //=========================
@@ -198,12 +290,6 @@ namespace Dune::PDELab
                   << std::setw(12) << std::setprecision(4) << std::scientific
                   << _result.defect << std::endl;
 
-      //==========================
-      // Calculate Jacobian matrix
-      //==========================
-      if (not _jacobian)
-        _jacobian = std::make_shared<Jacobian>(_gridOperator);
-
       //=========================
       // Nonlinear iteration loop
       //=========================
@@ -316,8 +402,10 @@ namespace Dune::PDELab
                   << "   (" << std::setprecision(4) << _result.elapsed << "s)"
                   << std::endl;
 
-      if (not _keepMatrix)
+      if (not _keepMatrix){
         _jacobian.reset();
+        _jacobianValid = false;
+      }
     }
 
     //! Update _residual and defect in _result
@@ -335,8 +423,20 @@ namespace Dune::PDELab
         _gridOperator.localAssembler().backtransform(solution);
       }
 
+      // If the matrix is reassembled in every step anyway, assemble it in the same
+      // grid traversal as the residual
       _residual = 0.0;
-      _gridOperator.residual(solution, _residual);
+      _jacobianAssembled = false;
+      if (fusedAssembly() and not jacobianReusable()){
+        *_jacobian = Real(0.0);
+        _jacobianAssembled = Impl::residualAndJacobian(_gridOperator, solution, _residual, *_jacobian,
+                                                       Impl::HasResidualAndJacobian<GridOperator>());
+        _jacobianValid = _jacobianAssembled;
+        if (_jacobianAssembled)
+          _jacobianState = Impl::JacobianState<GridOperator>::get(_gridOperator);
+      }
+      else
+        _gridOperator.residual(solution, _residual);
 
       // Use the maximum norm as a stopping criterion. This helps loosen the tolerance
       // when solving for stationary solutions of nonlinear time-dependent problems.
@@ -405,6 +505,27 @@ namespace Dune::PDELab
       _hangingNodeModifications = b;
     }
 
+    /** \brief Set whether to assemble residual and Jacobian in a single grid traversal
+     *
+     * If enabled, the grid operator provides residual_and_jacobian() and the
+     * Jacobian is reassembled in every step (i.e. the reassemble threshold is
+     * not positive), the Jacobian is assembled together with each residual in
+     * updateDefect(). This saves one grid traversal per Newton step, but also
+     * assembles the Jacobian for the last residual and for every rejected
+     * line search step.
+     */
+    void setFusedAssembly(bool b)
+    {
+      _fusedAssembly = b;
+    }
+
+    //! Return whether residual and Jacobian are assembled in a single grid traversal
+    bool fusedAssembly() const
+    {
+      return _fusedAssembly and _jacobian and _reassembleThreshold <= 0.0
+        and Impl::HasResidualAndJacobian<GridOperator>::value;
+    }
+
 
     //! Return whether the jacobian matrix is kept across calls to apply().
     bool keepMatrix() const
@@ -417,6 +538,21 @@ namespace Dune::PDELab
     {
       if(_jacobian)
         _jacobian.reset();
+      _jacobianValid = false;
+    }
+
+    /** \brief Return whether the stored Jacobian matrix can be used without reassembling it
+     *
+     * This is the case if the grid operator provides jacobianState() and jacobianUnchanged()
+     * and confirms that the state recorded when this solver assembled its matrix is still
+     * current, see OneStepGridOperator::setConstantJacobian(). The matrix is then kept
+     * across Newton iterations and calls to apply(), provided keepMatrix() is set, and the
+     * linear solver backend is asked to reuse its preconditioner.
+     */
+    bool jacobianReusable() const
+    {
+      return _jacobian and _jacobianValid
+        and Impl::JacobianState<GridOperator>::unchanged(_gridOperator, _jacobianState);
     }
 
     /**\brief Set the minimal reduction in the linear solver
@@ -488,6 +624,7 @@ namespace Dune::PDELab
       _keepMatrix = parameterTree.get("KeepMatrix", _keepMatrix);
       _useMaxNorm = parameterTree.get("UseMaxNorm", _useMaxNorm);
       _hangingNodeModifications = parameterTree.get("HangingNodeModifications", _hangingNodeModifications);
+      _fusedAssembly = parameterTree.get("FusedAssembly", _fusedAssembly);
       _minLinearReduction = parameterTree.get("MinLinearReduction", _minLinearReduction);
       _fixedLinearReduction = parameterTree.get("FixedLinearReduction", _fixedLinearReduction);
       _reassembleThreshold = parameterTree.get("ReassembleThreshold", _reassembleThreshold);
@@ -597,6 +734,15 @@ namespace Dune::PDELab
 
     // Remember if jacobian was reassembled in prepareStep
     bool _reassembled = true; // will be set in prepare step
+
+    // Remember if jacobian was assembled together with the residual in updateDefect
+    bool _jacobianAssembled = false;
+
+    // Remember if _jacobian holds an assembled matrix
+    bool _jacobianValid = false;
+
+    // State of the grid operator when _jacobian was assembled
+    typename Impl::JacobianState<GridOperator>::type _jacobianState = {};
     Real _linearReduction = 0.0; // will be set in prepare step
 
     // User parameters
@@ -609,6 +755,9 @@ namespace Dune::PDELab
     // Special treatment if we have hanging nodes
     bool _hangingNodeModifications = false;
 
+    // Assemble residual and jacobian in a single grid traversal
+    bool _fusedAssembly = false;
+
     // User parameters for prepareStep()
     Real _minLinearReduction = 1e-3;
     bool _fixedLinearReduction = false;
@@ -0,0 +1,147 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_PDELAB_TEST_JUMPPENALTYLAPLACE_HH
+#define DUNE_PDELAB_TEST_JUMPPENALTYLAPLACE_HH
+
+#include<vector>
+
+#include<dune/common/fvector.hh>
+
+#include<dune/pdelab/common/quadraturerules.hh>
+#include<dune/pdelab/localoperator/defaultimp.hh>
+#include<dune/pdelab/localoperator/flags.hh>
+#include<dune/pdelab/localoperator/numericaljacobian.hh>
+#include<dune/pdelab/localoperator/numericaljacobianapply.hh>
+#include<dune/pdelab/localoperator/pattern.hh>
+
+/** a local operator for -\Delta u + c u = f with an additional penalty on the jumps of u
+ *
+ * The operator evaluates the local basis directly instead of going through a
+ * LocalBasisCache, so it does not modify any state during assembly and can be
+ * used to test threaded assemblers. For conforming spaces the jump term
+ * vanishes for the solution, but it still couples neighboring cells in the
+ * jacobian and thus exercises all skeleton code paths.
+ */
+class JumpPenaltyLaplace :
+  public Dune::PDELab::NumericalJacobianVolume<JumpPenaltyLaplace>,
+  public Dune::PDELab::NumericalJacobianSkeleton<JumpPenaltyLaplace>,
+  public Dune::PDELab::NumericalJacobianApplyVolume<JumpPenaltyLaplace>,
+  public Dune::PDELab::NumericalJacobianApplySkeleton<JumpPenaltyLaplace>,
+  public Dune::PDELab::FullVolumePattern,
+  public Dune::PDELab::FullSkeletonPattern,
+  public Dune::PDELab::LocalOperatorDefaultFlags
+{
+  double reaction;
+  double penalty;
+
+public:
+  // pattern assembly flags
+  enum { doPatternVolume = true };
+  enum { doPatternSkeleton = true };
+
+  // residual assembly flags
+  enum { doAlphaVolume = true };
+  enum { doAlphaSkeleton = true };
+  enum { doLambdaVolume = true };
+
+  JumpPenaltyLaplace (double reaction_ = 1.0, double penalty_ = 1.0)
+    : reaction(reaction_), penalty(penalty_)
+  {}
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    using LocalBasis = typename LFSU::Traits::FiniteElementType::Traits::LocalBasisType;
+    using RangeType = typename LocalBasis::Traits::RangeType;
+    using JacobianType = typename LocalBasis::Traits::JacobianType;
+    using RF = typename LocalBasis::Traits::RangeFieldType;
+    constexpr int dim = EG::Entity::dimension;
+
+    std::vector<RangeType> phi(lfsu.size());
+    std::vector<JacobianType> js(lfsu.size());
+    std::vector<Dune::FieldVector<RF,dim> > gradphi(lfsu.size());
+
+    auto geo = eg.geometry();
+    const int order = 2*lfsu.finiteElement().localBasis().order();
+    for (const auto& ip : Dune::PDELab::quadratureRule(geo,order))
+      {
+        lfsu.finiteElement().localBasis().evaluateFunction(ip.position(),phi);
+        lfsu.finiteElement().localBasis().evaluateJacobian(ip.position(),js);
+        const auto S = geo.jacobianInverseTransposed(ip.position());
+        for (std::size_t i=0; i<lfsu.size(); i++)
+          S.mv(js[i][0],gradphi[i]);
+
+        RF u = 0.0;
+        Dune::FieldVector<RF,dim> gradu(0.0);
+        for (std::size_t i=0; i<lfsu.size(); i++)
+          {
+            u += x(lfsu,i)*phi[i];
+            gradu.axpy(x(lfsu,i),gradphi[i]);
+          }
+
+        const RF factor = ip.weight()*geo.integrationElement(ip.position());
+        for (std::size_t i=0; i<lfsv.size(); i++)
+          r.accumulate(lfsv,i,(gradu*gradphi[i] + reaction*u*phi[i])*factor);
+      }
+  }
+
+  template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_skeleton (const IG& ig,
+                       const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+                       const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+                       R& r_s, R& r_n) const
+  {
+    using LocalBasis = typename LFSU::Traits::FiniteElementType::Traits::LocalBasisType;
+    using RangeType = typename LocalBasis::Traits::RangeType;
+    using RF = typename LocalBasis::Traits::RangeFieldType;
+
+    std::vector<RangeType> phi_s(lfsu_s.size());
+    std::vector<RangeType> phi_n(lfsu_n.size());
+
+    auto geo = ig.geometry();
+    auto geo_in_inside = ig.geometryInInside();
+    auto geo_in_outside = ig.geometryInOutside();
+    const int order = 2*lfsu_s.finiteElement().localBasis().order();
+    for (const auto& ip : Dune::PDELab::quadratureRule(geo,order))
+      {
+        lfsu_s.finiteElement().localBasis().evaluateFunction(geo_in_inside.global(ip.position()),phi_s);
+        lfsu_n.finiteElement().localBasis().evaluateFunction(geo_in_outside.global(ip.position()),phi_n);
+
+        RF u_s = 0.0;
+        for (std::size_t i=0; i<lfsu_s.size(); i++)
+          u_s += x_s(lfsu_s,i)*phi_s[i];
+        RF u_n = 0.0;
+        for (std::size_t i=0; i<lfsu_n.size(); i++)
+          u_n += x_n(lfsu_n,i)*phi_n[i];
+
+        const RF jump = penalty*(u_s-u_n)*ip.weight()*geo.integrationElement(ip.position());
+        for (std::size_t i=0; i<lfsv_s.size(); i++)
+          r_s.accumulate(lfsv_s,i,jump*phi_s[i]);
+        for (std::size_t i=0; i<lfsv_n.size(); i++)
+          r_n.accumulate(lfsv_n,i,-jump*phi_n[i]);
+      }
+  }
+
+  template<typename EG, typename LFSV, typename R>
+  void lambda_volume (const EG& eg, const LFSV& lfsv, R& r) const
+  {
+    using LocalBasis = typename LFSV::Traits::FiniteElementType::Traits::LocalBasisType;
+    using RangeType = typename LocalBasis::Traits::RangeType;
+
+    std::vector<RangeType> phi(lfsv.size());
+
+    auto geo = eg.geometry();
+    const int order = 2*lfsv.finiteElement().localBasis().order();
+    for (const auto& ip : Dune::PDELab::quadratureRule(geo,order))
+      {
+        lfsv.finiteElement().localBasis().evaluateFunction(ip.position(),phi);
+        const auto f = geo.global(ip.position()).two_norm2();
+        const auto factor = ip.weight()*geo.integrationElement(ip.position());
+        for (std::size_t i=0; i<lfsv.size(); i++)
+          r.accumulate(lfsv,i,-f*phi[i]*factor);
+      }
+  }
+};
+
+#endif // DUNE_PDELAB_TEST_JUMPPENALTYLAPLACE_HH
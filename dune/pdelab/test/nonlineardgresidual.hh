@@ -0,0 +1,185 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifndef DUNE_PDELAB_TEST_NONLINEARDGRESIDUAL_HH
+#define DUNE_PDELAB_TEST_NONLINEARDGRESIDUAL_HH
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/pdelab/common/quadraturerules.hh>
+#include <dune/pdelab/localoperator/flags.hh>
+#include <dune/pdelab/localoperator/pattern.hh>
+
+// Residual of the nonlinear problem -div((1+u^2) grad u) + div(b u^2/2) + sin(u) = 0 discretized with
+// symmetric interior penalty DG. All methods are generic in the value type of the coefficients.
+class NonlinearDGResidual
+  : public Dune::PDELab::FullVolumePattern,
+    public Dune::PDELab::FullSkeletonPattern,
+    public Dune::PDELab::LocalOperatorDefaultFlags
+{
+public:
+  enum { doPatternVolume = true };
+  enum { doPatternSkeleton = true };
+
+  enum { doAlphaVolume = true };
+  enum { doAlphaSkeleton = true };
+  enum { doAlphaBoundary = true };
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    using RF = typename X::value_type;
+    using std::sin;
+    const int dim = EG::Entity::dimension;
+
+    auto geo = eg.geometry();
+    for (const auto& ip : Dune::PDELab::quadratureRule(geo,2))
+      {
+        auto gradphi = physicalGradients(lfsu,geo,ip.position());
+        std::vector<Dune::FieldVector<double,1> > phi(lfsu.size());
+        lfsu.finiteElement().localBasis().evaluateFunction(ip.position(),phi);
+
+        RF u = 0.0;
+        std::array<RF,dim> gradu;
+        gradu.fill(RF(0.0));
+        for (std::size_t j = 0; j < lfsu.size(); ++j)
+          {
+            u += x(lfsu,j)*phi[j][0];
+            for (int d = 0; d < dim; ++d)
+              gradu[d] += x(lfsu,j)*gradphi[j][d];
+          }
+
+        const double factor = ip.weight()*geo.integrationElement(ip.position());
+        for (std::size_t i = 0; i < lfsv.size(); ++i)
+          {
+            RF value = sin(u)*phi[i][0];
+            for (int d = 0; d < dim; ++d)
+              value += ((1.0+u*u)*gradu[d] - 0.5*u*u*b[d])*gradphi[i][d];
+            r.accumulate(lfsv,i,value*factor);
+          }
+      }
+  }
+
+  template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_skeleton (const IG& ig,
+                       const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+                       const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+                       R& r_s, R& r_n) const
+  {
+    using RF = typename X::value_type;
+    const int dim = IG::Entity::dimension;
+
+    auto geo = ig.geometry();
+    auto geo_s = ig.inside().geometry();
+    auto geo_n = ig.outside().geometry();
+    const auto n = ig.centerUnitOuterNormal();
+    const double h = std::min(geo_s.volume(),geo_n.volume()) / geo.volume();
+    double bn = 0.0;
+    for (int d = 0; d < dim; ++d)
+      bn += b[d]*n[d];
+
+    for (const auto& ip : Dune::PDELab::quadratureRule(geo,2))
+      {
+        auto local_s = ig.geometryInInside().global(ip.position());
+        auto local_n = ig.geometryInOutside().global(ip.position());
+        auto gradphi_s = physicalGradients(lfsu_s,geo_s,local_s);
+        auto gradphi_n = physicalGradients(lfsu_n,geo_n,local_n);
+        std::vector<Dune::FieldVector<double,1> > phi_s(lfsu_s.size()), phi_n(lfsu_n.size());
+        lfsu_s.finiteElement().localBasis().evaluateFunction(local_s,phi_s);
+        lfsu_n.finiteElement().localBasis().evaluateFunction(local_n,phi_n);
+
+        RF u_s = 0.0, u_n = 0.0, flux_s = 0.0, flux_n = 0.0;
+        for (std::size_t j = 0; j < lfsu_s.size(); ++j)
+          {
+            u_s += x_s(lfsu_s,j)*phi_s[j][0];
+            for (int d = 0; d < dim; ++d)
+              flux_s += x_s(lfsu_s,j)*gradphi_s[j][d]*n[d];
+          }
+        for (std::size_t j = 0; j < lfsu_n.size(); ++j)
+          {
+            u_n += x_n(lfsu_n,j)*phi_n[j][0];
+            for (int d = 0; d < dim; ++d)
+              flux_n += x_n(lfsu_n,j)*gradphi_n[j][d]*n[d];
+          }
+
+        // averaged diffusive flux, penalty and central convective flux
+        const RF mean_flux = 0.5*((1.0+u_s*u_s)*flux_s + (1.0+u_n*u_n)*flux_n);
+        const RF jump = u_s - u_n;
+        const RF numerical_flux = -mean_flux + penalty/h*jump + 0.25*(u_s*u_s + u_n*u_n)*bn;
+
+        const double factor = ip.weight()*geo.integrationElement(ip.position());
+        for (std::size_t i = 0; i < lfsv_s.size(); ++i)
+          {
+            double normal_gradient = 0.0;
+            for (int d = 0; d < dim; ++d)
+              normal_gradient += gradphi_s[i][d]*n[d];
+            r_s.accumulate(lfsv_s,i,(numerical_flux*phi_s[i][0] - 0.5*jump*normal_gradient)*factor);
+          }
+        for (std::size_t i = 0; i < lfsv_n.size(); ++i)
+          {
+            double normal_gradient = 0.0;
+            for (int d = 0; d < dim; ++d)
+              normal_gradient += gradphi_n[i][d]*n[d];
+            r_n.accumulate(lfsv_n,i,(-numerical_flux*phi_n[i][0] - 0.5*jump*normal_gradient)*factor);
+          }
+      }
+  }
+
+  template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_boundary (const IG& ig,
+                       const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+                       R& r_s) const
+  {
+    using RF = typename X::value_type;
+    const int dim = IG::Entity::dimension;
+
+    auto geo = ig.geometry();
+    auto geo_s = ig.inside().geometry();
+    const auto n = ig.centerUnitOuterNormal();
+    const double h = geo_s.volume() / geo.volume();
+    double bn = 0.0;
+    for (int d = 0; d < dim; ++d)
+      bn += b[d]*n[d];
+
+    for (const auto& ip : Dune::PDELab::quadratureRule(geo,2))
+      {
+        auto local_s = ig.geometryInInside().global(ip.position());
+        std::vector<Dune::FieldVector<double,1> > phi_s(lfsu_s.size());
+        lfsu_s.finiteElement().localBasis().evaluateFunction(local_s,phi_s);
+
+        RF u_s = 0.0;
+        for (std::size_t j = 0; j < lfsu_s.size(); ++j)
+          u_s += x_s(lfsu_s,j)*phi_s[j][0];
+
+        // weakly imposed homogeneous Dirichlet values and outflow
+        const RF numerical_flux = penalty/h*u_s + 0.5*u_s*u_s*(bn > 0.0 ? bn : 0.0);
+        const double factor = ip.weight()*geo.integrationElement(ip.position());
+        for (std::size_t i = 0; i < lfsv_s.size(); ++i)
+          r_s.accumulate(lfsv_s,i,numerical_flux*phi_s[i][0]*factor);
+      }
+  }
+
+private:
+
+  template<typename LFS, typename Geometry, typename Position>
+  static std::vector<Dune::FieldVector<double,Geometry::mydimension> >
+  physicalGradients (const LFS& lfs, const Geometry& geo, const Position& position)
+  {
+    std::vector<Dune::FieldMatrix<double,1,Geometry::mydimension> > js(lfs.size());
+    lfs.finiteElement().localBasis().evaluateJacobian(position,js);
+    const auto S = geo.jacobianInverseTransposed(position);
+    std::vector<Dune::FieldVector<double,Geometry::mydimension> > gradphi(lfs.size());
+    for (std::size_t i = 0; i < lfs.size(); ++i)
+      S.mv(js[i][0],gradphi[i]);
+    return gradphi;
+  }
+
+  const std::array<double,2> b = {{1.0,0.5}};
+  const double penalty = 3.0;
+};
+
+#endif // DUNE_PDELAB_TEST_NONLINEARDGRESIDUAL_HH
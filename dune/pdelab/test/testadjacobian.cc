@@ -0,0 +1,292 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <array>
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Residual of the nonlinear problem -div((1+u^2) grad u) + div(b u^2/2) + sin(u) = 0 discretized with
+// symmetric interior penalty DG. All methods are generic in the value type of the coefficients.
+class NonlinearDGResidual
+  : public Dune::PDELab::FullVolumePattern,
+    public Dune::PDELab::FullSkeletonPattern,
+    public Dune::PDELab::LocalOperatorDefaultFlags
+{
+public:
+  enum { doPatternVolume = true };
+  enum { doPatternSkeleton = true };
+
+  enum { doAlphaVolume = true };
+  enum { doAlphaSkeleton = true };
+  enum { doAlphaBoundary = true };
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    using RF = typename X::value_type;
+    using std::sin;
+    const int dim = EG::Entity::dimension;
+
+    auto geo = eg.geometry();
+    for (const auto& ip : Dune::PDELab::quadratureRule(geo,2))
+      {
+        auto gradphi = physicalGradients(lfsu,geo,ip.position());
+        std::vector<Dune::FieldVector<double,1> > phi(lfsu.size());
+        lfsu.finiteElement().localBasis().evaluateFunction(ip.position(),phi);
+
+        RF u = 0.0;
+        std::array<RF,dim> gradu;
+        gradu.fill(RF(0.0));
+        for (std::size_t j = 0; j < lfsu.size(); ++j)
+          {
+            u += x(lfsu,j)*phi[j][0];
+            for (int d = 0; d < dim; ++d)
+              gradu[d] += x(lfsu,j)*gradphi[j][d];
+          }
+
+        const double factor = ip.weight()*geo.integrationElement(ip.position());
+        for (std::size_t i = 0; i < lfsv.size(); ++i)
+          {
+            RF value = sin(u)*phi[i][0];
+            for (int d = 0; d < dim; ++d)
+              value += ((1.0+u*u)*gradu[d] - 0.5*u*u*b[d])*gradphi[i][d];
+            r.accumulate(lfsv,i,value*factor);
+          }
+      }
+  }
+
+  template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_skeleton (const IG& ig,
+                       const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+                       const LFSU& lfsu_n, const X& x_n, const LFSV& lfsv_n,
+                       R& r_s, R& r_n) const
+  {
+    using RF = typename X::value_type;
+    const int dim = IG::Entity::dimension;
+
+    auto geo = ig.geometry();
+    auto geo_s = ig.inside().geometry();
+    auto geo_n = ig.outside().geometry();
+    const auto n = ig.centerUnitOuterNormal();
+    const double h = std::min(geo_s.volume(),geo_n.volume()) / geo.volume();
+    double bn = 0.0;
+    for (int d = 0; d < dim; ++d)
+      bn += b[d]*n[d];
+
+    for (const auto& ip : Dune::PDELab::quadratureRule(geo,2))
+      {
+        auto local_s = ig.geometryInInside().global(ip.position());
+        auto local_n = ig.geometryInOutside().global(ip.position());
+        auto gradphi_s = physicalGradients(lfsu_s,geo_s,local_s);
+        auto gradphi_n = physicalGradients(lfsu_n,geo_n,local_n);
+        std::vector<Dune::FieldVector<double,1> > phi_s(lfsu_s.size()), phi_n(lfsu_n.size());
+        lfsu_s.finiteElement().localBasis().evaluateFunction(local_s,phi_s);
+        lfsu_n.finiteElement().localBasis().evaluateFunction(local_n,phi_n);
+
+        RF u_s = 0.0, u_n = 0.0, flux_s = 0.0, flux_n = 0.0;
+        for (std::size_t j = 0; j < lfsu_s.size(); ++j)
+          {
+            u_s += x_s(lfsu_s,j)*phi_s[j][0];
+            for (int d = 0; d < dim; ++d)
+              flux_s += x_s(lfsu_s,j)*gradphi_s[j][d]*n[d];
+          }
+        for (std::size_t j = 0; j < lfsu_n.size(); ++j)
+          {
+            u_n += x_n(lfsu_n,j)*phi_n[j][0];
+            for (int d = 0; d < dim; ++d)
+              flux_n += x_n(lfsu_n,j)*gradphi_n[j][d]*n[d];
+          }
+
+        // averaged diffusive flux, penalty and central convective flux
+        const RF mean_flux = 0.5*((1.0+u_s*u_s)*flux_s + (1.0+u_n*u_n)*flux_n);
+        const RF jump = u_s - u_n;
+        const RF numerical_flux = -mean_flux + penalty/h*jump + 0.25*(u_s*u_s + u_n*u_n)*bn;
+
+        const double factor = ip.weight()*geo.integrationElement(ip.position());
+        for (std::size_t i = 0; i < lfsv_s.size(); ++i)
+          {
+            double normal_gradient = 0.0;
+            for (int d = 0; d < dim; ++d)
+              normal_gradient += gradphi_s[i][d]*n[d];
+            r_s.accumulate(lfsv_s,i,(numerical_flux*phi_s[i][0] - 0.5*jump*normal_gradient)*factor);
+          }
+        for (std::size_t i = 0; i < lfsv_n.size(); ++i)
+          {
+            double normal_gradient = 0.0;
+            for (int d = 0; d < dim; ++d)
+              normal_gradient += gradphi_n[i][d]*n[d];
+            r_n.accumulate(lfsv_n,i,(-numerical_flux*phi_n[i][0] - 0.5*jump*normal_gradient)*factor);
+          }
+      }
+  }
+
+  template<typename IG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_boundary (const IG& ig,
+                       const LFSU& lfsu_s, const X& x_s, const LFSV& lfsv_s,
+                       R& r_s) const
+  {
+    using RF = typename X::value_type;
+    const int dim = IG::Entity::dimension;
+
+    auto geo = ig.geometry();
+    auto geo_s = ig.inside().geometry();
+    const auto n = ig.centerUnitOuterNormal();
+    const double h = geo_s.volume() / geo.volume();
+    double bn = 0.0;
+    for (int d = 0; d < dim; ++d)
+      bn += b[d]*n[d];
+
+    for (const auto& ip : Dune::PDELab::quadratureRule(geo,2))
+      {
+        auto local_s = ig.geometryInInside().global(ip.position());
+        std::vector<Dune::FieldVector<double,1> > phi_s(lfsu_s.size());
+        lfsu_s.finiteElement().localBasis().evaluateFunction(local_s,phi_s);
+
+        RF u_s = 0.0;
+        for (std::size_t j = 0; j < lfsu_s.size(); ++j)
+          u_s += x_s(lfsu_s,j)*phi_s[j][0];
+
+        // weakly imposed homogeneous Dirichlet values and outflow
+        const RF numerical_flux = penalty/h*u_s + 0.5*u_s*u_s*(bn > 0.0 ? bn : 0.0);
+        const double factor = ip.weight()*geo.integrationElement(ip.position());
+        for (std::size_t i = 0; i < lfsv_s.size(); ++i)
+          r_s.accumulate(lfsv_s,i,numerical_flux*phi_s[i][0]*factor);
+      }
+  }
+
+private:
+
+  template<typename LFS, typename Geometry, typename Position>
+  static std::vector<Dune::FieldVector<double,Geometry::mydimension> >
+  physicalGradients (const LFS& lfs, const Geometry& geo, const Position& position)
+  {
+    std::vector<Dune::FieldMatrix<double,1,Geometry::mydimension> > js(lfs.size());
+    lfs.finiteElement().localBasis().evaluateJacobian(position,js);
+    const auto S = geo.jacobianInverseTransposed(position);
+    std::vector<Dune::FieldVector<double,Geometry::mydimension> > gradphi(lfs.size());
+    for (std::size_t i = 0; i < lfs.size(); ++i)
+      S.mv(js[i][0],gradphi[i]);
+    return gradphi;
+  }
+
+  const std::array<double,2> b = {{1.0,0.5}};
+  const double penalty = 3.0;
+};
+
+// The residual with jacobians computed by automatic differentiation
+class ADNonlinearDG
+  : public NonlinearDGResidual,
+    public Dune::PDELab::ADJacobianVolume<ADNonlinearDG,4>,
+    public Dune::PDELab::ADJacobianSkeleton<ADNonlinearDG,8>,
+    public Dune::PDELab::ADJacobianBoundary<ADNonlinearDG,4>
+{};
+
+// The residual with jacobians computed by finite differences
+class NumericalNonlinearDG
+  : public NonlinearDGResidual,
+    public Dune::PDELab::NumericalJacobianVolume<NumericalNonlinearDG>,
+    public Dune::PDELab::NumericalJacobianSkeleton<NumericalNonlinearDG>,
+    public Dune::PDELab::NumericalJacobianBoundary<NumericalNonlinearDG>
+{};
+
+template<typename GV>
+bool testADJacobian(const GV& gv)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  MBE mbe(5);
+
+  using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,1,GV::dimension>;
+  FEM fem;
+  using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+  GFS gfs(gv,fem);
+  using CC = Dune::PDELab::EmptyTransformation;
+
+  ADNonlinearDG ad_lop;
+  using ADGO = Dune::PDELab::GridOperator<GFS,GFS,ADNonlinearDG,MBE,RF,RF,RF,CC,CC>;
+  ADGO ad_go(gfs,gfs,ad_lop,mbe);
+
+  NumericalNonlinearDG numerical_lop;
+  using NumericalGO = Dune::PDELab::GridOperator<GFS,GFS,NumericalNonlinearDG,MBE,RF,RF,RF,CC,CC>;
+  NumericalGO numerical_go(gfs,gfs,numerical_lop,mbe);
+
+  typename ADGO::Traits::Domain x(gfs,0.0);
+  auto f = [](const auto& p){ return std::sin(3.0*p[0])*std::cos(2.0*p[1]) + p[0]; };
+  Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gv,f),gfs,x);
+
+  bool passed = true;
+
+  // both operators share the residual
+  typename ADGO::Traits::Range r_ad(gfs,0.0), r_numerical(gfs,0.0);
+  ad_go.residual(x,r_ad);
+  numerical_go.residual(x,r_numerical);
+  r_numerical -= r_ad;
+  if (r_numerical.infinity_norm() > 1e-14 * std::max(r_ad.infinity_norm(),1.0))
+    {
+      std::cerr << "residuals differ by " << r_numerical.infinity_norm() << std::endl;
+      passed = false;
+    }
+
+  // the finite differences are only accurate up to the perturbation
+  typename ADGO::Traits::Jacobian a_ad(ad_go,0.0);
+  ad_go.jacobian(x,a_ad);
+  typename NumericalGO::Traits::Jacobian a_numerical(numerical_go,0.0);
+  numerical_go.jacobian(x,a_numerical);
+  auto& native_numerical = Dune::PDELab::Backend::native(a_numerical);
+  native_numerical -= Dune::PDELab::Backend::native(a_ad);
+  const double norm = Dune::PDELab::Backend::native(a_ad).frobenius_norm();
+  std::cout << "relative difference of AD and numerical jacobian: "
+            << native_numerical.frobenius_norm() / norm << std::endl;
+  if (native_numerical.frobenius_norm() > 1e-5 * norm)
+    passed = false;
+
+  // the AD jacobian matches central differences of the residual up to second order terms
+  typename ADGO::Traits::Domain z(gfs,0.0), xh(x);
+  auto g = [](const auto& p){ return p[0]*p[1] - 0.3; };
+  Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gv,g),gfs,z);
+  const double h = 1e-4;
+  xh.axpy(h,z);
+  typename ADGO::Traits::Range rh(gfs,0.0), az(gfs,0.0), rmh(gfs,0.0);
+  ad_go.residual(xh,rh);
+  xh.axpy(-2.0*h,z);
+  ad_go.residual(xh,rmh);
+  rh -= rmh;
+  rh *= 0.5/h;
+  Dune::PDELab::Backend::native(a_ad).mv(Dune::PDELab::Backend::native(z),Dune::PDELab::Backend::native(az));
+  rh -= az;
+  std::cout << "error of the directional derivative: " << rh.infinity_norm() << std::endl;
+  if (rh.infinity_norm() > 1e-6 * std::max(az.infinity_norm(),1.0))
+    passed = false;
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{8,6}});
+
+    return testADJacobian(grid.leafGridView()) ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
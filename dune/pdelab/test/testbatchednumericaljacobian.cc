@@ -0,0 +1,108 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+#include "nonlineardgresidual.hh"
+
+// The residual with jacobians computed by finite differences in batches of L lanes
+template<std::size_t L>
+class BatchedNonlinearDG
+  : public NonlinearDGResidual,
+    public Dune::PDELab::BatchedNumericalJacobianVolume<BatchedNonlinearDG<L>,L>,
+    public Dune::PDELab::BatchedNumericalJacobianSkeleton<BatchedNonlinearDG<L>,L>,
+    public Dune::PDELab::BatchedNumericalJacobianBoundary<BatchedNonlinearDG<L>,L>
+{};
+
+// The residual with jacobians computed by finite differences one column at a time
+class NumericalNonlinearDG
+  : public NonlinearDGResidual,
+    public Dune::PDELab::NumericalJacobianVolume<NumericalNonlinearDG>,
+    public Dune::PDELab::NumericalJacobianSkeleton<NumericalNonlinearDG>,
+    public Dune::PDELab::NumericalJacobianBoundary<NumericalNonlinearDG>
+{};
+
+// The batched evaluation performs the same perturbations as the column-wise one, so both
+// jacobians agree up to rounding amplified by the difference quotients, independent of the
+// number of lanes.
+template<std::size_t L, typename GFS, typename X, typename M>
+bool compareWithNumericalJacobian(const GFS& gfs, const X& x, const M& a)
+{
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using CC = Dune::PDELab::EmptyTransformation;
+  using LOP = BatchedNonlinearDG<L>;
+  LOP lop;
+  using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,double,double,double,CC,CC>;
+  GO go(gfs,gfs,lop,MBE(5));
+
+  typename GO::Traits::Jacobian a_batched(go,0.0);
+  go.jacobian(x,a_batched);
+  auto& native_batched = Dune::PDELab::Backend::native(a_batched);
+  native_batched -= Dune::PDELab::Backend::native(a);
+  const double difference = native_batched.frobenius_norm() / Dune::PDELab::Backend::native(a).frobenius_norm();
+  std::cout << L << " lanes: relative difference to the numerical jacobian: " << difference << std::endl;
+  return difference < 1e-7;
+}
+
+template<typename GV>
+bool testBatchedNumericalJacobian(const GV& gv)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+
+  using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,1,GV::dimension>;
+  FEM fem;
+  using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+  GFS gfs(gv,fem);
+  using CC = Dune::PDELab::EmptyTransformation;
+
+  NumericalNonlinearDG lop;
+  using GO = Dune::PDELab::GridOperator<GFS,GFS,NumericalNonlinearDG,MBE,RF,RF,RF,CC,CC>;
+  GO go(gfs,gfs,lop,MBE(5));
+
+  typename GO::Traits::Domain x(gfs,0.0);
+  auto f = [](const auto& p){ return std::sin(3.0*p[0])*std::cos(2.0*p[1]) + p[0]; };
+  Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gv,f),gfs,x);
+
+  typename GO::Traits::Jacobian a(go,0.0);
+  go.jacobian(x,a);
+
+  bool passed = true;
+  // a single perturbation per evaluation, batches not filling the last evaluation, and
+  // all columns of a cell or a face in a single evaluation
+  passed &= compareWithNumericalJacobian<2>(gfs,x,a);
+  passed &= compareWithNumericalJacobian<4>(gfs,x,a);
+  passed &= compareWithNumericalJacobian<9>(gfs,x,a);
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{8,6}});
+
+    return testBatchedNumericalJacobian(grid.leafGridView()) ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,128 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Integrates the heat equation with a DG discretization and Heun's method, once solving with the
+// assembled mass matrix in every stage and once with the inverse mass matrix cached by
+// ExplicitOneStepMethod, and compares the results. The structure of the cached inverse is
+// checked separately.
+template<typename FEM, typename LS, typename GV>
+bool testBlockDiagonalMassInverse(const GV& gv, const FEM& fem, bool diagonal, const std::string& name)
+{
+  using RF = double;
+  using Problem = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+  Problem problem;
+
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+  using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+  GFS gfs(gv,fem);
+
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using LOP = Dune::PDELab::ConvectionDiffusionDG<Problem,FEM>;
+  LOP lop(problem);
+  using TLOP = Dune::PDELab::L2;
+  TLOP tlop;
+  using GO0 = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF>;
+  GO0 go0(gfs,gfs,lop,MBE(5));
+  using GO1 = Dune::PDELab::GridOperator<GFS,GFS,TLOP,MBE,RF,RF,RF>;
+  GO1 go1(gfs,gfs,tlop,MBE(5));
+  using IGO = Dune::PDELab::OneStepGridOperator<GO0,GO1,false>;
+  IGO igo(go0,go1);
+
+  bool passed = true;
+
+  // structure of the cached inverse
+  using V = typename IGO::Traits::Domain;
+  V x(gfs,0.0);
+  Dune::PDELab::ConvectionDiffusionDirichletExtensionAdapter<Problem> g(gv,problem);
+  Dune::PDELab::interpolate(g,gfs,x);
+  typename GO1::Traits::Jacobian mass(go1,0.0);
+  go1.jacobian(x,mass);
+  Dune::PDELab::BlockDiagonalMassInverse<GFS,RF> mass_inverse;
+  mass_inverse.update(gfs,mass);
+  V Mx(gfs,0.0), y(gfs,0.0);
+  Dune::PDELab::Backend::native(mass).mv(Dune::PDELab::Backend::native(x),Dune::PDELab::Backend::native(Mx));
+  mass_inverse.solve(y,Mx);
+  y -= x;
+  passed &= mass_inverse.diagonal() == diagonal;
+  passed &= y.infinity_norm() < 1e-10 * x.infinity_norm();
+
+  // time integration with and without caching
+  Dune::PDELab::HeunParameter<RF> method;
+  LS ls;
+  using OSM = Dune::PDELab::ExplicitOneStepMethod<RF,IGO,LS,V,V>;
+  OSM osm(method,igo,ls);
+  osm.setVerbosityLevel(0);
+  OSM osm_cached(method,igo,ls);
+  osm_cached.setVerbosityLevel(0);
+  osm_cached.setMassInverseCaching(true);
+
+  V xold(x), xold_cached(x);
+  const RF dt = 1e-4;
+  RF time = 0.0;
+  for (int step = 0; step < 5; ++step)
+    {
+      V xnew(xold), xnew_cached(xold_cached);
+      osm.apply(time,dt,xold,xnew);
+      osm_cached.apply(time,dt,xold_cached,xnew_cached);
+      xold = xnew;
+      xold_cached = xnew_cached;
+      time += dt;
+    }
+
+  xold_cached -= xold;
+  const double difference = xold_cached.infinity_norm() / xold.infinity_norm();
+  std::cout << name << ": " << (mass_inverse.diagonal() ? "diagonal" : "dense")
+            << " mass blocks, relative difference of cached and assembled mass matrix " << difference << std::endl;
+  passed &= difference < 1e-10;
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{6,5}});
+    using GV = Dune::YaspGrid<2>::LeafGridView;
+    GV gv = grid.leafGridView();
+    using DF = GV::Grid::ctype;
+    using RF = double;
+
+    // orthonormal basis, the mass matrix is diagonal and the explicit diagonal solver is exact
+    using OPBFEM = Dune::PDELab::OPBLocalFiniteElementMap<DF,RF,2,2,Dune::GeometryType::cube>;
+    OPBFEM opbfem;
+    passed &= testBlockDiagonalMassInverse<OPBFEM,Dune::PDELab::ISTLBackend_SEQ_ExplicitDiagonal>
+      (gv,opbfem,true,"OPB P2");
+
+    // Lagrange basis with dense mass blocks, ILU0 is an exact factorization of a block diagonal matrix
+    using QkFEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,2,2>;
+    QkFEM qkfem;
+    passed &= testBlockDiagonalMassInverse<QkFEM,Dune::PDELab::ISTLBackend_SEQ_BCGS_ILU0>
+      (gv,qkfem,false,"DG Q2");
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,174 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Solves the heat equation with Dirichlet constraints and the Alexander SDIRK scheme, once
+// assembling the mass term in every Jacobian and residual and once with the mass matrix cached
+// by the OneStepGridOperator, and compares a stage Jacobian, a stage residual and the solutions
+// after some time steps for both placements of the time step size.
+template<typename GFS, typename CC, typename Problem>
+class ConstantMassTest
+{
+public:
+  using RF = double;
+  using FEM = typename GFS::Traits::FiniteElementMap;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using LOP = Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM>;
+  using TLOP = Dune::PDELab::L2;
+  using GO0 = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+  using GO1 = Dune::PDELab::GridOperator<GFS,GFS,TLOP,MBE,RF,RF,RF,CC,CC>;
+  using IGO = Dune::PDELab::OneStepGridOperator<GO0,GO1>;
+  using V = typename IGO::Traits::Domain;
+  using M = typename IGO::Traits::Jacobian;
+
+  ConstantMassTest(const GFS& gfs_, const CC& cc_, Problem& problem_, bool constant_mass, bool divide_mass)
+    : gfs(gfs_), problem(problem_), lop(problem), tlop()
+    , go0(gfs,cc_,gfs,cc_,lop,MBE(9)), go1(gfs,cc_,gfs,cc_,tlop,MBE(9))
+    , igo(go0,go1)
+  {
+    igo.setConstantMass(constant_mass);
+    if (divide_mass)
+      igo.divideMassTermByDeltaT();
+  }
+
+  const IGO& gridOperator() const
+  {
+    return igo;
+  }
+
+  // Jacobian and residual of the second stage of the first step
+  void stage(V& x, RF dt, M& jacobian, V& residual)
+  {
+    std::vector<V*> stages{&x,&x};
+    igo.preStep(method,0.0,dt);
+    igo.preStage(2,stages);
+    jacobian = 0.0;
+    igo.jacobian(x,jacobian);
+    residual = 0.0;
+    igo.residual(x,residual);
+    igo.postStage();
+    igo.postStep();
+  }
+
+  // solution after some time steps
+  void integrate(V& x, RF dt, int steps)
+  {
+    using LS = Dune::PDELab::ISTLBackend_SEQ_CG_AMG_SSOR<IGO>;
+    LS ls(5000,0);
+    using Solver = Dune::PDELab::NewtonMethod<IGO,LS>;
+    Solver newton(igo,ls);
+    newton.setVerbosityLevel(0);
+    newton.setReduction(1e-10);
+    newton.setMinLinearReduction(1e-13);
+    Dune::PDELab::OneStepMethod<RF,IGO,Solver,V,V> osm(method,igo,newton);
+    osm.setVerbosityLevel(0);
+
+    using G = Dune::PDELab::ConvectionDiffusionDirichletExtensionAdapter<Problem>;
+    G g(gfs.gridView(),problem);
+    RF time = 0.0;
+    for (int step = 0; step < steps; ++step)
+      {
+        V xnew(x);
+        osm.apply(time,dt,x,g,xnew);
+        x = xnew;
+        time += dt;
+      }
+  }
+
+private:
+  const GFS& gfs;
+  Problem& problem;
+  LOP lop;
+  TLOP tlop;
+  GO0 go0;
+  GO1 go1;
+  IGO igo;
+  Dune::PDELab::Alexander2Parameter<RF> method;
+};
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{12,12}});
+    using GV = Dune::YaspGrid<2>::LeafGridView;
+    GV gv = grid.leafGridView();
+    using DF = GV::Grid::ctype;
+    using RF = double;
+
+    using FEM = Dune::PDELab::QkLocalFiniteElementMap<GV,DF,RF,2>;
+    FEM fem(gv);
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,
+                                                Dune::PDELab::ISTL::VectorBackend<>>;
+    GFS gfs(gv,fem);
+
+    using Problem = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+    Problem problem;
+    using CC = typename GFS::template ConstraintsContainer<RF>::Type;
+    CC cc;
+    Dune::PDELab::ConvectionDiffusionBoundaryConditionAdapter<Problem> bctype(gv,problem);
+    Dune::PDELab::constraints(bctype,gfs,cc);
+
+    using Test = ConstantMassTest<GFS,CC,Problem>;
+    typename Test::V x0(gfs,0.0);
+    Dune::PDELab::ConvectionDiffusionDirichletExtensionAdapter<Problem> g(gv,problem);
+    Dune::PDELab::interpolate(g,gfs,x0);
+    const RF dt = 0.01;
+
+    for (bool divide_mass : {false,true})
+      {
+        const std::string mode = divide_mass ? "mass term divided by dt" : "spatial term multiplied by dt";
+        Test assembled(gfs,cc,problem,false,divide_mass);
+        Test cached(gfs,cc,problem,true,divide_mass);
+
+        // a single stage
+        typename Test::V x(x0), residual(gfs,0.0), residual_cached(gfs,0.0);
+        typename Test::M jacobian(assembled.gridOperator(),0.0), jacobian_cached(cached.gridOperator(),0.0);
+        assembled.stage(x,dt,jacobian,residual);
+        cached.stage(x,dt,jacobian_cached,residual_cached);
+        using Dune::PDELab::Backend::native;
+        native(jacobian_cached) -= native(jacobian);
+        residual_cached -= residual;
+        const RF jacobian_difference = native(jacobian_cached).infinity_norm() / native(jacobian).infinity_norm();
+        const RF residual_difference = residual_cached.infinity_norm() / residual.infinity_norm();
+        std::cout << mode << ": relative difference of the stage Jacobians " << jacobian_difference
+                  << ", of the stage residuals " << residual_difference << std::endl;
+        passed &= jacobian_difference < 1e-12;
+        passed &= residual_difference < 1e-10;
+
+        // time integration
+        typename Test::V x_assembled(x0), x_cached(x0);
+        assembled.integrate(x_assembled,dt,5);
+        cached.integrate(x_cached,dt,5);
+        x_cached -= x_assembled;
+        const RF difference = x_cached.infinity_norm() / x_assembled.infinity_norm();
+        std::cout << mode << ": relative difference of the solutions " << difference << std::endl;
+        passed &= difference < 1e-8;
+      }
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,153 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+#include <dune/pdelab/gridoperator/default/coloredassembler.hh>
+
+// Applies the jacobian of a linear operator with and without element matrix caching and
+// compares the results, for repeated applications and after a change of the weight.
+template<typename GO, typename X>
+bool compareElementMatrixCaching(GO& go, const X& x, const std::string& name, double tolerance = 1e-12)
+{
+  const auto& gfs = go.trialGridFunctionSpace();
+  bool passed = true;
+
+  auto compare = [&](const std::string& what)
+    {
+      go.setElementMatrixCaching(false);
+      X y_direct(gfs,1.0);
+      go.jacobian_apply(x,y_direct);
+
+      go.setElementMatrixCaching(true);
+      for (int repetition = 0; repetition < 2; ++repetition)
+        {
+          X y_cached(gfs,1.0);
+          go.jacobian_apply(x,y_cached);
+          y_cached -= y_direct;
+          if (y_cached.infinity_norm() > tolerance * y_direct.infinity_norm())
+            {
+              std::cerr << name << ", " << what << ": cached jacobian application differs by "
+                        << y_cached.infinity_norm() << std::endl;
+              passed = false;
+            }
+        }
+    };
+
+  compare("weight 1");
+  // the cache is rebuilt for a new weight, without switching the caching off
+  go.localAssembler().setWeight(-2.5);
+  {
+    X y_cached(gfs,0.0), y_direct(gfs,0.0);
+    go.jacobian_apply(x,y_cached);
+    go.setElementMatrixCaching(false);
+    go.jacobian_apply(x,y_direct);
+    y_cached -= y_direct;
+    if (y_cached.infinity_norm() > tolerance * y_direct.infinity_norm())
+      {
+        std::cerr << name << ": cached jacobian application was not updated for a new weight" << std::endl;
+        passed = false;
+      }
+  }
+  compare("weight -2.5");
+  go.localAssembler().setWeight(1.0);
+  go.setElementMatrixCaching(false);
+
+  return passed;
+}
+
+template<typename GV>
+bool testElementMatrixCache(const GV& gv)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  MBE mbe(9);
+  using Problem = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+  Problem problem;
+  auto f = [](const auto& p){ return std::sin(3.0*p[0])*std::cos(2.0*p[1]) + p[0]; };
+
+  bool passed = true;
+
+  // interior penalty DG with skeleton and boundary terms, also with a threaded assembler
+  {
+    using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,2,GV::dimension>;
+    FEM fem;
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = Dune::PDELab::EmptyTransformation;
+
+    using LOP = Dune::PDELab::ConvectionDiffusionDG<Problem,FEM>;
+    LOP lop(problem);
+
+    using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+    GO go(gfs,gfs,lop,mbe);
+
+    typename GO::Traits::Domain x(gfs,0.0);
+    Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gv,f),gfs,x);
+
+    passed &= compareElementMatrixCaching(go,x,"DG Q2");
+
+    using ColoredGO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC,
+                                                 Dune::PDELab::ColoredAssembler<GFS,GFS,CC,CC> >;
+    ColoredGO colored_go(gfs,gfs,lop,mbe);
+    colored_go.assembler().setThreads(3);
+    passed &= compareElementMatrixCaching(colored_go,x,"DG Q2 colored");
+  }
+
+  // conforming Q2 with Dirichlet constraints
+  {
+    using FEM = Dune::PDELab::QkLocalFiniteElementMap<GV,DF,RF,2>;
+    FEM fem(gv);
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = typename GFS::template ConstraintsContainer<RF>::Type;
+    CC cc;
+    Dune::PDELab::ConvectionDiffusionBoundaryConditionAdapter<Problem> bctype(gv,problem);
+    Dune::PDELab::constraints(bctype,gfs,cc);
+
+    using LOP = Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM>;
+    LOP lop(problem);
+
+    using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+    GO go(gfs,cc,gfs,cc,lop,mbe);
+
+    typename GO::Traits::Domain x(gfs,0.0);
+    Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gv,f),gfs,x);
+
+    // the jacobian is applied by numerical differentiation without caching
+    passed &= compareElementMatrixCaching(go,x,"Q2",1e-6);
+  }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{8,6}});
+
+    return testElementMatrixCache(grid.leafGridView()) ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,162 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Integrates u' = -lambda u, discretized by the L2 operator in space and time, with embedded
+// Runge-Kutta pairs and the PI step size controller. Checks that the error at the final time
+// follows the tolerance, that tighter tolerances need more steps, that a far too large
+// initial step is rejected and that a non-finite error leads to a rejection.
+template<typename GFS>
+class DecayProblem
+{
+public:
+  using RF = double;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using LOP = Dune::PDELab::L2;
+  using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF>;
+  using IGO = Dune::PDELab::OneStepGridOperator<GO,GO,false>;
+  using V = typename GO::Traits::Domain;
+  using LS = Dune::PDELab::ISTLBackend_SEQ_ExplicitDiagonal;
+
+  DecayProblem(const GFS& gfs_, RF lambda_)
+    : gfs(gfs_), lambda(lambda_)
+    , spatial_lop(0,lambda), temporal_lop()
+    , go0(gfs,gfs,spatial_lop,MBE(4)), go1(gfs,gfs,temporal_lop,MBE(4))
+    , igo(go0,go1)
+    , x0(gfs,0.0)
+  {
+    auto f = [](const auto& xg) { return 1.0 + xg[0]; };
+    Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gfs.gridView(),f),gfs,x0);
+  }
+
+  // integrates up to time T and returns the error there
+  RF adaptiveError(const Dune::PDELab::EmbeddedTimeSteppingParameterInterface<RF>& method, RF T, RF dt,
+                   Dune::PDELab::PIStepSizeController<RF>& controller)
+  {
+    LS ls;
+    Dune::PDELab::ExplicitOneStepMethod<RF,IGO,LS,V> osm(method,igo,ls);
+    osm.setVerbosityLevel(0);
+    osm.setMassInverseCaching(true);
+    V xold(x0), xnew(x0);
+    RF time = 0.0;
+    while (time < T - 1e-12)
+      {
+        dt = std::min(dt,T-time);
+        time += osm.applyAdaptive(time,dt,xold,xnew,controller);
+        xold = xnew;
+      }
+    return error(xold,T);
+  }
+
+  // a step with a non-finite solution is rejected with the smallest step size factor
+  bool nonFiniteErrorRejected() const
+  {
+    Dune::PDELab::PIStepSizeController<RF> controller(1e-6,1e-6,0.9,0.2,5.0);
+    V xnew(x0), xembedded(x0);
+    *xnew.begin() = std::numeric_limits<RF>::quiet_NaN();
+    const RF error = controller.errorNorm(x0,xnew,xembedded);
+    const bool accepted = controller.accept(error);
+    return std::isinf(error) && !accepted && controller.factor(error,3,accepted) == 0.2;
+  }
+
+private:
+
+  RF error(V x, RF T) const
+  {
+    x.axpy(-std::exp(-lambda*T),x0);
+    return x.infinity_norm();
+  }
+
+  const GFS& gfs;
+  RF lambda;
+  LOP spatial_lop;
+  LOP temporal_lop;
+  GO go0;
+  GO go1;
+  IGO igo;
+  V x0;
+};
+
+template<typename Problem>
+bool testEmbeddedMethod(Problem& problem, const Dune::PDELab::EmbeddedTimeSteppingParameterInterface<double>& method)
+{
+  const double T = 1.0;
+  bool passed = true;
+
+  // the initial step is much too large and has to be rejected
+  Dune::PDELab::PIStepSizeController<double> coarse(1e-4,1e-4);
+  const double coarse_error = problem.adaptiveError(method,T,1.0,coarse);
+  Dune::PDELab::PIStepSizeController<double> fine(1e-8,1e-8);
+  const double fine_error = problem.adaptiveError(method,T,1.0,fine);
+
+  std::cout << method.name() << ": tolerance 1e-4 error " << coarse_error << " with "
+            << coarse.accepted() << " accepted and " << coarse.rejected() << " rejected steps, "
+            << "tolerance 1e-8 error " << fine_error << " with "
+            << fine.accepted() << " accepted and " << fine.rejected() << " rejected steps" << std::endl;
+
+  // the global error may exceed the local tolerance by a moderate factor
+  passed &= coarse_error < 2e-3;
+  passed &= fine_error < 2e-7;
+  passed &= fine_error < coarse_error;
+  passed &= fine.accepted() > coarse.accepted();
+  passed &= coarse.rejected() > 0;
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{4,4}});
+    using GV = Dune::YaspGrid<2>::LeafGridView;
+    GV gv = grid.leafGridView();
+    using DF = GV::Grid::ctype;
+    using RF = double;
+
+    using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,1,2>;
+    FEM fem;
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,Dune::PDELab::ISTL::VectorBackend<>>;
+    GFS gfs(gv,fem);
+
+    DecayProblem<GFS> problem(gfs,10.0);
+
+    if (!problem.nonFiniteErrorRejected())
+      {
+        std::cerr << "a non-finite error was not rejected" << std::endl;
+        passed = false;
+      }
+
+    Dune::PDELab::BogackiShampineParameter<RF> bogackishampine;
+    passed &= testEmbeddedMethod(problem,bogackishampine);
+
+    Dune::PDELab::DormandPrinceParameter<RF> dormandprince;
+    passed &= testEmbeddedMethod(problem,dormandprince);
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,135 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/geometrygrid.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// A smooth deformation of the unit square, which yields non-affine cells and faces.
+class Deformation
+  : public Dune::AnalyticalCoordFunction<double,2,2,Deformation>
+{
+public:
+  void evaluate (const Dune::FieldVector<double,2>& x, Dune::FieldVector<double,2>& y) const
+  {
+    y[0] = x[0] + 0.1*std::sin(M_PI*x[0])*std::sin(M_PI*x[1]);
+    y[1] = x[1] + 0.05*x[0]*x[0]*x[1];
+  }
+};
+
+// Compares residual, jacobian and jacobian application of grid operators with and without
+// cached geometries. The cached assemblies are repeated to make sure the cached values are
+// reused, and the cache is rebuilt in between by calling update().
+template<typename GV>
+bool testGeometryCache(const GV& gv, const std::string& name)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  MBE mbe(9);
+
+  using Problem = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+  Problem problem;
+  using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,2,GV::dimension>;
+  FEM fem;
+  using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+  GFS gfs(gv,fem);
+  using CC = Dune::PDELab::EmptyTransformation;
+  CC cc;
+
+  using LOP = Dune::PDELab::ConvectionDiffusionDG<Problem,FEM>;
+  LOP lop(problem);
+
+  using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+  GO go(gfs,cc,gfs,cc,lop,mbe);
+  using CachedGO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC,
+                                              Dune::PDELab::DefaultAssembler<GFS,GFS,CC,CC,true> >;
+  CachedGO cached_go(gfs,cc,gfs,cc,lop,mbe);
+
+  using X = typename GO::Traits::Domain;
+  using M = typename GO::Traits::Jacobian;
+
+  X x(gfs,0.0);
+  auto f = [](const auto& p){ return std::exp(p[0])*std::sin(2.0*p[1]); };
+  Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gv,f),gfs,x);
+
+  X r(gfs,0.0);
+  go.residual(x,r);
+  M a(go,0.0);
+  go.jacobian(x,a);
+  X y(gfs,0.0);
+  go.jacobian_apply(x,y);
+
+  bool passed = true;
+  for (int i = 0; i < 3; ++i)
+    {
+      if (i == 2)
+        cached_go.update();
+
+      X r_cached(gfs,0.0);
+      cached_go.residual(x,r_cached);
+      r_cached -= r;
+      if (r_cached.infinity_norm() > 1e-12 * std::max(r.infinity_norm(),1.0))
+        {
+          std::cerr << name << ": residuals differ by " << r_cached.infinity_norm() << std::endl;
+          passed = false;
+        }
+
+      typename CachedGO::Traits::Jacobian a_cached(cached_go,0.0);
+      cached_go.jacobian(x,a_cached);
+      auto& native_cached = Dune::PDELab::Backend::native(a_cached);
+      native_cached -= Dune::PDELab::Backend::native(a);
+      if (native_cached.frobenius_norm() > 1e-12 * std::max(Dune::PDELab::Backend::native(a).frobenius_norm(),1.0))
+        {
+          std::cerr << name << ": jacobians differ by " << native_cached.frobenius_norm() << std::endl;
+          passed = false;
+        }
+
+      X y_cached(gfs,0.0);
+      cached_go.jacobian_apply(x,y_cached);
+      y_cached -= y;
+      if (y_cached.infinity_norm() > 1e-12 * std::max(y.infinity_norm(),1.0))
+        {
+          std::cerr << name << ": jacobian applications differ by " << y_cached.infinity_norm() << std::endl;
+          passed = false;
+        }
+    }
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    using HostGrid = Dune::YaspGrid<2>;
+    HostGrid host_grid({{1.0,1.0}},{{9,7}});
+
+    Deformation deformation;
+    Dune::GeometryGrid<HostGrid,Deformation> grid(host_grid,deformation);
+
+    bool passed = true;
+    passed &= testGeometryCache(host_grid.leafGridView(),"affine");
+    passed &= testGeometryCache(grid.leafGridView(),"deformed");
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,127 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// the model problem with a source term
+template<typename GV, typename RF>
+class HybridizationProblem
+  : public Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>
+{
+public:
+  using Traits = typename Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>::Traits;
+
+  typename Traits::RangeFieldType
+  f (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    auto xglobal = e.geometry().global(x);
+    return 1.0 + xglobal[0]*xglobal[0];
+  }
+};
+
+// Solves the hybridized system with CG and AMG, reconstructs velocity and pressure and checks that
+// they solve the saddle point system of DiffusionMixed.
+template<typename GV>
+bool testHybridizedDiffusionMixed(const GV& gv, const std::string& name)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  const int dim = GV::dimension;
+  using Problem = HybridizationProblem<GV,RF>;
+  Problem problem;
+
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using RT0FEM = Dune::PDELab::RaviartThomasLocalFiniteElementMap<GV,DF,RF,0>;
+  RT0FEM rt0fem(gv);
+
+  // hybridized system for the face values
+  using TraceGFS = Dune::PDELab::GridFunctionSpace<GV,RT0FEM,Dune::PDELab::ConformingDirichletConstraints,VBE>;
+  TraceGFS trace_gfs(gv,rt0fem);
+  using CC = typename TraceGFS::template ConstraintsContainer<RF>::Type;
+  CC cc;
+  Dune::PDELab::ConvectionDiffusionBoundaryConditionAdapter<Problem> bctype(gv,problem);
+  Dune::PDELab::constraints(bctype,trace_gfs,cc);
+
+  using HybridLOP = Dune::PDELab::HybridizedDiffusionMixed<Problem>;
+  HybridLOP hybrid_lop(problem);
+  using HybridGO = Dune::PDELab::GridOperator<TraceGFS,TraceGFS,HybridLOP,MBE,RF,RF,RF,CC,CC>;
+  HybridGO hybrid_go(trace_gfs,cc,trace_gfs,cc,hybrid_lop,MBE(2*dim+1));
+
+  using TraceV = typename HybridGO::Traits::Domain;
+  TraceV lambda(trace_gfs,0.0);
+  hybrid_lop.interpolateDirichletTraces(trace_gfs,lambda);
+
+  using LS = Dune::PDELab::ISTLBackend_SEQ_CG_AMG_SSOR<HybridGO>;
+  LS ls(5000,0);
+  Dune::PDELab::StationaryLinearProblemSolver<HybridGO,LS,TraceV> slp(hybrid_go,ls,lambda,1e-12,1e-99,0);
+  slp.apply();
+
+  // mixed space of DiffusionMixed
+  using P0FEM = Dune::PDELab::P0LocalFiniteElementMap<DF,RF,dim>;
+  P0FEM p0fem(Dune::GeometryTypes::cube(dim));
+  using VelocityGFS = Dune::PDELab::GridFunctionSpace<GV,RT0FEM,Dune::PDELab::NoConstraints,VBE>;
+  VelocityGFS velocity_gfs(gv,rt0fem);
+  using PressureGFS = Dune::PDELab::GridFunctionSpace<GV,P0FEM,Dune::PDELab::NoConstraints,VBE>;
+  PressureGFS pressure_gfs(gv,p0fem);
+  using MixedGFS = Dune::PDELab::CompositeGridFunctionSpace<VBE,Dune::PDELab::LexicographicOrderingTag,VelocityGFS,PressureGFS>;
+  MixedGFS mixed_gfs(velocity_gfs,pressure_gfs);
+
+  using MixedLOP = Dune::PDELab::DiffusionMixed<Problem>;
+  MixedLOP mixed_lop(problem);
+  using MixedGO = Dune::PDELab::GridOperator<MixedGFS,MixedGFS,MixedLOP,MBE,RF,RF,RF>;
+  MixedGO mixed_go(mixed_gfs,mixed_gfs,mixed_lop,MBE(2*dim+2));
+
+  using MixedV = typename MixedGO::Traits::Domain;
+  MixedV x(mixed_gfs,0.0);
+  hybrid_lop.reconstruct(trace_gfs,lambda,mixed_gfs,x);
+
+  MixedV zero(mixed_gfs,0.0);
+  typename MixedGO::Traits::Range r0(mixed_gfs,0.0), r(mixed_gfs,0.0);
+  mixed_go.residual(zero,r0);
+  mixed_go.residual(x,r);
+  const double defect = r.infinity_norm() / r0.infinity_norm();
+
+  std::cout << name << ": " << slp.ls_result().iterations << " CG iterations for "
+            << trace_gfs.globalSize() << " face values, relative residual of the mixed system "
+            << defect << std::endl;
+
+  bool passed = slp.ls_result().converged;
+  passed &= defect < 1e-8;
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::YaspGrid<2> grid2d({{1.0,1.0}},{{16,12}});
+    passed &= testHybridizedDiffusionMixed(grid2d.leafGridView(),"2D RT0");
+
+    Dune::YaspGrid<3> grid3d({{1.0,1.0,1.0}},{{6,5,4}});
+    passed &= testHybridizedDiffusionMixed(grid3d.leafGridView(),"3D RT0");
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
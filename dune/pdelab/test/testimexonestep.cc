@@ -0,0 +1,128 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Integrates u' = -(lambda_E + lambda_I) u with IMEX Runge-Kutta schemes, where both parts of the
+// spatial operator are L2 operators, lambda_E u is treated explicitly and lambda_I u implicitly.
+// Checks the observed convergence orders against the exact solution.
+template<typename GFS>
+class SplitDecayProblem
+{
+public:
+  using RF = double;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using LOP = Dune::PDELab::L2;
+  using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF>;
+  using IGO = Dune::PDELab::OneStepGridOperator<GO,GO>;
+  using V = typename GO::Traits::Domain;
+  // the mass and implicit operators are block diagonal, so ILU0 is an exact factorization
+  using LS = Dune::PDELab::ISTLBackend_SEQ_BCGS_ILU0;
+  using Newton = Dune::PDELab::NewtonMethod<IGO,LS>;
+
+  SplitDecayProblem(const GFS& gfs_, RF lambda_explicit_, RF lambda_implicit_)
+    : gfs(gfs_), lambda(lambda_explicit_+lambda_implicit_)
+    , explicit_lop(0,lambda_explicit_), implicit_lop(0,lambda_implicit_), temporal_lop()
+    , goe(gfs,gfs,explicit_lop,MBE(4)), goi(gfs,gfs,implicit_lop,MBE(4)), go1(gfs,gfs,temporal_lop,MBE(4))
+    , igo(goi,go1)
+    , x0(gfs,0.0)
+  {
+    auto f = [](const auto& xg) { return 1.0 + xg[0]; };
+    Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gfs.gridView(),f),gfs,x0);
+  }
+
+  // error at time T
+  RF error(const Dune::PDELab::IMEXParameterInterface<RF>& method, RF T, int steps)
+  {
+    LS ls(5000,0);
+    Newton newton(igo,ls);
+    newton.setVerbosityLevel(0);
+    newton.setReduction(1e-12);
+    newton.setAbsoluteLimit(1e-14);
+    newton.setMinLinearReduction(1e-13);
+    Dune::PDELab::IMEXOneStepMethod<RF,IGO,GO,Newton,V> osm(method,igo,goe,newton);
+    osm.setVerbosityLevel(0);
+    V xold(x0), xnew(x0);
+    const RF dt = T/steps;
+    for (int i = 0; i < steps; ++i)
+      {
+        osm.apply(i*dt,dt,xold,xnew);
+        xold = xnew;
+      }
+    xold.axpy(-std::exp(-lambda*T),x0);
+    return xold.infinity_norm();
+  }
+
+private:
+
+  const GFS& gfs;
+  RF lambda;
+  LOP explicit_lop;
+  LOP implicit_lop;
+  LOP temporal_lop;
+  GO goe;
+  GO goi;
+  GO go1;
+  IGO igo;
+  V x0;
+};
+
+bool checkOrder(const std::string& name, double coarse, double fine, double order)
+{
+  const double observed = std::log2(coarse/fine);
+  std::cout << name << ": errors " << coarse << " and " << fine << ", observed order " << observed << std::endl;
+  return observed > order - 0.3;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{4,4}});
+    using GV = Dune::YaspGrid<2>::LeafGridView;
+    GV gv = grid.leafGridView();
+    using DF = GV::Grid::ctype;
+    using RF = double;
+
+    using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,1,2>;
+    FEM fem;
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,Dune::PDELab::ISTL::VectorBackend<>>;
+    GFS gfs(gv,fem);
+
+    SplitDecayProblem<GFS> problem(gfs,1.0,4.0);
+    const RF T = 1.0;
+
+    Dune::PDELab::ARS222Parameter<RF> ars222;
+    passed &= checkOrder("ARS(2,2,2)",problem.error(ars222,T,20),problem.error(ars222,T,40),2.0);
+
+    Dune::PDELab::ARS443Parameter<RF> ars443;
+    passed &= checkOrder("ARS(4,4,3)",problem.error(ars443,T,20),problem.error(ars443,T,40),3.0);
+
+    Dune::PDELab::KennedyCarpenterARK3Parameter<RF> ark3;
+    passed &= checkOrder("ARK3(2)4L[2]SA",problem.error(ark3,T,20),problem.error(ark3,T,40),3.0);
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,170 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <iostream>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Solves the heat equation with the Alexander SDIRK scheme and Newton's method, once
+// reassembling the matrix in every stage and once with the Jacobian of the OneStepGridOperator
+// declared constant, and compares the results. Both stages of the scheme have the same
+// diagonal coefficient, so with a constant Jacobian the matrix and the AMG hierarchy are only
+// built again when the time step size changes.
+template<typename GV, typename RF>
+class SourceProblem
+  : public Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>
+{
+  using Base = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+
+public:
+  using Traits = typename Base::Traits;
+
+  typename Traits::RangeFieldType
+  f (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return 1.0;
+  }
+
+  Dune::PDELab::ConvectionDiffusionBoundaryConditions::Type
+  bctype (const typename Traits::IntersectionType& is, const typename Traits::IntersectionDomainType& x) const
+  {
+    return Dune::PDELab::ConvectionDiffusionBoundaryConditions::Neumann;
+  }
+
+  typename Traits::RangeFieldType
+  j (const typename Traits::IntersectionType& is, const typename Traits::IntersectionDomainType& x) const
+  {
+    return 0.0;
+  }
+};
+
+// AMG solver backend counting how often the hierarchy is built
+template<typename GO>
+class CountingAMGBackend
+  : public Dune::PDELab::ISTLBackend_SEQ_CG_AMG_SSOR<GO>
+{
+  using Base = Dune::PDELab::ISTLBackend_SEQ_CG_AMG_SSOR<GO>;
+
+public:
+  CountingAMGBackend()
+    : Base(5000,0), setups(0), solves(0)
+  {}
+
+  template<typename M, typename V, typename W, typename R>
+  void apply(M& A, V& z, W& r, R reduction)
+  {
+    if (not this->getReuse())
+      ++setups;
+    ++solves;
+    Base::apply(A,z,r,reduction);
+  }
+
+  int setups;
+  int solves;
+};
+
+template<typename GFS, typename Problem, typename V>
+void integrate(const GFS& gfs, Problem& problem, bool constant_jacobian, V& x, int& setups, int& solves)
+{
+  using RF = double;
+  using FEM = typename GFS::Traits::FiniteElementMap;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using LOP = Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM>;
+  LOP lop(problem);
+  using TLOP = Dune::PDELab::L2;
+  TLOP tlop;
+  using GO0 = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF>;
+  GO0 go0(gfs,gfs,lop,MBE(9));
+  using GO1 = Dune::PDELab::GridOperator<GFS,GFS,TLOP,MBE,RF,RF,RF>;
+  GO1 go1(gfs,gfs,tlop,MBE(9));
+  using IGO = Dune::PDELab::OneStepGridOperator<GO0,GO1>;
+  IGO igo(go0,go1);
+  igo.setConstantJacobian(constant_jacobian);
+
+  using LS = CountingAMGBackend<IGO>;
+  LS ls;
+  using Solver = Dune::PDELab::NewtonMethod<IGO,LS>;
+  Solver newton(igo,ls);
+  newton.setVerbosityLevel(0);
+  newton.setReduction(1e-10);
+  newton.setMinLinearReduction(1e-13);
+
+  Dune::PDELab::Alexander2Parameter<RF> method;
+  Dune::PDELab::OneStepMethod<RF,IGO,Solver,V,V> osm(method,igo,newton);
+  osm.setVerbosityLevel(0);
+
+  // the step size changes once
+  RF time = 0.0;
+  for (int step = 0; step < 8; ++step)
+    {
+      const RF dt = step < 4 ? 0.01 : 0.005;
+      V xnew(x);
+      osm.apply(time,dt,x,xnew);
+      x = xnew;
+      time += dt;
+    }
+
+  setups = ls.setups;
+  solves = ls.solves;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{16,16}});
+    using GV = Dune::YaspGrid<2>::LeafGridView;
+    GV gv = grid.leafGridView();
+    using DF = GV::Grid::ctype;
+    using RF = double;
+
+    using FEM = Dune::PDELab::QkLocalFiniteElementMap<GV,DF,RF,1>;
+    FEM fem(gv);
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,Dune::PDELab::ISTL::VectorBackend<>>;
+    GFS gfs(gv,fem);
+
+    using Problem = SourceProblem<GV,RF>;
+    Problem problem;
+
+    using V = Dune::PDELab::Backend::Vector<GFS,RF>;
+    auto u0 = [](const auto& xg) { return xg[0]*xg[1]; };
+    V x(gfs,0.0);
+    Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gv,u0),gfs,x);
+    V x_reused(x);
+
+    int setups = 0, solves = 0;
+    integrate(gfs,problem,false,x,setups,solves);
+    std::cout << "reassembling: " << setups << " AMG setups in " << solves << " solves" << std::endl;
+    passed &= setups == solves;
+
+    int setups_reused = 0, solves_reused = 0;
+    integrate(gfs,problem,true,x_reused,setups_reused,solves_reused);
+    std::cout << "constant Jacobian: " << setups_reused << " AMG setups in " << solves_reused << " solves" << std::endl;
+    passed &= setups_reused == 2;
+
+    x_reused -= x;
+    const double difference = x_reused.infinity_norm() / x.infinity_norm();
+    std::cout << "relative difference of the solutions " << difference << std::endl;
+    passed &= difference < 1e-8;
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
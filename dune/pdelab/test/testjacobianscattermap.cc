@@ -0,0 +1,135 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+#include <dune/pdelab/gridoperator/default/coloredassembler.hh>
+#include <dune/pdelab/gridoperator/default/taskassembler.hh>
+
+#include "jumppenaltylaplace.hh"
+
+// Assembles the jacobian repeatedly into the same matrix, so that most assemblies use the
+// scatter map recorded during the first one, and compares the results against a jacobian
+// assembled into a fresh matrix.
+template<typename GO>
+bool testRepeatedAssembly(GO& go, const std::string& name)
+{
+  using X = typename GO::Traits::Domain;
+  using M = typename GO::Traits::Jacobian;
+
+  const auto& gfs = go.trialGridFunctionSpace();
+  X x(gfs,0.0);
+  auto f = [](const auto& p){ return std::exp(p[0])*std::cos(2.0*p[1]); };
+  Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gfs.gridView(),f),gfs,x);
+
+  M reference(go,0.0);
+  go.jacobian(x,reference);
+  const auto norm = Dune::PDELab::Backend::native(reference).frobenius_norm();
+
+  bool passed = true;
+  M a(go);
+  for (int i = 0; i < 4; ++i)
+    {
+      // the grid did not change, so this must not affect the result either
+      if (i == 2)
+        go.update();
+      // the pattern is rebuilt into the existing storage, so the map must be recorded again
+      if (i == 3)
+        a = M(go);
+
+      a = 0.0;
+      go.jacobian(x,a);
+
+      auto diff = Dune::PDELab::Backend::native(a);
+      diff -= Dune::PDELab::Backend::native(reference);
+      if (diff.frobenius_norm() > 1e-12 * norm)
+        {
+          std::cerr << name << ": assembly " << i << " differs by " << diff.frobenius_norm() << std::endl;
+          passed = false;
+        }
+    }
+  return passed;
+}
+
+template<typename GV>
+bool testScatterMap(const GV& gv)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  MBE mbe(9);
+
+  JumpPenaltyLaplace lop;
+  bool passed = true;
+
+  // conforming Q1 space with Dirichlet constraints
+  {
+    using FEM = Dune::PDELab::QkLocalFiniteElementMap<GV,DF,RF,1>;
+    FEM fem(gv);
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = typename GFS::template ConstraintsContainer<RF>::Type;
+    CC cc;
+    auto bctype = Dune::PDELab::makeBoundaryConditionFromCallable(gv,[](const auto& x){ return x[1] < 1e-6; });
+    Dune::PDELab::constraints(bctype,gfs,cc);
+
+    Dune::PDELab::GridOperator<GFS,GFS,JumpPenaltyLaplace,MBE,RF,RF,RF,CC,CC> go(gfs,cc,gfs,cc,lop,mbe);
+    passed &= testRepeatedAssembly(go,"Q1");
+  }
+
+  // discontinuous Q2 space with skeleton couplings, also using a threaded assembler
+  {
+    using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,2,GV::dimension>;
+    FEM fem;
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = Dune::PDELab::EmptyTransformation;
+    CC cc;
+
+    Dune::PDELab::GridOperator<GFS,GFS,JumpPenaltyLaplace,MBE,RF,RF,RF,CC,CC> go(gfs,cc,gfs,cc,lop,mbe);
+    passed &= testRepeatedAssembly(go,"DG Q2");
+
+    using ColoredGO = Dune::PDELab::GridOperator<GFS,GFS,JumpPenaltyLaplace,MBE,RF,RF,RF,CC,CC,
+                                                 Dune::PDELab::ColoredAssembler<GFS,GFS,CC,CC> >;
+    ColoredGO colored_go(gfs,cc,gfs,cc,lop,mbe);
+    colored_go.assembler().setThreads(3);
+    passed &= testRepeatedAssembly(colored_go,"DG Q2 colored");
+
+    using TaskGO = Dune::PDELab::GridOperator<GFS,GFS,JumpPenaltyLaplace,MBE,RF,RF,RF,CC,CC,
+                                              Dune::PDELab::TaskAssembler<GFS,GFS,CC,CC> >;
+    TaskGO task_go(gfs,cc,gfs,cc,lop,mbe);
+    task_go.assembler().setThreads(3);
+    passed &= testRepeatedAssembly(task_go,"DG Q2 task");
+  }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{12,9}});
+
+    return testScatterMap(grid.leafGridView()) ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,147 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Integrates u' = -lambda u, discretized by the L2 operator in space and time, with a
+// low-storage Runge-Kutta scheme and the generic explicit one step method, and checks the
+// observed convergence orders against the exact solution. The DG mass matrix has dense cell
+// blocks, so both methods solve with its cached block inverse.
+template<typename GFS>
+class DecayProblem
+{
+public:
+  using RF = double;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using LOP = Dune::PDELab::L2;
+  using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF>;
+  using IGO = Dune::PDELab::OneStepGridOperator<GO,GO,false>;
+  using V = typename GO::Traits::Domain;
+  using LS = Dune::PDELab::ISTLBackend_SEQ_ExplicitDiagonal;
+
+  DecayProblem(const GFS& gfs_, RF lambda_)
+    : gfs(gfs_), lambda(lambda_)
+    , spatial_lop(0,lambda), temporal_lop()
+    , go0(gfs,gfs,spatial_lop,MBE(4)), go1(gfs,gfs,temporal_lop,MBE(4))
+    , igo(go0,go1)
+    , x0(gfs,0.0)
+  {
+    auto f = [](const auto& xg) { return 1.0 + xg[0]; };
+    Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gfs.gridView(),f),gfs,x0);
+  }
+
+  // error at time T of the low-storage scheme
+  RF lowStorageError(const Dune::PDELab::LowStorageRKParameterInterface<RF>& method, RF T, int steps)
+  {
+    LS ls;
+    Dune::PDELab::LowStorageExplicitOneStepMethod<RF,GO,GO,LS,V> osm(method,go0,go1,ls);
+    osm.setVerbosityLevel(0);
+    osm.setMassInverseCaching(true);
+    V x(x0);
+    const RF dt = T/steps;
+    for (int i = 0; i < steps; ++i)
+      osm.apply(i*dt,dt,x,x);
+    return error(x,T);
+  }
+
+  // error at time T of the generic explicit scheme
+  RF genericError(const Dune::PDELab::TimeSteppingParameterInterface<RF>& method, RF T, int steps)
+  {
+    LS ls;
+    Dune::PDELab::ExplicitOneStepMethod<RF,IGO,LS,V> osm(method,igo,ls);
+    osm.setVerbosityLevel(0);
+    osm.setMassInverseCaching(true);
+    V xold(x0), xnew(x0);
+    const RF dt = T/steps;
+    for (int i = 0; i < steps; ++i)
+      {
+        osm.apply(i*dt,dt,xold,xnew);
+        xold = xnew;
+      }
+    return error(xold,T);
+  }
+
+private:
+
+  RF error(V x, RF T) const
+  {
+    x.axpy(-std::exp(-lambda*T),x0);
+    return x.infinity_norm();
+  }
+
+  const GFS& gfs;
+  RF lambda;
+  LOP spatial_lop;
+  LOP temporal_lop;
+  GO go0;
+  GO go1;
+  IGO igo;
+  V x0;
+};
+
+bool checkOrder(const std::string& name, double coarse, double fine, double order)
+{
+  const double observed = std::log2(coarse/fine);
+  std::cout << name << ": errors " << coarse << " and " << fine << ", observed order " << observed << std::endl;
+  return observed > order - 0.2;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{4,4}});
+    using GV = Dune::YaspGrid<2>::LeafGridView;
+    GV gv = grid.leafGridView();
+    using DF = GV::Grid::ctype;
+    using RF = double;
+
+    using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,1,2>;
+    FEM fem;
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,Dune::PDELab::ISTL::VectorBackend<>>;
+    GFS gfs(gv,fem);
+
+    DecayProblem<GFS> problem(gfs,2.0);
+    const RF T = 1.0;
+
+    Dune::PDELab::Williamson3Parameter<RF> williamson3;
+    passed &= checkOrder("Williamson RK3",
+                         problem.lowStorageError(williamson3,T,10),
+                         problem.lowStorageError(williamson3,T,20),3.0);
+
+    Dune::PDELab::CarpenterKennedy4Parameter<RF> carpenterkennedy4;
+    passed &= checkOrder("Carpenter-Kennedy RK4",
+                         problem.lowStorageError(carpenterkennedy4,T,10),
+                         problem.lowStorageError(carpenterkennedy4,T,20),4.0);
+
+    // the generic scheme reuses its vectors between the steps
+    Dune::PDELab::RK4Parameter<RF> rk4;
+    passed &= checkOrder("RK4",
+                         problem.genericError(rk4,T,10),
+                         problem.genericError(rk4,T,20),4.0);
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
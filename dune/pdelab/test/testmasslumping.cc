@@ -0,0 +1,124 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Assembles the L2 operator with the consistent and the lumped mass matrices and checks that the
+// lumped matrices are diagonal, preserve the total mass and agree with the row sums of the
+// consistent matrix. For Lagrange bases with Gauss-Lobatto nodes row sum and nodal lumping coincide.
+// Finally, the explicit diagonal solver has to invert the lumped matrix exactly.
+template<typename GFS>
+bool testMassLumping(const GFS& gfs, const std::string& name, double volume)
+{
+  using RF = double;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using LOP = Dune::PDELab::L2;
+  using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF>;
+  using V = typename GO::Traits::Domain;
+  using M = typename GO::Traits::Jacobian;
+  using Dune::PDELab::Backend::native;
+
+  LOP lop_consistent(0,1.0,Dune::PDELab::MassLumping::none);
+  GO go_consistent(gfs,gfs,lop_consistent,MBE(9));
+  V x(gfs,0.0);
+  M mass(go_consistent,0.0);
+  go_consistent.jacobian(x,mass);
+
+  bool passed = true;
+
+  for (auto lumping : {Dune::PDELab::MassLumping::rowSum, Dune::PDELab::MassLumping::nodal})
+    {
+      const std::string variant = name + (lumping == Dune::PDELab::MassLumping::rowSum ? " row sum" : " nodal");
+      LOP lop(0,1.0,lumping);
+      GO go(gfs,gfs,lop,MBE(1));
+      M lumped(go,0.0);
+      go.jacobian(x,lumped);
+
+      const auto& D = native(lumped);
+      const auto& A = native(mass);
+      double total = 0.0;
+      double deviation = 0.0;
+      for (auto row = A.begin(); row != A.end(); ++row)
+        {
+          double rowsum = 0.0;
+          for (auto col = row->begin(); col != row->end(); ++col)
+            rowsum += *col;
+          const double d = D[row.index()][row.index()];
+          total += d;
+          deviation = std::max(deviation,std::abs(d - rowsum));
+        }
+
+      std::cout << variant << ": " << D.nonzeroes() << " of " << A.nonzeroes()
+                << " matrix entries stored, total mass " << total
+                << ", deviation from row sums " << deviation << std::endl;
+      passed &= D.nonzeroes() == D.N();
+      passed &= std::abs(total - volume) < 1e-12;
+      passed &= deviation < 1e-12;
+
+      // one sweep of the explicit diagonal solver inverts the lumped matrix
+      V r(gfs,0.0);
+      auto f = [](const auto& xg) { return 1.0 + xg[0]; };
+      Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gfs.gridView(),f),gfs,r);
+      V z(gfs,0.0);
+      Dune::PDELab::ISTLBackend_SEQ_ExplicitDiagonal ls;
+      ls.apply(lumped,z,r,1e-10);
+      V Dz(gfs,0.0);
+      native(lumped).mv(native(z),native(Dz));
+      Dz -= r;
+      passed &= Dz.infinity_norm() < 1e-12 * r.infinity_norm();
+    }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::YaspGrid<2> grid({{1.0,2.0}},{{8,6}});
+    using GV = Dune::YaspGrid<2>::LeafGridView;
+    GV gv = grid.leafGridView();
+    using DF = GV::Grid::ctype;
+    using RF = double;
+    using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+
+    // conforming Q1
+    using Q1FEM = Dune::PDELab::QkLocalFiniteElementMap<GV,DF,RF,1>;
+    Q1FEM q1fem(gv);
+    using Q1GFS = Dune::PDELab::GridFunctionSpace<GV,Q1FEM,Dune::PDELab::NoConstraints,VBE>;
+    Q1GFS q1gfs(gv,q1fem);
+    passed &= testMassLumping(q1gfs,"Q1",2.0);
+
+    // discontinuous Q2 with Gauss-Lobatto nodes
+    using DGFEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,2,2,Dune::PDELab::QkDGBasisPolynomial::lobatto>;
+    DGFEM dgfem;
+    using DGGFS = Dune::PDELab::GridFunctionSpace<GV,DGFEM,Dune::PDELab::NoConstraints,VBE>;
+    DGGFS dggfs(gv,dgfem);
+    passed &= testMassLumping(dggfs,"DG Q2 Gauss-Lobatto",2.0);
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
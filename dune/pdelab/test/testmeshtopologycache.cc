@@ -0,0 +1,147 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Compares residual, jacobian and jacobian application of a grid operator with a cached mesh
+// topology against a grid operator traversing the grid interface. The assemblies are repeated
+// to make sure the cache is reused, and the cache is rebuilt in between by calling update().
+template<typename GO>
+bool compareWithUncachedTopology(GO& go, GO& cached_go, const std::string& name)
+{
+  using X = typename GO::Traits::Domain;
+  using M = typename GO::Traits::Jacobian;
+
+  const auto& gfs = go.trialGridFunctionSpace();
+  X x(gfs,0.0);
+  auto f = [](const auto& p){ return std::sin(3.0*p[0])*std::cos(2.0*p[1]) + p[0]; };
+  Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gfs.gridView(),f),gfs,x);
+
+  X r(gfs,0.0);
+  go.residual(x,r);
+  M a(go,0.0);
+  go.jacobian(x,a);
+  X y(gfs,0.0);
+  go.jacobian_apply(x,y);
+
+  bool passed = true;
+  for (int i = 0; i < 3; ++i)
+    {
+      if (i == 2)
+        cached_go.update();
+
+      X r_cached(gfs,0.0);
+      cached_go.residual(x,r_cached);
+      r_cached -= r;
+      if (r_cached.infinity_norm() > 1e-12 * std::max(r.infinity_norm(),1.0))
+        {
+          std::cerr << name << ": residuals differ by " << r_cached.infinity_norm() << std::endl;
+          passed = false;
+        }
+
+      M a_cached(cached_go,0.0);
+      cached_go.jacobian(x,a_cached);
+      auto& native_cached = Dune::PDELab::Backend::native(a_cached);
+      native_cached -= Dune::PDELab::Backend::native(a);
+      if (native_cached.frobenius_norm() > 1e-12 * std::max(Dune::PDELab::Backend::native(a).frobenius_norm(),1.0))
+        {
+          std::cerr << name << ": jacobians differ by " << native_cached.frobenius_norm() << std::endl;
+          passed = false;
+        }
+
+      X y_cached(gfs,0.0);
+      cached_go.jacobian_apply(x,y_cached);
+      y_cached -= y;
+      if (y_cached.infinity_norm() > 1e-12 * std::max(y.infinity_norm(),1.0))
+        {
+          std::cerr << name << ": jacobian applications differ by " << y_cached.infinity_norm() << std::endl;
+          passed = false;
+        }
+    }
+  return passed;
+}
+
+template<typename GV>
+bool testMeshTopologyCache(const GV& gv)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  MBE mbe(9);
+
+  bool passed = true;
+
+  // interior penalty DG with skeleton and boundary terms
+  {
+    using Problem = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+    Problem problem;
+    using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,1,GV::dimension>;
+    FEM fem;
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = Dune::PDELab::EmptyTransformation;
+    CC cc;
+
+    using LOP = Dune::PDELab::ConvectionDiffusionDG<Problem,FEM>;
+    LOP lop(problem);
+
+    using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+    GO go(gfs,cc,gfs,cc,lop,mbe);
+    GO cached_go(gfs,cc,gfs,cc,lop,mbe);
+    cached_go.assembler().setTopologyCaching(true);
+    passed &= compareWithUncachedTopology(go,cached_go,"DG Q1");
+  }
+
+  // cell-centered finite volumes with skeleton and boundary terms
+  {
+    using Problem = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+    Problem problem;
+    using FEM = Dune::PDELab::P0LocalFiniteElementMap<DF,RF,GV::dimension>;
+    FEM fem(Dune::GeometryTypes::cube(GV::dimension));
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = Dune::PDELab::EmptyTransformation;
+    CC cc;
+
+    using LOP = Dune::PDELab::ConvectionDiffusionCCFV<Problem>;
+    LOP lop(problem);
+
+    using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+    GO go(gfs,cc,gfs,cc,lop,mbe);
+    GO cached_go(gfs,cc,gfs,cc,lop,mbe);
+    cached_go.assembler().setTopologyCaching(true);
+    passed &= compareWithUncachedTopology(go,cached_go,"CCFV");
+  }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{11,8}});
+
+    return testMeshTopologyCache(grid.leafGridView()) ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,253 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+#include <dune/pdelab/gridoperator/default/coloredassembler.hh>
+#include <dune/pdelab/gridoperator/default/taskassembler.hh>
+
+#include "nonlinearpoissonfem.hh"
+
+// Nonlinear Poisson problem -Delta u + u^2 = f with Dirichlet boundary conditions
+class NonlinearPoissonProblem
+{
+public:
+  typedef double value_type;
+
+  double q (double u) const
+  {
+    return u*u;
+  }
+
+  template<typename E, typename X>
+  double f (const E& e, const X& x) const
+  {
+    auto global = e.geometry().global(x);
+    return -2.0*x.size() + global.two_norm2()*global.two_norm2();
+  }
+
+  template<typename I, typename X>
+  bool b (const I& i, const X& x) const
+  {
+    return true;
+  }
+
+  template<typename E, typename X>
+  double g (const E& e, const X& x) const
+  {
+    auto global = e.geometry().global(x);
+    return global.two_norm2();
+  }
+
+  template<typename I, typename X>
+  double j (const I& i, const X& x) const
+  {
+    return 0.0;
+  }
+};
+
+// Perturbs the coefficients of every cell selected by the given index and returns the
+// cells whose coefficients changed, which for conforming spaces includes their neighbors.
+template<typename GFS, typename CC, typename X>
+std::vector<bool> perturbCells(const GFS& gfs, const CC& cc, X& x, std::size_t offset)
+{
+  using LFS = Dune::PDELab::LocalFunctionSpace<GFS>;
+  using LFSCache = Dune::PDELab::LFSIndexCache<LFS>;
+  LFS lfs(gfs);
+  LFSCache lfs_cache(lfs);
+
+  const auto& es = gfs.entitySet();
+  X x_old(x);
+  for (const auto& e : elements(es))
+    {
+      if (es.indexSet().index(e) % 11 != offset)
+        continue;
+      lfs.bind(e);
+      lfs_cache.update();
+      for (std::size_t i = 0; i < lfs_cache.size(); ++i)
+        x[lfs_cache.containerIndex(i)] += 0.1 * (i + 1);
+    }
+  // keep the Dirichlet values
+  Dune::PDELab::copy_constrained_dofs(cc,x_old,x);
+
+  std::vector<bool> marked(es.size(0),false);
+  for (const auto& e : elements(es))
+    {
+      lfs.bind(e);
+      lfs_cache.update();
+      for (std::size_t i = 0; i < lfs_cache.size(); ++i)
+        if (x[lfs_cache.containerIndex(i)] != x_old[lfs_cache.containerIndex(i)])
+          marked[es.indexSet().index(e)] = true;
+    }
+  return marked;
+}
+
+// Updates residual and jacobian by partial reassemblies after repeatedly perturbing the
+// solution on a few cells and compares them with a full assembly.
+template<typename GO, typename CC, typename X>
+bool comparePartialAssembly(GO& go, const CC& cc, X x, const std::string& name)
+{
+  using M = typename GO::Traits::Jacobian;
+  const auto& gfs = go.trialGridFunctionSpace();
+
+  go.setContributionCaching(true);
+  X r(gfs,0.0);
+  go.residual(x,r);
+  M a(go,0.0);
+  go.jacobian(x,a);
+
+  bool passed = true;
+  for (std::size_t step = 0; step < 3; ++step)
+    {
+      auto marked = perturbCells(gfs,cc,x,3*step+1);
+      go.residual(x,r,marked);
+      go.jacobian(x,a,marked);
+
+      X r_full(gfs,0.0);
+      go.residual(x,r_full);
+      r_full -= r;
+      if (r_full.infinity_norm() > 1e-12 * std::max(r.infinity_norm(),1.0))
+        {
+          std::cerr << name << ": partially updated residual differs by " << r_full.infinity_norm() << std::endl;
+          passed = false;
+        }
+
+      M a_full(go,0.0);
+      go.jacobian(x,a_full);
+      auto& native_full = Dune::PDELab::Backend::native(a_full);
+      native_full -= Dune::PDELab::Backend::native(a);
+      if (native_full.frobenius_norm() > 1e-12 * std::max(Dune::PDELab::Backend::native(a).frobenius_norm(),1.0))
+        {
+          std::cerr << name << ": partially updated jacobian differs by " << native_full.frobenius_norm() << std::endl;
+          passed = false;
+        }
+
+      // the full assemblies refreshed the cache, continue from their results
+      go.residual(x,r);
+      a = 0.0;
+      go.jacobian(x,a);
+    }
+
+  // partial assembly without cached contributions has to be rejected
+  go.setContributionCaching(false);
+  try
+    {
+      std::vector<bool> marked(gfs.entitySet().size(0),false);
+      go.residual(x,r,marked);
+      std::cerr << name << ": partial assembly without cached contributions was not rejected" << std::endl;
+      passed = false;
+    }
+  catch (Dune::InvalidStateException&)
+    {}
+
+  return passed;
+}
+
+template<typename GV>
+bool testPartialAssembly(const GV& gv)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  MBE mbe(9);
+
+  bool passed = true;
+
+  // interior penalty DG with skeleton and boundary terms, also using threaded assemblers
+  {
+    using Problem = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+    Problem problem;
+    using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,1,GV::dimension>;
+    FEM fem;
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = Dune::PDELab::EmptyTransformation;
+    CC cc;
+
+    using LOP = Dune::PDELab::ConvectionDiffusionDG<Problem,FEM>;
+    LOP lop(problem);
+
+    using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+    GO go(gfs,cc,gfs,cc,lop,mbe);
+
+    typename GO::Traits::Domain x(gfs,0.0);
+    auto f = [](const auto& p){ return std::sin(3.0*p[0])*std::cos(2.0*p[1]) + p[0]; };
+    Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gv,f),gfs,x);
+
+    passed &= comparePartialAssembly(go,cc,x,"DG Q1");
+
+    go.assembler().setTopologyCaching(true);
+    passed &= comparePartialAssembly(go,cc,x,"DG Q1 cached topology");
+
+    using ColoredGO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC,
+                                                 Dune::PDELab::ColoredAssembler<GFS,GFS,CC,CC> >;
+    ColoredGO colored_go(gfs,cc,gfs,cc,lop,mbe);
+    colored_go.assembler().setThreads(3);
+    passed &= comparePartialAssembly(colored_go,cc,x,"DG Q1 colored");
+
+    using TaskGO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC,
+                                              Dune::PDELab::TaskAssembler<GFS,GFS,CC,CC> >;
+    TaskGO task_go(gfs,cc,gfs,cc,lop,mbe);
+    task_go.assembler().setThreads(3);
+    passed &= comparePartialAssembly(task_go,cc,x,"DG Q1 task");
+  }
+
+  // nonlinear conforming Q1 with Dirichlet constraints
+  {
+    using Problem = NonlinearPoissonProblem;
+    Problem problem;
+    using FEM = Dune::PDELab::QkLocalFiniteElementMap<GV,DF,RF,1>;
+    FEM fem(gv);
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = typename GFS::template ConstraintsContainer<RF>::Type;
+    CC cc;
+    auto bctype = Dune::PDELab::makeBoundaryConditionFromCallable(gv,[&](const auto& i, const auto& x){ return problem.b(i,x); });
+    Dune::PDELab::constraints(bctype,gfs,cc);
+
+    using LOP = NonlinearPoissonFEM<Problem,FEM>;
+    LOP lop(problem);
+
+    using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+    GO go(gfs,cc,gfs,cc,lop,mbe);
+
+    typename GO::Traits::Domain x(gfs,0.0);
+    auto g = Dune::PDELab::makeGridFunctionFromCallable(gv,[&](const auto& e, const auto& x){ return problem.g(e,x); });
+    Dune::PDELab::interpolate(g,gfs,x);
+    Dune::PDELab::set_nonconstrained_dofs(cc,0.5,x);
+
+    passed &= comparePartialAssembly(go,cc,x,"nonlinear Q1");
+  }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{10,7}});
+
+    return testPartialAssembly(grid.leafGridView()) ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
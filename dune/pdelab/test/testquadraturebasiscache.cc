@@ -0,0 +1,133 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+#include <dune/pdelab/finiteelement/quadraturebasiscache.hh>
+
+// Compares a table with the direct evaluation of the local basis at the given positions.
+template<typename LocalBasis, typename Table, typename Positions>
+bool compareTable(const LocalBasis& localbasis, const Table& table, const Positions& positions)
+{
+  std::vector<typename LocalBasis::Traits::RangeType> phi;
+  std::vector<typename LocalBasis::Traits::JacobianType> js;
+  double difference = 0.0;
+  if (table.points() != positions.size() || table.size() != localbasis.size())
+    return false;
+  for (std::size_t q=0; q<positions.size(); ++q)
+    {
+      localbasis.evaluateFunction(positions[q],phi);
+      localbasis.evaluateJacobian(positions[q],js);
+      auto tabulated_phi = table.function(q);
+      auto tabulated_js = table.jacobian(q);
+      for (std::size_t i=0; i<localbasis.size(); ++i)
+        {
+          difference = std::max(difference,std::abs(tabulated_phi[i][0]-phi[i][0]));
+          auto d = tabulated_js[i][0];
+          d -= js[i][0];
+          difference = std::max(difference,d.infinity_norm());
+        }
+    }
+  return difference < 1e-14;
+}
+
+// Checks the tables of a DG basis in the cells and on both sides of all intersections
+// against direct evaluation, and checks that tables are reused by repeated lookups, by
+// copies of the cache and by concurrent lookups.
+template<typename GV>
+bool testQuadratureBasisCache(const GV& gv)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,2,GV::dimension>;
+  FEM fem;
+  using LocalBasis = typename FEM::Traits::FiniteElementType::Traits::LocalBasisType;
+
+  Dune::PDELab::QuadratureBasisCache<LocalBasis> cache;
+  auto copy = cache;
+
+  bool passed = true;
+  for (const auto& cell : elements(gv))
+    {
+      const auto& localbasis = fem.find(cell).localBasis();
+      auto rule = quadratureRule(cell.geometry(),4);
+      const auto& table = cache.table(localbasis,rule);
+      std::vector<typename LocalBasis::Traits::DomainType> positions;
+      for (const auto& ip : rule)
+        positions.push_back(ip.position());
+      passed &= compareTable(localbasis,table,positions);
+      passed &= &copy.table(localbasis,rule) == &table;
+
+      for (const auto& is : intersections(gv,cell))
+        {
+          auto face_rule = quadratureRule(is.geometry(),4);
+          const auto& face_table = cache.table(localbasis,face_rule,is.geometryInInside());
+          std::vector<typename LocalBasis::Traits::DomainType> face_positions;
+          for (const auto& ip : face_rule)
+            face_positions.push_back(is.geometryInInside().global(ip.position()));
+          passed &= compareTable(localbasis,face_table,face_positions);
+          passed &= &cache.table(localbasis,face_rule,is.geometryInInside()) == &face_table;
+
+          if (is.neighbor())
+            {
+              const auto& outside_table = copy.table(localbasis,face_rule,is.geometryInOutside());
+              passed &= &outside_table != &face_table;
+              face_positions.clear();
+              for (const auto& ip : face_rule)
+                face_positions.push_back(is.geometryInOutside().global(ip.position()));
+              passed &= compareTable(localbasis,outside_table,face_positions);
+            }
+        }
+    }
+  if (!passed)
+    std::cerr << "tabulated basis differs from direct evaluation or was not reused" << std::endl;
+
+  // concurrent lookups of new and existing tables all obtain the same table
+  auto cell = *gv.template begin<0>();
+  const auto& localbasis = fem.find(cell).localBasis();
+  auto rule = quadratureRule(cell.geometry(),7);
+  std::vector<const typename Dune::PDELab::QuadratureBasisCache<LocalBasis>::Table*> tables(4);
+  std::vector<std::thread> threads;
+  for (std::size_t t=0; t<tables.size(); ++t)
+    threads.emplace_back([&,t](){ tables[t] = &cache.table(localbasis,rule); });
+  for (auto& thread : threads)
+    thread.join();
+  for (auto table : tables)
+    if (table != tables[0] || table != &cache.table(localbasis,rule))
+      {
+        std::cerr << "concurrent lookups returned different tables" << std::endl;
+        passed = false;
+      }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{4,3}});
+
+    return testQuadratureBasisCache(grid.leafGridView()) ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,249 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+#include <dune/pdelab/gridoperator/default/coloredassembler.hh>
+#include <dune/pdelab/gridoperator/default/taskassembler.hh>
+
+#include "nonlinearpoissonfem.hh"
+
+// Nonlinear Poisson problem -Delta u + u^2 = f with the exact solution u = |x|^2
+class NonlinearPoissonProblem
+{
+public:
+  typedef double value_type;
+
+  double q (double u) const
+  {
+    return u*u;
+  }
+
+  template<typename E, typename X>
+  double f (const E& e, const X& x) const
+  {
+    auto global = e.geometry().global(x);
+    return -2.0*x.size() + global.two_norm2()*global.two_norm2();
+  }
+
+  template<typename I, typename X>
+  bool b (const I& i, const X& x) const
+  {
+    return true;
+  }
+
+  template<typename E, typename X>
+  double g (const E& e, const X& x) const
+  {
+    auto global = e.geometry().global(x);
+    return global.two_norm2();
+  }
+
+  template<typename I, typename X>
+  double j (const I& i, const X& x) const
+  {
+    return 0.0;
+  }
+};
+
+// Local operator evaluating residual and jacobian of the volume term in a single method
+template<typename Param, typename FEM>
+class FusedNonlinearPoissonFEM
+  : public NonlinearPoissonFEM<Param,FEM>
+{
+  typedef NonlinearPoissonFEM<Param,FEM> Base;
+
+public:
+  FusedNonlinearPoissonFEM (Param& param)
+    : Base(param)
+    , fused_calls(0)
+  {}
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R, typename M>
+  void alpha_and_jacobian_volume (const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv,
+                                  R& r, M& mat) const
+  {
+    ++fused_calls;
+    Base::alpha_volume(eg,lfsu,x,lfsv,r);
+    Base::jacobian_volume(eg,lfsu,x,lfsv,mat);
+  }
+
+  mutable std::size_t fused_calls;
+};
+
+// Compares residual and jacobian assembled in a single grid traversal with the separately
+// assembled ones. The assembly is repeated to exercise the recorded matrix scatter map.
+template<typename GO, typename X>
+bool compareWithSeparateAssembly(const GO& go, const X& x, const std::string& name)
+{
+  using M = typename GO::Traits::Jacobian;
+  const auto& gfs = go.trialGridFunctionSpace();
+
+  X r(gfs,0.0);
+  go.residual(x,r);
+  M a(go,0.0);
+  go.jacobian(x,a);
+
+  bool passed = true;
+  for (int i = 0; i < 2; ++i)
+    {
+      X r_fused(gfs,0.0);
+      M a_fused(go,0.0);
+      go.residual_and_jacobian(x,r_fused,a_fused);
+
+      r_fused -= r;
+      if (r_fused.infinity_norm() > 1e-12 * std::max(r.infinity_norm(),1.0))
+        {
+          std::cerr << name << ": residuals differ by " << r_fused.infinity_norm() << std::endl;
+          passed = false;
+        }
+
+      auto& native_fused = Dune::PDELab::Backend::native(a_fused);
+      native_fused -= Dune::PDELab::Backend::native(a);
+      if (native_fused.frobenius_norm() > 1e-12 * std::max(Dune::PDELab::Backend::native(a).frobenius_norm(),1.0))
+        {
+          std::cerr << name << ": jacobians differ by " << native_fused.frobenius_norm() << std::endl;
+          passed = false;
+        }
+    }
+  return passed;
+}
+
+template<typename GV>
+bool testResidualJacobian(const GV& gv)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  MBE mbe(9);
+
+  bool passed = true;
+
+  // interior penalty DG with skeleton and boundary terms, also using threaded assemblers
+  {
+    using Problem = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+    Problem problem;
+    using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,1,GV::dimension>;
+    FEM fem;
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = Dune::PDELab::EmptyTransformation;
+    CC cc;
+
+    using LOP = Dune::PDELab::ConvectionDiffusionDG<Problem,FEM>;
+    LOP lop(problem);
+
+    using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+    GO go(gfs,cc,gfs,cc,lop,mbe);
+
+    typename GO::Traits::Domain x(gfs,0.0);
+    auto f = [](const auto& p){ return std::sin(3.0*p[0])*std::cos(2.0*p[1]) + p[0]; };
+    Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gv,f),gfs,x);
+
+    passed &= compareWithSeparateAssembly(go,x,"DG Q1");
+
+    using ColoredGO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC,
+                                                 Dune::PDELab::ColoredAssembler<GFS,GFS,CC,CC> >;
+    ColoredGO colored_go(gfs,cc,gfs,cc,lop,mbe);
+    colored_go.assembler().setThreads(3);
+    passed &= compareWithSeparateAssembly(colored_go,x,"DG Q1 colored");
+
+    using TaskGO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC,
+                                              Dune::PDELab::TaskAssembler<GFS,GFS,CC,CC> >;
+    TaskGO task_go(gfs,cc,gfs,cc,lop,mbe);
+    task_go.assembler().setThreads(3);
+    passed &= compareWithSeparateAssembly(task_go,x,"DG Q1 task");
+  }
+
+  // nonlinear conforming Q1 with Dirichlet constraints and a combined volume method
+  {
+    using Problem = NonlinearPoissonProblem;
+    Problem problem;
+    using FEM = Dune::PDELab::QkLocalFiniteElementMap<GV,DF,RF,1>;
+    FEM fem(gv);
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = typename GFS::template ConstraintsContainer<RF>::Type;
+    CC cc;
+    auto bctype = Dune::PDELab::makeBoundaryConditionFromCallable(gv,[&](const auto& i, const auto& x){ return problem.b(i,x); });
+    Dune::PDELab::constraints(bctype,gfs,cc);
+
+    using LOP = FusedNonlinearPoissonFEM<Problem,FEM>;
+    LOP lop(problem);
+
+    using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+    GO go(gfs,cc,gfs,cc,lop,mbe);
+
+    using X = typename GO::Traits::Domain;
+    X x(gfs,0.0);
+    auto g = Dune::PDELab::makeGridFunctionFromCallable(gv,[&](const auto& e, const auto& x){ return problem.g(e,x); });
+    Dune::PDELab::interpolate(g,gfs,x);
+    Dune::PDELab::set_nonconstrained_dofs(cc,0.5,x);
+
+    passed &= compareWithSeparateAssembly(go,x,"nonlinear Q1");
+    if (lop.fused_calls == 0)
+      {
+        std::cerr << "nonlinear Q1: combined volume method was not used" << std::endl;
+        passed = false;
+      }
+
+    // Newton with and without assembling residual and jacobian in a single traversal
+    using LS = Dune::PDELab::ISTLBackend_SEQ_CG_SSOR;
+    LS ls(5000,0);
+    Dune::PDELab::set_nonconstrained_dofs(cc,0.0,x);
+    X x_fused(x);
+
+    Dune::PDELab::NewtonMethod<GO,LS> newton(go,ls);
+    newton.setReduction(1e-10);
+    newton.apply(x);
+
+    Dune::PDELab::NewtonMethod<GO,LS> fused_newton(go,ls);
+    fused_newton.setReduction(1e-10);
+    fused_newton.setFusedAssembly(true);
+    fused_newton.apply(x_fused);
+
+    if (fused_newton.result().iterations != newton.result().iterations)
+      {
+        std::cerr << "Newton: iteration counts differ: " << fused_newton.result().iterations
+                  << " vs. " << newton.result().iterations << std::endl;
+        passed = false;
+      }
+    x_fused -= x;
+    if (x_fused.infinity_norm() > 1e-10 * std::max(x.infinity_norm(),1.0))
+      {
+        std::cerr << "Newton: solutions differ by " << x_fused.infinity_norm() << std::endl;
+        passed = false;
+      }
+  }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{10,7}});
+
+    return testResidualJacobian(grid.leafGridView()) ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,171 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Solves the heat equation with the exact solution u(x,t) = sin(t) + x_0, which is contained in
+// the Q1 space, so the error at the final time is the error of the Rosenbrock methods. The
+// source term depends on time, which requires the time derivative of the residual for the
+// full order of ROS3P and RODASP.
+template<typename GV, typename RF>
+class LinearInTimeProblem
+  : public Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>
+{
+  using Base = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+
+public:
+  using Traits = typename Base::Traits;
+
+  LinearInTimeProblem() : time(0.0) {}
+
+  typename Traits::RangeFieldType
+  f (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return std::cos(time);
+  }
+
+  Dune::PDELab::ConvectionDiffusionBoundaryConditions::Type
+  bctype (const typename Traits::IntersectionType& is, const typename Traits::IntersectionDomainType& x) const
+  {
+    return Dune::PDELab::ConvectionDiffusionBoundaryConditions::Neumann;
+  }
+
+  typename Traits::RangeFieldType
+  j (const typename Traits::IntersectionType& is, const typename Traits::IntersectionDomainType& x) const
+  {
+    // flux -grad u * n
+    return -is.centerUnitOuterNormal()[0];
+  }
+
+  void setTime (RF t)
+  {
+    time = t;
+  }
+
+private:
+  RF time;
+};
+
+template<typename GFS, typename Problem>
+class RosenbrockTest
+{
+public:
+  using RF = double;
+  using FEM = typename GFS::Traits::FiniteElementMap;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using LOP = Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM>;
+  using TLOP = Dune::PDELab::L2;
+  using GO0 = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF>;
+  using GO1 = Dune::PDELab::GridOperator<GFS,GFS,TLOP,MBE,RF,RF,RF>;
+  using IGO = Dune::PDELab::OneStepGridOperator<GO0,GO1>;
+  using V = typename IGO::Traits::Domain;
+  // keeps the AMG hierarchy of the first stage for the other stages
+  using LS = Dune::PDELab::ISTLBackend_SEQ_CG_AMG_SSOR<IGO>;
+
+  RosenbrockTest(const GFS& gfs_, Problem& problem)
+    : gfs(gfs_), lop(problem), tlop()
+    , go0(gfs,gfs,lop,MBE(9)), go1(gfs,gfs,tlop,MBE(9))
+    , igo(go0,go1)
+  {}
+
+  // error at time T
+  RF error(const Dune::PDELab::RosenbrockParameterInterface<RF>& method, RF T, int steps, bool time_derivative = true)
+  {
+    LS ls(5000,0);
+    Dune::PDELab::RosenbrockOneStepMethod<RF,IGO,LS,V> osm(method,igo,ls);
+    osm.setVerbosityLevel(0);
+    osm.setLinearReduction(1e-13);
+    osm.setTimeDerivative(time_derivative);
+    V x(gfs,0.0);
+    interpolate(x,0.0);
+    const RF dt = T/steps;
+    for (int i = 0; i < steps; ++i)
+      osm.apply(i*dt,dt,x,x);
+    V exact(gfs,0.0);
+    interpolate(exact,T);
+    x -= exact;
+    return x.infinity_norm();
+  }
+
+private:
+
+  void interpolate(V& x, RF t) const
+  {
+    auto u = [t](const auto& xg) { return std::sin(t) + xg[0]; };
+    Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gfs.gridView(),u),gfs,x);
+  }
+
+  const GFS& gfs;
+  LOP lop;
+  TLOP tlop;
+  GO0 go0;
+  GO1 go1;
+  IGO igo;
+};
+
+bool checkOrder(const std::string& name, double coarse, double fine, double order)
+{
+  const double observed = std::log2(coarse/fine);
+  std::cout << name << ": errors " << coarse << " and " << fine << ", observed order " << observed << std::endl;
+  return observed > order - 0.2;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{8,8}});
+    using GV = Dune::YaspGrid<2>::LeafGridView;
+    GV gv = grid.leafGridView();
+    using DF = GV::Grid::ctype;
+    using RF = double;
+
+    using FEM = Dune::PDELab::QkLocalFiniteElementMap<GV,DF,RF,1>;
+    FEM fem(gv);
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,Dune::PDELab::ISTL::VectorBackend<>>;
+    GFS gfs(gv,fem);
+
+    using Problem = LinearInTimeProblem<GV,RF>;
+    Problem problem;
+    RosenbrockTest<GFS,Problem> test(gfs,problem);
+    const RF T = 1.0;
+
+    Dune::PDELab::ROS2Parameter<RF> ros2;
+    passed &= checkOrder("ROS2",test.error(ros2,T,10),test.error(ros2,T,20),2.0);
+
+    Dune::PDELab::ROS3PParameter<RF> ros3p;
+    passed &= checkOrder("ROS3P",test.error(ros3p,T,10),test.error(ros3p,T,20),3.0);
+
+    Dune::PDELab::RODASPParameter<RF> rodasp;
+    passed &= checkOrder("RODASP",test.error(rodasp,T,5),test.error(rodasp,T,10),4.0);
+
+    // without the time derivative of the source term ROS3P is only of first order
+    const double observed = std::log2(test.error(ros3p,T,10,false)/test.error(ros3p,T,20,false));
+    std::cout << "ROS3P without time derivative: observed order " << observed << std::endl;
+    passed &= observed < 2.0;
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
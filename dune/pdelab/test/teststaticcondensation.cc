@@ -0,0 +1,116 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Solves a Poisson problem with conforming Qk elements once with the full system and once with
+// the cell interior DOFs eliminated by static condensation, and compares the solutions and the
+// sizes of the matrices.
+template<int k, typename GV>
+bool testStaticCondensation(const GV& gv, const std::string& name)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using Problem = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+  Problem problem;
+
+  using FEM = Dune::PDELab::QkLocalFiniteElementMap<GV,DF,RF,k>;
+  FEM fem(gv);
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+  using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,VBE>;
+  GFS gfs(gv,fem);
+  using CC = typename GFS::template ConstraintsContainer<RF>::Type;
+  CC cc;
+  Dune::PDELab::ConvectionDiffusionBoundaryConditionAdapter<Problem> bctype(gv,problem);
+  Dune::PDELab::constraints(bctype,gfs,cc);
+
+  using LOP = Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM>;
+  LOP lop(problem);
+
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+  GO go(gfs,cc,gfs,cc,lop,MBE(2*k+1));
+  GO go_condensed(gfs,cc,gfs,cc,lop,MBE(2*k+1));
+  go_condensed.setStaticCondensation(true);
+
+  using V = typename GO::Traits::Domain;
+  V x0(gfs,0.0);
+  Dune::PDELab::ConvectionDiffusionDirichletExtensionAdapter<Problem> g(gv,problem);
+  Dune::PDELab::interpolate(g,gfs,x0);
+
+  bool passed = true;
+
+  // full system
+  V x(x0);
+  using LS = Dune::PDELab::ISTLBackend_SEQ_CG_SSOR;
+  LS ls(5000,0);
+  Dune::PDELab::StationaryLinearProblemSolver<GO,LS,V> slp(go,ls,x,1e-12,1e-99,0);
+  slp.apply();
+  typename GO::Traits::Jacobian jac(go);
+
+  // condensed system
+  V x_condensed(x0);
+  typename GO::Traits::Jacobian jac_condensed(go_condensed);
+  V r(gfs,0.0);
+  go_condensed.condensed_residual_and_jacobian(x_condensed,r,jac_condensed);
+  V z(gfs,0.0);
+  ls.apply(jac_condensed,z,r,1e-12);
+  passed &= ls.result().converged;
+  go_condensed.recover_interior(z);
+  x_condensed -= z;
+
+  x_condensed -= x;
+  const double error = x_condensed.infinity_norm() / x.infinity_norm();
+  using Dune::PDELab::Backend::native;
+  std::cout << name << ": " << native(jac_condensed).nonzeroes() << " of " << native(jac).nonzeroes()
+            << " matrix entries stored, relative difference of the solutions " << error << std::endl;
+  passed &= error < 1e-8;
+  passed &= native(jac_condensed).nonzeroes() < native(jac).nonzeroes();
+
+  // recovering requires a preceding condensed assembly
+  go_condensed.update();
+  try {
+    go_condensed.recover_interior(z);
+    std::cerr << name << ": recover_interior() without condensed assembly did not throw" << std::endl;
+    passed = false;
+  }
+  catch (Dune::InvalidStateException&) {}
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::YaspGrid<2> grid2d({{1.0,1.0}},{{8,6}});
+    passed &= testStaticCondensation<3>(grid2d.leafGridView(),"2D Q3");
+    passed &= testStaticCondensation<4>(grid2d.leafGridView(),"2D Q4");
+
+    Dune::YaspGrid<3> grid3d({{1.0,1.0,1.0}},{{3,3,2}});
+    passed &= testStaticCondensation<2>(grid3d.leafGridView(),"3D Q2");
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,253 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+#include <dune/pdelab/finiteelement/sumfactorization.hh>
+
+// Compares all kernels with the direct evaluation of the local basis at the points of the
+// tensor product rule, in the cell and on all faces.
+template<typename LocalBasis>
+bool testKernel(const LocalBasis& localbasis, int order, const std::string& name)
+{
+  constexpr int dim = LocalBasis::Traits::dimDomain;
+  auto kernel = Dune::PDELab::makeSumFactorizationKernel(localbasis,order);
+  const std::size_t n = kernel.size();
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distribution(-1.0,1.0);
+  auto random = [&](std::size_t size){
+    std::vector<double> v(size);
+    for (auto& entry : v)
+      entry = distribution(generator);
+    return v;
+  };
+
+  std::vector<typename LocalBasis::Traits::RangeType> phi;
+  std::vector<typename LocalBasis::Traits::JacobianType> js;
+  double difference = 0.0;
+
+  // evaluates at the given points and tests the given values and vectors against the basis
+  auto compare = [&](std::size_t points, auto position, auto evaluate, auto evaluateGradient,
+                     auto integrate, auto integrateGradient)
+    {
+      auto x = random(n);
+      std::vector<double> u(points), grad(dim*points);
+      evaluate(x.data(),u.data());
+      evaluateGradient(x.data(),grad.data());
+      auto values = random(points);
+      auto vectors = random(dim*points);
+      std::vector<double> r(n,1.0);
+      integrate(values.data(),r.data());
+      integrateGradient(vectors.data(),r.data());
+
+      std::vector<double> r_direct(n,1.0);
+      for (std::size_t q=0; q<points; ++q)
+        {
+          localbasis.evaluateFunction(position(q),phi);
+          localbasis.evaluateJacobian(position(q),js);
+          double u_direct = 0.0;
+          for (std::size_t i=0; i<n; ++i)
+            {
+              u_direct += x[i]*phi[i][0];
+              r_direct[i] += values[q]*phi[i][0];
+            }
+          difference = std::max(difference,std::abs(u_direct-u[q]));
+          for (int j=0; j<dim; ++j)
+            {
+              double grad_direct = 0.0;
+              for (std::size_t i=0; i<n; ++i)
+                {
+                  grad_direct += x[i]*js[i][0][j];
+                  r_direct[i] += vectors[j*points+q]*js[i][0][j];
+                }
+              difference = std::max(difference,std::abs(grad_direct-grad[j*points+q]));
+            }
+        }
+      for (std::size_t i=0; i<n; ++i)
+        difference = std::max(difference,std::abs(r_direct[i]-r[i]));
+    };
+
+  compare(kernel.points(),
+          [&](std::size_t q){ return kernel.position(q); },
+          [&](const double* x, double* u){ kernel.evaluate(x,u); },
+          [&](const double* x, double* g){ kernel.evaluateGradient(x,g); },
+          [&](const double* v, double* r){ kernel.integrate(v,r); },
+          [&](const double* v, double* r){ kernel.integrateGradient(v,r); });
+  for (int face=0; face<2*dim; ++face)
+    compare(kernel.facePoints(),
+            [&](std::size_t q){ return kernel.facePosition(face,q); },
+            [&](const double* x, double* u){ kernel.evaluateFace(face,x,u); },
+            [&](const double* x, double* g){ kernel.evaluateFaceGradient(face,x,g); },
+            [&](const double* v, double* r){ kernel.integrateFace(face,v,r); },
+            [&](const double* v, double* r){ kernel.integrateFaceGradient(face,v,r); });
+
+  std::cout << name << ": maximum difference to direct evaluation: " << difference << std::endl;
+  return difference < 1e-11;
+}
+
+// Volume part of -Laplace u + u for the fast DG assembler, integrated either with the sum
+// factorization kernel or by evaluating all basis functions at all quadrature points.
+template<typename FEM, bool sumfactorized>
+class MassStiffnessFastDG
+  : public Dune::PDELab::FullVolumePattern,
+    public Dune::PDELab::LocalOperatorDefaultFlags
+{
+  using LocalBasis = typename FEM::Traits::FiniteElementType::Traits::LocalBasisType;
+  using Kernel = decltype(Dune::PDELab::makeSumFactorizationKernel<LocalBasis>(0));
+  static constexpr int dim = LocalBasis::Traits::dimDomain;
+
+public:
+  enum { doPatternVolume = true };
+  enum { doAlphaVolume = true };
+
+  MassStiffnessFastDG(int order)
+    : kernel(Dune::PDELab::makeSumFactorizationKernel<LocalBasis>(order))
+  {}
+
+  template<typename EG, typename LFSU, typename X, typename LFSV, typename R>
+  void alpha_volume(const EG& eg, const LFSU& lfsu, const X& x, const LFSV& lfsv, R& r) const
+  {
+    alpha_volume(eg,lfsu,x,r,std::integral_constant<bool,sumfactorized>());
+  }
+
+private:
+
+  template<typename EG, typename LFSU, typename X, typename R>
+  void alpha_volume(const EG& eg, const LFSU& lfsu, const X& x, R& r, std::true_type) const
+  {
+    auto geo = eg.geometry();
+    const std::size_t points = kernel.points();
+    std::vector<double> u(points), grad(dim*points);
+    kernel.evaluate(x.data(),u.data());
+    kernel.evaluateGradient(x.data(),grad.data());
+    for (std::size_t q=0; q<points; ++q)
+      {
+        auto position = kernel.position(q);
+        auto jac = geo.jacobianInverseTransposed(position);
+        auto factor = kernel.weight(q) * geo.integrationElement(position) * r.weight();
+        Dune::FieldVector<double,dim> gradhat, gradu, flux;
+        for (int j=0; j<dim; ++j)
+          gradhat[j] = grad[j*points+q];
+        jac.mv(gradhat,gradu);
+        jac.mtv(gradu,flux);
+        u[q] *= factor;
+        for (int j=0; j<dim; ++j)
+          grad[j*points+q] = flux[j]*factor;
+      }
+    kernel.integrate(u.data(),r.data());
+    kernel.integrateGradient(grad.data(),r.data());
+  }
+
+  template<typename EG, typename LFSU, typename X, typename R>
+  void alpha_volume(const EG& eg, const LFSU& lfsu, const X& x, R& r, std::false_type) const
+  {
+    auto geo = eg.geometry();
+    const auto& localbasis = lfsu.finiteElement().localBasis();
+    std::vector<typename LocalBasis::Traits::RangeType> phi;
+    std::vector<typename LocalBasis::Traits::JacobianType> js;
+    for (std::size_t q=0; q<kernel.points(); ++q)
+      {
+        auto position = kernel.position(q);
+        localbasis.evaluateFunction(position,phi);
+        localbasis.evaluateJacobian(position,js);
+        auto jac = geo.jacobianInverseTransposed(position);
+        std::vector<Dune::FieldVector<double,dim> > gradphi(lfsu.size());
+        double u = 0.0;
+        Dune::FieldVector<double,dim> gradu(0.0);
+        for (std::size_t i=0; i<lfsu.size(); ++i)
+          {
+            jac.mv(js[i][0],gradphi[i]);
+            u += x[i]*phi[i][0];
+            gradu.axpy(x[i],gradphi[i]);
+          }
+        auto factor = kernel.weight(q) * geo.integrationElement(position) * r.weight();
+        for (std::size_t i=0; i<lfsu.size(); ++i)
+          r.data()[i] += (u*phi[i][0] + gradu*gradphi[i])*factor;
+      }
+  }
+
+  Kernel kernel;
+};
+
+// Assembles the residual with the fast DG assembler using the sum-factorized and the direct
+// integration and compares the results.
+template<int degree, typename GV>
+bool testFastDG(const GV& gv)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,degree,GV::dimension>;
+  FEM fem;
+  const int blocksize = Dune::QkStuff::QkSize<degree,GV::dimension>::value;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<Dune::PDELab::ISTL::Blocking::fixed,blocksize>;
+  using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+  GFS gfs(gv,fem);
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using CC = Dune::PDELab::EmptyTransformation;
+
+  using SumFactorizedLOP = MassStiffnessFastDG<FEM,true>;
+  SumFactorizedLOP sumfactorized_lop(2*degree);
+  using SumFactorizedGO = Dune::PDELab::FastDGGridOperator<GFS,GFS,SumFactorizedLOP,MBE,RF,RF,RF,CC,CC>;
+  SumFactorizedGO sumfactorized_go(gfs,gfs,sumfactorized_lop,MBE(1));
+
+  using DirectLOP = MassStiffnessFastDG<FEM,false>;
+  DirectLOP direct_lop(2*degree);
+  using DirectGO = Dune::PDELab::FastDGGridOperator<GFS,GFS,DirectLOP,MBE,RF,RF,RF,CC,CC>;
+  DirectGO direct_go(gfs,gfs,direct_lop,MBE(1));
+
+  typename SumFactorizedGO::Traits::Domain x(gfs,0.0);
+  auto f = [](const auto& p){ return std::exp(p[0])*std::sin(3.0*p[1]); };
+  Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gv,f),gfs,x);
+
+  typename SumFactorizedGO::Traits::Range r_sumfactorized(gfs,0.0), r_direct(gfs,0.0);
+  sumfactorized_go.residual(x,r_sumfactorized);
+  direct_go.residual(x,r_direct);
+
+  r_sumfactorized -= r_direct;
+  const double difference = r_sumfactorized.infinity_norm() / r_direct.infinity_norm();
+  std::cout << "fast DG residual with degree " << degree << ": relative difference: " << difference << std::endl;
+  return difference < 1e-12;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    passed &= testKernel(Dune::QkDGLagrangeLocalFiniteElement<double,double,3,2>().localBasis(),7,"Lagrange, k=3, d=2");
+    passed &= testKernel(Dune::QkDGLagrangeLocalFiniteElement<double,double,2,3>().localBasis(),6,"Lagrange, k=2, d=3");
+    passed &= testKernel(Dune::QkDGLegendreLocalFiniteElement<double,double,4,2>().localBasis(),8,"Legendre, k=4, d=2");
+    passed &= testKernel(Dune::QkDGLegendreLocalFiniteElement<double,double,3,3>().localBasis(),6,"Legendre, k=3, d=3");
+    passed &= testKernel(Dune::QkDGGLLocalFiniteElement<double,double,5,2>().localBasis(),10,"Gauss-Lobatto, k=5, d=2");
+
+    Dune::YaspGrid<2> grid({{1.0,2.0}},{{4,5}});
+    passed &= testFastDG<3>(grid.leafGridView());
+
+    Dune::YaspGrid<3> grid3d({{1.0,1.0,1.0}},{{2,3,2}});
+    passed &= testFastDG<2>(grid3d.leafGridView());
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
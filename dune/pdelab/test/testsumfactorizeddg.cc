@@ -0,0 +1,272 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+#include <dune/pdelab/backend/istl/sumfactorizeddg.hh>
+
+// Convection-diffusion-reaction with constant anisotropic diffusion, Dirichlet boundary
+// conditions on the left and right, outflow on the top and Neumann on all other faces.
+template<typename GV, typename RF>
+class AnisotropicProblem
+{
+  typedef Dune::PDELab::ConvectionDiffusionBoundaryConditions::Type BCType;
+
+public:
+  typedef Dune::PDELab::ConvectionDiffusionParameterTraits<GV,RF> Traits;
+
+  AnisotropicProblem ()
+  {
+    for (std::size_t i=0; i<Traits::dimDomain; i++)
+      for (std::size_t j=0; j<Traits::dimDomain; j++)
+        K[i][j] = (i==j) ? 1.0+i : 0.25;
+    for (std::size_t i=0; i<Traits::dimDomain; i++)
+      v[i] = 0.0;
+    v[0] = 1.0;
+    v[1] = 0.5;
+  }
+
+  static constexpr bool permeabilityIsConstantPerCell()
+  {
+    return true;
+  }
+
+  typename Traits::PermTensorType
+  A (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return K;
+  }
+
+  typename Traits::RangeType
+  b (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return v;
+  }
+
+  typename Traits::RangeFieldType
+  c (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return 2.0;
+  }
+
+  typename Traits::RangeFieldType
+  f (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return 0.0;
+  }
+
+  BCType
+  bctype (const typename Traits::IntersectionType& is, const typename Traits::IntersectionDomainType& xlocal) const
+  {
+    auto x = is.geometry().global(xlocal);
+    if (x[0] < 1e-8 || x[0] > 1.0-1e-8)
+      return Dune::PDELab::ConvectionDiffusionBoundaryConditions::Dirichlet;
+    if (x[1] > 1.0-1e-8)
+      return Dune::PDELab::ConvectionDiffusionBoundaryConditions::Outflow;
+    return Dune::PDELab::ConvectionDiffusionBoundaryConditions::Neumann;
+  }
+
+  typename Traits::RangeFieldType
+  g (const typename Traits::ElementType& e, const typename Traits::DomainType& xlocal) const
+  {
+    return 0.0;
+  }
+
+  typename Traits::RangeFieldType
+  j (const typename Traits::IntersectionType& is, const typename Traits::IntersectionDomainType& x) const
+  {
+    return 0.0;
+  }
+
+  typename Traits::RangeFieldType
+  o (const typename Traits::IntersectionType& is, const typename Traits::IntersectionDomainType& x) const
+  {
+    return 0.0;
+  }
+
+private:
+  typename Traits::PermTensorType K;
+  typename Traits::RangeType v;
+};
+
+// The same problem with a reaction coefficient that varies within the cells.
+template<typename GV, typename RF>
+class VaryingReactionProblem
+  : public AnisotropicProblem<GV,RF>
+{
+public:
+  typedef typename AnisotropicProblem<GV,RF>::Traits Traits;
+
+  typename Traits::RangeFieldType
+  c (const typename Traits::ElementType& e, const typename Traits::DomainType& x) const
+  {
+    return 2.0 + x[0];
+  }
+};
+
+// Compares the matrix-free operator, its diagonal blocks and both preconditioners with the
+// jacobian assembled from ConvectionDiffusionDG, and solves a linear system with it.
+template<int degree, typename GV>
+bool testSumFactorizedDG(const GV& gv, Dune::PDELab::ConvectionDiffusionDGMethod::Type method)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,degree,GV::dimension>;
+  FEM fem;
+  const int blocksize = Dune::QkStuff::QkSize<degree,GV::dimension>::value;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<Dune::PDELab::ISTL::Blocking::fixed,blocksize>;
+  using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+  GFS gfs(gv,fem);
+
+  using Problem = AnisotropicProblem<GV,RF>;
+  Problem problem;
+  using LOP = Dune::PDELab::ConvectionDiffusionDG<Problem,FEM>;
+  LOP lop(problem,method,Dune::PDELab::ConvectionDiffusionDGWeights::weightsOn,2.0);
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using CC = Dune::PDELab::EmptyTransformation;
+  using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+  GO go(gfs,gfs,lop,MBE(9));
+
+  using Operator = Dune::PDELab::SumFactorizedConvectionDiffusionDGOperator<GFS,Problem>;
+  Operator op(gfs,problem,method,Dune::PDELab::ConvectionDiffusionDGWeights::weightsOn,2.0);
+
+  using V = typename GO::Traits::Domain;
+  V x(gfs,0.0);
+  auto f = [](const auto& p){ return std::exp(p[0])*std::sin(3.0*p[1]) + p[0]*p[1]; };
+  Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gv,f),gfs,x);
+
+  bool passed = true;
+
+  // operator application
+  V y_go(gfs,0.0), y(gfs,0.0);
+  go.jacobian_apply(x,y_go);
+  op.apply(x,y);
+  y -= y_go;
+  double difference = y.infinity_norm() / y_go.infinity_norm();
+  std::cout << "degree " << degree << ", dimension " << GV::dimension
+            << ": relative difference of operator application: " << difference << std::endl;
+  passed &= difference < 1e-12;
+
+  // y = y_go + 0.5 A x
+  y = y_go;
+  op.applyscaleadd(0.5,x,y);
+  y.axpy(-1.5,y_go);
+  passed &= y.infinity_norm() < 1e-12 * y_go.infinity_norm();
+
+  // diagonal blocks and preconditioners
+  typename GO::Traits::Jacobian jac(go);
+  go.jacobian(x,jac);
+  std::vector<Dune::DynamicMatrix<RF> > blocks;
+  op.blockDiagonal(blocks);
+  Dune::PDELab::SumFactorizedDGJacobi<Operator> jacobi(op);
+  Dune::PDELab::SumFactorizedDGBlockJacobi<Operator> blockjacobi(op);
+  V v_jacobi(gfs,0.0), v_blockjacobi(gfs,0.0);
+  jacobi.apply(v_jacobi,x);
+  blockjacobi.apply(v_blockjacobi,x);
+
+  using LFS = Dune::PDELab::LocalFunctionSpace<GFS>;
+  LFS lfs(gfs);
+  Dune::PDELab::LFSIndexCache<LFS> lfs_cache(lfs);
+  double block_difference = 0.0, scale = 0.0, preconditioner_difference = 0.0;
+  for (const auto& cell : elements(gv))
+    {
+      lfs.bind(cell);
+      lfs_cache.update();
+      const auto& block = blocks[gv.indexSet().index(cell)];
+      for (std::size_t i=0; i<lfs.size(); ++i)
+        {
+          const auto& ci = lfs_cache.containerIndex(i);
+          preconditioner_difference = std::max(preconditioner_difference,
+                                               std::abs(v_jacobi[ci]*jac(ci,ci) - x[ci]));
+          RF product = 0.0;
+          for (std::size_t j=0; j<lfs.size(); ++j)
+            {
+              const auto& cj = lfs_cache.containerIndex(j);
+              block_difference = std::max(block_difference,std::abs(block[i][j] - jac(ci,cj)));
+              scale = std::max(scale,std::abs(jac(ci,cj)));
+              product += jac(ci,cj)*v_blockjacobi[cj];
+            }
+          preconditioner_difference = std::max(preconditioner_difference,std::abs(product - x[ci]));
+        }
+    }
+  std::cout << "relative difference of diagonal blocks: " << block_difference/scale
+            << ", preconditioner defect: " << preconditioner_difference/x.infinity_norm() << std::endl;
+  passed &= block_difference < 1e-12*scale;
+  passed &= preconditioner_difference < 1e-10*x.infinity_norm();
+
+  // solve A z = A x
+  using Solver = Dune::PDELab::ISTLBackend_SEQ_MatrixFree_SumFactorizedDG_BCGS<Operator>;
+  Solver solver(op,5000,1);
+  V z(gfs,0.0);
+  V r = y_go;
+  solver.apply(z,r,1e-12);
+  z -= x;
+  double error = z.infinity_norm() / x.infinity_norm();
+  std::cout << "relative error of the solution after " << solver.result().iterations
+            << " iterations: " << error << std::endl;
+  passed &= solver.result().converged;
+  passed &= error < 1e-8;
+
+  return passed;
+}
+
+// Checks that the operator rejects coefficients that are not constant per cell.
+template<typename GV>
+bool testVaryingCoefficients(const GV& gv)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,1,GV::dimension>;
+  FEM fem;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<Dune::PDELab::ISTL::Blocking::fixed,4>;
+  using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+  GFS gfs(gv,fem);
+
+  using Problem = VaryingReactionProblem<GV,RF>;
+  Problem problem;
+  try {
+    Dune::PDELab::SumFactorizedConvectionDiffusionDGOperator<GFS,Problem> op(gfs,problem);
+  }
+  catch (Dune::NotImplemented&) {
+    return true;
+  }
+  std::cerr << "operator accepted a reaction coefficient that varies within the cells" << std::endl;
+  return false;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    bool passed = true;
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{5,4}});
+    passed &= testSumFactorizedDG<3>(grid.leafGridView(),Dune::PDELab::ConvectionDiffusionDGMethod::SIPG);
+    passed &= testSumFactorizedDG<2>(grid.leafGridView(),Dune::PDELab::ConvectionDiffusionDGMethod::NIPG);
+    passed &= testVaryingCoefficients(grid.leafGridView());
+
+    Dune::YaspGrid<3> grid3d({{1.0,1.0,1.0}},{{3,2,2}});
+    passed &= testSumFactorizedDG<2>(grid3d.leafGridView(),Dune::PDELab::ConvectionDiffusionDGMethod::SIPG);
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
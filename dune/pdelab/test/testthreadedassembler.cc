@@ -0,0 +1,156 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+#include <dune/pdelab/gridoperator/default/coloredassembler.hh>
+#include <dune/pdelab/gridoperator/default/taskassembler.hh>
+
+#include "jumppenaltylaplace.hh"
+
+// Compares residual, jacobian and jacobian application of a grid operator using the global
+// assembler GA against the results of a grid operator using the DefaultAssembler.
+template<template<typename,typename,typename,typename> class GA, typename GFS, typename CC, typename LOP>
+bool compareWithDefaultAssembler(const GFS& gfs, const CC& cc, LOP& lop, std::size_t threads, const std::string& name)
+{
+  using RF = double;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  MBE mbe(9);
+
+  using DefaultGO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+  using ThreadedGO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC,GA<GFS,GFS,CC,CC> >;
+  DefaultGO default_go(gfs,cc,gfs,cc,lop,mbe);
+  ThreadedGO threaded_go(gfs,cc,gfs,cc,lop,mbe);
+  threaded_go.assembler().setThreads(threads);
+
+  using X = typename DefaultGO::Traits::Domain;
+  X x(gfs,0.0);
+  auto f = [](const auto& p){ return std::sin(3.0*p[0])*std::cos(2.0*p[1]) + p[0]; };
+  Dune::PDELab::interpolate(Dune::PDELab::makeGridFunctionFromCallable(gfs.gridView(),f),gfs,x);
+
+  bool passed = true;
+
+  // residual
+  X r_default(gfs,0.0);
+  X r_threaded(gfs,0.0);
+  default_go.residual(x,r_default);
+  threaded_go.residual(x,r_threaded);
+  r_threaded -= r_default;
+  if (r_threaded.infinity_norm() > 1e-12 * std::max(r_default.infinity_norm(),1.0))
+    {
+      std::cerr << name << ": residuals differ by " << r_threaded.infinity_norm() << std::endl;
+      passed = false;
+    }
+
+  // jacobian, including the pattern
+  using M = typename DefaultGO::Traits::Jacobian;
+  M a_default(default_go,0.0);
+  M a_threaded(threaded_go,0.0);
+  default_go.jacobian(x,a_default);
+  threaded_go.jacobian(x,a_threaded);
+  auto& native_default = Dune::PDELab::Backend::native(a_default);
+  auto& native_threaded = Dune::PDELab::Backend::native(a_threaded);
+  if (native_default.nonzeroes() != native_threaded.nonzeroes())
+    {
+      std::cerr << name << ": jacobian patterns differ" << std::endl;
+      passed = false;
+    }
+  else
+    {
+      native_threaded -= native_default;
+      if (native_threaded.frobenius_norm() > 1e-12 * std::max(native_default.frobenius_norm(),1.0))
+        {
+          std::cerr << name << ": jacobians differ by " << native_threaded.frobenius_norm() << std::endl;
+          passed = false;
+        }
+    }
+
+  // matrix-free application of the jacobian
+  X y_default(gfs,0.0);
+  X y_threaded(gfs,0.0);
+  default_go.jacobian_apply(x,y_default);
+  threaded_go.jacobian_apply(x,y_threaded);
+  y_threaded -= y_default;
+  if (y_threaded.infinity_norm() > 1e-12 * std::max(y_default.infinity_norm(),1.0))
+    {
+      std::cerr << name << ": jacobian applications differ by " << y_threaded.infinity_norm() << std::endl;
+      passed = false;
+    }
+
+  return passed;
+}
+
+template<template<typename,typename,typename,typename> class GA, typename GV>
+bool testAssembler(const GV& gv, const std::string& name)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+
+  JumpPenaltyLaplace lop;
+  bool passed = true;
+
+  // conforming Q2 space with Dirichlet constraints
+  {
+    using FEM = Dune::PDELab::QkLocalFiniteElementMap<GV,DF,RF,2>;
+    FEM fem(gv);
+    using CON = Dune::PDELab::ConformingDirichletConstraints;
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,CON,VBE>;
+    GFS gfs(gv,fem);
+    using CC = typename GFS::template ConstraintsContainer<RF>::Type;
+    CC cc;
+    auto bctype = Dune::PDELab::makeBoundaryConditionFromCallable(gv,[](const auto& x){ return x[0] < 1e-6; });
+    Dune::PDELab::constraints(bctype,gfs,cc);
+
+    for (std::size_t threads : {1,2,4})
+      passed &= compareWithDefaultAssembler<GA>(gfs,cc,lop,threads,name + " Q2");
+  }
+
+  // discontinuous P0 space, only coupled through skeleton terms
+  {
+    using FEM = Dune::PDELab::P0LocalFiniteElementMap<DF,RF,GV::dimension>;
+    FEM fem(Dune::GeometryTypes::cube(GV::dimension));
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = Dune::PDELab::EmptyTransformation;
+    CC cc;
+
+    for (std::size_t threads : {1,3})
+      passed &= compareWithDefaultAssembler<GA>(gfs,cc,lop,threads,name + " P0");
+  }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{17,13}});
+    auto gv = grid.leafGridView();
+
+    bool passed = true;
+    passed &= testAssembler<Dune::PDELab::ColoredAssembler>(gv,"ColoredAssembler");
+    passed &= testAssembler<Dune::PDELab::TaskAssembler>(gv,"TaskAssembler");
+
+    return passed ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,178 @@
+// -*- tab-width: 4; indent-tabs-mode: nil -*-
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/pdelab.hh>
+
+// Compares a jacobian assembled into upper triangular storage with the full jacobian. Rows and
+// columns of Dirichlet-constrained DOFs only keep their diagonal entry in upper triangular storage.
+template<typename M, typename IsConstrained>
+bool compareUpperTriangle(const M& full, const M& upper, IsConstrained is_constrained, const std::string& name)
+{
+  using Dune::PDELab::Backend::native;
+  bool passed = true;
+  double difference = 0.0;
+  for (auto row = native(upper).begin(); row != native(upper).end(); ++row)
+    for (auto col = row->begin(); col != row->end(); ++col)
+      {
+        const auto i = row.index();
+        const auto j = col.index();
+        if (j < i)
+          {
+            std::cerr << name << ": entry (" << i << "," << j << ") below the diagonal is stored" << std::endl;
+            passed = false;
+            continue;
+          }
+        auto expected = native(full)[i][j];
+        for (std::size_t bi = 0; bi < expected.N(); ++bi)
+          for (std::size_t bj = 0; bj < expected.M(); ++bj)
+            if (is_constrained(i*expected.N()+bi) || is_constrained(j*expected.M()+bj))
+              expected[bi][bj] = (i == j && bi == bj) ? 1.0 : 0.0;
+        expected -= *col;
+        difference = std::max(difference,expected.infinity_norm());
+      }
+  std::cout << name << ": " << native(upper).nonzeroes() << " of " << native(full).nonzeroes()
+            << " blocks stored, maximum difference " << difference << std::endl;
+  passed &= difference < 1e-12;
+  passed &= 2*native(upper).nonzeroes() < native(full).nonzeroes() + 2*native(full).N();
+  return passed;
+}
+
+// Solves the problem with full storage and CG/SSOR and with upper triangular storage and both
+// preconditioners for upper triangular storage, and compares the solutions.
+template<typename GO, typename GOUpper, typename V>
+bool compareSolutions(const GO& go, const GOUpper& go_upper, const V& x0, const std::string& name)
+{
+  bool passed = true;
+
+  V x(x0);
+  Dune::PDELab::ISTLBackend_SEQ_CG_SSOR ls(5000,0);
+  Dune::PDELab::StationaryLinearProblemSolver<GO,Dune::PDELab::ISTLBackend_SEQ_CG_SSOR,V> slp(go,ls,x,1e-12,1e-99,0);
+  slp.apply();
+
+  auto check = [&](auto& ls_upper, const std::string& preconditioner)
+    {
+      V x_upper(x0);
+      using LS = std::decay_t<decltype(ls_upper)>;
+      Dune::PDELab::StationaryLinearProblemSolver<GOUpper,LS,V> slp_upper(go_upper,ls_upper,x_upper,1e-12,1e-99,0);
+      slp_upper.apply();
+      x_upper -= x;
+      const double error = x_upper.infinity_norm() / x.infinity_norm();
+      std::cout << name << ", " << preconditioner << ": " << slp_upper.ls_result().iterations
+                << " iterations, relative difference of the solutions " << error << std::endl;
+      passed &= slp_upper.ls_result().converged;
+      passed &= error < 1e-8;
+    };
+
+  Dune::PDELab::ISTLBackend_SEQ_CG_UpperTriangular_SSOR ls_ssor(5000,0);
+  check(ls_ssor,"SSOR");
+  Dune::PDELab::ISTLBackend_SEQ_CG_UpperTriangular_Jac ls_jac(5000,0);
+  check(ls_jac,"Jacobi");
+
+  return passed;
+}
+
+template<typename GV>
+bool testUpperTriangularStorage(const GV& gv)
+{
+  using DF = typename GV::Grid::ctype;
+  using RF = double;
+  using MBE = Dune::PDELab::ISTL::BCRSMatrixBackend<>;
+  using Problem = Dune::PDELab::ConvectionDiffusionModelProblem<GV,RF>;
+  Problem problem;
+
+  bool passed = true;
+
+  // conforming Q2 with Dirichlet constraints
+  {
+    using FEM = Dune::PDELab::QkLocalFiniteElementMap<GV,DF,RF,2>;
+    FEM fem(gv);
+    using VBE = Dune::PDELab::ISTL::VectorBackend<>;
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::ConformingDirichletConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = typename GFS::template ConstraintsContainer<RF>::Type;
+    CC cc;
+    Dune::PDELab::ConvectionDiffusionBoundaryConditionAdapter<Problem> bctype(gv,problem);
+    Dune::PDELab::constraints(bctype,gfs,cc);
+
+    using LOP = Dune::PDELab::ConvectionDiffusionFEM<Problem,FEM>;
+    LOP lop(problem);
+
+    using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+    GO go(gfs,cc,gfs,cc,lop,MBE(9));
+    GO go_upper(gfs,cc,gfs,cc,lop,MBE(9,Dune::PDELab::ISTL::MatrixStorage::upperTriangular));
+
+    using V = typename GO::Traits::Domain;
+    V x(gfs,0.0);
+    Dune::PDELab::ConvectionDiffusionDirichletExtensionAdapter<Problem> g(gv,problem);
+    Dune::PDELab::interpolate(g,gfs,x);
+
+    typename GO::Traits::Jacobian jac(go), jac_upper(go_upper);
+    go.jacobian(x,jac);
+    go_upper.jacobian(x,jac_upper);
+    V constrained(gfs,0.0);
+    Dune::PDELab::set_constrained_dofs(cc,1.0,constrained);
+    auto is_constrained = [&](std::size_t i){ return Dune::PDELab::Backend::native(constrained)[i][0] != 0.0; };
+    passed &= compareUpperTriangle(jac,jac_upper,is_constrained,"Q2");
+
+    passed &= compareSolutions(go,go_upper,x,"Q2");
+  }
+
+  // symmetric interior penalty DG with blocked vectors
+  {
+    using FEM = Dune::PDELab::QkDGLocalFiniteElementMap<DF,RF,1,GV::dimension>;
+    FEM fem;
+    using VBE = Dune::PDELab::ISTL::VectorBackend<Dune::PDELab::ISTL::Blocking::fixed,4>;
+    using GFS = Dune::PDELab::GridFunctionSpace<GV,FEM,Dune::PDELab::NoConstraints,VBE>;
+    GFS gfs(gv,fem);
+    using CC = Dune::PDELab::EmptyTransformation;
+
+    using LOP = Dune::PDELab::ConvectionDiffusionDG<Problem,FEM>;
+    LOP lop(problem,Dune::PDELab::ConvectionDiffusionDGMethod::SIPG,Dune::PDELab::ConvectionDiffusionDGWeights::weightsOn,3.0);
+
+    using GO = Dune::PDELab::GridOperator<GFS,GFS,LOP,MBE,RF,RF,RF,CC,CC>;
+    GO go(gfs,gfs,lop,MBE(5));
+    GO go_upper(gfs,gfs,lop,MBE(5,Dune::PDELab::ISTL::MatrixStorage::upperTriangular));
+
+    using V = typename GO::Traits::Domain;
+    V x(gfs,0.0);
+
+    typename GO::Traits::Jacobian jac(go), jac_upper(go_upper);
+    go.jacobian(x,jac);
+    go_upper.jacobian(x,jac_upper);
+    passed &= compareUpperTriangle(jac,jac_upper,[](std::size_t){ return false; },"DG Q1");
+
+    passed &= compareSolutions(go,go_upper,x,"DG Q1");
+  }
+
+  return passed;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+
+    Dune::MPIHelper::instance(argc, argv);
+
+    Dune::YaspGrid<2> grid({{1.0,1.0}},{{8,6}});
+
+    return testUpperTriangularStorage(grid.leafGridView()) ? 0 : 1;
+
+  }
+  catch (std::exception &e){
+    std::cerr << "Dune reported error: " << e.what() << std::endl;
+    return 1;
+  }
+  catch (...){
+    std::cerr << "Unknown exception thrown!" << std::endl;
+    return 1;
+  }
+}